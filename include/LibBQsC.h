@@ -4,15 +4,28 @@
 #define MASTER_HEADER_H
 
 
+#include "../include/core/allocation.h"
+#include "../include/core/gemm.h"
 #include "../include/core/linear_algebra.h"
+#include "../include/core/matrix.h"
+#include "../include/core/model_file.h"
+#include "../include/core/sparse_matrix.h"
+#include "../include/core/thread_pool.h"
+#include "../include/core/vector_kernels.h"
+#include "../include/core/workspace.h"
+
+#include "../include/data/csv_loader.h"
+#include "../include/data/dataset_file.h"
 
 #include "../include/metrics/regression_metrics.h"
 
 #include "../include/neural_networks/ANN.h"
+#include "../include/neural_networks/FrozenANN.h"
 #include "../include/neural_networks/neural_network_utilities.h"
 
 #include "../include/optimization/adam_optimizer.h"
 #include "../include/optimization/gradient_descent.h"
+#include "../include/optimization/lbfgs_optimizer.h"
 #include "../include/optimization/optimization_config.h"
 
 #include "../include/preprocessing/feature_scaling.h"
@@ -0,0 +1,50 @@
+//Allocation class of LibBQsC by Berkay
+
+#ifndef ALLOCATION_H
+#define ALLOCATION_H
+
+#include <stddef.h>
+
+/**
+ * Note : 	The library allocates its heap memory through the methods of this
+ * 			class instead of calling malloc() and aligned_alloc() directly.
+ * 			The memory is freed with free() as usual.
+ *
+ * Note : 	When the library is compiled with LIBBQSC_DEBUG_ALLOCATIONS defined,
+ * 			every allocation is counted. The counter can be used to check that
+ * 			the steady-state iterations of the training loops don't allocate,
+ * 			e.g. by comparing the counts of two trainings that only differ in
+ * 			the number of iterations. Without the definition the methods only
+ * 			forward to the standard library and the count is always zero.
+ */
+
+/**
+ * Method to allocate memory
+ *
+ * @param	size	size of the memory in bytes
+ * @return			pointer to the memory, NULL on failure
+ */
+void* allocateMemory(size_t size);
+
+/**
+ * Method to allocate aligned memory
+ *
+ * @param	alignment	alignment of the memory in bytes
+ * @param	size		size of the memory in bytes, a multiple of the alignment
+ * @return				pointer to the memory, NULL on failure
+ */
+void* allocateAlignedMemory(size_t alignment, size_t size);
+
+/**
+ * Method to get the number of allocations done since the last reset
+ *
+ * @return	number of allocations, always zero without LIBBQSC_DEBUG_ALLOCATIONS
+ */
+long getAllocationCount(void);
+
+/**
+ * Method to reset the number of allocations to zero
+ */
+void resetAllocationCount(void);
+
+#endif //ALLOCATION_H
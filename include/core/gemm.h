@@ -0,0 +1,87 @@
+//GEMM class of LibBQsC by Berkay
+
+#ifndef GEMM_H
+#define GEMM_H
+
+#include "matrix.h"
+
+/**
+ * Note : 	matrixGEMM() is the general matrix multiplication routine shared by the
+ * 			models of the library. It computes C = alpha * op(A) x op(B) + beta * C
+ * 			where op(X) is either X or X^T.
+ *
+ * Note : 	The multiplication is blocked for the caches. Panels of op(B) of
+ * 			GEMM_KC x GEMM_NC and blocks of op(A) of GEMM_MC x GEMM_KC are packed
+ * 			into contiguous buffers so that the micro-kernel reads both operands
+ * 			sequentially, and the micro-kernel keeps a GEMM_MR x GEMM_NR tile of C
+ * 			in registers while iterating over the packed panels.
+ *
+ * Note : 	The micro-kernel uses AVX2 when the instruction set selected in the
+ * 			vector kernels class supports it, and a portable version otherwise.
+ *
+ * Note : 	Packing buffers are kept per thread and reused between the calls, so
+ * 			the routine doesn't allocate in the steady state.
+ *
+ * Note : 	matrixGEMMEpilogue() calls an epilogue on each piece of a row of C as
+ * 			soon as the piece is final, i.e. right after the micro-kernel adds the
+ * 			last block of the depth to the tile holding it. So, the element-wise
+ * 			operations that follow a multiplication (e.g. adding a bias and
+ * 			applying an activation) are done while the tile is still in the L1
+ * 			cache instead of in a separate pass over C.
+ */
+
+//Register tile of the micro-kernel : rows of A and columns of B
+#define GEMM_MR 4
+#define GEMM_NR 8
+
+//Cache blocks : GEMM_MC x GEMM_KC block of A for L2 and GEMM_KC x GEMM_NR sliver of B for L1
+#define GEMM_MC 128
+#define GEMM_KC 256
+#define GEMM_NC 4096
+
+/**
+ * Method for general matrix multiplication : C = alpha * op(A) x op(B) + beta * C
+ *
+ * @param	transpose_A		1 if A^T will be used as op(A)
+ * @param	transpose_B		1 if B^T will be used as op(B)
+ * @param	alpha			scalar to multiply op(A) x op(B) by
+ * @param	A				first matrix
+ * @param	B				second matrix
+ * @param	beta			scalar to multiply C by, C is not read if it is 0
+ * @param	C				resulting matrix with the dimensions of op(A) x op(B)
+ */
+void matrixGEMM(int transpose_A, int transpose_B, double alpha, Matrix* A, Matrix* B, double beta, Matrix* C);
+
+/**
+ * GEMMEpilogue type
+ *
+ * Method applied to the items C[row][column], ..., C[row][column + n - 1] once they are final
+ */
+typedef void (*GEMMEpilogue)(Matrix* C, int row, int column, int n, void* argument);
+
+/**
+ * Method for general matrix multiplication followed by an epilogue : C = epilogue(alpha * op(A) x op(B) + beta * C)
+ *
+ * Each item of C is passed to the epilogue exactly once. The pieces may be passed in any order and
+ * their sizes are not specified, so the epilogue should only depend on the positions of the items.
+ *
+ * @param	transpose_A		1 if A^T will be used as op(A)
+ * @param	transpose_B		1 if B^T will be used as op(B)
+ * @param	alpha			scalar to multiply op(A) x op(B) by
+ * @param	A				first matrix
+ * @param	B				second matrix
+ * @param	beta			scalar to multiply C by, C is not read if it is 0
+ * @param	C				resulting matrix with the dimensions of op(A) x op(B)
+ * @param	epilogue		method to be applied to the pieces of the rows of C, may be NULL
+ * @param	argument		argument to be passed to the epilogue
+ */
+void matrixGEMMEpilogue(int transpose_A, int transpose_B, double alpha, Matrix* A, Matrix* B, double beta, Matrix* C, GEMMEpilogue epilogue, void* argument);
+
+/**
+ * Method to dispose the packing buffers of the calling thread
+ *
+ * The buffers are initialized again by the next call of matrixGEMM() if required.
+ */
+void disposeGEMMBuffers(void);
+
+#endif //GEMM_H
@@ -11,13 +11,28 @@
  * 			dispose the passed arrays. So, the passed arrays should be
  * 			disposed by the user if are no longer needed.
  *
- * Note : 	Some other methods such as LU decomposition are likely
- * 			to be added to this class later. When these methods are
- * 			added, the methods like matrixDeterminant() and
- * 			matrixInverse() will handle the selection of the method
- * 			to be used.
+ * Note : 	Methods that return a new vector or matrix have "Into"
+ * 			variants that write the result into an existing one instead,
+ * 			and the element-wise ones have "InPlace" variants as well. These
+ * 			variants do not allocate unless it is stated otherwise, so they
+ * 			should be preferred in loops. The exceptions are luSolveInto()
+ * 			when x is b, luInverseInto(), matrixAdjointInto() and
+ * 			matrixInverseInto(), which allocate temporaries at each call. The
+ * 			vector variants (such as vectorAdditionInto()) are in the vector
+ * 			kernels class.
+ *
+ * Note : 	matrixDeterminant() and matrixInverse() handle the selection
+ * 			of the method to be used. Laplace expansion and the adjoint
+ * 			matrix are used for matrices up to LU_DECOMPOSITION_THRESHOLD
+ * 			rows, and LU decomposition is used for the larger ones.
  */
 
+#include "matrix.h"
+#include "vector_kernels.h"
+
+//Size of the largest matrix whose determinant and inverse are calculated without LU decomposition
+#define LU_DECOMPOSITION_THRESHOLD 3
+
 /**
  * Vector methods of the linear algebra class
  */
@@ -305,6 +320,12 @@ double** matrixInverse(double** A, int rows, int columns);
 /**
  * Method for calculating the right inverse of a matrix
  *
+ * A^T (A A^T)^-1 is calculated as the transpose of the left inverse of the A^T, so (A A^T) Z = A
+ * is solved with the Cholesky decomposition of the Gram matrix, or with the Householder QR
+ * decomposition of the A^T if the Gram matrix is not numerically positive definite, and
+ * (A A^T)^-1 is never calculated explicitly. Exits if the A is rank deficient, where the right
+ * inverse doesn't exist.
+ *
  * @param	A		the matrix whose right inverse will be calculated
  * @param	rows	number of rows in the matrix
  * @param	columns number of columns in the matrix
@@ -315,6 +336,11 @@ double** matrixRightInverse(double** A, int rows, int columns);
 /**
  * Method for calculating the left inverse of a matrix
  *
+ * (A^T A)^-1 A^T is calculated by solving (A^T A) Z = A^T with the Cholesky decomposition
+ * of the Gram matrix, or with the Householder QR decomposition of the A if the Gram
+ * matrix is not numerically positive definite. Exits if the A is rank deficient, where
+ * the left inverse doesn't exist.
+ *
  * @param	A		the matrix whose left inverse will be calculated
  * @param	rows	number of rows in the matrix
  * @param	columns number of columns in the matrix
@@ -322,6 +348,160 @@ double** matrixRightInverse(double** A, int rows, int columns);
  */
 double** matrixLeftInverse(double** A, int rows, int columns);
 
+/**
+ * LU decomposition methods of the linear algebra class
+ */
+
+/**
+ * LUDecomposition struct
+ *
+ * PA = LU where P is a permutation matrix, L is a lower triangular matrix with ones on
+ * its diagonal and U is an upper triangular matrix. L and U are stored in the same
+ * matrix : items below the diagonal belong to L, and the others belong to U.
+ */
+typedef struct
+{
+	//L and U in a single matrix
+	Matrix* LU;
+	//Row permutation : the ith row of PA is the pivots[i]th row of A
+	int* pivots;
+	//Size of the decomposed matrix
+	int n;
+	//Sign of the permutation : -1 if the number of row swaps is odd
+	int sign;
+	//1 if a pivot is zero so the decomposed matrix is singular
+	int singular;
+}
+LUDecomposition;
+
+/**
+ * Method to compute the LU decomposition of a matrix with partial pivoting
+ *
+ * @param	A		the matrix to be decomposed
+ * @param	rows	number of rows in the matrix
+ * @param	columns number of columns in the matrix
+ * @return			pointer to the initialized LUDecomposition
+ */
+LUDecomposition* initLUDecomposition(double** A, int rows, int columns);
+
+/**
+ * Method to compute the LU decomposition of a Matrix with partial pivoting
+ *
+ * @param	A	the matrix to be decomposed
+ * @return		pointer to the initialized LUDecomposition
+ */
+LUDecomposition* initLUDecompositionStruct(Matrix* A);
+
+/**
+ * Method for calculating a determinant using an LU decomposition
+ *
+ * @param	lu	LU decomposition of the matrix
+ * @return		determinant of the matrix
+ */
+double luDeterminant(LUDecomposition* lu);
+
+/**
+ * Method to solve Ax = b using the LU decomposition of A
+ *
+ * @param	lu	LU decomposition of the A
+ * @param	b	right hand side vector of size n
+ * @return		the solution x
+ */
+double* luSolve(LUDecomposition* lu, double* b);
+
+/**
+ * Method to solve Ax = b into an existing vector using the LU decomposition of A
+ *
+ * It doesn't allocate unless the x is the b, then a copy of the b is allocated and freed at each call.
+ *
+ * @param	lu	LU decomposition of the A
+ * @param	b	right hand side vector of size n
+ * @param	x	vector of size n into which the solution will be written, may be the b
+ */
+void luSolveInto(LUDecomposition* lu, double* b, double* x);
+
+/**
+ * Method for calculating the inverse of a matrix using its LU decomposition
+ *
+ * @param	lu	LU decomposition of the matrix
+ * @return		inverse of the matrix
+ */
+double** luInverse(LUDecomposition* lu);
+
+/**
+ * Method for calculating the inverse of a matrix into an existing matrix using its LU decomposition
+ *
+ * Unlike the other Into variants it allocates : two vectors of size n are allocated and freed at
+ * each call to solve the columns of the inverse.
+ *
+ * @param	lu		LU decomposition of the matrix
+ * @param	inverse	matrix of dimensions (n, n) into which the inverse will be written
+ */
+void luInverseInto(LUDecomposition* lu, double** inverse);
+
+/**
+ * Method to dispose an LUDecomposition
+ *
+ * @param	lu	LUDecomposition to be disposed
+ */
+void disposeLUDecomposition(LUDecomposition* lu);
+
+/**
+ * Least squares methods of the linear algebra class
+ */
+
+/**
+ * LeastSquaresSolver enum
+ *
+ * CHOLESKY_SOLVER solves the normal equations (X^T X) B = X^T Y with the Cholesky decomposition
+ * of the Gram matrix X^T X. It is the fastest one but squares the condition number of the X.
+ *
+ * QR_SOLVER decomposes the X itself with Householder reflections and solves R B = Q^T Y. It is
+ * slower but more accurate for ill-conditioned X.
+ */
+typedef enum
+{
+	CHOLESKY_SOLVER,
+	QR_SOLVER
+}
+LeastSquaresSolver;
+
+/**
+ * Method for the Cholesky decomposition of a symmetric positive definite Matrix in place
+ *
+ * A = L L^T where L is lower triangular. L is written on and below the diagonal of the
+ * A, and the items above the diagonal are not read or modified.
+ *
+ * @param	A	the matrix to be decomposed
+ * @return		1 if the decomposition is successful, 0 if A is not positive definite
+ */
+int matrixCholeskyDecomposition(Matrix* A);
+
+/**
+ * Method to solve (L L^T) Z = B in place using a Cholesky decomposition
+ *
+ * Each column of the B is a right hand side, and the B is replaced with the Z.
+ *
+ * @param	L	Cholesky decomposition computed by matrixCholeskyDecomposition()
+ * @param	B	right hand sides with as many rows as the L
+ */
+void matrixCholeskySolve(Matrix* L, Matrix* B);
+
+/**
+ * Method for the least squares solution B minimizing ||XB - Y||
+ *
+ * The CHOLESKY_SOLVER falls back to the QR_SOLVER if the Gram matrix is not numerically
+ * positive definite. The inverse of the Gram matrix is never calculated explicitly. Exits
+ * if the X is rank deficient, where the B isn't unique : a diagonal item of the R is at
+ * most max(samples, features) * DBL_EPSILON times the largest of them.
+ *
+ * @param	X		matrix of dimensions (samples, features) with samples >= features
+ * @param	Y		matrix of dimensions (samples, targets)
+ * @param	solver	solver to be used
+ * @return			B of dimensions (features, targets)
+ */
+Matrix* matrixLeastSquares(Matrix* X, Matrix* Y, LeastSquaresSolver solver);
+
 /**
  * Method to dispose a Matrix
  *
@@ -380,4 +560,185 @@ double* convertMatrixVector(double** A, int rows, int columns, int dispose);
  */
 double* flatten(double** A, int rows, int columns, int dispose);
 
+/**
+ * Allocation-free methods of the linear algebra class
+ */
+
+/**
+ * Method to append a number to a vector into an existing vector
+ *
+ * @param	result	vector of size n + 1 into which the result will be written
+ * @param 	vector 	vector to which the number will be appended
+ * @param 	n 		size of the vector
+ * @param 	number  number to be appended
+ * @param 	index 	index to append the number
+ */
+void vectorAppendInto(double* result, double* vector, int n, double number, int index);
+
+/**
+ * Method to get a row from a matrix into an existing vector
+ *
+ * @param	row		vector of size columns into which the row will be copied
+ * @param	A		matrix whose row will be copied
+ * @param	rows	number of rows in the matrix
+ * @param	columns	number of columns in the matrix
+ * @param	index	index of the row to be copied, the program exits if it is out of the rows
+ */
+void matrixGetRowInto(double* row, double** A, int rows, int columns, int index);
+
+/**
+ * Method to get a column from a matrix into an existing vector
+ *
+ * @param	column	vector of size rows into which the column will be copied
+ * @param	A		matrix whose column will be copied
+ * @param	rows	number of rows in the matrix
+ * @param	columns	number of columns in the matrix
+ * @param	index	index of the column to be copied, the program exits if it is out of the columns
+ */
+void matrixGetColumnInto(double* column, double** A, int rows, int columns, int index);
+
+/**
+ * Method for matrix addition into an existing matrix
+ *
+ * @param	result	matrix into which the result will be written, may be A or B
+ * @param	A		first matrix
+ * @param	B 		second matrix
+ * @param	rows	number of rows in the matrices
+ * @param	columns number of columns in the matrices
+ */
+void matrixAdditionInto(double** result, double** A, double** B, int rows, int columns);
+
+/**
+ * Method for matrix subtraction into an existing matrix
+ *
+ * @param	result	matrix into which the result will be written, may be A or B
+ * @param	A		first matrix
+ * @param	B 		second matrix
+ * @param	rows	number of rows in the matrices
+ * @param	columns number of columns in the matrices
+ */
+void matrixSubtractionInto(double** result, double** A, double** B, int rows, int columns);
+
+/**
+ * Method for matrix scalar multiplication into an existing matrix
+ *
+ * @param	result	matrix into which the result will be written, may be A
+ * @param	A		matrix
+ * @param	rows	number of rows in the matrix
+ * @param	columns number of columns in the matrix
+ * @param 	scalar	scalar to multiply the matrix by
+ */
+void matrixScalarMultiplicationInto(double** result, double** A, int rows, int columns, double scalar);
+
+/**
+ * Method for matrix multiplication into an existing matrix
+ *
+ * @param	result		matrix of dimensions (rows_A, columns_B), may not be A or B
+ * @param	A			first matrix
+ * @param 	rows_A		number of rows in the A matrix
+ * @param	columns_A 	number of columns in the A matrix
+ * @param	B 			second matrix
+ * @param	rows_B		number of rows in the B matrix
+ * @param	columns_B	number of columns in the B matrix
+ */
+void matrixMultiplicationInto(double** result, double** A, int rows_A, int columns_A, double** B, int rows_B, int columns_B);
+
+/**
+ * Method for matrix transpose into an existing matrix
+ *
+ * @param	result	matrix of dimensions (columns, rows), may not be A
+ * @param	A		the matrix
+ * @param	rows	number of rows in the matrix
+ * @param	columns number of columns in the matrix
+ */
+void matrixTransposeInto(double** result, double** A, int rows, int columns);
+
+/**
+ * Method for sub matrix into an existing matrix
+ *
+ * @param	result	matrix of dimensions (rows - 1, columns - 1)
+ * @param	A		the matrix
+ * @param	rows	number of rows in the matrix
+ * @param	columns number of columns in the matrix
+ * @param	i		index of the row to exclude
+ * @param	j		index of the column to exclude
+ */
+void matrixSubmatrixInto(double** result, double** A, int rows, int columns, int i, int j);
+
+/**
+ * Method for calculating an adjoint matrix into an existing matrix
+ *
+ * Unlike the other Into variants it allocates : each cofactor allocates and frees a sub matrix of
+ * dimensions (rows - 1, columns - 1), and its determinant allocates the LU decomposition of it
+ * if it has more than LU_DECOMPOSITION_THRESHOLD rows.
+ *
+ * @param	result	matrix with the same dimensions, may not be A
+ * @param	A		the matrix whose adjoint will be calculated
+ * @param	rows	number of rows in the matrix
+ * @param	columns number of columns in the matrix
+ */
+void matrixAdjointInto(double** result, double** A, int rows, int columns);
+
+/**
+ * Method for calculating the inverse of a matrix into an existing matrix
+ *
+ * Unlike the other Into variants it allocates : the adjoint matrix of the small matrices, or the
+ * LU decomposition of the larger ones and the vectors of luInverseInto(), are allocated and freed
+ * at each call.
+ *
+ * @param	result	matrix with the same dimensions, may be A
+ * @param	A		the matrix whose inverse will be calculated
+ * @param	rows	number of rows in the matrix
+ * @param	columns number of columns in the matrix
+ */
+void matrixInverseInto(double** result, double** A, int rows, int columns);
+
+/**
+ * Method to flatten a matrix into an existing vector
+ *
+ * @param	a		vector of size rows * columns
+ * @param 	A		matrix to be flattened
+ * @param 	rows	number of rows in the matrix
+ * @param	columns	number of columns in the matrix
+ */
+void flattenInto(double* a, double** A, int rows, int columns);
+
+/**
+ * Method for matrix addition in place : A = A + B
+ *
+ * @param	A		first matrix, into which the result will be written
+ * @param	B 		second matrix
+ * @param	rows	number of rows in the matrices
+ * @param	columns number of columns in the matrices
+ */
+void matrixAdditionInPlace(double** A, double** B, int rows, int columns);
+
+/**
+ * Method for matrix subtraction in place : A = A - B
+ *
+ * @param	A		first matrix, into which the result will be written
+ * @param	B 		second matrix
+ * @param	rows	number of rows in the matrices
+ * @param	columns number of columns in the matrices
+ */
+void matrixSubtractionInPlace(double** A, double** B, int rows, int columns);
+
+/**
+ * Method for matrix scalar multiplication in place : A = scalar * A
+ *
+ * @param	A		matrix, into which the result will be written
+ * @param	rows	number of rows in the matrix
+ * @param	columns number of columns in the matrix
+ * @param 	scalar	scalar to multiply the matrix by
+ */
+void matrixScalarMultiplicationInPlace(double** A, int rows, int columns, double scalar);
+
+/**
+ * Method for the transpose of a square matrix in place
+ *
+ * @param	A	the matrix, into which the result will be written
+ * @param	n	number of rows and columns in the matrix
+ */
+void matrixTransposeInPlace(double** A, int n);
+
 #endif //LINEAR_ALGEBRA_H
@@ -0,0 +1,140 @@
+//Matrix class of LibBQsC by Berkay
+
+#ifndef MATRIX_H
+#define MATRIX_H
+
+/**
+ * Note : 	A Matrix keeps all of its items in a single contiguous row-major
+ * 			buffer instead of the separately allocated rows of a double**.
+ * 			Initializing a Matrix costs one allocation regardless of the
+ * 			number of rows, and walking over the rows doesn't chase a pointer
+ * 			per row.
+ *
+ * Note : 	The buffer is aligned to MATRIX_ALIGNMENT bytes so that it can be
+ * 			used by the vectorized kernels of the library.
+ *
+ * Note : 	The stride is the distance between the beginnings of two
+ * 			consecutive rows in items. It is equal to the number of columns
+ * 			for the matrices initialized in this class, so the buffer of such
+ * 			a matrix can be passed to the methods that expect flattened
+ * 			vectors (e.g. optimizers) without being copied.
+ *
+ * Note : 	Instances of this class should be initialized using the methods
+ * 			provided and disposed using disposeMatrix().
+ */
+
+//Alignment of the buffers in bytes
+#define MATRIX_ALIGNMENT 64
+
+//Pointer to the beginning of a row of a Matrix
+#define MATRIX_ROW(M, i) ((M)->data + (long)(i) * (M)->stride)
+
+//Item on the ith row and the jth column of a Matrix
+#define MATRIX_AT(M, i, j) (MATRIX_ROW(M, i)[j])
+
+/**
+ * Matrix struct
+ */
+typedef struct
+{
+	//Contiguous row-major buffer of the items
+	double* data;
+	//Dimensions of the matrix
+	int rows;
+	int columns;
+	//Distance between the beginnings of two consecutive rows
+	int stride;
+}
+Matrix;
+
+/**
+ * Method to initialize a Matrix whose items are not initialized
+ *
+ * @param	rows	number of rows to be in the matrix
+ * @param	columns	number of columns to be in the matrix
+ * @return			pointer to the initialized Matrix
+ */
+Matrix* createMatrix(int rows, int columns);
+
+/**
+ * Method to initialize a Matrix of zeros
+ *
+ * @param	rows	number of rows to be in the matrix
+ * @param	columns	number of columns to be in the matrix
+ * @return			pointer to the initialized Matrix
+ */
+Matrix* createZeroMatrix(int rows, int columns);
+
+/**
+ * Method to initialize a Matrix of random numbers between 0 and 1
+ *
+ * @param	rows	number of rows to be in the matrix
+ * @param	columns	number of columns to be in the matrix
+ * @return			pointer to the initialized Matrix
+ */
+Matrix* createRandomMatrix(int rows, int columns);
+
+/**
+ * Method to clone a Matrix
+ *
+ * @param	M	matrix to be cloned
+ * @return		pointer to the clone
+ */
+Matrix* cloneMatrix(Matrix* M);
+
+/**
+ * Method to set all items of a Matrix to zero
+ *
+ * @param	M	matrix to be filled with zeros
+ */
+void matrixFillZero(Matrix* M);
+
+/**
+ * Method to dispose a Matrix
+ *
+ * @param	M	matrix to be disposed
+ */
+void disposeMatrix(Matrix* M);
+
+/**
+ * Method to print a Matrix
+ *
+ * @param	M				matrix to print
+ * @param	decimal_places	number of decimal places to print
+ */
+void printMatrixStruct(Matrix* M, int decimal_places);
+
+/**
+ * Methods to convert a double** to a Matrix and vice versa
+ *
+ * These methods are the adapters for the callers that still use double** arrays.
+ * They copy the items and do not dispose the passed arrays.
+ */
+
+/**
+ * Method to convert a double** to a Matrix
+ *
+ * @param	A		double** to be converted
+ * @param	rows	number of rows in the double**
+ * @param	columns	number of columns in the double**
+ * @return			pointer to the initialized Matrix
+ */
+Matrix* matrixFromArray(double** A, int rows, int columns);
+
+/**
+ * Method to copy the items of a double** into an existing Matrix
+ *
+ * @param	M	matrix into which the items will be copied
+ * @param	A	double** with the same dimensions as the Matrix
+ */
+void matrixCopyFromArray(Matrix* M, double** A);
+
+/**
+ * Method to convert a Matrix to a double**
+ *
+ * @param	M	matrix to be converted
+ * @return		initialized double** that should be disposed using matrixDispose()
+ */
+double** matrixToArray(Matrix* M);
+
+#endif //MATRIX_H
@@ -0,0 +1,186 @@
+//Model file class of LibBQsC by Berkay
+
+/**
+ * Note : 	A model file keeps the parameters of a model in a binary format that can be
+ * 			mapped into the memory and used without being copied. It consists of :
+ *
+ * 			header		: ModelFileHeader, MODEL_FILE_ALIGNMENT bytes
+ * 			layer table	: a ModelFileLayer for each layer, padded to MODEL_FILE_ALIGNMENT bytes
+ * 			blobs		: W of each layer followed by its B, each of them starting at a multiple
+ * 						  of MODEL_FILE_ALIGNMENT bytes. The rows of the W and the B are padded
+ * 						  with zeros to multiples of MODEL_FILE_ALIGNMENT bytes, so a W can be
+ * 						  used as a Matrix whose stride is the stride of its layer.
+ *
+ * Note : 	The numbers are written in the byte order of the writing machine, which is
+ * 			recorded by the endianness field of the header. A file written on a machine
+ * 			with the other byte order is rejected rather than converted, since it couldn't
+ * 			be used without copying.
+ *
+ * Note : 	The header has a checksum of its own fields and a checksum of the rest of the
+ * 			file. The latter reads the whole file, so it can be skipped when the file is
+ * 			mapped, e.g. by the worker processes of a service after it is verified once.
+ *
+ * Note : 	The files are mapped read-only and shared, so the processes mapping the same
+ * 			file share a single copy of it in the page cache.
+ */
+
+#ifndef MODEL_FILE_H
+#define MODEL_FILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "matrix.h"
+
+//Version of the format written by this version of the library
+#define MODEL_FILE_VERSION 1
+
+//Alignment of the sections and the blobs in bytes
+#define MODEL_FILE_ALIGNMENT 64
+
+//Value of the endianness field as written by the writing machine
+#define MODEL_FILE_ENDIANNESS 0x01020304u
+
+//Initial value of the checksums
+#define MODEL_FILE_CHECKSUM_OFFSET 14695981039346656037ULL
+
+/**
+ * ModelFileType enum
+ *
+ * Type of the model whose parameters are in the file
+ */
+typedef enum
+{
+	MODEL_FILE_ANN = 1,
+	MODEL_FILE_LOGISTIC_REGRESSION = 2
+}
+ModelFileType;
+
+/**
+ * ModelFileHeader struct
+ */
+typedef struct
+{
+	//"LIBBQSC" followed by a 0
+	char magic[8];
+	//Version of the format, byte order of the numbers and type of the model
+	uint32_t version;
+	uint32_t endianness;
+	uint32_t model_type;
+	//Number of entries in the layer table
+	uint32_t number_of_layers;
+	//Size of the file in bytes
+	uint64_t size;
+	//Checksum of the bytes after the header
+	uint64_t checksum;
+	//Checksum of the fields of the header before this one
+	uint64_t header_checksum;
+	//Reserved for the later versions, written as zeros
+	uint8_t reserved[16];
+}
+ModelFileHeader;
+
+/**
+ * ModelFileLayer struct
+ *
+ * Entry of the layer table. A model without layers (e.g. a logistic regression) is written as a single layer.
+ */
+typedef struct
+{
+	//Dimensions of the W : (rows, columns), and the number of doubles between the beginnings of its rows
+	uint32_t rows;
+	uint32_t columns;
+	uint32_t stride;
+	//Activation of the layer, 0 if the model doesn't have activations
+	uint32_t activation;
+	//Offsets of the W and the B from the beginning of the file in bytes
+	uint64_t W_offset;
+	uint64_t B_offset;
+}
+ModelFileLayer;
+
+/**
+ * ModelFile struct
+ *
+ * A model file mapped into the memory
+ */
+typedef struct
+{
+	//Mapping of the file and its size in bytes
+	void* mapping;
+	size_t size;
+	//Header and the layer table in the mapping
+	ModelFileHeader* header;
+	ModelFileLayer* layers;
+}
+ModelFile;
+
+/**
+ * Method to continue a checksum over the passed bytes
+ *
+ * The checksum of the bytes is updateModelFileChecksum(MODEL_FILE_CHECKSUM_OFFSET, data, size), and
+ * it can be continued over the following bytes by passing it back. The other binary files of the
+ * library use the same checksum.
+ *
+ * @param	checksum	checksum of the preceding bytes
+ * @param	data		bytes to be added to the checksum
+ * @param	size		number of the bytes, a multiple of 8
+ * @return				checksum of the preceding bytes followed by the passed ones
+ */
+uint64_t updateModelFileChecksum(uint64_t checksum, const void* data, size_t size);
+
+/**
+ * Method to write the parameters of a model into a model file
+ *
+ * @param	path				path of the file to be written, it is replaced if it exists
+ * @param	model_type			type of the model
+ * @param	number_of_layers	number of layers of the model, at least 1
+ * @param	W					W matrices of the layers
+ * @param	B					B vectors of the layers, each of them has as many items as the columns of its W
+ * @param	activations			activations of the layers, may be NULL if the model doesn't have activations
+ */
+void writeModelFile(const char* path, ModelFileType model_type, int number_of_layers, Matrix** W, double** B, int* activations);
+
+/**
+ * Method to map a model file into the memory
+ *
+ * The header and the layer table are validated, and the program exits with a message if the file is
+ * not a valid model file of the passed type.
+ *
+ * @param	path				path of the file
+ * @param	model_type			type of the model expected in the file
+ * @param	verify_checksum		1 if the checksum of the whole file will be verified as well
+ * @return						pointer to the mapped ModelFile
+ */
+ModelFile* mapModelFile(const char* path, ModelFileType model_type, int verify_checksum);
+
+/**
+ * Method to get a W of a mapped model file as a Matrix
+ *
+ * The items of the Matrix are in the mapping, so they are read-only and the Matrix must not be disposed.
+ *
+ * @param	file		mapped ModelFile
+ * @param	layer_no	index of the layer
+ * @return				Matrix viewing the W of the layer
+ */
+Matrix modelFileW(ModelFile* file, int layer_no);
+
+/**
+ * Method to get a B of a mapped model file
+ *
+ * @param	file		mapped ModelFile
+ * @param	layer_no	index of the layer
+ * @return				read-only B of the layer in the mapping
+ */
+double* modelFileB(ModelFile* file, int layer_no);
+
+/**
+ * Method to unmap a model file
+ *
+ * The Matrix views and the vectors obtained from the ModelFile are invalid afterwards.
+ *
+ * @param	file	ModelFile to be unmapped
+ */
+void unmapModelFile(ModelFile* file);
+
+#endif //MODEL_FILE_H
@@ -0,0 +1,133 @@
+//Sparse matrix class of LibBQsC by Berkay
+
+/**
+ * Note : 	A SparseMatrix keeps only the nonzero items in the compressed sparse row (CSR)
+ * 			format. The nonzero items of the rows are stored one row after another in the
+ * 			values with their columns in the column_indices, and the row i is between the
+ * 			row_offsets[i] and the row_offsets[i + 1] of them. So, a row is a contiguous
+ * 			run of both arrays and walking over the rows costs the number of nonzero items.
+ *
+ * Note : 	The multiplications of this class cost O(nonzeros x columns of B) instead of the
+ * 			O(rows x columns x columns of B) of matrixGEMM(). They compute each row of the
+ * 			result as a sum of the rows of B scaled by the nonzero items of the row of A, so
+ * 			B and C are read row by row and no item of A is read twice.
+ *
+ * Note : 	The columns of a row don't need to be sorted, but each column should appear at
+ * 			most once in a row. The loaders and the conversions of the library keep them
+ * 			sorted.
+ *
+ * Note : 	Instances of this class should be initialized using the methods provided and
+ * 			disposed using disposeSparseMatrix().
+ */
+
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+
+#include "gemm.h"
+#include "matrix.h"
+
+//Number of the nonzero items of a SparseMatrix
+#define SPARSE_NONZEROS(A) ((A)->row_offsets[(A)->rows])
+
+/**
+ * SparseMatrix struct
+ */
+typedef struct
+{
+	//Nonzero items of the rows one row after another, and the column of each of them
+	double* values;
+	int* column_indices;
+	//Beginning of each row in the values and the number of the nonzero items at the end : (rows + 1)
+	long* row_offsets;
+	//Dimensions of the matrix
+	int rows;
+	int columns;
+}
+SparseMatrix;
+
+/**
+ * Method to initialize a SparseMatrix whose items are not initialized
+ *
+ * The row_offsets[0] is 0 and the row_offsets[rows] is the number of the nonzero items, the
+ * other offsets, the values and the column_indices should be filled by the caller.
+ *
+ * @param	rows		number of rows to be in the matrix
+ * @param	columns		number of columns to be in the matrix
+ * @param	nonzeros	number of the nonzero items to be in the matrix
+ * @return				pointer to the initialized SparseMatrix
+ */
+SparseMatrix* createSparseMatrix(int rows, int columns, long nonzeros);
+
+/**
+ * Method to convert a Matrix to a SparseMatrix
+ *
+ * @param	M	matrix to be converted, its items that are exactly 0 are left out
+ * @return		pointer to the initialized SparseMatrix
+ */
+SparseMatrix* sparseMatrixFromMatrix(Matrix* M);
+
+/**
+ * Method to convert a SparseMatrix to a Matrix
+ *
+ * @param	A	sparse matrix to be converted
+ * @return		pointer to the initialized Matrix
+ */
+Matrix* sparseMatrixToMatrix(SparseMatrix* A);
+
+/**
+ * Method to clone a SparseMatrix
+ *
+ * @param	A	sparse matrix to be cloned
+ * @return		pointer to the clone
+ */
+SparseMatrix* cloneSparseMatrix(SparseMatrix* A);
+
+/**
+ * Method for sparse times dense matrix multiplication : C = alpha * A x B + beta * C
+ *
+ * @param	alpha	scalar to multiply A x B by
+ * @param	A		sparse matrix : (m, k)
+ * @param	B		dense matrix : (k, n)
+ * @param	beta	scalar to multiply C by, C is not read if it is 0
+ * @param	C		resulting matrix : (m, n)
+ */
+void sparseMatrixGEMM(double alpha, SparseMatrix* A, Matrix* B, double beta, Matrix* C);
+
+/**
+ * Method for sparse times dense matrix multiplication followed by an epilogue : C = epilogue(alpha * A x B + beta * C)
+ *
+ * Each row of C is passed to the epilogue as a single piece right after it is calculated, so the
+ * epilogues written for matrixGEMMEpilogue() can be used as they are.
+ *
+ * @param	alpha		scalar to multiply A x B by
+ * @param	A			sparse matrix : (m, k)
+ * @param	B			dense matrix : (k, n)
+ * @param	beta		scalar to multiply C by, C is not read if it is 0
+ * @param	C			resulting matrix : (m, n)
+ * @param	epilogue	method to be applied to the rows of C, may be NULL
+ * @param	argument	argument to be passed to the epilogue
+ */
+void sparseMatrixGEMMEpilogue(double alpha, SparseMatrix* A, Matrix* B, double beta, Matrix* C, GEMMEpilogue epilogue, void* argument);
+
+/**
+ * Method for transposed sparse times dense matrix multiplication : C = alpha * A^T x B + beta * C
+ *
+ * The A isn't transposed, each row i of the A scatters the row i of the B into the rows of the C
+ * in its columns. It is the multiplication of the gradients of the models, e.g. X^T x (P - Y).
+ *
+ * @param	alpha	scalar to multiply A^T x B by
+ * @param	A		sparse matrix : (m, k)
+ * @param	B		dense matrix : (m, n)
+ * @param	beta	scalar to multiply C by, C is not read if it is 0
+ * @param	C		resulting matrix : (k, n)
+ */
+void sparseMatrixTransposeGEMM(double alpha, SparseMatrix* A, Matrix* B, double beta, Matrix* C);
+
+/**
+ * Method to dispose a SparseMatrix
+ *
+ * @param	A	sparse matrix to be disposed
+ */
+void disposeSparseMatrix(SparseMatrix* A);
+
+#endif //SPARSE_MATRIX_H
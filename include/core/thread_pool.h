@@ -0,0 +1,77 @@
+//Thread pool class of LibBQsC by Berkay
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <pthread.h>
+
+/**
+ * Note : 	A ThreadPool keeps its threads alive between the tasks, so a task
+ * 			can be run on every iteration of a training without creating
+ * 			threads. The thread calling runThreadPool() is the thread 0 of the
+ * 			pool and runs its part of the task as well, so a pool of n threads
+ * 			creates n - 1 threads.
+ *
+ * Note : 	A task is run once by each thread with the number of the thread,
+ * 			and the task is expected to split its work using that number. So,
+ * 			the split, and hence the result of a task, only depends on the
+ * 			number of threads and not on the scheduling.
+ */
+
+/**
+ * ThreadPool struct
+ */
+typedef struct
+{
+	//Threads of the pool except the calling thread
+	pthread_t* threads;
+	int number_of_threads;
+	//Synchronization of the threads
+	pthread_mutex_t mutex;
+	pthread_cond_t task_ready;
+	pthread_cond_t task_done;
+	//Current task, its argument and the number of threads that haven't finished it yet
+	void (*task)(void* argument, int thread_no);
+	void* argument;
+	int remaining;
+	//Number of the tasks run so far, the threads wait until it changes
+	long generation;
+	//1 if the threads should exit
+	int stop;
+}
+ThreadPool;
+
+/**
+ * Method to get the number of processors available
+ *
+ * @return	number of processors online, at least 1
+ */
+int getNumberOfProcessors(void);
+
+/**
+ * Method to initialize a ThreadPool
+ *
+ * @param	number_of_threads	number of threads including the calling thread
+ * @return						pointer to the initialized ThreadPool
+ */
+ThreadPool* initThreadPool(int number_of_threads);
+
+/**
+ * Method to run a task on all threads of a ThreadPool and wait for it to finish
+ *
+ * @param	pool		ThreadPool to run the task on
+ * @param	task		method to be run by each thread with the argument and the number of the thread
+ * @param	argument	argument to be passed to the task
+ */
+void runThreadPool(ThreadPool* pool, void (*task)(void* argument, int thread_no), void* argument);
+
+/**
+ * Method to dispose a ThreadPool
+ *
+ * The threads are stopped and joined before the pool is disposed.
+ *
+ * @param	pool	ThreadPool to be disposed
+ */
+void disposeThreadPool(ThreadPool* pool);
+
+#endif //THREAD_POOL_H
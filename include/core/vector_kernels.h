@@ -0,0 +1,233 @@
+//Vector kernels class of LibBQsC by Berkay
+
+#ifndef VECTOR_KERNELS_H
+#define VECTOR_KERNELS_H
+
+/**
+ * Note : 	Methods in this class work on existing vectors and do not allocate,
+ * 			so they can be used in the hot loops of the library.
+ *
+ * Note : 	Each method has scalar, SSE2, AVX2 and AVX-512 implementations on x86.
+ * 			The widest instruction set supported by the processor is selected once
+ * 			when the library is loaded, and the scalar implementations are used on
+ * 			the other architectures.
+ *
+ * Note : 	Reductions (vectorDot() and vectorNrm2()) use several accumulators, so
+ * 			their results may differ from a sequential sum in the last bits.
+ *
+ * Note : 	vectorSum() and vectorMoments() are compensated : each accumulator keeps the
+ * 			rounding errors of its additions in a second accumulator (Knuth's TwoSum), so
+ * 			the sums are as accurate as if they were accumulated in twice the precision
+ * 			and their errors don't grow with the size of the vector. They differ between
+ * 			the instruction sets in the last bit at most.
+ *
+ * Note : 	The transcendental methods (vectorExp(), vectorLog(), vectorSigmoid(),
+ * 			vectorTanh() and vectorSoftmax()) use the C library when the scalar
+ * 			kernels are selected, and polynomial approximations otherwise. The
+ * 			maximum errors of the SIMD implementations, measured against a long
+ * 			double reference, are :
+ *
+ * 			exp		: 1.5 ulp, results below DBL_MIN are flushed to 0 and above DBL_MAX are inf
+ * 			log		: 1 ulp, log(0) is -inf and log(x < 0) is NaN
+ * 			sigmoid	: 2.5 ulp for x >= -709, the result is 0 below it as exp(-x) overflows
+ * 			tanh	: 3.5 ulp, the result is +-1 for |x| > 20
+ * 			softmax	: 3 ulp on top of the error of rounding x[i] - max(x), which is the
+ * 					  same as for the scalar implementation
+ *
+ * 			NaN inputs give NaN outputs in all of them.
+ */
+
+/**
+ * VectorMoments struct
+ *
+ * Minimum, maximum, sum and sum of squares of a vector calculated in a single pass
+ */
+typedef struct
+{
+	double min;
+	double max;
+	double sum;
+	double sum_of_squares;
+}
+VectorMoments;
+
+/**
+ * InstructionSet enum
+ *
+ * Instruction sets that the kernels can be implemented with, ordered by their widths
+ */
+typedef enum
+{
+	INSTRUCTION_SET_SCALAR,
+	INSTRUCTION_SET_SSE2,
+	INSTRUCTION_SET_AVX2,
+	INSTRUCTION_SET_AVX512
+}
+InstructionSet;
+
+/**
+ * Method to get the instruction set of the selected kernels
+ *
+ * @return	instruction set in use
+ */
+InstructionSet getInstructionSet(void);
+
+/**
+ * Method to select the kernels of an instruction set
+ *
+ * The widest supported instruction set is selected automatically, so this method is
+ * only required to use a narrower one (e.g. to compare the implementations). Instruction
+ * sets that the processor doesn't support are lowered to the widest supported one.
+ *
+ * @param	instruction_set		instruction set to be used
+ */
+void setInstructionSet(InstructionSet instruction_set);
+
+/**
+ * Method for y = alpha * x + y
+ *
+ * @param	alpha	scalar to multiply x by
+ * @param	x		vector to be added
+ * @param	y		vector to which alpha * x will be added
+ * @param	n		size of the vectors
+ */
+void vectorAxpy(double alpha, double* x, double* y, int n);
+
+/**
+ * Method for x = alpha * x
+ *
+ * @param	alpha	scalar to multiply x by
+ * @param	x		vector to be scaled
+ * @param	n		size of the vector
+ */
+void vectorScal(double alpha, double* x, int n);
+
+/**
+ * Method for the dot product of two vectors
+ *
+ * @param	x	first vector
+ * @param	y	second vector
+ * @param	n	size of the vectors
+ * @return		the dot product
+ */
+double vectorDot(double* x, double* y, int n);
+
+/**
+ * Method for the Euclidean norm of a vector
+ *
+ * Calculated as the square root of the dot product of the vector by itself
+ *
+ * @param	x	the vector
+ * @param	n	size of the vector
+ * @return		the Euclidean norm
+ */
+double vectorNrm2(double* x, int n);
+
+/**
+ * Method for the compensated sum of a vector
+ *
+ * @param	x	the vector
+ * @param	n	size of the vector
+ * @return		the sum
+ */
+double vectorSum(double* x, int n);
+
+/**
+ * Method for the minimum, maximum, compensated sum and compensated sum of squares of a vector in a single pass
+ *
+ * The minimum and the maximum skip the NaNs, and they are inf and -inf if the vector doesn't
+ * have any other items. The sums are NaN if the vector has a NaN.
+ *
+ * @param	x	the vector
+ * @param	n	size of the vector
+ * @return		the moments
+ */
+VectorMoments vectorMoments(double* x, int n);
+
+/**
+ * Method to merge the moments of two vectors into the moments of their concatenation
+ *
+ * @param	a	moments of the first vector
+ * @param	b	moments of the second vector
+ * @return		the merged moments
+ */
+VectorMoments mergeVectorMoments(VectorMoments a, VectorMoments b);
+
+/**
+ * Method for result = a + b
+ *
+ * @param	result	vector into which the result will be written, may be a or b
+ * @param	a		first vector
+ * @param	b		second vector
+ * @param	n		size of the vectors
+ */
+void vectorAdditionInto(double* result, double* a, double* b, int n);
+
+/**
+ * Method for result = a - b
+ *
+ * @param	result	vector into which the result will be written, may be a or b
+ * @param	a		first vector
+ * @param	b		second vector
+ * @param	n		size of the vectors
+ */
+void vectorSubtractionInto(double* result, double* a, double* b, int n);
+
+/**
+ * Method for result = scalar * vector
+ *
+ * @param	result	vector into which the result will be written, may be the vector
+ * @param	vector	vector to be multiplied
+ * @param	n		size of the vectors
+ * @param	scalar	scalar
+ */
+void vectorScalarMultiplicationInto(double* result, double* vector, int n, double scalar);
+
+/**
+ * Method for result = exp(x)
+ *
+ * @param	result	vector into which the result will be written, may be the x
+ * @param	x		the vector
+ * @param	n		size of the vectors
+ */
+void vectorExp(double* result, double* x, int n);
+
+/**
+ * Method for result = log(x)
+ *
+ * @param	result	vector into which the result will be written, may be the x
+ * @param	x		the vector
+ * @param	n		size of the vectors
+ */
+void vectorLog(double* result, double* x, int n);
+
+/**
+ * Method for result = sigmoid(x) = 1 / (1 + exp(-x))
+ *
+ * @param	result	vector into which the result will be written, may be the x
+ * @param	x		the vector
+ * @param	n		size of the vectors
+ */
+void vectorSigmoid(double* result, double* x, int n);
+
+/**
+ * Method for result = tanh(x)
+ *
+ * @param	result	vector into which the result will be written, may be the x
+ * @param	x		the vector
+ * @param	n		size of the vectors
+ */
+void vectorTanh(double* result, double* x, int n);
+
+/**
+ * Method for result = softmax(x), i.e. result[i] = exp(x[i]) / sum(exp(x))
+ *
+ * The maximum of the x is subtracted from the items before the exp for numerical stability.
+ *
+ * @param	result	vector into which the result will be written, may be the x
+ * @param	x		the vector, n should be at least 1
+ * @param	n		size of the vectors
+ */
+void vectorSoftmax(double* result, double* x, int n);
+
+#endif //VECTOR_KERNELS_H
@@ -0,0 +1,97 @@
+//Workspace class of LibBQsC by Berkay
+
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include <stddef.h>
+
+#include "matrix.h"
+
+/**
+ * Note : 	A Workspace is a bump-pointer arena for the temporaries of an
+ * 			iteration. Memory is carved from a single buffer by moving an
+ * 			offset, and all of it is released at once by resetWorkspace().
+ * 			Memory carved from a Workspace must not be freed or disposed
+ * 			individually.
+ *
+ * Note : 	Requests that don't fit in the buffer are served by separate
+ * 			allocations until the next reset, which replaces the buffer with
+ * 			one that can hold everything requested since the previous reset.
+ * 			So, an iteration that requests the same memory as the previous one
+ * 			doesn't allocate.
+ *
+ * Note : 	Each model owns its Workspace, so the models trained in different
+ * 			threads don't contend for the allocator. A Workspace itself is not
+ * 			thread-safe.
+ */
+
+/**
+ * Workspace struct
+ */
+typedef struct
+{
+	//Buffer of the arena and its size in bytes
+	char* buffer;
+	size_t capacity;
+	//Bytes carved from the buffer since the last reset
+	size_t offset;
+	//Bytes requested since the last reset, including the ones that didn't fit in the buffer
+	size_t requested;
+	//Linked list of the allocations that didn't fit in the buffer
+	void* overflow;
+}
+Workspace;
+
+/**
+ * Method to initialize a Workspace
+ *
+ * @param	capacity	initial size of the buffer in bytes, may be 0
+ * @return				pointer to the initialized Workspace
+ */
+Workspace* initWorkspace(size_t capacity);
+
+/**
+ * Method to carve memory from a Workspace
+ *
+ * @param	workspace	Workspace to carve the memory from
+ * @param	size		size of the memory in bytes
+ * @return				pointer to the memory aligned to MATRIX_ALIGNMENT bytes
+ */
+void* workspaceAllocate(Workspace* workspace, size_t size);
+
+/**
+ * Method to carve a vector from a Workspace
+ *
+ * @param	workspace	Workspace to carve the vector from
+ * @param	n			size of the vector
+ * @return				vector whose items are not initialized
+ */
+double* workspaceVector(Workspace* workspace, int n);
+
+/**
+ * Method to carve a Matrix from a Workspace
+ *
+ * The Matrix must not be disposed using disposeMatrix().
+ *
+ * @param	workspace	Workspace to carve the Matrix from
+ * @param	rows		number of rows to be in the matrix
+ * @param	columns		number of columns to be in the matrix
+ * @return				pointer to the Matrix whose items are not initialized
+ */
+Matrix* workspaceMatrix(Workspace* workspace, int rows, int columns);
+
+/**
+ * Method to release all of the memory carved from a Workspace
+ *
+ * @param	workspace	Workspace to be reset
+ */
+void resetWorkspace(Workspace* workspace);
+
+/**
+ * Method to dispose a Workspace
+ *
+ * @param	workspace	Workspace to be disposed
+ */
+void disposeWorkspace(Workspace* workspace);
+
+#endif //WORKSPACE_H
@@ -0,0 +1,99 @@
+//CSV loader class of LibBQsC by Berkay
+
+/**
+ * Note : 	The file is mapped into the memory rather than read through a FILE*, and it is
+ * 			split into as many chunks as there are threads. Each chunk begins after a line
+ * 			break, so the threads parse whole rows without sharing any state.
+ *
+ * Note : 	A CSV file is loaded in two passes over the mapping. The first pass counts the
+ * 			rows of each chunk, which gives the row of the X at which each chunk begins. The
+ * 			X and the Y are then allocated once, and the second pass parses the numbers of
+ * 			each chunk straight into its rows. The first pass only looks for line breaks,
+ * 			so it is much faster than the second one.
+ *
+ * Note : 	The numbers are parsed by a parser of the library that handles the usual decimal
+ * 			and scientific notations without calling strtod(). The numbers with more than 19
+ * 			significant digits or a large exponent, and the words such as "nan" and "inf",
+ * 			are passed to strtod(). Both give the correctly rounded double, so a file written
+ * 			with enough digits (e.g. "%.17g") is loaded exactly.
+ *
+ * Note : 	An empty field is loaded as NaN, and the empty lines are skipped. The fields
+ * 			can't be quoted.
+ *
+ * Note : 	loadLibSVM() loads the sparse libsvm (SVMlight) format with the same mapping,
+ * 			chunks and number parser. Its first pass also counts the colons of each chunk,
+ * 			which gives the nonzero item at which each chunk begins, so the arrays of the
+ * 			SparseMatrix are allocated once and the threads parse straight into them.
+ */
+
+#ifndef CSV_LOADER_H
+#define CSV_LOADER_H
+
+#include "../core/matrix.h"
+#include "../core/sparse_matrix.h"
+
+/**
+ * CSVOptions struct
+ *
+ * Options of loading a CSV file, defaultCSVOptions() returns the options of a comma-separated
+ * file with a header whose last column is the label.
+ */
+typedef struct
+{
+	//Delimiter of the fields
+	char delimiter;
+	//1 if the first line is a header to be skipped
+	int header;
+	//Columns of the file to be loaded into the X in this order, NULL for all columns except the label column
+	int* feature_columns;
+	int number_of_features;
+	//Column of the labels, -1 for the last column and -2 if the file doesn't have labels
+	int label_column;
+	//Number of classes to one-hot encode the labels into, 0 to load the labels as they are into a single column
+	int one_hot_classes;
+	//Number of threads to parse the file with, 0 for the number of processors
+	int threads;
+}
+CSVOptions;
+
+/**
+ * Method to get the default options of loading a CSV file
+ *
+ * @return	options of a comma-separated file with a header and the labels in its last column
+ */
+CSVOptions defaultCSVOptions(void);
+
+/**
+ * Method to load a CSV file into a feature matrix and a label matrix
+ *
+ * The rows of the file are loaded into the rows of the X and the Y in the same order. If the
+ * labels are one-hot encoded, each label must be an integer between 0 and one_hot_classes - 1, and its
+ * row of the Y has a 1 in that column and 0 in the others. The program exits with a message if
+ * the file can't be loaded or a row doesn't match the first row.
+ *
+ * @param	path		path of the CSV file
+ * @param	options		options of loading the file, NULL for the default options
+ * @param	X			pointer to which the loaded features will be assigned : (rows, number_of_features)
+ * @param	Y			pointer to which the loaded labels will be assigned : (rows, one_hot_classes or 1), NULL if the labels aren't needed
+ */
+void loadCSV(const char* path, CSVOptions* options, Matrix** X, Matrix** Y);
+
+/**
+ * Method to load a libsvm file into a sparse feature matrix and a label matrix
+ *
+ * Each line is a label followed by the index:value pairs of the nonzero features, e.g.
+ * "1 3:0.5 10:2", with the 1-based indices in the ascending order. The comments beginning
+ * with '#' and the empty lines are skipped. The labels are loaded as they are or one-hot
+ * encoded as in loadCSV(), so the -1 / +1 labels of a binary file should be mapped to 0 / 1
+ * by the caller before training a logistic regression. The program exits with a message if
+ * the file can't be loaded or a row is invalid.
+ *
+ * @param	path			path of the libsvm file
+ * @param	features		number of the features, 0 for the largest index in the file
+ * @param	one_hot_classes	number of classes to one-hot encode the labels into, 0 to load the labels as they are
+ * @param	X				pointer to which the loaded features will be assigned : (rows, features)
+ * @param	Y				pointer to which the loaded labels will be assigned : (rows, one_hot_classes or 1), NULL if the labels aren't needed
+ */
+void loadLibSVM(const char* path, int features, int one_hot_classes, SparseMatrix** X, Matrix** Y);
+
+#endif //CSV_LOADER_H
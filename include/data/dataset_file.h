@@ -0,0 +1,248 @@
+//Dataset file class of LibBQsC by Berkay
+
+/**
+ * Note : 	A dataset file keeps a dataset in a binary format that can be mapped into the
+ * 			memory and used without being parsed or copied. It consists of :
+ *
+ * 			header		: DatasetFileHeader, 128 bytes
+ * 			rows		: the features of each row followed by its labels, the rows are back to
+ * 						  back and stride items apart, starting at a multiple of DATASET_FILE_ALIGNMENT
+ * 			statistics	: optional minimums, ranges, means and standard deviations of the features,
+ * 						  each of them an array of doubles starting at a multiple of DATASET_FILE_ALIGNMENT
+ *
+ * Note : 	Keeping the labels next to the features of each row makes the X and the Y two
+ * 			views into the same rows with the same stride, and a batch of consecutive rows
+ * 			a single contiguous range of the file. So, a file can be written in a single
+ * 			pass without knowing the number of rows beforehand, and a training reads each
+ * 			batch with a sequential read.
+ *
+ * Note : 	The items are either doubles or floats. The X and the Y of a file of doubles can
+ * 			be used as Matrix views into the mapping. The rows of a file of floats, which is
+ * 			half the size, are converted into matrices of the caller by datasetFileRows().
+ *
+ * Note : 	The statistics are calculated while the file is written, and they are the arrays
+ * 			expected by the feature scaling methods, e.g. minMaxScaleMatrix(X, statistics.min, statistics.range).
+ * 			So, scaling a mapped dataset doesn't read it once more to calculate them.
+ *
+ * Note : 	The files are mapped read-only and shared, so a dataset larger than the memory is
+ * 			paged in from the file as it is read, and the pages that were read can be dropped
+ * 			by the system at any time. The byte order and the checksums are handled the same
+ * 			way as the model files.
+ */
+
+#ifndef DATASET_FILE_H
+#define DATASET_FILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "../core/matrix.h"
+#include "../statistics/statistics.h"
+
+//Version of the format written by this version of the library
+#define DATASET_FILE_VERSION 1
+
+//Alignment of the sections in bytes
+#define DATASET_FILE_ALIGNMENT 64
+
+/**
+ * DatasetElementType enum
+ *
+ * Type of the items in the rows of a dataset file
+ */
+typedef enum
+{
+	DATASET_FLOAT64 = 1,
+	DATASET_FLOAT32 = 2
+}
+DatasetElementType;
+
+/**
+ * DatasetFileHeader struct
+ */
+typedef struct
+{
+	//"LIBBQSD" followed by a 0
+	char magic[8];
+	//Version of the format and byte order of the numbers
+	uint32_t version;
+	uint32_t endianness;
+	//Type of the items and 1 if the file has the statistics of the features
+	uint32_t element_type;
+	uint32_t has_statistics;
+	//Number of features and labels in a row
+	uint32_t features;
+	uint32_t labels;
+	//Number of rows and the number of items between the beginnings of two rows
+	uint64_t rows;
+	uint64_t stride;
+	//Offsets of the rows and the statistics from the beginning of the file in bytes
+	uint64_t rows_offset;
+	uint64_t statistics_offset;
+	//Size of the file in bytes
+	uint64_t size;
+	//Checksum of the bytes after the header
+	uint64_t checksum;
+	//Checksum of the fields of the header before this one
+	uint64_t header_checksum;
+	//Reserved for the later versions, written as zeros
+	uint8_t reserved[40];
+}
+DatasetFileHeader;
+
+/**
+ * DatasetStatistics struct
+ *
+ * Statistics of the features of a dataset, each of them is an array with an item for each feature
+ */
+typedef struct
+{
+	double* min;
+	double* range;
+	double* mean;
+	double* standard_deviation;
+}
+DatasetStatistics;
+
+/**
+ * DatasetWriter struct
+ *
+ * A dataset file being written
+ */
+typedef struct
+{
+	//File being written and its header
+	FILE* file;
+	DatasetFileHeader header;
+	//Checksum of the bytes written after the header
+	uint64_t checksum;
+	//Buffer of a row in the type of the items
+	void* row;
+	//Running statistics of the features, NULL without the statistics
+	ColumnStatistics* statistics;
+	//Features of a row as they are written, used for the statistics of a file of floats
+	double* items;
+}
+DatasetWriter;
+
+/**
+ * DatasetFile struct
+ *
+ * A dataset file mapped into the memory
+ */
+typedef struct
+{
+	//Mapping of the file and its size in bytes
+	void* mapping;
+	size_t size;
+	//Header in the mapping
+	DatasetFileHeader* header;
+}
+DatasetFile;
+
+/**
+ * Method to begin writing a dataset file
+ *
+ * @param	path				path of the file to be written, it is replaced if it exists
+ * @param	features			number of features in a row
+ * @param	labels				number of labels in a row, may be 0
+ * @param	element_type		type of the items to be written
+ * @param	with_statistics		1 if the statistics of the features will be calculated and written
+ * @return						pointer to the initialized DatasetWriter
+ */
+DatasetWriter* openDatasetWriter(const char* path, int features, int labels, DatasetElementType element_type, int with_statistics);
+
+/**
+ * Method to append rows to a dataset file being written
+ *
+ * @param	writer	DatasetWriter of the file
+ * @param	X		features of the rows : (rows, features)
+ * @param	Y		labels of the rows : (rows, labels), NULL if the file doesn't have labels
+ */
+void appendDatasetWriter(DatasetWriter* writer, Matrix* X, Matrix* Y);
+
+/**
+ * Method to finish writing a dataset file
+ *
+ * The statistics and the header are written, and the DatasetWriter is disposed.
+ *
+ * @param	writer	DatasetWriter of the file
+ */
+void closeDatasetWriter(DatasetWriter* writer);
+
+/**
+ * Method to write a dataset into a dataset file at once
+ *
+ * @param	path				path of the file to be written, it is replaced if it exists
+ * @param	X					features : (rows, features)
+ * @param	Y					labels : (rows, labels), NULL if the file won't have labels
+ * @param	element_type		type of the items to be written
+ * @param	with_statistics		1 if the statistics of the features will be calculated and written
+ */
+void writeDatasetFile(const char* path, Matrix* X, Matrix* Y, DatasetElementType element_type, int with_statistics);
+
+/**
+ * Method to map a dataset file into the memory
+ *
+ * The header is validated, and the program exits with a message if the file is not a valid dataset file.
+ *
+ * @param	path				path of the file
+ * @param	verify_checksum		1 if the checksum of the whole file will be verified as well, which reads the whole file
+ * @return						pointer to the mapped DatasetFile
+ */
+DatasetFile* mapDatasetFile(const char* path, int verify_checksum);
+
+/**
+ * Method to get the features of a mapped dataset file of doubles as a Matrix
+ *
+ * The items of the Matrix are in the mapping, so they are read-only and the Matrix must not be disposed.
+ *
+ * @param	file	mapped DatasetFile
+ * @return			Matrix viewing the features : (rows, features)
+ */
+Matrix datasetFileX(DatasetFile* file);
+
+/**
+ * Method to get the labels of a mapped dataset file of doubles as a Matrix
+ *
+ * The items of the Matrix are in the mapping, so they are read-only and the Matrix must not be disposed.
+ *
+ * @param	file	mapped DatasetFile
+ * @return			Matrix viewing the labels : (rows, labels)
+ */
+Matrix datasetFileY(DatasetFile* file);
+
+/**
+ * Method to copy consecutive rows of a mapped dataset file into matrices as doubles
+ *
+ * As many rows as the rows of the X are copied, and the items of a file of floats are converted.
+ *
+ * @param	file		mapped DatasetFile
+ * @param	first_row	index of the first row to be copied
+ * @param	X			matrix into which the features will be copied : (rows, features)
+ * @param	Y			matrix into which the labels will be copied : (rows, labels), NULL if the labels aren't needed
+ */
+void datasetFileRows(DatasetFile* file, long first_row, Matrix* X, Matrix* Y);
+
+/**
+ * Method to get the statistics of the features of a mapped dataset file
+ *
+ * The arrays are in the mapping, so they are read-only. The program exits with a message if the file
+ * was written without the statistics.
+ *
+ * @param	file	mapped DatasetFile
+ * @return			statistics of the features
+ */
+DatasetStatistics datasetFileStatistics(DatasetFile* file);
+
+/**
+ * Method to unmap a dataset file
+ *
+ * The Matrix views and the statistics obtained from the DatasetFile are invalid afterwards.
+ *
+ * @param	file	DatasetFile to be unmapped
+ */
+void unmapDatasetFile(DatasetFile* file);
+
+#endif //DATASET_FILE_H
@@ -3,6 +3,8 @@
 #ifndef REGRESSION_METRICS_H
 #define REGRESSION_METRICS_H
 
+#include "../core/matrix.h"
+
 /**
  * Note : 	Some other features such as weights for MSE are likely
  * 			to be added.
@@ -66,4 +68,13 @@ double logLoss(double* y_true, double* y_pred, int n);
  */
 double logLossMatrix(double** y_true, double** y_pred, int samples, int classes);
 
+/**
+ * Method to calculate a log loss for contiguous matrices
+ *
+ * @param	Y_true		true y values
+ * @param 	Y_pred		predicted y values with the same dimensions
+ * @return	   			log loss
+ */
+double logLossMatrixStruct(Matrix* Y_true, Matrix* Y_pred);
+
 #endif //REGRESSION_METRICS_H
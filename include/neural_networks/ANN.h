@@ -9,15 +9,18 @@
 #define ANN_H
 
 #include "neural_network_utilities.h"
+#include "../core/workspace.h"
+#include "../data/dataset_file.h"
+#include "../preprocessing/feature_scaling.h"
 
 /**
  * ANN struct
  */
 typedef struct
 {
-	//Input data
-	double** X;
-	double** Y;
+	//Input data copied into contiguous matrices
+	Matrix* X;
+	Matrix* Y;
 	//Input data dimensions
 	int samples;
 	int features;
@@ -25,12 +28,25 @@ typedef struct
 	//Layers of the ANN
 	ANNLayer** layers;
 	int number_of_layers;
+	//Number of threads used to train the ANN
+	int threads;
+	//Workspace of the temporaries of the training iterations and the predictions
+	Workspace* workspace;
+	//Scaler of the inputs folded into the first layer, NULL if the inputs are used as they are
+	Scaler* scaler;
+	//W and B of the first layer with the Scaler folded into them, allocated when they are first folded
+	Matrix* W_folded;
+	double* B_folded;
 }
 ANN;
 
 /**
  * Method to initialize an ANN
  *
+ * X and Y are copied into the contiguous matrices of the ANN, so the passed arrays
+ * can be disposed by the user after the initialization. They may be NULL if the ANN
+ * will only be trained on a dataset file by trainANNDataset().
+ *
  * @param X			X input data
  * @param Y			labels of the X
  * @param samples	number of samples in the X and Y
@@ -50,6 +66,42 @@ ANN* initANN(double** X, double** Y, int samples, int features, int classes);
  */
 void addLayerANN(ANN* ann, int neurons, LayerType layer_type, Activation activation);
 
+/**
+ * Method to set the number of threads used to train the ANN
+ *
+ * The rows of each training step are split between the threads, and their gradients are
+ * summed in the same order regardless of the scheduling. So, a training is reproducible
+ * for a fixed number of threads, while different numbers of threads may differ in the
+ * last bits.
+ *
+ * @param ann		ANN whose number of threads will be set
+ * @param threads	number of threads, e.g. getNumberOfProcessors()
+ */
+void setThreadsANN(ANN* ann, int threads);
+
+/**
+ * Method to set the Scaler of the inputs of the ANN
+ *
+ * The Scaler is folded into the W and B of the first layer at each training step and
+ * prediction, so the X, the dataset files and the inputs to be predicted are used unscaled
+ * without a scaled copy being made. The W and B of the first layer are the parameters of
+ * the scaled inputs, and the saved and compiled models have the Scaler folded into them,
+ * so they take the unscaled inputs as well.
+ *
+ * @param ann		ANN whose inputs will be scaled
+ * @param scaler	fitted Scaler of the features of the ANN, it isn't copied and must outlive the ANN, NULL to remove the Scaler
+ */
+void setScalerANN(ANN* ann, Scaler* scaler);
+
+/**
+ * Method to get the W and B of the first layer applied to the unscaled inputs
+ *
+ * @param ann	ANN with at least a layer
+ * @param W		pointer to which the W of the first layer will be assigned, with the Scaler folded into it if the ANN has a Scaler
+ * @param B		pointer to which the B of the first layer will be assigned, with the Scaler folded into it if the ANN has a Scaler
+ */
+void inputLayerParametersANN(ANN* ann, Matrix** W, double** B);
+
 /**
  * Method to train the ANN
  *
@@ -59,6 +111,34 @@ void addLayerANN(ANN* ann, int neurons, LayerType layer_type, Activation activat
  */
 void trainANN(ANN* ann, int max_iterations, double threshold);
 
+/**
+ * Method to train the ANN using mini-batches
+ *
+ * The samples are shuffled at the beginning of every epoch and the parameters are updated
+ * once per batch. The matrices of the layers hold a batch instead of the whole data.
+ *
+ * @param ann			ANN to be trained
+ * @param epochs		maximum number of passes over the data
+ * @param batch_size	number of samples in a batch, the last batch of an epoch may be smaller
+ * @param threshold		training will stop if the change in the loss of an epoch is smaller than the threshold
+ */
+void trainANNMiniBatch(ANN* ann, int epochs, int batch_size, double threshold);
+
+/**
+ * Method to train the ANN on a mapped dataset file using mini-batches
+ *
+ * The batches are consecutive rows of the file and their order is shuffled at the beginning
+ * of every epoch, so the file is read in contiguous pieces and it can be larger than the
+ * memory. The X and Y of the ANN are not used.
+ *
+ * @param ann			ANN to be trained, its features and classes must match the features and labels of the file
+ * @param dataset		mapped dataset file
+ * @param epochs		maximum number of passes over the data
+ * @param batch_size	number of samples in a batch, the last batch of the file may be smaller
+ * @param threshold		training will stop if the change in the loss of an epoch is smaller than the threshold
+ */
+void trainANNDataset(ANN* ann, DatasetFile* dataset, int epochs, int batch_size, double threshold);
+
 /**
  * Method to make a prediction
  *
@@ -70,6 +150,16 @@ void trainANN(ANN* ann, int max_iterations, double threshold);
  */
 double** predictANN(ANN* ann, double** X, int samples, int features);
 
+/**
+ * Method to save the parameters of an ANN into a model file
+ *
+ * The file can be loaded by loadFrozenANN() to make predictions.
+ *
+ * @param ann	trained ANN with an output layer
+ * @param path	path of the file to be written, it is replaced if it exists
+ */
+void saveANN(ANN* ann, const char* path);
+
 /**
  * Method to dispose an ANN
  *
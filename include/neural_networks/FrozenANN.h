@@ -0,0 +1,111 @@
+//FrozenANN class of LibBQsC by Berkay
+
+/**
+ * Note : 	A FrozenANN is an inference-only copy of a trained ANN. It keeps only the
+ * 			parameters and the activations of the layers, so it doesn't carry the data,
+ * 			the outputs and the gradients used by the training.
+ *
+ * Note : 	The W and B of all layers are packed into a single aligned buffer. The rows
+ * 			of each W are padded to MATRIX_ALIGNMENT bytes, so every row starts on a
+ * 			cache line. The GEMM epilogue of each layer is selected once when the
+ * 			FrozenANN is compiled.
+ *
+ * Note : 	predictFrozenANN() writes into a buffer of the caller and carves the outputs
+ * 			of the hidden layers from a Workspace of the caller. So, it doesn't allocate
+ * 			once the Workspace is large enough, and a FrozenANN can be used by several
+ * 			threads at once as long as each of them has its own Workspace.
+ *
+ * Note : 	loadFrozenANN() maps a model file written by saveANN() and uses the W and B
+ * 			in the mapping without copying them, so the processes loading the same file
+ * 			share its parameters and the loading doesn't depend on the size of the model.
+ */
+
+#ifndef FROZEN_ANN_H
+#define FROZEN_ANN_H
+
+#include <stddef.h>
+
+#include "ANN.h"
+#include "../core/model_file.h"
+
+/**
+ * FrozenANN struct
+ */
+typedef struct
+{
+	//Input and output dimensions
+	int features;
+	int classes;
+	//Number of layers and the largest number of neurons in a hidden layer
+	int number_of_layers;
+	int max_hidden_neurons;
+	//Single buffer of the packed W and B of the layers, NULL if they are in the mapping of a model file
+	double* parameters;
+	//Views of the W of the layers into the parameters
+	Matrix* W;
+	//B of the layers in the parameters
+	double** B;
+	//GEMM epilogues of the layers, applying their biases and activations
+	GEMMEpilogue* epilogues;
+	//Model file whose mapping has the parameters if the FrozenANN is loaded, NULL otherwise
+	ModelFile* file;
+}
+FrozenANN;
+
+/**
+ * Method to compile a trained ANN into a FrozenANN
+ *
+ * The parameters are copied, so the ANN can be trained further or disposed afterwards
+ * without changing the FrozenANN. The Scaler of the ANN is folded into the first layer,
+ * so the FrozenANN takes the unscaled inputs.
+ *
+ * @param	ann		trained ANN with an output layer
+ * @return			pointer to the compiled FrozenANN
+ */
+FrozenANN* compileANN(ANN* ann);
+
+/**
+ * Method to load a FrozenANN from a model file written by saveANN()
+ *
+ * The file is mapped into the memory, and the parameters are used from the mapping until
+ * the FrozenANN is disposed.
+ *
+ * @param	path				path of the model file
+ * @param	verify_checksum		1 if the checksum of the whole file will be verified, which reads the whole file
+ * @return						pointer to the loaded FrozenANN
+ */
+FrozenANN* loadFrozenANN(const char* path, int verify_checksum);
+
+/**
+ * Method to get the size of the Workspace required to predict the passed number of samples
+ *
+ * A Workspace initialized with this capacity, e.g. initWorkspace(scratchSizeFrozenANN(frozen, samples)),
+ * is not grown by the predictions of at most that many samples.
+ *
+ * @param	frozen		FrozenANN to be used
+ * @param	samples		largest number of samples to be predicted at once
+ * @return				size of the Workspace in bytes
+ */
+size_t scratchSizeFrozenANN(FrozenANN* frozen, int samples);
+
+/**
+ * Method to make a prediction
+ *
+ * The Workspace is reset by the method, so the memory carved from it before the call is released.
+ *
+ * @param	frozen		FrozenANN to be used
+ * @param	X			contiguous row-major data points to be predicted : (samples, features)
+ * @param	samples		number of data points in the X
+ * @param	output		contiguous row-major buffer into which the activated output layer will be written : (samples, classes)
+ * @param	scratch		Workspace from which the outputs of the hidden layers will be carved
+ */
+void predictFrozenANN(FrozenANN* frozen, double* X, int samples, double* output, Workspace* scratch);
+
+/**
+ * Method to dispose a FrozenANN
+ *
+ * @param	frozen	FrozenANN to be disposed
+ */
+void disposeFrozenANN(FrozenANN* frozen);
+
+#endif //FROZEN_ANN_H
@@ -8,6 +8,9 @@
 #ifndef NEURAL_NETWORK_UTILITIES_H
 #define NEURAL_NETWORK_UTILITIES_H
 
+#include "../core/gemm.h"
+#include "../core/matrix.h"
+
 /**
  * LayerType enum
  *
@@ -52,6 +55,60 @@ double activationFunction(double z, Activation activation);
  */
 double activationFunctionDerivative(double z, Activation activation);
 
+/**
+ * Method to multiply a vector by the derivative of the activation function, calculated from the output of the activation
+ *
+ * The derivatives of the activations are functions of their outputs (e.g. sigmoid'(z) = A * (1 - A)), so the backward
+ * propagation uses the A cached by the forward propagation instead of calculating the activation from the Z again.
+ *
+ * @param	dA			vector to be multiplied by the derivative item by item
+ * @param	A			outputs of the activation function
+ * @param	n			size of the vectors
+ * @param	activation	activation function whose derivative will be applied
+ */
+void multiplyActivationDerivative(double* dA, double* A, int n, Activation activation);
+
+/**
+ * LayerEpilogue struct
+ *
+ * Argument of the epilogues of the layers : the bias to be added to the Z and the matrix into which the
+ * activation will be written
+ */
+typedef struct
+{
+	double* B;
+	Matrix* A;
+}
+LayerEpilogue;
+
+/**
+ * Method to select the GEMM epilogue of an activation
+ *
+ * The epilogue adds the B of its LayerEpilogue argument to the pieces of the rows of the C and writes
+ * their activations into the A of the argument, which may be the C itself.
+ *
+ * @param	activation	activation function to be applied by the epilogue
+ * @return				epilogue to be passed to the matrixGEMMEpilogue() with a LayerEpilogue
+ */
+GEMMEpilogue selectLayerEpilogue(Activation activation);
+
+/**
+ * Method for the forward pass of a layer : Z = X x W + B and A = activation_function(Z)
+ *
+ * The multiplication, the addition of the bias and the activation are fused : the bias and the
+ * activation are applied to each tile of the Z by the GEMM right after the tile is calculated.
+ * The loop applying them is selected once per call for the activation, so the activation is not
+ * dispatched per item, and sigmoid and tanh are applied by the vector kernels.
+ *
+ * @param	X			input matrix : (samples, neurons in the previous layer)
+ * @param	W			weight matrix : (neurons in the previous layer, neurons in this layer)
+ * @param	B			intercept vector : (neurons in this layer)
+ * @param	activation	activation function to be applied
+ * @param	Z			matrix into which the weighted sum will be written : (samples, neurons in this layer)
+ * @param	A			matrix into which the activation will be written, may be the Z if the weighted sum isn't required
+ */
+void layerForward(Matrix* X, Matrix* W, double* B, Activation activation, Matrix* Z, Matrix* A);
+
 /**
  * ANNLayer struct
  *
@@ -59,24 +116,24 @@ double activationFunctionDerivative(double z, Activation activation);
  */
 typedef struct
 {
-	//Dimensions of the matrices
+	//Dimensions of the matrices, samples is the number of rows the Z, A and dZ can hold
 	int samples;
 	int neurons_previous;
 	int neurons;
 	//Weight matrix W : (neurons in the previous layer, neurons in this layer)
-	double** W;
-	//Intercept matrix B : (samples, neurons in this layer)
-	double** B;
+	Matrix* W;
+	//Intercept vector B : (neurons in this layer), broadcast over the rows of the Z
+	double* B;
 	//Weighted sum matrix Z : (samples, neurons in this layer)
-	double** Z;
+	Matrix* Z;
 	//Activation matrix A : (samples, neurons in this layer)
-	double** A;
+	Matrix* A;
 	//dL/dZ : (samples, neurons in this layer)
-	double** dZ;
+	Matrix* dZ;
 	//dL/dW : (neurons in the previous layer, neurons in this layer)
-	double** dW;
-	//dL/dB : (samples, neurons in this layer)
-	double** dB;
+	Matrix* dW;
+	//dL/dB : (neurons in this layer)
+	double* dB;
 	//Type and the activation of the layer
 	LayerType layer_type;
 	Activation activation;
@@ -97,6 +154,39 @@ ANNLayer;
  */
 ANNLayer* initANNLayer(int samples, int neurons_previous, int neurons, LayerType layer_type, Activation activation);
 
+/**
+ * Method to resize the matrices of an ANNLayer whose number of rows depends on the samples
+ *
+ * The Z, A and dZ matrices are initialized again with the new number of rows, so their
+ * items are lost.
+ *
+ * @param	ann_layer	ANNLayer to be resized
+ * @param	samples		number of rows to be in the Z, A and dZ matrices
+ */
+void resizeANNLayer(ANNLayer* ann_layer, int samples);
+
+/**
+ * Method to initialize an ANNLayer sharing the W and B of another ANNLayer
+ *
+ * The other matrices and vectors are owned by the new ANNLayer, so it can be used to
+ * calculate the outputs and the gradients of a part of the data in parallel to the
+ * layer it shares the parameters with.
+ *
+ * @param	ann_layer	ANNLayer whose W and B will be shared
+ * @param	samples		number of rows to be in the Z, A and dZ matrices
+ * @return				pointer to the initialized ANNLayer
+ */
+ANNLayer* initSharedANNLayer(ANNLayer* ann_layer, int samples);
+
+/**
+ * Method to dispose an ANNLayer sharing the W and B of another ANNLayer
+ *
+ * The shared W and B are not disposed.
+ *
+ * @param shared_layer	ANNLayer to be disposed
+ */
+void disposeSharedANNLayer(ANNLayer* shared_layer);
+
 /**
  * Method to dispose an ANNLayer
  *
@@ -0,0 +1,95 @@
+//L-BFGS optimizer class of LibBQsC by Berkay
+
+/**
+ * Note : 	Instances of this class should be initialized using the constructor
+ * 			method provided. Initialization of LBFGS instances with braces may
+ * 			lead to undefined behavior or incomplete initialization.
+ *
+ * Note : 	This class utilizes vectors to maintain compatibility with algorithms
+ * 			that expect weights in vector format. Therefore, weight matrices
+ * 			should be flattened into vectors.
+ *
+ * Note : 	L-BFGS doesn't take fixed steps like the other optimizers. It calculates a
+ * 			direction from the latest updates of the w and the gradient, and the caller
+ * 			searches a step along the direction which decreases its loss enough, since
+ * 			only the caller can calculate the loss. So, an iteration is :
+ *
+ * 			directionLBFGS(lbfgs, gradient, direction, n);
+ * 			w = w + step * direction, with the step found by a line search
+ * 			updateLBFGS(lbfgs, gradient_of_the_new_w, n);
+ */
+
+#ifndef LBFGS_OPTIMIZER_H
+#define LBFGS_OPTIMIZER_H
+
+/**
+ * LBFGS structure
+ */
+typedef struct
+{
+	//Weight vector w and its size
+	double* w;
+	int n;
+	//Number of the latest updates to be kept and the number of the ones kept so far
+	int memory;
+	int count;
+	//Index of the newest update, the updates are kept in a ring
+	int newest;
+	//Updates of the w and the gradient as the rows of (memory, n) buffers, and 1 / (y^T s) of each
+	double* s;
+	double* y;
+	double* rho;
+	//Coefficients of the two-loop recursion
+	double* alpha;
+	//w and gradient when the latest direction was calculated
+	double* w_previous;
+	double* gradient_previous;
+}
+LBFGS;
+
+/**
+ * Constructor method of the L-BFGS optimizer class
+ *
+ * The number of the updates kept is lbfgs_memory of the optimization config.
+ *
+ * @param 	w	weight vector
+ * @param 	n 	size of the weight vector
+ * @return		pointer to the initialized LBFGS
+ */
+LBFGS* initLBFGS(double* w, int n);
+
+/**
+ * Method to calculate the direction of the next step
+ *
+ * The direction is -H g, where H is the approximation of the inverse Hessian built from
+ * the kept updates by the two-loop recursion. It is -g before any update is kept. The w
+ * and the gradient are remembered to calculate the update of the step by updateLBFGS().
+ *
+ * @param	lbfgs		the LBFGS
+ * @param	gradient	gradient of the current w
+ * @param	direction	vector into which the direction will be written
+ * @param	n			size of the gradient
+ */
+void directionLBFGS(LBFGS* lbfgs, double* gradient, double* direction, int n);
+
+/**
+ * Method to keep the update of a step taken by the caller
+ *
+ * The update is dropped if it doesn't satisfy the curvature condition y^T s > 0, so the
+ * approximation stays positive definite.
+ *
+ * @param	lbfgs		the LBFGS whose w was moved along the latest direction
+ * @param	gradient	gradient of the moved w
+ * @param	n			size of the gradient
+ */
+void updateLBFGS(LBFGS* lbfgs, double* gradient, int n);
+
+/**
+ * Method to dispose an LBFGS
+ *
+ * @param	lbfgs		LBFGS to be disposed
+ * @param	dispose_w	1 if the w will be disposed
+ */
+void disposeLBFGS(LBFGS* lbfgs, int dispose_w);
+
+#endif //LBFGS_OPTIMIZER_H
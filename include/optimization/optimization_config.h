@@ -5,11 +5,19 @@
 
 /**
  * Optimizer enum
+ *
+ * NEWTON_OPTIMIZER and LBFGS_OPTIMIZER are second-order optimizers which search a step along
+ * their directions with a backtracking line search instead of taking fixed steps. The Newton
+ * optimizer solves the Hessian of the loss with a Cholesky decomposition at each iteration, which
+ * is IRLS for the logistic regression, so it suits moderate numbers of parameters. L-BFGS keeps
+ * the latest lbfgs_memory updates instead of the Hessian, so it suits many parameters.
  */
 typedef enum
 {
 	GRADIENT_DESCENT,
-	ADAM_OPTIMIZER
+	ADAM_OPTIMIZER,
+	NEWTON_OPTIMIZER,
+	LBFGS_OPTIMIZER
 }
 Optimizer;
 
@@ -22,4 +30,14 @@ extern double adam_beta_1;
 extern double adam_beta_2;
 extern double adam_epsilon;
 
+//Newton optimizer parameters, the smallest ridge relative to the mean of the diagonal of the Hessian added when its steps fail
+extern double newton_ridge;
+
+//L-BFGS optimizer parameters
+extern int lbfgs_memory;
+
+//Backtracking line search parameters of the second-order optimizers
+extern double line_search_sufficient_decrease;
+extern int line_search_max_steps;
+
 #endif //OPTIMIZATION_CONFIG_H
@@ -3,6 +3,9 @@
 #ifndef FEATURE_SCALING_H
 #define FEATURE_SCALING_H
 
+#include "../core/matrix.h"
+#include "../statistics/statistics.h"
+
 /**
  * Method for min-max scaling
  *
@@ -59,4 +62,212 @@ double** standardize(double** X_input, double* mean, double* standard_deviation,
  */
 double** inverseStandardize(double** X_scaled, double* mean, double* standard_deviation, int samples, int features);
 
+/**
+ * Methods for contiguous matrices
+ *
+ * These methods work on the Matrix struct and return a new scaled Matrix whose
+ * dimensions are the same as the passed one.
+ */
+
+/**
+ * Method for min-max scaling of a Matrix
+ *
+ * @param	X_input 	X input matrix
+ * @param	min			vector of minimums of columns of X input matrix
+ * @param	range		vector of ranges of columns of X input matrix
+ * @return				scaled X
+ */
+Matrix* minMaxScaleMatrix(Matrix* X_input, double* min, double* range);
+
+/**
+ * Method to revert min-max scaling of a Matrix
+ *
+ * @param	X_scaled 	X scaled matrix
+ * @param	min			vector of minimums of columns of X input matrix
+ * @param	range		vector of ranges of columns of X input matrix
+ * @return				X
+ */
+Matrix* inverseMinMaxScaleMatrix(Matrix* X_scaled, double* min, double* range);
+
+/**
+ * Method for standardization of a Matrix
+ *
+ * @param	X_input 			X input matrix
+ * @param	mean				vector of means of columns of X input matrix
+ * @param	standard_deviation	vector of standard deviations of columns of X input matrix
+ * @return						scaled X
+ */
+Matrix* standardizeMatrix(Matrix* X_input, double* mean, double* standard_deviation);
+
+/**
+ * Method to revert standardization of a Matrix
+ *
+ * @param	X_scaled 			X scaled matrix
+ * @param	mean				vector of means of columns of X input matrix
+ * @param	standard_deviation	vector of standard deviations of columns of X input matrix
+ * @return						X
+ */
+Matrix* inverseStandardizeMatrix(Matrix* X_scaled, double* mean, double* standard_deviation);
+
+/**
+ * Scaler
+ *
+ * Note : 	A Scaler keeps the statistics of the features it is fitted to, so the same scaling
+ * 			can be applied to the training data, the data to be predicted and reverted. Each
+ * 			feature is scaled as x_scaled = (x - offset) / scale, where the offset and the scale
+ * 			are the minimum and the range, the mean and the standard deviation, or the median
+ * 			and the interquartile range of the feature depending on the type of the Scaler.
+ * 			The features whose scale is 0 are only shifted.
+ *
+ * Note : 	A Scaler can be folded into a linear layer instead of being applied to the data :
+ *
+ * 			X_scaled x W + B = X x W_folded + B_folded
+ * 			W_folded = W / scale (each row divided by the scale of its feature)
+ * 			B_folded = B - (offset / scale) x W
+ *
+ * 			So, the ANN and the logistic regression apply a Scaler set on them by folding it into
+ * 			their first layer at each step, which costs a pass over the W rather than over the
+ * 			data, and a scaled copy of the data is never made. The gradients calculated with the
+ * 			unscaled X are converted into the gradients of the W by unfoldScalerGradients().
+ */
+
+/**
+ * ScalerType enum
+ */
+typedef enum
+{
+	MIN_MAX_SCALER,
+	STANDARD_SCALER,
+	ROBUST_SCALER
+}
+ScalerType;
+
+/**
+ * Scaler struct
+ */
+typedef struct
+{
+	//Type of the scaling and the number of features
+	ScalerType type;
+	int features;
+	//Offsets and scales of the features : x_scaled = (x - offset) / scale
+	double* offset;
+	double* scale;
+	//Inverses of the scales, the scaling multiplies by them rather than dividing
+	double* inverse_scale;
+}
+Scaler;
+
+/**
+ * Method to initialize a Scaler that doesn't change the features until it is fitted
+ *
+ * @param	type		type of the scaling
+ * @param	features	number of features
+ * @return				pointer to the initialized Scaler
+ */
+Scaler* initScaler(ScalerType type, int features);
+
+/**
+ * Method to fit a Scaler to the features of a Matrix
+ *
+ * A min-max or standard Scaler reads the X once, and a robust Scaler selects the median and the quartiles
+ * of each column from a scratch copy of it in O(rows).
+ *
+ * @param	scaler	Scaler to be fitted
+ * @param	X		matrix whose columns are the features
+ */
+void fitScaler(Scaler* scaler, Matrix* X);
+
+/**
+ * Method to fit a min-max or standard Scaler to the statistics of the features
+ *
+ * The statistics can be merged from several parts of the data, e.g. the batches of a dataset
+ * file, so the data doesn't have to be in the memory at once.
+ *
+ * @param	scaler		Scaler to be fitted, either min-max or standard
+ * @param	statistics	ColumnStatistics of the features
+ */
+void fitScalerStatistics(Scaler* scaler, ColumnStatistics* statistics);
+
+/**
+ * Method to fit a robust Scaler to the quantile sketches of the features
+ *
+ * The medians and the interquartile ranges are estimated from the sketches, so the features of
+ * a dataset that doesn't fit in the memory can be added to the sketches batch by batch.
+ *
+ * @param	scaler		Scaler to be fitted, a robust one
+ * @param	sketches	QuantileSketches of the features, one for each feature
+ */
+void fitScalerQuantiles(Scaler* scaler, QuantileSketch** sketches);
+
+/**
+ * Method to scale the features of a Matrix in place
+ *
+ * @param	scaler	fitted Scaler
+ * @param	X		matrix to be scaled
+ */
+void transformScaler(Scaler* scaler, Matrix* X);
+
+/**
+ * Method to scale the features of a Matrix into another Matrix
+ *
+ * @param	scaler		fitted Scaler
+ * @param	X			matrix to be scaled, it isn't changed
+ * @param	X_scaled	matrix with the same dimensions into which the scaled features will be written
+ */
+void transformScalerInto(Scaler* scaler, Matrix* X, Matrix* X_scaled);
+
+/**
+ * Method to revert the scaling of the features of a Matrix in place
+ *
+ * @param	scaler		fitted Scaler
+ * @param	X_scaled	matrix whose scaling will be reverted
+ */
+void inverseTransformScaler(Scaler* scaler, Matrix* X_scaled);
+
+/**
+ * Method to fold a Scaler into the parameters of a linear layer
+ *
+ * @param	scaler		fitted Scaler
+ * @param	W			W of the layer : (features, neurons)
+ * @param	B			B of the layer : neurons
+ * @param	W_folded	matrix into which the W divided by the scales will be written : (features, neurons)
+ * @param	B_folded	vector into which the B with the offsets folded into it will be written : neurons
+ */
+void foldScaler(Scaler* scaler, Matrix* W, double* B, Matrix* W_folded, double* B_folded);
+
+/**
+ * Method to convert the gradients of a folded layer into the gradients of its W
+ *
+ * The dW calculated as 1/m * (X^T x dZ) with the unscaled X is converted in place into the dW of
+ * the scaled X : dW = (dW - offset x dB^T) / scale. The dB is the same for both.
+ *
+ * @param	scaler	fitted Scaler folded into the layer
+ * @param	dW		gradient of the W calculated with the unscaled X : (features, neurons)
+ * @param	dB		gradient of the B : neurons
+ */
+void unfoldScalerGradients(Scaler* scaler, Matrix* dW, double* dB);
+
+/**
+ * Method to unfold a Scaler from the parameters of a linear layer
+ *
+ * It is the inverse of foldScaler() : W = W_folded x scale and B = B_folded + offset x W_folded.
+ * Both are linear, so it converts a step of the folded parameters into the step of the W and B
+ * as well.
+ *
+ * @param	scaler		fitted Scaler folded into the parameters
+ * @param	W_folded	folded W of the layer : (features, neurons)
+ * @param	B_folded	folded B of the layer : neurons
+ * @param	W			matrix into which the W will be written, may be the W_folded : (features, neurons)
+ * @param	B			vector into which the B will be written, may be the B_folded : neurons
+ */
+void unfoldScaler(Scaler* scaler, Matrix* W_folded, double* B_folded, Matrix* W, double* B);
+
+/**
+ * Method to dispose a Scaler
+ *
+ * @param	scaler	Scaler to be disposed
+ */
+void disposeScaler(Scaler* scaler);
+
 #endif //FEATURE_SCALING_H
@@ -3,7 +3,12 @@
 #ifndef LOGISTIC_REGRESSION_H
 #define LOGISTIC_REGRESSION_H
 
+#include "../core/matrix.h"
+#include "../core/model_file.h"
+#include "../core/sparse_matrix.h"
+#include "../core/workspace.h"
 #include "../optimization/optimization_config.h"
+#include "../preprocessing/feature_scaling.h"
 
 //Extern the constant variables
 extern int debugTrainingLogisticRegression;
@@ -13,29 +18,44 @@ extern int debugTrainingLogisticRegression;
  */
 typedef struct
 {
-	//X and Y matrices
-	double** X;
-	double** Y;
+	//X and Y matrices copied into contiguous matrices
+	Matrix* X;
+	Matrix* Y;
+	//Copy of the X if it is sparse, the X is NULL then
+	SparseMatrix* X_sparse;
 	//Dimensions of the matrices
 	int samples;
 	int features;
 	int classes;
 	//Weights and their gradients
-	double** W;
-	double** dW;
+	Matrix* W;
+	Matrix* dW;
 	//Bias terms and their gradients
 	double* b;
 	double* db;
-	//Last prediction made to be used to calculate the loss in the training
-	double** P;
+	//Last prediction made to be used to calculate the gradients and the loss in the training, NULL if the model is loaded
+	Matrix* P;
+	//Workspace of the temporaries of the training iterations
+	Workspace* workspace;
+	//Optimizers of the W and b kept between the chunks of the online training, NULL before the first chunk
+	Optimizer online_optimizer;
+	void* optimizer_w;
+	void* optimizer_b;
+	//Scaler of the features folded into the W and b, NULL if the features are used as they are
+	Scaler* scaler;
 	//Log loss of the model
 	double log_loss;
+	//Model file whose mapping has the W and b if the model is loaded, NULL otherwise
+	ModelFile* file;
 }
 LogisticRegression;
 
 /**
  * Method to initialize a LogisticRegression struct
  *
+ * X and Y are copied into the contiguous matrices of the LogisticRegression, so the
+ * passed arrays can be disposed by the user after the initialization.
+ *
  * @param	X			X feature matrix
  * @param 	Y			Y matrix
  * @param	samples		number of samples in the X and Y matrices
@@ -45,16 +65,113 @@ LogisticRegression;
  */
 LogisticRegression* initLogisticRegression(double** X, double** Y, int samples, int features, int classes);
 
+/**
+ * Method to initialize a LogisticRegression struct with a sparse X
+ *
+ * The training and the predictions of the model cost the nonzero items of the X instead of
+ * its size, e.g. for the one-hot encoded or bag-of-words features. The arrays of the X and
+ * the Y are copied, so they can be disposed by the user after the initialization.
+ *
+ * @param	X			X feature matrix : (samples, features)
+ * @param 	Y			Y matrix : (samples, classes)
+ * @param	classes		number of classes in the Y matrix
+ * @return				pointer to the initialized LogisticRegression
+ */
+LogisticRegression* initLogisticRegressionSparse(SparseMatrix* X, double** Y, int classes);
+
+/**
+ * Method to initialize a LogisticRegression struct to be trained online
+ *
+ * The model doesn't keep any rows, it is trained on chunks of rows by partialFitLogisticRegression(),
+ * partialFitLogisticRegressionSparse() or trainLogisticRegressionStream().
+ *
+ * @param	features	number of features
+ * @param	classes		number of classes
+ * @return				pointer to the initialized LogisticRegression
+ */
+LogisticRegression* initLogisticRegressionOnline(int features, int classes);
+
+/**
+ * Method to set the Scaler of the features of a logistic regression
+ *
+ * The Scaler is folded into the W and b at each training iteration and prediction, so the
+ * X and the inputs to be predicted are used unscaled without a scaled copy being made. The
+ * W and b are the parameters of the scaled features, and the saved model has the Scaler
+ * folded into them, so it takes the unscaled features as well.
+ *
+ * @param	regr	logistic regression whose features will be scaled
+ * @param	scaler	fitted Scaler of the features, it isn't copied and must outlive the model, NULL to remove the Scaler
+ */
+void setScalerLogisticRegression(LogisticRegression* regr, Scaler* scaler);
+
 /**
  * Method to train a logistic regression
  *
+ * NEWTON_OPTIMIZER and LBFGS_OPTIMIZER converge in far fewer iterations than the others since
+ * the loss is convex, and they stop when no step along their directions decreases the loss.
+ * The log loss of the model is the one of the final W and b with them.
+ *
  * @param 	regr			logistic regression to be trained
+ * @param	optimizer		optimizer of the W and b
  * @param	max_iterations	maximum number of iterations
  * @param	threshold		training will stop if the change in the loss
  * 							function is smaller than the threshold
  */
 void trainLogisticRegression(LogisticRegression* regr, Optimizer optimizer, int max_iterations, double threshold);
 
+/**
+ * LogisticRegressionReader type
+ *
+ * Method that reads the next rows of a stream into the first rows of the X and the Y, and returns the
+ * number of the rows read, at most the rows of the X. 0 is returned at the end of the stream.
+ */
+typedef int (*LogisticRegressionReader)(Matrix* X, Matrix* Y, void* argument);
+
+/**
+ * Method to train a logistic regression on a chunk of rows
+ *
+ * A step of the optimizer is taken with the gradients of the mean log loss of the chunk, so the cost
+ * of a call only depends on the size of the chunk. The optimizer is kept in the model between the
+ * calls, so any model, including an initialized, trained or loaded one, can be trained further on new
+ * rows. A loaded model is copied out of its file at the first call. Only GRADIENT_DESCENT and
+ * ADAM_OPTIMIZER take steps with chunks.
+ *
+ * @param	regr		logistic regression to be trained
+ * @param	optimizer	optimizer of the W and b
+ * @param	X			features of the rows : (rows, features)
+ * @param	Y			labels of the rows : (rows, classes)
+ * @return				log loss of the rows before the step
+ */
+double partialFitLogisticRegression(LogisticRegression* regr, Optimizer optimizer, Matrix* X, Matrix* Y);
+
+/**
+ * Method to train a logistic regression on a chunk of sparse rows
+ *
+ * @param	regr		logistic regression to be trained
+ * @param	optimizer	optimizer of the W and b
+ * @param	X			features of the rows : (rows, features)
+ * @param	Y			labels of the rows : (rows, classes)
+ * @return				log loss of the rows before the step
+ */
+double partialFitLogisticRegressionSparse(LogisticRegression* regr, Optimizer optimizer, SparseMatrix* X, Matrix* Y);
+
+/**
+ * Method to train a logistic regression on the chunks of rows read from a reader
+ *
+ * The reader reads the chunks into two buffers of chunk_rows rows, which are the only memory used that
+ * depends on the number of rows, and a step is taken with each chunk by partialFitLogisticRegression().
+ * The log loss of the model is set to the mean of the losses of the rows before the steps taken with
+ * them, which estimates the loss on the unseen rows.
+ *
+ * @param	regr		logistic regression to be trained
+ * @param	optimizer	optimizer of the W and b
+ * @param	chunk_rows	maximum number of rows in a chunk
+ * @param	reader		method that reads the next chunk
+ * @param	argument	argument to be passed to the reader
+ * @return				log loss of the model
+ */
+double trainLogisticRegressionStream(LogisticRegression* regr, Optimizer optimizer, int chunk_rows, LogisticRegressionReader reader, void* argument);
+
 /**
  * Method to make a prediction
  *
@@ -66,6 +183,38 @@ void trainLogisticRegression(LogisticRegression* regr, Optimizer optimizer, int
  */
 double** predictLogisticRegression(LogisticRegression* regr, double** X, int samples, int features);
 
+/**
+ * Method to make a prediction for a sparse X
+ *
+ * The model doesn't need to be initialized with a sparse X, any model can predict a sparse X.
+ *
+ * @param regr		trained LogisticRegression
+ * @param X			data points to be predicted : (samples, features)
+ * @return			output of the LogisticRegression : (samples, classes)
+ */
+double** predictLogisticRegressionSparse(LogisticRegression* regr, SparseMatrix* X);
+
+/**
+ * Method to save the parameters of a logistic regression into a model file
+ *
+ * @param	regr	trained LogisticRegression
+ * @param	path	path of the file to be written, it is replaced if it exists
+ */
+void saveLogisticRegression(LogisticRegression* regr, const char* path);
+
+/**
+ * Method to load a logistic regression from a model file written by saveLogisticRegression()
+ *
+ * The file is mapped into the memory and the W and b are used from the mapping without being
+ * copied. The loaded LogisticRegression doesn't have the training data, so it can only make
+ * predictions or be trained further on chunks of new rows by partialFitLogisticRegression().
+ *
+ * @param	path				path of the model file
+ * @param	verify_checksum		1 if the checksum of the whole file will be verified, which reads the whole file
+ * @return						pointer to the loaded LogisticRegression
+ */
+LogisticRegression* loadLogisticRegression(const char* path, int verify_checksum);
+
 /**
  * Method to print a logistic regression
  *
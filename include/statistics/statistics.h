@@ -3,6 +3,18 @@
 #ifndef STATISTICS_H
 #define STATISTICS_H
 
+#include <stdint.h>
+
+#include "../core/matrix.h"
+#include "../core/vector_kernels.h"
+
+/**
+ * Note : 	The sums, the minimums and the maximums of the arrays are calculated by the compensated
+ * 			vector kernels, so the errors of the sums don't grow with the size of the arrays. The
+ * 			arrays of millions of items are split between the processors, and the results of the
+ * 			parts are merged in order. The minimums and the maximums skip the NaNs.
+ */
+
 /**
  * Method to calculate the sum of an array
  *
@@ -21,15 +33,53 @@ double sum(double* array, int n);
  */
 double mean(double* array, int n);
 
+/**
+ * Method to calculate the minimum, maximum, sum and sum of squares of an array in a single pass
+ *
+ * @param	array	array whose moments will be calculated
+ * @param	n		length of the array
+ * @return			moments of the array
+ */
+VectorMoments moments(double* array, int n);
+
 /**
  * Method to get the median of an array
  *
- * @param	array	array whose median will be got
+ * The array doesn't have to be sorted, the median is selected from a copy of it in O(n).
+ *
+ * @param	array	array whose median will be got, it isn't changed
  * @param	n		length of the array
  * @return			median of the array
  */
 double median(double* array, int n);
 
+/**
+ * Method to get a quantile of an array
+ *
+ * The quantile is interpolated between the two nearest items as the median is, e.g. the
+ * quantile 0.25 of a sorted array is between its items at (n - 1) * 0.25. The array doesn't
+ * have to be sorted, the quantile is selected from a copy of it in O(n).
+ *
+ * @param	array		array whose quantile will be got, it isn't changed
+ * @param	n			length of the array
+ * @param	fraction	quantile between 0 and 1, e.g. 0.5 for the median
+ * @return				quantile of the array
+ */
+double quantile(double* array, int n, double fraction);
+
+/**
+ * Method to get a quantile of an array reordering the array instead of copying it
+ *
+ * The items are reordered by the selection, so several quantiles of a scratch copy can be
+ * got without copying it again. The array must not have NaNs.
+ *
+ * @param	array		array whose quantile will be got, its items are reordered
+ * @param	n			length of the array
+ * @param	fraction	quantile between 0 and 1, e.g. 0.5 for the median
+ * @return				quantile of the array
+ */
+double selectQuantile(double* array, int n, double fraction);
+
 /**
  * Method to get the minimum value in an array
  *
@@ -66,4 +116,201 @@ double range(double* array, int n);
  */
 double standardDeviation(double* array, int n);
 
+/**
+ * Methods for the statistics of the columns of a matrix
+ *
+ * Note : 	The statistics of all columns are calculated in a single pass over the rows of a
+ * 			matrix, so each row is read once from the memory regardless of the number of
+ * 			columns. The mean and the sum of squared deviations of each column are updated
+ * 			with Welford's method, which doesn't lose the precision of the columns whose means
+ * 			are large compared to their deviations.
+ *
+ * Note : 	The statistics of two parts of the rows can be merged into the statistics of all
+ * 			of them. So, the rows can be split between several threads or read in batches,
+ * 			e.g. from a dataset file, and the statistics of the parts merged afterwards.
+ */
+
+/**
+ * ColumnStatistics struct
+ */
+typedef struct
+{
+	//Number of columns and the number of rows seen so far
+	int columns;
+	long count;
+	//Minimums, maximums, means and sums of squared deviations from the means of the columns
+	double* min;
+	double* max;
+	double* mean;
+	double* squared_deviations;
+}
+ColumnStatistics;
+
+/**
+ * Method to initialize the ColumnStatistics of no rows
+ *
+ * @param	columns		number of columns
+ * @return				pointer to the initialized ColumnStatistics
+ */
+ColumnStatistics* initColumnStatistics(int columns);
+
+/**
+ * Method to reset the ColumnStatistics to no rows
+ *
+ * @param	statistics	ColumnStatistics to be reset
+ */
+void resetColumnStatistics(ColumnStatistics* statistics);
+
+/**
+ * Method to add the rows of a Matrix to the ColumnStatistics
+ *
+ * @param	statistics	ColumnStatistics to be updated
+ * @param	X			matrix whose rows will be added, it has as many columns as the ColumnStatistics
+ */
+void updateColumnStatistics(ColumnStatistics* statistics, Matrix* X);
+
+/**
+ * Method to merge the ColumnStatistics of other rows into the ColumnStatistics
+ *
+ * @param	statistics	ColumnStatistics into which the other one will be merged
+ * @param	other		ColumnStatistics of the other rows, it isn't changed
+ */
+void mergeColumnStatistics(ColumnStatistics* statistics, ColumnStatistics* other);
+
+/**
+ * Method to calculate the statistics of the columns of a Matrix
+ *
+ * The rows are split into contiguous parts between the threads and the statistics of the parts
+ * are merged in order, so the result only depends on the number of threads.
+ *
+ * @param	X			matrix whose columns' statistics will be calculated
+ * @param	threads		number of threads, e.g. getNumberOfProcessors()
+ * @return				pointer to the initialized ColumnStatistics
+ */
+ColumnStatistics* columnStatistics(Matrix* X, int threads);
+
+/**
+ * Method to get the ranges of the columns
+ *
+ * @param	statistics	ColumnStatistics of the columns
+ * @param	range		vector into which the ranges will be written, e.g. to be passed to minMaxScaleMatrix()
+ */
+void columnRanges(ColumnStatistics* statistics, double* range);
+
+/**
+ * Method to get the standard deviations of the columns
+ *
+ * The standard deviations are the ones of a sample as calculated by standardDeviation().
+ *
+ * @param	statistics			ColumnStatistics of the columns
+ * @param	standard_deviation	vector into which the standard deviations will be written, e.g. to be passed to standardizeMatrix()
+ */
+void columnStandardDeviations(ColumnStatistics* statistics, double* standard_deviation);
+
+/**
+ * Method to dispose a ColumnStatistics
+ *
+ * @param	statistics	ColumnStatistics to be disposed
+ */
+void disposeColumnStatistics(ColumnStatistics* statistics);
+
+/**
+ * Methods for the quantile sketches
+ *
+ * Note : 	A QuantileSketch is a KLL sketch (Karnin, Lang and Liberty) : it keeps a small sample
+ * 			of the items it has seen, from which any quantile can be estimated. The sample is kept
+ * 			in compactors, the items of the compactor h standing for 2^h items each. When a
+ * 			compactor is full, it is sorted and every other item of it is moved into the next
+ * 			compactor, starting from the first or the second item at random. The capacities of
+ * 			the compactors shrink by 2/3 from the top one, which holds k items, down to the first
+ * 			one. So, the memory is O(k) regardless of the number of items.
+ *
+ * Note : 	The rank of an estimated quantile is within about 1.7 / k of the requested one with a high
+ * 			probability, e.g. a k of 200 estimates the quantile 0.25 of 100M items between the
+ * 			quantiles 0.24 and 0.26. The minimum and the maximum are exact.
+ *
+ * Note : 	Two sketches are merged by concatenating their compactors level by level and compacting
+ * 			the ones that are full. So, the items can be split between several threads or read in
+ * 			batches, e.g. from a dataset file, and the sketches of the parts merged afterwards.
+ *
+ * Note : 	The choices between the first and the second items are made by a generator of each
+ * 			sketch rather than by rand(), so a sketch is reproducible and it doesn't change the
+ * 			random numbers used by the models.
+ */
+
+/**
+ * QuantileSketch struct
+ */
+typedef struct
+{
+	//Capacity of the top compactor
+	int k;
+	//Number of compactors, their items, their sizes and the sizes of their buffers
+	int levels;
+	double** compactors;
+	int* sizes;
+	int* allocated;
+	//Number of items kept in the compactors and the number of them at which the sketch is compacted
+	int size;
+	int max_size;
+	//Number of items seen, their minimum and maximum
+	long count;
+	double min;
+	double max;
+	//State of the generator of the choices of the compactions
+	uint64_t random;
+}
+QuantileSketch;
+
+/**
+ * Method to initialize a QuantileSketch of no items
+ *
+ * @param	k	capacity of the top compactor, e.g. 200, the larger it is the more accurate and large the sketch is
+ * @return		pointer to the initialized QuantileSketch
+ */
+QuantileSketch* initQuantileSketch(int k);
+
+/**
+ * Method to add items to a QuantileSketch
+ *
+ * NaNs are skipped, so the empty fields of a loaded CSV file don't change the quantiles.
+ *
+ * @param	sketch	QuantileSketch to be updated
+ * @param	array	items to be added
+ * @param	n		number of the items
+ */
+void updateQuantileSketch(QuantileSketch* sketch, double* array, int n);
+
+/**
+ * Method to add the columns of a Matrix to a QuantileSketch for each column
+ *
+ * @param	sketches	QuantileSketches of the columns
+ * @param	X			matrix whose columns will be added, it has as many columns as the sketches
+ */
+void updateQuantileSketches(QuantileSketch** sketches, Matrix* X);
+
+/**
+ * Method to merge a QuantileSketch of other items into a QuantileSketch
+ *
+ * @param	sketch	QuantileSketch into which the other one will be merged
+ * @param	other	QuantileSketch of the other items, it isn't changed
+ */
+void mergeQuantileSketch(QuantileSketch* sketch, QuantileSketch* other);
+
+/**
+ * Method to estimate a quantile of the items of a QuantileSketch
+ *
+ * @param	sketch		QuantileSketch of at least an item
+ * @param	fraction	quantile between 0 and 1, the quantiles 0 and 1 are the exact minimum and maximum
+ * @return				estimated quantile of the items
+ */
+double sketchQuantile(QuantileSketch* sketch, double fraction);
+
+/**
+ * Method to dispose a QuantileSketch
+ *
+ * @param	sketch	QuantileSketch to be disposed
+ */
+void disposeQuantileSketch(QuantileSketch* sketch);
+
 #endif //STATISTICS_H
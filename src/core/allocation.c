@@ -0,0 +1,53 @@
+//Allocation class of LibBQsC by Berkay
+
+#include "../../include/core/allocation.h"
+
+#include <stdlib.h>
+
+#ifdef LIBBQSC_DEBUG_ALLOCATIONS
+
+#include <stdatomic.h>
+
+//Number of allocations, atomic since the allocations may be done by several threads
+static atomic_long allocation_count = 0;
+
+//Counts an allocation
+#define COUNT_ALLOCATION() atomic_fetch_add(&allocation_count, 1)
+
+#else
+
+#define COUNT_ALLOCATION()
+
+#endif //LIBBQSC_DEBUG_ALLOCATIONS
+
+//Method to allocate memory
+void* allocateMemory(size_t size)
+{
+	COUNT_ALLOCATION();
+	return malloc(size);
+}
+
+//Method to allocate aligned memory
+void* allocateAlignedMemory(size_t alignment, size_t size)
+{
+	COUNT_ALLOCATION();
+	return aligned_alloc(alignment, size);
+}
+
+//Method to get the number of allocations done since the last reset
+long getAllocationCount(void)
+{
+#ifdef LIBBQSC_DEBUG_ALLOCATIONS
+	return atomic_load(&allocation_count);
+#else
+	return 0;
+#endif
+}
+
+//Method to reset the number of allocations to zero
+void resetAllocationCount(void)
+{
+#ifdef LIBBQSC_DEBUG_ALLOCATIONS
+	atomic_store(&allocation_count, 0);
+#endif
+}
@@ -0,0 +1,320 @@
+//GEMM class of LibBQsC by Berkay
+
+#include "../../include/core/gemm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../include/core/allocation.h"
+#include "../../include/core/vector_kernels.h"
+
+//Multiplications smaller than this (m * n * k) skip the packing
+#define GEMM_SMALL_SIZE 32768
+
+/**
+ * Packing buffers of the calling thread. They grow when a larger block is required and
+ * are reused by the following calls.
+ */
+static _Thread_local double* packed_A = NULL;
+static _Thread_local long packed_A_capacity = 0;
+static _Thread_local double* packed_B = NULL;
+static _Thread_local long packed_B_capacity = 0;
+
+//Static method to make sure a packing buffer can hold n doubles
+static double* reserveBuffer(double** buffer, long* capacity, long n)
+{
+	//Grow the buffer if it is not large enough
+	if (*capacity < n)
+	{
+		free(*buffer);
+		*buffer = (double*) allocateAlignedMemory(MATRIX_ALIGNMENT, ((n * sizeof(double)) / MATRIX_ALIGNMENT + 1) * MATRIX_ALIGNMENT);
+		if (*buffer == NULL)
+		{
+			printf("Failed to allocate memory");
+			exit(EXIT_FAILURE);
+		}
+		*capacity = n;
+	}
+	//Return the buffer
+	return *buffer;
+}
+
+/**
+ * The item (i, j) of op(X) is X->data[i * row_step + j * column_step], so the packing
+ * methods and the small path handle the transposed and the non-transposed operands the
+ * same way.
+ */
+
+//Static method to pack an mc x kc block of op(A) into slivers of GEMM_MR rows
+static void packA(double* A, long row_step, long column_step, int mc, int kc, double* buffer)
+{
+	//Iterate over the slivers
+	for (int i = 0; i < mc; i += GEMM_MR)
+	{
+		int mr = (mc - i < GEMM_MR) ? mc - i : GEMM_MR;
+		//Each column of the sliver is stored back to back, rows beyond the edge are zeros
+		for (int p = 0; p < kc; p++)
+		{
+			double* a = A + i * row_step + p * column_step;
+			for (int ii = 0; ii < GEMM_MR; ii++)
+			{
+				*buffer++ = (ii < mr) ? a[ii * row_step] : 0.0;
+			}
+		}
+	}
+}
+
+//Static method to pack a kc x nc panel of op(B) into slivers of GEMM_NR columns
+static void packB(double* B, long row_step, long column_step, int kc, int nc, double* buffer)
+{
+	//Iterate over the slivers
+	for (int j = 0; j < nc; j += GEMM_NR)
+	{
+		int nr = (nc - j < GEMM_NR) ? nc - j : GEMM_NR;
+		//Each row of the sliver is stored back to back, columns beyond the edge are zeros
+		for (int p = 0; p < kc; p++)
+		{
+			double* b = B + p * row_step + j * column_step;
+			for (int jj = 0; jj < GEMM_NR; jj++)
+			{
+				*buffer++ = (jj < nr) ? b[jj * column_step] : 0.0;
+			}
+		}
+	}
+}
+
+/**
+ * The micro-kernel multiplies a packed GEMM_MR x kc sliver of A by a packed kc x GEMM_NR
+ * sliver of B. The GEMM_MR x GEMM_NR accumulator fits in the vector registers and its
+ * rows are updated with independent fused multiply-adds on every step.
+ */
+
+//Static method to compute a GEMM_MR x GEMM_NR tile of C
+static void microKernel(int kc, double* a, double* b, double alpha, double* C, int C_stride, int mr, int nr)
+{
+	//Accumulate the tile
+	double c[GEMM_MR][GEMM_NR] = {{0.0}};
+	for (int p = 0; p < kc; p++)
+	{
+		for (int ii = 0; ii < GEMM_MR; ii++)
+		{
+			double a_item = a[ii];
+			for (int jj = 0; jj < GEMM_NR; jj++)
+			{
+				c[ii][jj] += a_item * b[jj];
+			}
+		}
+		a += GEMM_MR;
+		b += GEMM_NR;
+	}
+	//Add the tile to the items of the C inside the edges
+	for (int ii = 0; ii < mr; ii++)
+	{
+		double* C_row = C + (long) ii * C_stride;
+		for (int jj = 0; jj < nr; jj++)
+		{
+			C_row[jj] += alpha * c[ii][jj];
+		}
+	}
+}
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+
+#include <immintrin.h>
+
+/**
+ * AVX2 version of the micro-kernel. Each row of the GEMM_MR x GEMM_NR tile is kept in two
+ * 256-bit registers, so eight independent fused multiply-add chains hide the latency of
+ * the FMA units. It is selected when getInstructionSet() is AVX2 or wider.
+ */
+#define GEMM_AVX2_KERNEL
+
+//Static method to compute a GEMM_MR x GEMM_NR tile of C with AVX2
+__attribute__((target("avx2,fma")))
+static void microKernelAVX2(int kc, double* a, double* b, double alpha, double* C, int C_stride, int mr, int nr)
+{
+	//Accumulate the tile in the registers
+	__m256d c_00 = _mm256_setzero_pd(), c_01 = _mm256_setzero_pd();
+	__m256d c_10 = _mm256_setzero_pd(), c_11 = _mm256_setzero_pd();
+	__m256d c_20 = _mm256_setzero_pd(), c_21 = _mm256_setzero_pd();
+	__m256d c_30 = _mm256_setzero_pd(), c_31 = _mm256_setzero_pd();
+	for (int p = 0; p < kc; p++)
+	{
+		__m256d b_0 = _mm256_load_pd(b);
+		__m256d b_1 = _mm256_load_pd(b + 4);
+		__m256d a_item = _mm256_broadcast_sd(a);
+		c_00 = _mm256_fmadd_pd(a_item, b_0, c_00);
+		c_01 = _mm256_fmadd_pd(a_item, b_1, c_01);
+		a_item = _mm256_broadcast_sd(a + 1);
+		c_10 = _mm256_fmadd_pd(a_item, b_0, c_10);
+		c_11 = _mm256_fmadd_pd(a_item, b_1, c_11);
+		a_item = _mm256_broadcast_sd(a + 2);
+		c_20 = _mm256_fmadd_pd(a_item, b_0, c_20);
+		c_21 = _mm256_fmadd_pd(a_item, b_1, c_21);
+		a_item = _mm256_broadcast_sd(a + 3);
+		c_30 = _mm256_fmadd_pd(a_item, b_0, c_30);
+		c_31 = _mm256_fmadd_pd(a_item, b_1, c_31);
+		a += GEMM_MR;
+		b += GEMM_NR;
+	}
+	//Store the tile and add it to the items of the C inside the edges
+	double c[GEMM_MR][GEMM_NR];
+	_mm256_storeu_pd(c[0], c_00);
+	_mm256_storeu_pd(c[0] + 4, c_01);
+	_mm256_storeu_pd(c[1], c_10);
+	_mm256_storeu_pd(c[1] + 4, c_11);
+	_mm256_storeu_pd(c[2], c_20);
+	_mm256_storeu_pd(c[2] + 4, c_21);
+	_mm256_storeu_pd(c[3], c_30);
+	_mm256_storeu_pd(c[3] + 4, c_31);
+	for (int ii = 0; ii < mr; ii++)
+	{
+		double* C_row = C + (long) ii * C_stride;
+		for (int jj = 0; jj < nr; jj++)
+		{
+			C_row[jj] += alpha * c[ii][jj];
+		}
+	}
+}
+
+#endif
+
+//Static method for small multiplications without packing, the epilogue is applied to each row once it is final
+static void smallGEMM(double* A, long a_row_step, long a_column_step, double* B, long b_row_step, long b_column_step, double alpha, Matrix* C, int k, GEMMEpilogue epilogue, void* argument)
+{
+	//Iterate over the rows of the C
+	for (int i = 0; i < C->rows; i++)
+	{
+		double* C_row = MATRIX_ROW(C, i);
+		//Add alpha * op(A)[i][p] * op(B)[p] to the row for each p
+		for (int p = 0; p < k; p++)
+		{
+			double a_item = alpha * A[i * a_row_step + p * a_column_step];
+			double* b = B + p * b_row_step;
+			//The rows of op(B) are contiguous if the B is not transposed
+			if (b_column_step == 1)
+			{
+				vectorAxpy(a_item, b, C_row, C->columns);
+				continue;
+			}
+			for (int j = 0; j < C->columns; j++)
+			{
+				C_row[j] += a_item * b[j * b_column_step];
+			}
+		}
+		if (epilogue != NULL)
+		{
+			epilogue(C, i, 0, C->columns, argument);
+		}
+	}
+}
+
+//Method for general matrix multiplication : C = alpha * op(A) x op(B) + beta * C
+void matrixGEMM(int transpose_A, int transpose_B, double alpha, Matrix* A, Matrix* B, double beta, Matrix* C)
+{
+	matrixGEMMEpilogue(transpose_A, transpose_B, alpha, A, B, beta, C, NULL, NULL);
+}
+
+//Method for general matrix multiplication followed by an epilogue : C = epilogue(alpha * op(A) x op(B) + beta * C)
+void matrixGEMMEpilogue(int transpose_A, int transpose_B, double alpha, Matrix* A, Matrix* B, double beta, Matrix* C, GEMMEpilogue epilogue, void* argument)
+{
+	//Dimensions of the op(A) (m, k) and op(B) (k, n)
+	int m = (transpose_A == 1) ? A->columns : A->rows;
+	int k = (transpose_A == 1) ? A->rows : A->columns;
+	int k_B = (transpose_B == 1) ? B->columns : B->rows;
+	int n = (transpose_B == 1) ? B->rows : B->columns;
+	//Check the dimensions
+	if (k != k_B || C->rows != m || C->columns != n)
+	{
+		printf("Invalid dimensions for matrix multiplication");
+		exit(EXIT_FAILURE);
+	}
+	//Scale the C by beta first, it is not read if beta is 0
+	for (int i = 0; i < m; i++)
+	{
+		double* C_row = MATRIX_ROW(C, i);
+		for (int j = 0; j < n; j++)
+		{
+			C_row[j] = (beta == 0.0) ? 0.0 : beta * C_row[j];
+		}
+	}
+	if (alpha == 0.0 || k == 0)
+	{
+		//The C is already final
+		for (int i = 0; i < m && epilogue != NULL; i++)
+		{
+			epilogue(C, i, 0, n, argument);
+		}
+		return;
+	}
+	//Steps to walk over the op(A) and op(B)
+	long a_row_step = (transpose_A == 1) ? 1 : A->stride;
+	long a_column_step = (transpose_A == 1) ? A->stride : 1;
+	long b_row_step = (transpose_B == 1) ? 1 : B->stride;
+	long b_column_step = (transpose_B == 1) ? B->stride : 1;
+	//Use the small path if the packing wouldn't pay off
+	if ((long) m * n * k <= GEMM_SMALL_SIZE)
+	{
+		smallGEMM(A->data, a_row_step, a_column_step, B->data, b_row_step, b_column_step, alpha, C, k, epilogue, argument);
+		return;
+	}
+	//Select the micro-kernel
+	void (*kernel)(int, double*, double*, double, double*, int, int, int) = microKernel;
+#ifdef GEMM_AVX2_KERNEL
+	if (getInstructionSet() >= INSTRUCTION_SET_AVX2)
+	{
+		kernel = microKernelAVX2;
+	}
+#endif
+	//Get the packing buffers
+	double* buffer_A = reserveBuffer(&packed_A, &packed_A_capacity, (long) GEMM_MC * GEMM_KC);
+	double* buffer_B = reserveBuffer(&packed_B, &packed_B_capacity, (long) GEMM_KC * (((n < GEMM_NC ? n : GEMM_NC) + GEMM_NR - 1) / GEMM_NR) * GEMM_NR);
+	//Iterate over the column panels of op(B) and C
+	for (int jc = 0; jc < n; jc += GEMM_NC)
+	{
+		int nc = (n - jc < GEMM_NC) ? n - jc : GEMM_NC;
+		//Iterate over the depth, a kc x nc panel of op(B) is packed for each step
+		for (int pc = 0; pc < k; pc += GEMM_KC)
+		{
+			int kc = (k - pc < GEMM_KC) ? k - pc : GEMM_KC;
+			//The tiles are final after the last block of the depth
+			int last_block = (pc + kc == k);
+			packB(B->data + pc * b_row_step + jc * b_column_step, b_row_step, b_column_step, kc, nc, buffer_B);
+			//Iterate over the row blocks of op(A) and C, an mc x kc block of op(A) is packed for each step
+			for (int ic = 0; ic < m; ic += GEMM_MC)
+			{
+				int mc = (m - ic < GEMM_MC) ? m - ic : GEMM_MC;
+				packA(A->data + ic * a_row_step + pc * a_column_step, a_row_step, a_column_step, mc, kc, buffer_A);
+				//Iterate over the slivers of the packed panel and block to compute the tiles of C
+				for (int jr = 0; jr < nc; jr += GEMM_NR)
+				{
+					int nr = (nc - jr < GEMM_NR) ? nc - jr : GEMM_NR;
+					for (int ir = 0; ir < mc; ir += GEMM_MR)
+					{
+						int mr = (mc - ir < GEMM_MR) ? mc - ir : GEMM_MR;
+						kernel(kc, buffer_A + (long) ir * kc, buffer_B + (long) jr * kc, alpha, &MATRIX_AT(C, ic + ir, jc + jr), C->stride, mr, nr);
+						//Apply the epilogue to the rows of the tile while it is in the cache
+						if (epilogue != NULL && last_block == 1)
+						{
+							for (int ii = 0; ii < mr; ii++)
+							{
+								epilogue(C, ic + ir + ii, jc + jr, nr, argument);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+//Method to dispose the packing buffers of the calling thread
+void disposeGEMMBuffers(void)
+{
+	free(packed_A);
+	packed_A = NULL;
+	packed_A_capacity = 0;
+	free(packed_B);
+	packed_B = NULL;
+	packed_B_capacity = 0;
+}
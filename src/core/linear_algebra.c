@@ -2,10 +2,18 @@
 
 #include "../../include/core/linear_algebra.h"
 
+#include <float.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#include "../../include/core/allocation.h"
+#include "../../include/core/gemm.h"
+#include "../../include/core/matrix.h"
+#include "../../include/core/vector_kernels.h"
+
 /**
  * Vector methods of the linear algebra class
  */
@@ -14,7 +22,7 @@
 double* initVector(int n)
 {
 	//Allocate the memory for the vector
-	double* vector = (double*) malloc (n * sizeof(double));
+	double* vector = (double*) allocateMemory(n * sizeof(double));
 	//Handle any allocation failure
 	if (vector == NULL)
 	{
@@ -33,7 +41,7 @@ double* initVector(int n)
 double* initZeroVector(int n)
 {
 	//Allocate the memory for the vector
-	double* vector = (double*) malloc (n * sizeof(double));
+	double* vector = (double*) allocateMemory(n * sizeof(double));
 	//Handle any allocation failure
 	if (vector == NULL)
 	{
@@ -52,7 +60,7 @@ double* initZeroVector(int n)
 double* initRandomVector(int n)
 {
 	//Allocate the memory for the vector
-	double* vector = (double*) malloc (n * sizeof(double));
+	double* vector = (double*) allocateMemory(n * sizeof(double));
 	//Handle any allocation failure
 	if (vector == NULL)
 	{
@@ -74,28 +82,14 @@ double* initRandomVector(int n)
 double* vectorAppend(double* vector, int n, double number, int index, int dispose)
 {
 	//Allocate the new memory for the vector
-	double* new_vector = (double*) malloc ((n + 1) * sizeof(double));
+	double* new_vector = (double*) allocateMemory((n + 1) * sizeof(double));
 	//Handle any allocation failure
 	if (new_vector == NULL)
 	{
 		exit(EXIT_FAILURE);
 	}
 	//Add the numbers to the new vector
-	for (int i = 0; i < (n + 1); i++)
-	{
-		if (i < index)
-		{
-			new_vector[i] = vector[i];
-		}
-		else if (i == index)
-		{
-			new_vector[i] = number;
-		}
-		else if (i > index)
-		{
-			new_vector[i] = vector[i-1];
-		}
-	}
+	vectorAppendInto(new_vector, vector, n, number, index);
 	//Dispose the old vector
 	if (dispose == 1)
 	{
@@ -109,12 +103,13 @@ double* vectorAppend(double* vector, int n, double number, int index, int dispos
 double* vectorAddition(double* a, double* b, int n)
 {
 	//Initialize the resulting vector
-	double* result = initVector(n);
-	//Do the vector addition into the result vector
-	for (int i = 0; i < n; i++)
+	double* result = (double*) allocateMemory(n * sizeof(double));
+	if (result == NULL)
 	{
-		result[i] = a[i] + b[i];
+		exit(EXIT_FAILURE);
 	}
+	//Do the vector addition into the result vector
+	vectorAdditionInto(result, a, b, n);
 	//Return the result vector
 	return result;
 }
@@ -123,12 +118,13 @@ double* vectorAddition(double* a, double* b, int n)
 double* vectorSubtraction(double* a, double* b, int n)
 {
 	//Initialize the resulting vector
-	double* result = initVector(n);
-	//Do the vector subtraction into the result vector
-	for (int i = 0; i < n; i++)
+	double* result = (double*) allocateMemory(n * sizeof(double));
+	if (result == NULL)
 	{
-		result[i] = a[i] - b[i];
+		exit(EXIT_FAILURE);
 	}
+	//Do the vector subtraction into the result vector
+	vectorSubtractionInto(result, a, b, n);
 	//Return the result vector
 	return result;
 }
@@ -137,12 +133,13 @@ double* vectorSubtraction(double* a, double* b, int n)
 double* vectorScalarMultiplication(double* vector, int n, double scalar)
 {
 	//Initialize the resulting vector
-	double* result = initVector(n);
-	//Do the scalar multiplication into the result vector
-	for (int i = 0; i < n; i++)
+	double* result = (double*) allocateMemory(n * sizeof(double));
+	if (result == NULL)
 	{
-		result[i] = scalar * vector[i];
+		exit(EXIT_FAILURE);
 	}
+	//Do the scalar multiplication into the result vector
+	vectorScalarMultiplicationInto(result, vector, n, scalar);
 	//Return the result vector
 	return result;
 }
@@ -150,14 +147,8 @@ double* vectorScalarMultiplication(double* vector, int n, double scalar)
 //The method dot product
 double vectorDotProduct(double* a, double* b, int n)
 {
-	double result = 0;
-	//Calculate the result
-	for (int i = 0; i < n; i++)
-	{
-		result += a[i] * b[i];
-	}
-	//Return the result
-	return result;
+	//Calculate and return the result
+	return vectorDot(a, b, n);
 }
 
 //Method to print a vector
@@ -181,7 +172,7 @@ void printVector(double* a, int n, int decimal_places)
 double** initMatrix(int rows, int columns)
 {
 	//Initialize the double** array
-	double** array = (double**) malloc (rows * sizeof(double*));
+	double** array = (double**) allocateMemory(rows * sizeof(double*));
 	//Handle the allocation failure for the array
 	if (array == NULL)
 	{
@@ -191,7 +182,7 @@ double** initMatrix(int rows, int columns)
 	//Define the columns of the array
 	for (int i = 0; i < rows; i++)
 	{
-		array[i] = (double*) malloc (columns * sizeof(double));
+		array[i] = (double*) allocateMemory(columns * sizeof(double));
 		//Handle the allocation failure for the current row of the array
 		if (array[i] == NULL)
 		{
@@ -207,7 +198,7 @@ double** initMatrix(int rows, int columns)
 double** initZeroMatrix(int rows, int columns)
 {
 	//Initialize the double** array
-	double** array = (double**) malloc (rows * sizeof(double*));
+	double** array = (double**) allocateMemory(rows * sizeof(double*));
 	//Handle the allocation failure for the array
 	if (array == NULL)
 	{
@@ -217,7 +208,7 @@ double** initZeroMatrix(int rows, int columns)
 	//Define the columns of the array
 	for (int i = 0; i < rows; i++)
 	{
-		array[i] = (double*) malloc (columns * sizeof(double));
+		array[i] = (double*) allocateMemory(columns * sizeof(double));
 		//Handle the allocation failure for the current row of the array
 		if (array[i] == NULL)
 		{
@@ -238,7 +229,7 @@ double** initZeroMatrix(int rows, int columns)
 double** initRandomMatrix(int rows, int columns)
 {
 	//Initialize the double** array
-	double** array = (double**) malloc (rows * sizeof(double*));
+	double** array = (double**) allocateMemory(rows * sizeof(double*));
 	//Handle the allocation failure for the array
 	if (array == NULL)
 	{
@@ -250,7 +241,7 @@ double** initRandomMatrix(int rows, int columns)
 	//Define the columns of the array
 	for (int i = 0; i < rows; i++)
 	{
-		array[i] = (double*) malloc (columns * sizeof(double));
+		array[i] = (double*) allocateMemory(columns * sizeof(double));
 		//Handle the allocation failure for the current row of the array
 		if (array[i] == NULL)
 		{
@@ -271,13 +262,9 @@ double** initRandomMatrix(int rows, int columns)
 //Method to get a row from a matrix; returns the clone of the row
 double* matrixGetRow(double** A, int rows, int columns, int index)
 {
-	//Initialize the empty vector
+	//Initialize the empty vector and copy the items into it
 	double* row = initVector(columns);
-	//Copy the items into the vector
-	for (int i = 0; i < columns; i++)
-	{
-		row[i] = A[index][i];
-	}
+	matrixGetRowInto(row, A, rows, columns, index);
 	//Return the vector
 	return row;
 }
@@ -285,13 +272,9 @@ double* matrixGetRow(double** A, int rows, int columns, int index)
 //Method to get a column from a matrix; returns the clone of the column
 double* matrixGetColumn(double** A, int rows, int columns, int index)
 {
-	//Initialize the empty vector
+	//Initialize the empty vector and copy the items into it
 	double* column = initVector(rows);
-	//Copy the items into the vector
-	for (int i = 0; i < rows; i++)
-	{
-		column[i] = A[i][index];
-	}
+	matrixGetColumnInto(column, A, rows, columns, index);
 	//Return the vector
 	return column;
 }
@@ -299,16 +282,9 @@ double* matrixGetColumn(double** A, int rows, int columns, int index)
 //The method for matrix addition
 double** matrixAddition(double** A, double** B, int rows, int columns)
 {
-	//Generate the empty result matrix
+	//Generate the empty result matrix and fill it accordingly
 	double** result_matrix = initMatrix(rows, columns);
-	//Fill the result matrix accordingly
-	for (int i = 0; i < rows; i++)
-	{
-		for (int j = 0; j < columns; j++)
-		{
-			result_matrix[i][j] = A[i][j] + B[i][j];
-		}
-	}
+	matrixAdditionInto(result_matrix, A, B, rows, columns);
 	//Return the result matrix
 	return result_matrix;
 }
@@ -316,16 +292,9 @@ double** matrixAddition(double** A, double** B, int rows, int columns)
 //The method for matrix subtraction
 double** matrixSubtraction(double** A, double** B, int rows, int columns)
 {
-	//Generate the empty result matrix
+	//Generate the empty result matrix and fill it accordingly
 	double** result_matrix = initMatrix(rows, columns);
-	//Fill the result matrix accordingly
-	for (int i = 0; i < rows; i++)
-	{
-		for (int j = 0; j < columns; j++)
-		{
-			result_matrix[i][j] = A[i][j] - B[i][j];
-		}
-	}
+	matrixSubtractionInto(result_matrix, A, B, rows, columns);
 	//Return the result matrix
 	return result_matrix;
 }
@@ -333,43 +302,36 @@ double** matrixSubtraction(double** A, double** B, int rows, int columns)
 //The method for matrix scalar multiplication
 double** matrixScalarMultiplication(double** A, int rows, int columns, double scalar)
 {
-	//Generate the empty result matrix
+	//Generate the empty result matrix and fill it accordingly
 	double** result_matrix = initMatrix(rows, columns);
-	//Fill the result matrix accordingly
-	for (int i = 0; i < rows; i++)
-	{
-		for (int j = 0; j < columns; j++)
-		{
-			result_matrix[i][j] = A[i][j] * scalar;
-		}
-	}
+	matrixScalarMultiplicationInto(result_matrix, A, rows, columns, scalar);
 	//Return the result matrix
 	return result_matrix;
 }
 
+/**
+ * matrixMultiplication() copies the double** arrays into contiguous matrices and uses the
+ * blocked matrixGEMM(). Copying is O(n^2) while the multiplication is O(n^3), so the copies
+ * are negligible except for the smallest matrices.
+ */
+
 //The method for matrix multiplication
 double** matrixMultiplication(double** A, int rows_A, int columns_A, double** B, int rows_B, int columns_B)
 {
 	//If the matrices have the required dimensions
 	if (columns_A == rows_B)
 	{
-		//Get the empty result matrix
-		double** result_matrix = initMatrix(rows_A, columns_B);
-		//Iterate on the rows of A
-		for (int a_row_no = 0; a_row_no < rows_A; a_row_no++)
-		{
-			//Iterate on the columns of B
-			for (int b_column_no = 0; b_column_no < columns_B; b_column_no++)
-			{
-				double new_item = 0;
-				//Iterate on the items
-				for (int index = 0; index < columns_A; index++)
-				{
-					new_item += A[a_row_no][index] * B[index][b_column_no];
-				}
-				result_matrix[a_row_no][b_column_no] = new_item;
-			}
-		}
+		//Copy the matrices into contiguous matrices
+		Matrix* A_matrix = matrixFromArray(A, rows_A, columns_A);
+		Matrix* B_matrix = matrixFromArray(B, rows_B, columns_B);
+		Matrix* C_matrix = createMatrix(rows_A, columns_B);
+		//Do the multiplication
+		matrixGEMM(0, 0, 1.0, A_matrix, B_matrix, 0.0, C_matrix);
+		//Get the result matrix and dispose the contiguous matrices
+		double** result_matrix = matrixToArray(C_matrix);
+		disposeMatrix(A_matrix);
+		disposeMatrix(B_matrix);
+		disposeMatrix(C_matrix);
 		//Return the result matrix
 		return result_matrix;
 	}
@@ -383,16 +345,9 @@ double** matrixMultiplication(double** A, int rows_A, int columns_A, double** B,
 //The method for transpose
 double** matrixTranspose(double** A, int rows, int columns)
 {
-	//Get the empty result matrix
+	//Get the empty result matrix and fill it accordingly
 	double** result_matrix = initMatrix(columns, rows);
-	//Fill the result matrix accordingly
-	for (int i = 0; i < columns; i++)
-	{
-		for (int j = 0; j < rows; j++)
-		{
-			result_matrix[i][j] = A[j][i];
-		}
-	}
+	matrixTransposeInto(result_matrix, A, rows, columns);
 	//Return the result matrix
 	return result_matrix;
 }
@@ -403,39 +358,9 @@ double** matrixSubmatrix(double** A, int rows, int columns, int i, int j)
 	//If the matrix is big enough
 	if (rows > 1 && columns > 1)
 	{
-		//Get the empty result matrix
+		//Get the empty result matrix and fill it with the items of the passed matrix
 		double** result_matrix = initMatrix(rows-1, columns-1);
-		//Iterate on the rows of the result matrix
-		for (int row_no = 0; row_no < rows-1; row_no++)
-		{
-			//Iterate on the columns of the result matrix
-			for (int column_no = 0; column_no < columns-1; column_no++)
-			{
-				//Indices of the items to be taken from the passed matrix
-				int row_index_in_original_matrix = row_no;
-				int column_index_in_original_matrix = column_no;
-				//Drop the ith row
-				if (row_no < i)
-				{
-					row_index_in_original_matrix = row_no;
-				}
-				else
-				{
-					row_index_in_original_matrix = row_no + 1;
-				}
-				//Drop the jth column
-				if (column_no < j)
-				{
-					column_index_in_original_matrix = column_no;
-				}
-				else
-				{
-					column_index_in_original_matrix = column_no + 1;
-				}
-				//Add the correct item to the result matrix
-				result_matrix[row_no][column_no] = A[row_index_in_original_matrix][column_index_in_original_matrix];
-			}
-		}
+		matrixSubmatrixInto(result_matrix, A, rows, columns, i, j);
 		//Return the result matrix
 		return result_matrix;
 	}
@@ -485,8 +410,17 @@ double matrixDeterminantLaplaceExpansion(double** A, int rows, int columns)
 //The method for determinant
 double matrixDeterminant(double** A, int rows, int columns)
 {
-	//There is single method to find a determinant for now, new one will be added
-	return matrixDeterminantLaplaceExpansion(A, rows, columns);
+	//Use the Laplace expansion for the small matrices
+	if (rows <= LU_DECOMPOSITION_THRESHOLD)
+	{
+		return matrixDeterminantLaplaceExpansion(A, rows, columns);
+	}
+	//Use the LU decomposition otherwise
+	LUDecomposition* lu = initLUDecomposition(A, rows, columns);
+	double determinant = luDeterminant(lu);
+	disposeLUDecomposition(lu);
+	//Return the determinant
+	return determinant;
 }
 
 //The method for a minor of a matrix
@@ -532,20 +466,9 @@ double** matrixAdjoint(double** A, int rows, int columns)
 	//If the matrix is square
 	if (rows == columns)
 	{
-		//Get the cofactor matrix
-		double** cofactor_matrix = initMatrix(rows, columns);
-		//Fill the cofactor matrix with the cofactors
-		for (int i = 0; i < rows; i++)
-		{
-			for (int j = 0; j < columns; j++)
-			{
-				cofactor_matrix[i][j] = matrixCofactor(A, rows, columns, i, j);
-			}
-		}
-		//Get the adjoint matrix
-		double** adj_matrix = matrixTranspose(cofactor_matrix, rows, columns);
-		//Dispose the cofactor matrix
-		matrixDispose(cofactor_matrix, rows);
+		//Get the empty adjoint matrix and fill it with the transposed cofactors
+		double** adj_matrix = initMatrix(rows, columns);
+		matrixAdjointInto(adj_matrix, A, rows, columns);
 		//Return the adjoint matrix
 		return adj_matrix;
 	}
@@ -582,8 +505,71 @@ double** matrixInverseByAdjoint(double** A, int rows, int columns)
 //The method for the inverse of a matrix
 double** matrixInverse(double** A, int rows, int columns)
 {
-	//There is single method to find an inverse for now, new one will be added
-	return matrixInverseByAdjoint(A, rows, columns);
+	//Use the adjoint matrix for the small matrices
+	if (rows <= LU_DECOMPOSITION_THRESHOLD)
+	{
+		return matrixInverseByAdjoint(A, rows, columns);
+	}
+	//Use the LU decomposition otherwise
+	LUDecomposition* lu = initLUDecomposition(A, rows, columns);
+	double** inverse = luInverse(lu);
+	disposeLUDecomposition(lu);
+	//Return the inverse
+	return inverse;
+}
+
+/**
+ * The left inverse (X^T X)^-1 X^T is the least squares solution of XB = I, so it is calculated
+ * by solving (X^T X) B = X^T with the Cholesky decomposition of the Gram matrix. The right
+ * inverse of A is the transpose of the left inverse of A^T.
+ */
+
+//Static method to calculate the transpose of a Matrix into a new Matrix
+static Matrix* transposeStruct(Matrix* A)
+{
+	Matrix* result_matrix = createMatrix(A->columns, A->rows);
+	for (int i = 0; i < A->rows; i++)
+	{
+		double* row = MATRIX_ROW(A, i);
+		for (int j = 0; j < A->columns; j++)
+		{
+			MATRIX_AT(result_matrix, j, i) = row[j];
+		}
+	}
+	return result_matrix;
+}
+
+//Static method to solve (X^T X) B = R in place of the R, returns 0 if X^T X is not positive definite
+static int solveGramSystem(Matrix* X, Matrix* R)
+{
+	//Calculate the Gram matrix and decompose it
+	Matrix* G = createMatrix(X->columns, X->columns);
+	matrixGEMM(1, 0, 1.0, X, X, 0.0, G);
+	int positive_definite = matrixCholeskyDecomposition(G);
+	//Solve the system if the decomposition is successful
+	if (positive_definite == 1)
+	{
+		matrixCholeskySolve(G, R);
+	}
+	disposeMatrix(G);
+	return positive_definite;
+}
+
+//Static method for the left inverse using the Householder QR decomposition, defined with the least squares methods
+static Matrix* leftInverseQR(Matrix* X);
+
+//Static method to calculate the left inverse of a Matrix with more rows than columns
+static Matrix* leftInverseStruct(Matrix* X)
+{
+	//Solve (X^T X) B = X^T
+	Matrix* B = transposeStruct(X);
+	if (solveGramSystem(X, B) == 1)
+	{
+		return B;
+	}
+	disposeMatrix(B);
+	//Use the QR decomposition otherwise, which calculates the (n, m) B without an (m, m) matrix
+	return leftInverseQR(X);
 }
 
 //The method for the right inverse of a matrix
@@ -592,15 +578,17 @@ double** matrixRightInverse(double** A, int rows, int columns)
 	//If the matrix is valid
 	if (rows < columns)
 	{
-		double** Xt = matrixTranspose(A, rows, columns);
-		double** XXt = matrixMultiplication(A, rows, columns, Xt, columns, rows);
-		double** XXti = matrixInverse(XXt, rows, rows);
-		//Result matrix : Xt x XXti
-		double** result_matrix = matrixMultiplication(Xt, columns, rows, XXti, rows, rows);
+		//Right inverse of the A is the transpose of the left inverse of the A^T
+		Matrix* A_matrix = matrixFromArray(A, rows, columns);
+		Matrix* At = transposeStruct(A_matrix);
+		Matrix* At_left_inverse = leftInverseStruct(At);
+		Matrix* right_inverse = transposeStruct(At_left_inverse);
+		double** result_matrix = matrixToArray(right_inverse);
 		//Dispose the matrices
-		matrixDispose(Xt, columns);
-		matrixDispose(XXt, rows);
-		matrixDispose(XXti, rows);
+		disposeMatrix(A_matrix);
+		disposeMatrix(At);
+		disposeMatrix(At_left_inverse);
+		disposeMatrix(right_inverse);
 		//Return the result matrix
 		return result_matrix;
 	}
@@ -617,16 +605,12 @@ double** matrixLeftInverse(double** A, int rows, int columns)
 	//If the matrix is valid
 	if (rows > columns)
 	{
-		//Xt matrix, XtX matrix, and XtXi matrix
-		double** Xt = matrixTranspose(A, rows, columns);
-		double** XtX = matrixMultiplication(Xt, columns, rows, A, rows, columns);
-		double** XtXi = matrixInverse(XtX, columns, columns);
-		//Result matrix : XtXi x Xt
-		double** result_matrix = matrixMultiplication(XtXi, columns, columns, Xt, columns, rows);
+		Matrix* A_matrix = matrixFromArray(A, rows, columns);
+		Matrix* left_inverse = leftInverseStruct(A_matrix);
+		double** result_matrix = matrixToArray(left_inverse);
 		//Dispose the matrices
-		matrixDispose(Xt, columns);
-		matrixDispose(XtX, columns);
-		matrixDispose(XtXi, columns);
+		disposeMatrix(A_matrix);
+		disposeMatrix(left_inverse);
 		//Return the result matrix
 		return result_matrix;
 	}
@@ -637,6 +621,490 @@ double** matrixLeftInverse(double** A, int rows, int columns)
 	}
 }
 
+/**
+ * LU decomposition methods of the linear algebra class
+ *
+ * The decomposition is done in place on a contiguous copy of the matrix using Gaussian
+ * elimination with partial pivoting, which is O(n^3). Rows are swapped physically, so
+ * each elimination step updates the contiguous rows below the pivot with vectorAxpy().
+ */
+
+//Method to compute the LU decomposition of a matrix with partial pivoting
+LUDecomposition* initLUDecomposition(double** A, int rows, int columns)
+{
+	//Decompose a contiguous copy of the matrix
+	Matrix* A_matrix = matrixFromArray(A, rows, columns);
+	LUDecomposition* lu = initLUDecompositionStruct(A_matrix);
+	disposeMatrix(A_matrix);
+	//Return the decomposition
+	return lu;
+}
+
+//Method to compute the LU decomposition of a Matrix with partial pivoting
+LUDecomposition* initLUDecompositionStruct(Matrix* A)
+{
+	//If the matrix is square
+	if (A->rows == A->columns)
+	{
+		//Initialize the LUDecomposition and handle any allocation failure
+		LUDecomposition* lu = allocateMemory(sizeof(LUDecomposition));
+		int* pivots = (int*) allocateMemory(A->rows * sizeof(int));
+		if (lu == NULL || pivots == NULL)
+		{
+			printf("Failed to allocate memory");
+			exit(EXIT_FAILURE);
+		}
+		int n = A->rows;
+		lu->LU = cloneMatrix(A);
+		lu->pivots = pivots;
+		lu->n = n;
+		lu->sign = 1;
+		lu->singular = 0;
+		//Rows are not permuted initially
+		for (int i = 0; i < n; i++)
+		{
+			pivots[i] = i;
+		}
+		//Eliminate the columns one by one
+		for (int k = 0; k < n; k++)
+		{
+			//Find the row with the largest item in the current column
+			int pivot_row = k;
+			double pivot_magnitude = fabs(MATRIX_AT(lu->LU, k, k));
+			for (int i = k + 1; i < n; i++)
+			{
+				if (fabs(MATRIX_AT(lu->LU, i, k)) > pivot_magnitude)
+				{
+					pivot_row = i;
+					pivot_magnitude = fabs(MATRIX_AT(lu->LU, i, k));
+				}
+			}
+			//The column is already eliminated if the pivot is zero
+			if (pivot_magnitude == 0.0)
+			{
+				lu->singular = 1;
+				continue;
+			}
+			//Swap the current row with the pivot row
+			if (pivot_row != k)
+			{
+				double* row_k = MATRIX_ROW(lu->LU, k);
+				double* row_pivot = MATRIX_ROW(lu->LU, pivot_row);
+				for (int j = 0; j < n; j++)
+				{
+					double temporary = row_k[j];
+					row_k[j] = row_pivot[j];
+					row_pivot[j] = temporary;
+				}
+				int temporary_pivot = pivots[k];
+				pivots[k] = pivots[pivot_row];
+				pivots[pivot_row] = temporary_pivot;
+				lu->sign = -lu->sign;
+			}
+			//Eliminate the items below the pivot and store the multipliers in their places
+			double* row_k = MATRIX_ROW(lu->LU, k);
+			for (int i = k + 1; i < n; i++)
+			{
+				double* row_i = MATRIX_ROW(lu->LU, i);
+				double multiplier = row_i[k] / row_k[k];
+				row_i[k] = multiplier;
+				vectorAxpy(-multiplier, row_k + k + 1, row_i + k + 1, n - k - 1);
+			}
+		}
+		//Return the decomposition
+		return lu;
+	}
+	else
+	{
+		printf("LU decomposition of a non-square Matrix cannot be calculated");
+		exit(EXIT_FAILURE);
+	}
+}
+
+//Method for calculating a determinant using an LU decomposition
+double luDeterminant(LUDecomposition* lu)
+{
+	//Determinant of a singular matrix is zero
+	if (lu->singular == 1)
+	{
+		return 0.0;
+	}
+	//Determinant is the sign of the permutation times the product of the diagonal of the U
+	double determinant = lu->sign;
+	for (int i = 0; i < lu->n; i++)
+	{
+		determinant *= MATRIX_AT(lu->LU, i, i);
+	}
+	//Return the determinant
+	return determinant;
+}
+
+//Method to solve Ax = b using the LU decomposition of A
+double* luSolve(LUDecomposition* lu, double* b)
+{
+	//Initialize the solution and solve into it
+	double* x = initVector(lu->n);
+	luSolveInto(lu, b, x);
+	//Return the solution
+	return x;
+}
+
+//Method to solve Ax = b into an existing vector using the LU decomposition of A
+void luSolveInto(LUDecomposition* lu, double* b, double* x)
+{
+	int n = lu->n;
+	//Permute the b into the x, a copy is required if they are the same vector
+	if (x == b)
+	{
+		double* b_copy = initVector(n);
+		memcpy(b_copy, b, n * sizeof(double));
+		for (int i = 0; i < n; i++)
+		{
+			x[i] = b_copy[lu->pivots[i]];
+		}
+		free(b_copy);
+	}
+	else
+	{
+		for (int i = 0; i < n; i++)
+		{
+			x[i] = b[lu->pivots[i]];
+		}
+	}
+	//Forward substitution : Ly = Pb, the diagonal of the L is ones
+	for (int i = 1; i < n; i++)
+	{
+		x[i] -= vectorDot(MATRIX_ROW(lu->LU, i), x, i);
+	}
+	//Backward substitution : Ux = y
+	for (int i = n - 1; i >= 0; i--)
+	{
+		double* row_i = MATRIX_ROW(lu->LU, i);
+		x[i] = (x[i] - vectorDot(row_i + i + 1, x + i + 1, n - i - 1)) / row_i[i];
+	}
+}
+
+//Method for calculating the inverse of a matrix using its LU decomposition
+double** luInverse(LUDecomposition* lu)
+{
+	//Initialize the inverse and calculate into it
+	double** inverse = initMatrix(lu->n, lu->n);
+	luInverseInto(lu, inverse);
+	//Return the inverse
+	return inverse;
+}
+
+//Method for calculating the inverse of a matrix into an existing matrix using its LU decomposition
+void luInverseInto(LUDecomposition* lu, double** inverse)
+{
+	int n = lu->n;
+	//Initialize the column to be solved and its solution once, solving a column in place would copy it at each call
+	double* column = initVector(n);
+	double* solution = initVector(n);
+	//The jth column of the inverse is the solution of Ax = e_j
+	for (int j = 0; j < n; j++)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			column[i] = (i == j) ? 1.0 : 0.0;
+		}
+		luSolveInto(lu, column, solution);
+		for (int i = 0; i < n; i++)
+		{
+			inverse[i][j] = solution[i];
+		}
+	}
+	//Dispose the column and the solution
+	free(column);
+	free(solution);
+}
+
+//Method to dispose an LUDecomposition
+void disposeLUDecomposition(LUDecomposition* lu)
+{
+	disposeMatrix(lu->LU);
+	lu->LU = NULL;
+	free(lu->pivots);
+	lu->pivots = NULL;
+	free(lu);
+	lu = NULL;
+}
+
+/**
+ * Least squares methods of the linear algebra class
+ *
+ * Both decompositions work on the rows of the contiguous matrices : the dot products of the
+ * Cholesky decomposition are over the prefixes of two rows, and the substitutions and the
+ * Householder reflections update whole rows of the right hand sides with vectorAxpy().
+ */
+
+//Method for the Cholesky decomposition of a symmetric positive definite Matrix in place
+int matrixCholeskyDecomposition(Matrix* A)
+{
+	int n = A->rows;
+	//Calculate the columns of the L one by one
+	for (int j = 0; j < n; j++)
+	{
+		double* row_j = MATRIX_ROW(A, j);
+		//L[j][j] = sqrt(A[j][j] - sum(L[j][k]^2)), A is not numerically positive definite if it is not positive
+		double diagonal = row_j[j] - vectorDot(row_j, row_j, j);
+		if (!(diagonal > n * DBL_EPSILON * fabs(row_j[j])))
+		{
+			return 0;
+		}
+		row_j[j] = sqrt(diagonal);
+		//L[i][j] = (A[i][j] - sum(L[i][k] * L[j][k])) / L[j][j]
+		for (int i = j + 1; i < n; i++)
+		{
+			double* row_i = MATRIX_ROW(A, i);
+			row_i[j] = (row_i[j] - vectorDot(row_i, row_j, j)) / row_j[j];
+		}
+	}
+	return 1;
+}
+
+//Method to solve (L L^T) Z = B in place using a Cholesky decomposition
+void matrixCholeskySolve(Matrix* L, Matrix* B)
+{
+	int n = L->rows;
+	int k = B->columns;
+	//Forward substitution : L Y = B
+	for (int i = 0; i < n; i++)
+	{
+		double* B_i = MATRIX_ROW(B, i);
+		for (int j = 0; j < i; j++)
+		{
+			vectorAxpy(-MATRIX_AT(L, i, j), MATRIX_ROW(B, j), B_i, k);
+		}
+		vectorScal(1.0 / MATRIX_AT(L, i, i), B_i, k);
+	}
+	//Backward substitution : L^T Z = Y
+	for (int i = n - 1; i >= 0; i--)
+	{
+		double* B_i = MATRIX_ROW(B, i);
+		for (int j = i + 1; j < n; j++)
+		{
+			vectorAxpy(-MATRIX_AT(L, j, i), MATRIX_ROW(B, j), B_i, k);
+		}
+		vectorScal(1.0 / MATRIX_AT(L, i, i), B_i, k);
+	}
+}
+
+//Static method to apply the reflection I - beta * v v^T to the rows from k of the columns from column of M
+static void applyHouseholder(Matrix* M, double* v, double beta, int k, int column, double* w)
+{
+	int n = M->columns - column;
+	if (n <= 0)
+	{
+		return;
+	}
+	//w = v^T M
+	for (int j = 0; j < n; j++)
+	{
+		w[j] = 0.0;
+	}
+	for (int i = k; i < M->rows; i++)
+	{
+		vectorAxpy(v[i], MATRIX_ROW(M, i) + column, w, n);
+	}
+	//M = M - beta * v w
+	for (int i = k; i < M->rows; i++)
+	{
+		vectorAxpy(-beta * v[i], w, MATRIX_ROW(M, i) + column, n);
+	}
+}
+
+/**
+ * The Householder QR decomposition is kept in the compact form : R is on and above the diagonal, and the
+ * reflection v_k of the kth column is below the diagonal of the kth column, scaled so that v_k[k] = 1,
+ * which doesn't need to be stored. So, the decomposition takes the memory of the X and the Q is never
+ * formed as an m x m matrix : Q^T Y applies the reflections to the Y, and the first n columns of the Q
+ * apply them in the reverse order to the first n columns of the identity.
+ */
+
+//Static method for the Householder QR decomposition of a Matrix in place, the betas of the reflections are written into the betas, exits if the matrix is rank deficient
+static void householderQR(Matrix* R, double* betas)
+{
+	int m = R->rows;
+	int n = R->columns;
+	double* v = initVector(m);
+	double* w = initVector(n);
+	//Eliminate the columns one by one
+	for (int k = 0; k < n; k++)
+	{
+		//Norm of the column below the diagonal
+		double norm = 0.0;
+		for (int i = k; i < m; i++)
+		{
+			norm += MATRIX_AT(R, i, k) * MATRIX_AT(R, i, k);
+		}
+		norm = sqrt(norm);
+		if (norm == 0.0)
+		{
+			betas[k] = 0.0;
+			continue;
+		}
+		//v = x - alpha * e_1 where alpha has the opposite sign of x[0] to avoid cancellation
+		double alpha = (MATRIX_AT(R, k, k) > 0) ? -norm : norm;
+		double v_norm_square = 0.0;
+		for (int i = k; i < m; i++)
+		{
+			v[i] = MATRIX_AT(R, i, k);
+		}
+		v[k] -= alpha;
+		for (int i = k; i < m; i++)
+		{
+			v_norm_square += v[i] * v[i];
+		}
+		//Apply the reflection to the remaining columns of the R
+		double beta = 2.0 / v_norm_square;
+		applyHouseholder(R, v, beta, k, k + 1, w);
+		//Keep the reflection scaled to v[k] = 1 below the diagonal
+		MATRIX_AT(R, k, k) = alpha;
+		for (int i = k + 1; i < m; i++)
+		{
+			MATRIX_AT(R, i, k) = v[i] / v[k];
+		}
+		betas[k] = beta * v[k] * v[k];
+	}
+	free(v);
+	free(w);
+	//The R of a rank deficient matrix has a diagonal item that is 0 up to the rounding errors, the substitutions would divide by it
+	double largest = 0.0;
+	for (int k = 0; k < n; k++)
+	{
+		largest = fmax(largest, fabs(MATRIX_AT(R, k, k)));
+	}
+	double tolerance = ((m > n) ? m : n) * DBL_EPSILON * largest;
+	for (int k = 0; k < n; k++)
+	{
+		if (fabs(MATRIX_AT(R, k, k)) <= tolerance)
+		{
+			printf("Matrix is rank deficient");
+			exit(EXIT_FAILURE);
+		}
+	}
+}
+
+//Static method to gather the reflection of the kth column of a compact QR decomposition into the v
+static void householderVector(Matrix* QR, int k, double* v)
+{
+	v[k] = 1.0;
+	for (int i = k + 1; i < QR->rows; i++)
+	{
+		v[i] = MATRIX_AT(QR, i, k);
+	}
+}
+
+//Static method to solve R B = B in place of the first n rows of the B by backward substitution
+static void solveUpperTriangular(Matrix* QR, Matrix* B)
+{
+	int t = B->columns;
+	for (int i = QR->columns - 1; i >= 0; i--)
+	{
+		double* B_i = MATRIX_ROW(B, i);
+		for (int j = i + 1; j < QR->columns; j++)
+		{
+			vectorAxpy(-MATRIX_AT(QR, i, j), MATRIX_ROW(B, j), B_i, t);
+		}
+		vectorScal(1.0 / MATRIX_AT(QR, i, i), B_i, t);
+	}
+}
+
+//Static method for the least squares solution using the Householder QR decomposition
+static Matrix* leastSquaresQR(Matrix* X, Matrix* Y)
+{
+	int m = X->rows;
+	int n = X->columns;
+	int t = Y->columns;
+	//R is calculated in a copy of the X and Q^T Y in a copy of the Y
+	Matrix* QR = cloneMatrix(X);
+	double* betas = initVector(n);
+	householderQR(QR, betas);
+	Matrix* QtY = cloneMatrix(Y);
+	double* v = initVector(m);
+	double* w = initVector(t);
+	for (int k = 0; k < n; k++)
+	{
+		householderVector(QR, k, v);
+		applyHouseholder(QtY, v, betas[k], k, 0, w);
+	}
+	//Backward substitution : R B = (Q^T Y)[0:n]
+	Matrix QtY_n = {QtY->data, n, t, QtY->stride};
+	solveUpperTriangular(QR, &QtY_n);
+	Matrix* B = createMatrix(n, t);
+	for (int i = 0; i < n; i++)
+	{
+		memcpy(MATRIX_ROW(B, i), MATRIX_ROW(QtY, i), t * sizeof(double));
+	}
+	//Dispose the temporary matrices and vectors
+	disposeMatrix(QR);
+	disposeMatrix(QtY);
+	free(betas);
+	free(v);
+	free(w);
+	//Return the solution
+	return B;
+}
+
+//Static method for the left inverse R^-1 Q_n^T using the Householder QR decomposition, where Q_n is the first n columns of the Q
+static Matrix* leftInverseQR(Matrix* X)
+{
+	int m = X->rows;
+	int n = X->columns;
+	Matrix* QR = cloneMatrix(X);
+	double* betas = initVector(n);
+	householderQR(QR, betas);
+	//Q_n = H_0 ... H_(n-1) [I; 0], the H_k doesn't change the columns before the kth one
+	Matrix* Q_n = createZeroMatrix(m, n);
+	for (int k = 0; k < n; k++)
+	{
+		MATRIX_AT(Q_n, k, k) = 1.0;
+	}
+	double* v = initVector(m);
+	double* w = initVector(n);
+	for (int k = n - 1; k >= 0; k--)
+	{
+		householderVector(QR, k, v);
+		applyHouseholder(Q_n, v, betas[k], k, k, w);
+	}
+	//Backward substitution : R B = Q_n^T, each row of the B has m items
+	Matrix* B = transposeStruct(Q_n);
+	solveUpperTriangular(QR, B);
+	//Dispose the temporary matrices and vectors
+	disposeMatrix(QR);
+	disposeMatrix(Q_n);
+	free(betas);
+	free(v);
+	free(w);
+	//Return the left inverse
+	return B;
+}
+
+//Method for the least squares solution B minimizing ||XB - Y||
+Matrix* matrixLeastSquares(Matrix* X, Matrix* Y, LeastSquaresSolver solver)
+{
+	//Check the dimensions
+	if (X->rows != Y->rows || X->rows < X->columns)
+	{
+		printf("Invalid dimensions for least squares");
+		exit(EXIT_FAILURE);
+	}
+	//Solve the normal equations (X^T X) B = X^T Y if the Cholesky solver will be used
+	if (solver == CHOLESKY_SOLVER)
+	{
+		Matrix* B = createMatrix(X->columns, Y->columns);
+		matrixGEMM(1, 0, 1.0, X, Y, 0.0, B);
+		if (solveGramSystem(X, B) == 1)
+		{
+			return B;
+		}
+		//Fall back to the QR solver
+		disposeMatrix(B);
+	}
+	return leastSquaresQR(X, Y);
+}
+
 //The method to dispose a Matrix
 void matrixDispose(double** A, int rows)
 {
@@ -745,16 +1213,9 @@ double* convertMatrixVector(double** A, int rows, int columns, int dispose)
 //Method to flatten a matrix into a vector
 double* flatten(double** A, int rows, int columns, int dispose)
 {
-	//Initialize the flattened a
+	//Initialize the flattened a and copy the items
 	double* a = initVector(rows * columns);
-	//Copy the items
-	for (int i = 0; i < rows; i++)
-	{
-		for (int j = 0; j < columns; j++)
-		{
-			a[i * columns + j] = A[i][j];
-		}
-	}
+	flattenInto(a, A, rows, columns);
 	//Dispose the A if required
 	if (dispose == 1)
 	{
@@ -764,3 +1225,230 @@ double* flatten(double** A, int rows, int columns, int dispose)
 	//Return the w
 	return a;
 }
+
+/**
+ * Allocation-free methods of the linear algebra class
+ *
+ * The allocating methods above are implemented on top of these methods. The rows of the
+ * double** arrays are contiguous, so the element-wise methods process a row at a time
+ * with the vector kernels.
+ */
+
+//Method to append a number to a vector into an existing vector
+void vectorAppendInto(double* result, double* vector, int n, double number, int index)
+{
+	//Copy the items before the index, the number and the items after the index
+	memcpy(result, vector, index * sizeof(double));
+	result[index] = number;
+	memcpy(result + index + 1, vector + index, (n - index) * sizeof(double));
+}
+
+//Method to get a row from a matrix into an existing vector
+void matrixGetRowInto(double* row, double** A, int rows, int columns, int index)
+{
+	//Check if the row exists
+	if (index < 0 || index >= rows)
+	{
+		printf("Row does not exist for this Matrix");
+		exit(EXIT_FAILURE);
+	}
+	memcpy(row, A[index], columns * sizeof(double));
+}
+
+//Method to get a column from a matrix into an existing vector
+void matrixGetColumnInto(double* column, double** A, int rows, int columns, int index)
+{
+	//Check if the column exists
+	if (index < 0 || index >= columns)
+	{
+		printf("Column does not exist for this Matrix");
+		exit(EXIT_FAILURE);
+	}
+	for (int i = 0; i < rows; i++)
+	{
+		column[i] = A[i][index];
+	}
+}
+
+//The method for matrix addition into an existing matrix
+void matrixAdditionInto(double** result, double** A, double** B, int rows, int columns)
+{
+	for (int i = 0; i < rows; i++)
+	{
+		vectorAdditionInto(result[i], A[i], B[i], columns);
+	}
+}
+
+//The method for matrix subtraction into an existing matrix
+void matrixSubtractionInto(double** result, double** A, double** B, int rows, int columns)
+{
+	for (int i = 0; i < rows; i++)
+	{
+		vectorSubtractionInto(result[i], A[i], B[i], columns);
+	}
+}
+
+//The method for matrix scalar multiplication into an existing matrix
+void matrixScalarMultiplicationInto(double** result, double** A, int rows, int columns, double scalar)
+{
+	for (int i = 0; i < rows; i++)
+	{
+		vectorScalarMultiplicationInto(result[i], A[i], columns, scalar);
+	}
+}
+
+/**
+ * matrixMultiplicationInto() can't copy the operands into contiguous matrices for
+ * matrixGEMM() without allocating, so it uses the i-k-j loop instead : each row of the
+ * result is accumulated from the rows of the B with vectorAxpy(), and all of the
+ * accesses are sequential.
+ */
+
+//The method for matrix multiplication into an existing matrix
+void matrixMultiplicationInto(double** result, double** A, int rows_A, int columns_A, double** B, int rows_B, int columns_B)
+{
+	//If the matrices have the required dimensions
+	if (columns_A == rows_B)
+	{
+		//Iterate over the rows of the result
+		for (int i = 0; i < rows_A; i++)
+		{
+			//result[i] = sum of A[i][k] * B[k]
+			memset(result[i], 0, columns_B * sizeof(double));
+			for (int k = 0; k < columns_A; k++)
+			{
+				vectorAxpy(A[i][k], B[k], result[i], columns_B);
+			}
+		}
+	}
+	else
+	{
+		printf("Invalid dimensions for matrix multiplication");
+		exit(EXIT_FAILURE);
+	}
+}
+
+//The method for transpose into an existing matrix
+void matrixTransposeInto(double** result, double** A, int rows, int columns)
+{
+	for (int i = 0; i < columns; i++)
+	{
+		for (int j = 0; j < rows; j++)
+		{
+			result[i][j] = A[j][i];
+		}
+	}
+}
+
+//The method for sub-matrix into an existing matrix
+void matrixSubmatrixInto(double** result, double** A, int rows, int columns, int i, int j)
+{
+	//If the matrix is big enough
+	if (rows > 1 && columns > 1)
+	{
+		//Iterate on the rows of the result matrix, dropping the ith row
+		for (int row_no = 0; row_no < rows-1; row_no++)
+		{
+			double* row = A[(row_no < i) ? row_no : row_no + 1];
+			//Copy the items before and after the jth column
+			memcpy(result[row_no], row, j * sizeof(double));
+			memcpy(result[row_no] + j, row + j + 1, (columns - j - 1) * sizeof(double));
+		}
+	}
+	else
+	{
+		printf("Sub matrix does not exist for this Matrix");
+		exit(EXIT_FAILURE);
+	}
+}
+
+//The method for the adjoint matrix of a matrix into an existing matrix
+void matrixAdjointInto(double** result, double** A, int rows, int columns)
+{
+	//If the matrix is square
+	if (rows == columns)
+	{
+		//Adjoint is the transpose of the cofactor matrix
+		for (int i = 0; i < rows; i++)
+		{
+			for (int j = 0; j < columns; j++)
+			{
+				result[j][i] = matrixCofactor(A, rows, columns, i, j);
+			}
+		}
+	}
+	else
+	{
+		printf("Adjoint Matrix of a non-square Matrix cannot be calculated");
+		exit(EXIT_FAILURE);
+	}
+}
+
+//The method for the inverse of a matrix into an existing matrix
+void matrixInverseInto(double** result, double** A, int rows, int columns)
+{
+	//If the matrix is square
+	if (rows == columns)
+	{
+		//Use the adjoint matrix for the small matrices, it is calculated into a temporary matrix since the result may be the A
+		if (rows <= LU_DECOMPOSITION_THRESHOLD)
+		{
+			double one_over_determinant = 1.0/matrixDeterminant(A, rows, columns);
+			double** adj_matrix = matrixAdjoint(A, rows, columns);
+			matrixScalarMultiplicationInto(result, adj_matrix, rows, columns, one_over_determinant);
+			matrixDispose(adj_matrix, rows);
+			return;
+		}
+		//Use the LU decomposition otherwise, the decomposition is done on a copy of the A
+		LUDecomposition* lu = initLUDecomposition(A, rows, columns);
+		luInverseInto(lu, result);
+		disposeLUDecomposition(lu);
+	}
+	else
+	{
+		printf("Inverse of a non-square Matrix cannot be calculated");
+		exit(EXIT_FAILURE);
+	}
+}
+
+//Method to flatten a matrix into an existing vector
+void flattenInto(double* a, double** A, int rows, int columns)
+{
+	for (int i = 0; i < rows; i++)
+	{
+		memcpy(a + (long) i * columns, A[i], columns * sizeof(double));
+	}
+}
+
+//The method for matrix addition in place
+void matrixAdditionInPlace(double** A, double** B, int rows, int columns)
+{
+	matrixAdditionInto(A, A, B, rows, columns);
+}
+
+//The method for matrix subtraction in place
+void matrixSubtractionInPlace(double** A, double** B, int rows, int columns)
+{
+	matrixSubtractionInto(A, A, B, rows, columns);
+}
+
+//The method for matrix scalar multiplication in place
+void matrixScalarMultiplicationInPlace(double** A, int rows, int columns, double scalar)
+{
+	matrixScalarMultiplicationInto(A, A, rows, columns, scalar);
+}
+
+//The method for the transpose of a square matrix in place
+void matrixTransposeInPlace(double** A, int n)
+{
+	//Swap the items above the diagonal with the ones below
+	for (int i = 0; i < n; i++)
+	{
+		for (int j = i + 1; j < n; j++)
+		{
+			double temporary = A[i][j];
+			A[i][j] = A[j][i];
+			A[j][i] = temporary;
+		}
+	}
+}
@@ -0,0 +1,191 @@
+//Matrix class of LibBQsC by Berkay
+
+#include "../../include/core/matrix.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../../include/core/allocation.h"
+#include "../../include/core/linear_algebra.h"
+
+/**
+ * aligned_alloc() requires the size to be a multiple of the alignment, so the size
+ * of the buffer is rounded up. At least one aligned block is allocated so that an
+ * empty matrix still has a valid buffer to be freed.
+ */
+
+//Static method to allocate an aligned buffer of n doubles
+static double* allocateBuffer(long n)
+{
+	//Round the size up to a multiple of the alignment
+	size_t size = (size_t) n * sizeof(double);
+	size = ((size / MATRIX_ALIGNMENT) + 1) * MATRIX_ALIGNMENT;
+	//Allocate the buffer and handle any allocation failure
+	double* buffer = (double*) allocateAlignedMemory(MATRIX_ALIGNMENT, size);
+	if (buffer == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	//Return the buffer
+	return buffer;
+}
+
+//Method to initialize a Matrix whose items are not initialized
+Matrix* createMatrix(int rows, int columns)
+{
+	//Initialize the Matrix and handle any allocation failure
+	Matrix* M = allocateMemory(sizeof(Matrix));
+	if (M == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	//Import the dimensions, rows are stored back to back
+	M->rows = rows;
+	M->columns = columns;
+	M->stride = columns;
+	//Allocate the single buffer of the items
+	M->data = allocateBuffer((long) rows * columns);
+	//Return the Matrix
+	return M;
+}
+
+//Method to initialize a Matrix of zeros
+Matrix* createZeroMatrix(int rows, int columns)
+{
+	//Initialize the Matrix and fill it with zeros
+	Matrix* M = createMatrix(rows, columns);
+	matrixFillZero(M);
+	//Return the Matrix
+	return M;
+}
+
+//Method to initialize a Matrix of random numbers between 0 and 1
+Matrix* createRandomMatrix(int rows, int columns)
+{
+	//Initialize the Matrix
+	Matrix* M = createMatrix(rows, columns);
+	//Seed the random number generator
+	srand(time(NULL));
+	//Define the items of the Matrix
+	for (int i = 0; i < rows; i++)
+	{
+		double* row = MATRIX_ROW(M, i);
+		for (int j = 0; j < columns; j++)
+		{
+			row[j] = (double)rand() / RAND_MAX;
+		}
+	}
+	//Return the Matrix
+	return M;
+}
+
+//Method to clone a Matrix
+Matrix* cloneMatrix(Matrix* M)
+{
+	//Initialize the clone and copy the rows into it
+	Matrix* clone = createMatrix(M->rows, M->columns);
+	for (int i = 0; i < M->rows; i++)
+	{
+		memcpy(MATRIX_ROW(clone, i), MATRIX_ROW(M, i), M->columns * sizeof(double));
+	}
+	//Return the clone
+	return clone;
+}
+
+//Method to set all items of a Matrix to zero
+void matrixFillZero(Matrix* M)
+{
+	//Fill the rows with zeros
+	for (int i = 0; i < M->rows; i++)
+	{
+		memset(MATRIX_ROW(M, i), 0, M->columns * sizeof(double));
+	}
+}
+
+//Method to dispose a Matrix
+void disposeMatrix(Matrix* M)
+{
+	//Matrices might be optional in the structs that own them
+	if (M == NULL)
+	{
+		return;
+	}
+	//Dispose the buffer then the Matrix itself
+	free(M->data);
+	M->data = NULL;
+	free(M);
+	M = NULL;
+}
+
+//Method to print a Matrix
+void printMatrixStruct(Matrix* M, int decimal_places)
+{
+	//Find the maximum length
+	int max_length = 0;
+	for (int i = 0; i < M->rows; i++)
+	{
+		for (int j = 0; j < M->columns; j++)
+		{
+			//Find the current length and set the new maximum length
+			int current_length = snprintf(NULL, 0, "%.*f", decimal_places, MATRIX_AT(M, i, j));
+			if (current_length > max_length)
+			{
+				max_length = current_length;
+			}
+		}
+	}
+	//Iterate on the Matrix to print the Matrix
+	for (int i = 0; i < M->rows; i++)
+	{
+		//Print the left border
+		printf("| ");
+		//Print the numbers on the row aligned to the right
+		for (int j = 0; j < M->columns; j++)
+		{
+			printf("%*.*f ", max_length, decimal_places, MATRIX_AT(M, i, j));
+		}
+		//Print the right border
+		printf("|\n");
+	}
+}
+
+/**
+ * Methods to convert a double** to a Matrix and vice versa
+ */
+
+//Method to convert a double** to a Matrix
+Matrix* matrixFromArray(double** A, int rows, int columns)
+{
+	//Initialize the Matrix and copy the rows of the A into it
+	Matrix* M = createMatrix(rows, columns);
+	matrixCopyFromArray(M, A);
+	//Return the Matrix
+	return M;
+}
+
+//Method to copy the items of a double** into an existing Matrix
+void matrixCopyFromArray(Matrix* M, double** A)
+{
+	//Copy the rows one by one
+	for (int i = 0; i < M->rows; i++)
+	{
+		memcpy(MATRIX_ROW(M, i), A[i], M->columns * sizeof(double));
+	}
+}
+
+//Method to convert a Matrix to a double**
+double** matrixToArray(Matrix* M)
+{
+	//Initialize the double** and copy the rows of the Matrix into it
+	double** A = initMatrix(M->rows, M->columns);
+	for (int i = 0; i < M->rows; i++)
+	{
+		memcpy(A[i], MATRIX_ROW(M, i), M->columns * sizeof(double));
+	}
+	//Return the double**
+	return A;
+}
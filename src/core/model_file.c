@@ -0,0 +1,247 @@
+//Model file class of LibBQsC by Berkay
+
+#include "../../include/core/model_file.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../../include/core/allocation.h"
+
+//Magic number at the beginning of the files
+static const char model_file_magic[8] = "LIBBQSC";
+
+/**
+ * The checksums are 64-bit FNV-1a hashes calculated over 64-bit words rather than bytes, so
+ * they are fast enough for the large files. All sections of a file are multiples of 8 bytes.
+ */
+#define CHECKSUM_OFFSET MODEL_FILE_CHECKSUM_OFFSET
+#define CHECKSUM_PRIME 1099511628211ULL
+
+//Method to continue a checksum over the passed words
+uint64_t updateModelFileChecksum(uint64_t checksum, const void* data, size_t size)
+{
+	const unsigned char* bytes = data;
+	for (size_t i = 0; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+	{
+		uint64_t word;
+		memcpy(&word, bytes + i, sizeof(uint64_t));
+		checksum = (checksum ^ word) * CHECKSUM_PRIME;
+	}
+	return checksum;
+}
+
+//Static method to round a size up to the alignment of the file
+static uint64_t alignOffset(uint64_t offset)
+{
+	return (offset + MODEL_FILE_ALIGNMENT - 1) / MODEL_FILE_ALIGNMENT * MODEL_FILE_ALIGNMENT;
+}
+
+//Static method to write bytes into a file, continue the checksum and handle any failure
+static void writeBytes(FILE* file, const void* data, size_t size, uint64_t* checksum)
+{
+	if (fwrite(data, 1, size, file) != size)
+	{
+		printf("Failed to write the model file");
+		exit(EXIT_FAILURE);
+	}
+	*checksum = updateModelFileChecksum(*checksum, data, size);
+}
+
+//Method to write the parameters of a model into a model file
+void writeModelFile(const char* path, ModelFileType model_type, int number_of_layers, Matrix** W, double** B, int* activations)
+{
+	//Check if the model has any layers
+	if (number_of_layers < 1)
+	{
+		printf("Invalid number of layers for the model file");
+		exit(EXIT_FAILURE);
+	}
+	//Build the layer table, the blobs follow it in the order of the layers
+	ModelFileLayer* layers = allocateMemory(number_of_layers * sizeof(ModelFileLayer));
+	if (layers == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	memset(layers, 0, number_of_layers * sizeof(ModelFileLayer));
+	uint64_t offset = alignOffset(sizeof(ModelFileHeader) + number_of_layers * sizeof(ModelFileLayer));
+	int max_stride = 0;
+	for (int layer_no = 0; layer_no < number_of_layers; layer_no++)
+	{
+		ModelFileLayer* layer = &layers[layer_no];
+		layer->rows = W[layer_no]->rows;
+		layer->columns = W[layer_no]->columns;
+		layer->stride = alignOffset(layer->columns * sizeof(double)) / sizeof(double);
+		layer->activation = (activations != NULL) ? activations[layer_no] : 0;
+		layer->W_offset = offset;
+		layer->B_offset = layer->W_offset + (uint64_t) layer->rows * layer->stride * sizeof(double);
+		offset = layer->B_offset + layer->stride * sizeof(double);
+		max_stride = ((int) layer->stride > max_stride) ? (int) layer->stride : max_stride;
+	}
+	//Initialize the header, its checksums are calculated after the rest of the file is written
+	ModelFileHeader header;
+	memset(&header, 0, sizeof(ModelFileHeader));
+	memcpy(header.magic, model_file_magic, sizeof(header.magic));
+	header.version = MODEL_FILE_VERSION;
+	header.endianness = MODEL_FILE_ENDIANNESS;
+	header.model_type = model_type;
+	header.number_of_layers = number_of_layers;
+	header.size = offset;
+	//Open the file and handle any failure
+	FILE* file = fopen(path, "wb");
+	if (file == NULL)
+	{
+		printf("Failed to open the model file");
+		exit(EXIT_FAILURE);
+	}
+	//Write the placeholder header, the layer table and its padding
+	uint64_t checksum = CHECKSUM_OFFSET;
+	uint64_t ignored = CHECKSUM_OFFSET;
+	writeBytes(file, &header, sizeof(ModelFileHeader), &ignored);
+	writeBytes(file, layers, number_of_layers * sizeof(ModelFileLayer), &checksum);
+	double* row = allocateAlignedMemory(MODEL_FILE_ALIGNMENT, (max_stride + MODEL_FILE_ALIGNMENT) * sizeof(double));
+	if (row == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	memset(row, 0, (max_stride + MODEL_FILE_ALIGNMENT) * sizeof(double));
+	writeBytes(file, row, layers[0].W_offset - sizeof(ModelFileHeader) - number_of_layers * sizeof(ModelFileLayer), &checksum);
+	//Write the rows of the W and the B of each layer padded with zeros
+	for (int layer_no = 0; layer_no < number_of_layers; layer_no++)
+	{
+		ModelFileLayer* layer = &layers[layer_no];
+		for (uint32_t row_no = 0; row_no < layer->rows; row_no++)
+		{
+			memcpy(row, MATRIX_ROW(W[layer_no], row_no), layer->columns * sizeof(double));
+			writeBytes(file, row, layer->stride * sizeof(double), &checksum);
+		}
+		memcpy(row, B[layer_no], layer->columns * sizeof(double));
+		writeBytes(file, row, layer->stride * sizeof(double), &checksum);
+		memset(row, 0, layer->stride * sizeof(double));
+	}
+	//Write the header with its checksums over the placeholder
+	header.checksum = checksum;
+	header.header_checksum = updateModelFileChecksum(CHECKSUM_OFFSET, &header, offsetof(ModelFileHeader, header_checksum));
+	if (fseek(file, 0, SEEK_SET) != 0)
+	{
+		printf("Failed to write the model file");
+		exit(EXIT_FAILURE);
+	}
+	writeBytes(file, &header, sizeof(ModelFileHeader), &ignored);
+	if (fclose(file) != 0)
+	{
+		printf("Failed to write the model file");
+		exit(EXIT_FAILURE);
+	}
+	free(row);
+	free(layers);
+}
+
+//Static method to exit with a message if a condition of a valid file doesn't hold
+static void checkModelFile(int condition, const char* message)
+{
+	if (!condition)
+	{
+		printf("Invalid model file : %s", message);
+		exit(EXIT_FAILURE);
+	}
+}
+
+//Method to map a model file into the memory
+ModelFile* mapModelFile(const char* path, ModelFileType model_type, int verify_checksum)
+{
+	//Open the file and get its size
+	int descriptor = open(path, O_RDONLY);
+	if (descriptor < 0)
+	{
+		printf("Failed to open the model file");
+		exit(EXIT_FAILURE);
+	}
+	struct stat status;
+	if (fstat(descriptor, &status) != 0)
+	{
+		printf("Failed to open the model file");
+		exit(EXIT_FAILURE);
+	}
+	size_t size = (size_t) status.st_size;
+	checkModelFile(size >= sizeof(ModelFileHeader), "the file is too small");
+	//Map the file read-only and shared, the mapping stays valid after the file is closed
+	void* mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, descriptor, 0);
+	close(descriptor);
+	if (mapping == MAP_FAILED)
+	{
+		printf("Failed to map the model file");
+		exit(EXIT_FAILURE);
+	}
+	//Validate the header
+	ModelFileHeader* header = mapping;
+	checkModelFile(memcmp(header->magic, model_file_magic, sizeof(header->magic)) == 0, "wrong magic number");
+	checkModelFile(header->endianness != 0x04030201u, "the file has the other byte order");
+	checkModelFile(header->endianness == MODEL_FILE_ENDIANNESS, "wrong endianness flag");
+	checkModelFile(header->header_checksum == updateModelFileChecksum(CHECKSUM_OFFSET, header, offsetof(ModelFileHeader, header_checksum)), "wrong header checksum");
+	checkModelFile(header->version == MODEL_FILE_VERSION, "unsupported version");
+	checkModelFile(header->model_type == (uint32_t) model_type, "wrong model type");
+	checkModelFile(header->size == size, "wrong file size");
+	checkModelFile(header->number_of_layers > 0 && sizeof(ModelFileHeader) + (uint64_t) header->number_of_layers * sizeof(ModelFileLayer) <= size, "wrong number of layers");
+	//Validate the layer table, so the blobs can be used without bounds checks
+	ModelFileLayer* layers = (ModelFileLayer*) ((char*) mapping + sizeof(ModelFileHeader));
+	for (uint32_t layer_no = 0; layer_no < header->number_of_layers; layer_no++)
+	{
+		ModelFileLayer* layer = &layers[layer_no];
+		checkModelFile(layer->columns > 0 && layer->stride >= layer->columns, "wrong layer dimensions");
+		checkModelFile(layer->rows <= INT_MAX && layer->columns <= INT_MAX && layer->stride <= INT_MAX, "layer dimensions out of the range of int");
+		checkModelFile(layer->W_offset % MODEL_FILE_ALIGNMENT == 0 && layer->B_offset % MODEL_FILE_ALIGNMENT == 0, "misaligned blob");
+		//The sizes are compared by divisions, so the products can't wrap around
+		uint64_t row_size = (uint64_t) layer->stride * sizeof(double);
+		checkModelFile(layer->W_offset <= layer->B_offset && layer->B_offset <= size, "blob out of the file");
+		checkModelFile(layer->rows <= (layer->B_offset - layer->W_offset) / row_size, "overlapping blobs");
+		checkModelFile(row_size <= size - layer->B_offset, "blob out of the file");
+	}
+	//Verify the checksum of the rest of the file if requested
+	if (verify_checksum == 1)
+	{
+		checkModelFile(updateModelFileChecksum(CHECKSUM_OFFSET, (char*) mapping + sizeof(ModelFileHeader), size - sizeof(ModelFileHeader)) == header->checksum, "wrong checksum");
+	}
+	//Initialize the ModelFile and handle any allocation failure
+	ModelFile* file = allocateMemory(sizeof(ModelFile));
+	if (file == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	file->mapping = mapping;
+	file->size = size;
+	file->header = header;
+	file->layers = layers;
+	//Return the mapped ModelFile
+	return file;
+}
+
+//Method to get a W of a mapped model file as a Matrix
+Matrix modelFileW(ModelFile* file, int layer_no)
+{
+	ModelFileLayer* layer = &file->layers[layer_no];
+	Matrix W = {(double*) ((char*) file->mapping + layer->W_offset), (int) layer->rows, (int) layer->columns, (int) layer->stride};
+	return W;
+}
+
+//Method to get a B of a mapped model file
+double* modelFileB(ModelFile* file, int layer_no)
+{
+	return (double*) ((char*) file->mapping + file->layers[layer_no].B_offset);
+}
+
+//Method to unmap a model file
+void unmapModelFile(ModelFile* file)
+{
+	munmap(file->mapping, file->size);
+	free(file);
+	file = NULL;
+}
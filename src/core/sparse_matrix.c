@@ -0,0 +1,200 @@
+//Sparse matrix class of LibBQsC by Berkay
+
+#include "../../include/core/sparse_matrix.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../include/core/allocation.h"
+#include "../../include/core/vector_kernels.h"
+
+//Method to initialize a SparseMatrix whose items are not initialized
+SparseMatrix* createSparseMatrix(int rows, int columns, long nonzeros)
+{
+	//Check if the dimensions are valid
+	if (rows < 0 || columns < 0 || nonzeros < 0)
+	{
+		printf("Invalid dimensions of the sparse matrix");
+		exit(EXIT_FAILURE);
+	}
+	//Initialize the SparseMatrix and its arrays, at least one item is allocated for an empty matrix
+	SparseMatrix* A = allocateMemory(sizeof(SparseMatrix));
+	if (A == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	A->values = allocateMemory((size_t) (nonzeros + 1) * sizeof(double));
+	A->column_indices = allocateMemory((size_t) (nonzeros + 1) * sizeof(int));
+	A->row_offsets = allocateMemory((size_t) (rows + 1) * sizeof(long));
+	if (A->values == NULL || A->column_indices == NULL || A->row_offsets == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	//Import the dimensions and the bounds of the nonzero items
+	A->rows = rows;
+	A->columns = columns;
+	A->row_offsets[0] = 0;
+	A->row_offsets[rows] = nonzeros;
+	//Return the SparseMatrix
+	return A;
+}
+
+//Method to convert a Matrix to a SparseMatrix
+SparseMatrix* sparseMatrixFromMatrix(Matrix* M)
+{
+	//Count the nonzero items to allocate the arrays once
+	long nonzeros = 0;
+	for (int i = 0; i < M->rows; i++)
+	{
+		double* row = MATRIX_ROW(M, i);
+		for (int j = 0; j < M->columns; j++)
+		{
+			nonzeros += (row[j] != 0.0);
+		}
+	}
+	//Copy the nonzero items row by row
+	SparseMatrix* A = createSparseMatrix(M->rows, M->columns, nonzeros);
+	long index = 0;
+	for (int i = 0; i < M->rows; i++)
+	{
+		double* row = MATRIX_ROW(M, i);
+		A->row_offsets[i] = index;
+		for (int j = 0; j < M->columns; j++)
+		{
+			if (row[j] != 0.0)
+			{
+				A->values[index] = row[j];
+				A->column_indices[index] = j;
+				index++;
+			}
+		}
+	}
+	//Return the SparseMatrix
+	return A;
+}
+
+//Method to convert a SparseMatrix to a Matrix
+Matrix* sparseMatrixToMatrix(SparseMatrix* A)
+{
+	//Scatter the nonzero items into a Matrix of zeros
+	Matrix* M = createZeroMatrix(A->rows, A->columns);
+	for (int i = 0; i < A->rows; i++)
+	{
+		double* row = MATRIX_ROW(M, i);
+		for (long index = A->row_offsets[i]; index < A->row_offsets[i + 1]; index++)
+		{
+			row[A->column_indices[index]] = A->values[index];
+		}
+	}
+	//Return the Matrix
+	return M;
+}
+
+//Method to clone a SparseMatrix
+SparseMatrix* cloneSparseMatrix(SparseMatrix* A)
+{
+	//Initialize the clone and copy the arrays into it
+	long nonzeros = SPARSE_NONZEROS(A);
+	SparseMatrix* clone = createSparseMatrix(A->rows, A->columns, nonzeros);
+	memcpy(clone->values, A->values, nonzeros * sizeof(double));
+	memcpy(clone->column_indices, A->column_indices, nonzeros * sizeof(int));
+	memcpy(clone->row_offsets, A->row_offsets, (A->rows + 1) * sizeof(long));
+	//Return the clone
+	return clone;
+}
+
+//Method for sparse times dense matrix multiplication : C = alpha * A x B + beta * C
+void sparseMatrixGEMM(double alpha, SparseMatrix* A, Matrix* B, double beta, Matrix* C)
+{
+	sparseMatrixGEMMEpilogue(alpha, A, B, beta, C, NULL, NULL);
+}
+
+//Method for sparse times dense matrix multiplication followed by an epilogue : C = epilogue(alpha * A x B + beta * C)
+void sparseMatrixGEMMEpilogue(double alpha, SparseMatrix* A, Matrix* B, double beta, Matrix* C, GEMMEpilogue epilogue, void* argument)
+{
+	//Check if the dimensions are valid
+	if (A->columns != B->rows || C->rows != A->rows || C->columns != B->columns)
+	{
+		printf("Invalid dimensions for the sparse matrix multiplication");
+		exit(EXIT_FAILURE);
+	}
+	int n = B->columns;
+	for (int i = 0; i < A->rows; i++)
+	{
+		//Scale the row of the C, it is not read if the beta is 0
+		double* c = MATRIX_ROW(C, i);
+		if (beta == 0.0)
+		{
+			memset(c, 0, n * sizeof(double));
+		}
+		else if (beta != 1.0)
+		{
+			vectorScal(beta, c, n);
+		}
+		//Add the rows of the B in the columns of the nonzero items of the row
+		for (long index = A->row_offsets[i]; index < A->row_offsets[i + 1]; index++)
+		{
+			vectorAxpy(alpha * A->values[index], MATRIX_ROW(B, A->column_indices[index]), c, n);
+		}
+		//The row is final
+		if (epilogue != NULL)
+		{
+			epilogue(C, i, 0, n, argument);
+		}
+	}
+}
+
+//Method for transposed sparse times dense matrix multiplication : C = alpha * A^T x B + beta * C
+void sparseMatrixTransposeGEMM(double alpha, SparseMatrix* A, Matrix* B, double beta, Matrix* C)
+{
+	//Check if the dimensions are valid
+	if (A->rows != B->rows || C->rows != A->columns || C->columns != B->columns)
+	{
+		printf("Invalid dimensions for the sparse matrix multiplication");
+		exit(EXIT_FAILURE);
+	}
+	int n = B->columns;
+	//Scale the C once, it is not read if the beta is 0
+	if (beta == 0.0)
+	{
+		matrixFillZero(C);
+	}
+	else if (beta != 1.0)
+	{
+		for (int j = 0; j < C->rows; j++)
+		{
+			vectorScal(beta, MATRIX_ROW(C, j), n);
+		}
+	}
+	//Scatter each row of the B into the rows of the C in the columns of the nonzero items of its row of the A
+	for (int i = 0; i < A->rows; i++)
+	{
+		double* b = MATRIX_ROW(B, i);
+		for (long index = A->row_offsets[i]; index < A->row_offsets[i + 1]; index++)
+		{
+			vectorAxpy(alpha * A->values[index], b, MATRIX_ROW(C, A->column_indices[index]), n);
+		}
+	}
+}
+
+//Method to dispose a SparseMatrix
+void disposeSparseMatrix(SparseMatrix* A)
+{
+	//Sparse matrices might be optional in the structs that own them
+	if (A == NULL)
+	{
+		return;
+	}
+	//Dispose the arrays then the SparseMatrix itself
+	free(A->values);
+	A->values = NULL;
+	free(A->column_indices);
+	A->column_indices = NULL;
+	free(A->row_offsets);
+	A->row_offsets = NULL;
+	free(A);
+	A = NULL;
+}
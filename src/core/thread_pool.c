@@ -0,0 +1,157 @@
+//Thread pool class of LibBQsC by Berkay
+
+#include "../../include/core/thread_pool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "../../include/core/allocation.h"
+#include "../../include/core/gemm.h"
+
+/**
+ * Arguments of a thread of a ThreadPool
+ */
+typedef struct
+{
+	ThreadPool* pool;
+	int thread_no;
+}
+ThreadArgument;
+
+//Static method run by the threads of a ThreadPool : waits for the tasks and runs them
+static void* runThread(void* argument)
+{
+	ThreadPool* pool = ((ThreadArgument*) argument)->pool;
+	int thread_no = ((ThreadArgument*) argument)->thread_no;
+	free(argument);
+	long generation = 0;
+	while (1)
+	{
+		//Wait for a new task or the stop
+		pthread_mutex_lock(&pool->mutex);
+		while (pool->generation == generation && pool->stop == 0)
+		{
+			pthread_cond_wait(&pool->task_ready, &pool->mutex);
+		}
+		//Dispose the thread-local buffers of the library before exiting
+		if (pool->stop == 1)
+		{
+			pthread_mutex_unlock(&pool->mutex);
+			disposeGEMMBuffers();
+			return NULL;
+		}
+		generation = pool->generation;
+		void (*task)(void*, int) = pool->task;
+		void* task_argument = pool->argument;
+		pthread_mutex_unlock(&pool->mutex);
+		//Run the task and notify the calling thread if this was the last one
+		task(task_argument, thread_no);
+		pthread_mutex_lock(&pool->mutex);
+		pool->remaining -= 1;
+		if (pool->remaining == 0)
+		{
+			pthread_cond_signal(&pool->task_done);
+		}
+		pthread_mutex_unlock(&pool->mutex);
+	}
+}
+
+//Method to get the number of processors available
+int getNumberOfProcessors(void)
+{
+	long processors = sysconf(_SC_NPROCESSORS_ONLN);
+	return (processors > 0) ? (int) processors : 1;
+}
+
+//Method to initialize a ThreadPool
+ThreadPool* initThreadPool(int number_of_threads)
+{
+	//Check the number of threads
+	if (number_of_threads < 1)
+	{
+		printf("Invalid number of threads");
+		exit(EXIT_FAILURE);
+	}
+	//Initialize the ThreadPool and handle any allocation failure
+	ThreadPool* pool = allocateMemory(sizeof(ThreadPool));
+	pthread_t* threads = allocateMemory((number_of_threads > 1 ? number_of_threads - 1 : 1) * sizeof(pthread_t));
+	if (pool == NULL || threads == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	pool->threads = threads;
+	pool->number_of_threads = number_of_threads;
+	pthread_mutex_init(&pool->mutex, NULL);
+	pthread_cond_init(&pool->task_ready, NULL);
+	pthread_cond_init(&pool->task_done, NULL);
+	pool->task = NULL;
+	pool->argument = NULL;
+	pool->remaining = 0;
+	pool->generation = 0;
+	pool->stop = 0;
+	//Create the threads, the calling thread is the thread 0
+	for (int thread_no = 1; thread_no < number_of_threads; thread_no++)
+	{
+		ThreadArgument* argument = allocateMemory(sizeof(ThreadArgument));
+		if (argument == NULL)
+		{
+			printf("Failed to allocate memory");
+			exit(EXIT_FAILURE);
+		}
+		argument->pool = pool;
+		argument->thread_no = thread_no;
+		if (pthread_create(&pool->threads[thread_no-1], NULL, runThread, argument) != 0)
+		{
+			printf("Failed to create a thread");
+			exit(EXIT_FAILURE);
+		}
+	}
+	//Return the ThreadPool
+	return pool;
+}
+
+//Method to run a task on all threads of a ThreadPool and wait for it to finish
+void runThreadPool(ThreadPool* pool, void (*task)(void* argument, int thread_no), void* argument)
+{
+	//Publish the task to the threads
+	pthread_mutex_lock(&pool->mutex);
+	pool->task = task;
+	pool->argument = argument;
+	pool->remaining = pool->number_of_threads - 1;
+	pool->generation += 1;
+	pthread_cond_broadcast(&pool->task_ready);
+	pthread_mutex_unlock(&pool->mutex);
+	//Run the part of the calling thread
+	task(argument, 0);
+	//Wait for the other threads
+	pthread_mutex_lock(&pool->mutex);
+	while (pool->remaining > 0)
+	{
+		pthread_cond_wait(&pool->task_done, &pool->mutex);
+	}
+	pthread_mutex_unlock(&pool->mutex);
+}
+
+//Method to dispose a ThreadPool
+void disposeThreadPool(ThreadPool* pool)
+{
+	//Stop and join the threads
+	pthread_mutex_lock(&pool->mutex);
+	pool->stop = 1;
+	pthread_cond_broadcast(&pool->task_ready);
+	pthread_mutex_unlock(&pool->mutex);
+	for (int thread_no = 1; thread_no < pool->number_of_threads; thread_no++)
+	{
+		pthread_join(pool->threads[thread_no-1], NULL);
+	}
+	//Dispose the synchronization objects and the pool
+	pthread_mutex_destroy(&pool->mutex);
+	pthread_cond_destroy(&pool->task_ready);
+	pthread_cond_destroy(&pool->task_done);
+	free(pool->threads);
+	pool->threads = NULL;
+	free(pool);
+	pool = NULL;
+}
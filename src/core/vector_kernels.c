@@ -0,0 +1,993 @@
+//Vector kernels class of LibBQsC by Berkay
+
+#include "../../include/core/vector_kernels.h"
+
+#include <math.h>
+#include <string.h>
+
+//The SIMD implementations are compiled for x86 with GCC compatible compilers
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define VECTOR_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+/**
+ * VectorKernels struct
+ *
+ * Table of the implementations of an instruction set. The table in use is selected
+ * once and the public methods only forward to it.
+ */
+typedef struct
+{
+	void (*axpy)(double alpha, double* x, double* y, int n);
+	double (*dot)(double* x, double* y, int n);
+	void (*addition)(double* result, double* a, double* b, int n);
+	void (*subtraction)(double* result, double* a, double* b, int n);
+	void (*scalarMultiplication)(double* result, double* vector, int n, double scalar);
+	void (*exp)(double* result, double* x, int n);
+	void (*log)(double* result, double* x, int n);
+	void (*sigmoid)(double* result, double* x, int n);
+	void (*tanh)(double* result, double* x, int n);
+	void (*softmax)(double* result, double* x, int n);
+	double (*sum)(double* x, int n);
+	void (*moments)(double* x, int n, VectorMoments* moments);
+}
+VectorKernels;
+
+/**
+ * Scalar implementations
+ */
+
+//Scalar y = alpha * x + y
+static void axpyScalar(double alpha, double* x, double* y, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		y[i] += alpha * x[i];
+	}
+}
+
+//Scalar dot product with four accumulators
+static double dotScalar(double* x, double* y, int n)
+{
+	double sum_0 = 0.0, sum_1 = 0.0, sum_2 = 0.0, sum_3 = 0.0;
+	int i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		sum_0 += x[i] * y[i];
+		sum_1 += x[i+1] * y[i+1];
+		sum_2 += x[i+2] * y[i+2];
+		sum_3 += x[i+3] * y[i+3];
+	}
+	for (; i < n; i++)
+	{
+		sum_0 += x[i] * y[i];
+	}
+	return (sum_0 + sum_1) + (sum_2 + sum_3);
+}
+
+//Scalar result = a + b
+static void additionScalar(double* result, double* a, double* b, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		result[i] = a[i] + b[i];
+	}
+}
+
+//Scalar result = a - b
+static void subtractionScalar(double* result, double* a, double* b, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		result[i] = a[i] - b[i];
+	}
+}
+
+//Scalar result = scalar * vector
+static void scalarMultiplicationScalar(double* result, double* vector, int n, double scalar)
+{
+	for (int i = 0; i < n; i++)
+	{
+		result[i] = scalar * vector[i];
+	}
+}
+
+//Scalar result = exp(x)
+static void expScalar(double* result, double* x, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		result[i] = exp(x[i]);
+	}
+}
+
+//Scalar result = log(x)
+static void logScalar(double* result, double* x, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		result[i] = log(x[i]);
+	}
+}
+
+//Scalar result = sigmoid(x)
+static void sigmoidScalar(double* result, double* x, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		result[i] = 1.0 / (1.0 + exp(-x[i]));
+	}
+}
+
+//Scalar result = tanh(x)
+static void tanhScalar(double* result, double* x, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		result[i] = tanh(x[i]);
+	}
+}
+
+//Scalar result = softmax(x), the maximum is subtracted from the items for numerical stability
+static void softmaxScalar(double* result, double* x, int n)
+{
+	double max_x = x[0];
+	for (int i = 1; i < n; i++)
+	{
+		max_x = (x[i] > max_x) ? x[i] : max_x;
+	}
+	double sum = 0.0;
+	for (int i = 0; i < n; i++)
+	{
+		result[i] = exp(x[i] - max_x);
+		sum += result[i];
+	}
+	for (int i = 0; i < n; i++)
+	{
+		result[i] /= sum;
+	}
+}
+
+/**
+ * The compensated sums add each item with Knuth's TwoSum, which gives the rounded sum s and its rounding error e
+ * such that s + e is exactly the sum of the accumulator and the item. The errors are summed into a second accumulator
+ * that is added to the sum at the end. The SIMD implementations keep a pair of accumulators for each lane and merge
+ * the lanes with TwoSum as well.
+ */
+
+//Static method for the rounded sum of two doubles and its rounding error
+static inline double twoSum(double a, double b, double* error)
+{
+	double sum = a + b;
+	double b_virtual = sum - a;
+	*error = (a - (sum - b_virtual)) + (b - b_virtual);
+	return sum;
+}
+
+//Static method to add an item to a compensated sum
+static inline void compensatedAdd(double* sum, double* compensation, double item)
+{
+	double error;
+	*sum = twoSum(*sum, item, &error);
+	*compensation += error;
+}
+
+//Scalar compensated sum with two accumulators
+static double sumScalar(double* x, int n)
+{
+	double sum_0 = 0.0, sum_1 = 0.0, compensation_0 = 0.0, compensation_1 = 0.0;
+	int i = 0;
+	for (; i + 2 <= n; i += 2)
+	{
+		compensatedAdd(&sum_0, &compensation_0, x[i]);
+		compensatedAdd(&sum_1, &compensation_1, x[i+1]);
+	}
+	for (; i < n; i++)
+	{
+		compensatedAdd(&sum_0, &compensation_0, x[i]);
+	}
+	compensatedAdd(&sum_0, &compensation_0, sum_1);
+	return sum_0 + (compensation_0 + compensation_1);
+}
+
+//Static method to add the items of a vector to the accumulators of the moments
+static void accumulateMomentsScalar(double* x, int n, double* min, double* max, double* sum, double* sum_compensation, double* squares, double* squares_compensation)
+{
+	for (int i = 0; i < n; i++)
+	{
+		*min = (x[i] < *min) ? x[i] : *min;
+		*max = (x[i] > *max) ? x[i] : *max;
+		compensatedAdd(sum, sum_compensation, x[i]);
+		compensatedAdd(squares, squares_compensation, x[i] * x[i]);
+	}
+}
+
+//Scalar moments
+static void momentsScalar(double* x, int n, VectorMoments* moments)
+{
+	double min = INFINITY, max = -INFINITY, sum = 0.0, sum_compensation = 0.0, squares = 0.0, squares_compensation = 0.0;
+	accumulateMomentsScalar(x, n, &min, &max, &sum, &sum_compensation, &squares, &squares_compensation);
+	*moments = (VectorMoments) {min, max, sum + sum_compensation, squares + squares_compensation};
+}
+
+static const VectorKernels kernels_scalar = {axpyScalar, dotScalar, additionScalar, subtractionScalar, scalarMultiplicationScalar,
+		expScalar, logScalar, sigmoidScalar, tanhScalar, softmaxScalar, sumScalar, momentsScalar};
+
+#ifdef VECTOR_KERNELS_X86
+
+/**
+ * SIMD implementations
+ *
+ * The implementations of the instruction sets only differ in the vector type and the
+ * intrinsics, so they are generated by the macro below. Each method processes WIDTH
+ * items per step using unaligned loads and stores, and the remaining items are
+ * processed by the scalar loop. The dot product keeps four vector accumulators to
+ * hide the latency of the additions.
+ */
+#define DEFINE_SIMD_KERNELS(NAME, TARGET, VECTOR, WIDTH, LOAD, STORE, SET1, ZERO, ADD, SUB, MUL, FMADD, REDUCE) \
+	__attribute__((target(TARGET))) \
+	static void axpy##NAME(double alpha, double* x, double* y, int n) \
+	{ \
+		VECTOR alpha_vector = SET1(alpha); \
+		int i = 0; \
+		for (; i + WIDTH <= n; i += WIDTH) \
+		{ \
+			STORE(y + i, FMADD(alpha_vector, LOAD(x + i), LOAD(y + i))); \
+		} \
+		axpyScalar(alpha, x + i, y + i, n - i); \
+	} \
+	__attribute__((target(TARGET))) \
+	static double dot##NAME(double* x, double* y, int n) \
+	{ \
+		VECTOR sum_0 = ZERO(), sum_1 = ZERO(), sum_2 = ZERO(), sum_3 = ZERO(); \
+		int i = 0; \
+		for (; i + 4 * WIDTH <= n; i += 4 * WIDTH) \
+		{ \
+			sum_0 = FMADD(LOAD(x + i), LOAD(y + i), sum_0); \
+			sum_1 = FMADD(LOAD(x + i + WIDTH), LOAD(y + i + WIDTH), sum_1); \
+			sum_2 = FMADD(LOAD(x + i + 2 * WIDTH), LOAD(y + i + 2 * WIDTH), sum_2); \
+			sum_3 = FMADD(LOAD(x + i + 3 * WIDTH), LOAD(y + i + 3 * WIDTH), sum_3); \
+		} \
+		for (; i + WIDTH <= n; i += WIDTH) \
+		{ \
+			sum_0 = FMADD(LOAD(x + i), LOAD(y + i), sum_0); \
+		} \
+		double result = REDUCE(ADD(ADD(sum_0, sum_1), ADD(sum_2, sum_3))); \
+		return result + dotScalar(x + i, y + i, n - i); \
+	} \
+	__attribute__((target(TARGET))) \
+	static void addition##NAME(double* result, double* a, double* b, int n) \
+	{ \
+		int i = 0; \
+		for (; i + WIDTH <= n; i += WIDTH) \
+		{ \
+			STORE(result + i, ADD(LOAD(a + i), LOAD(b + i))); \
+		} \
+		additionScalar(result + i, a + i, b + i, n - i); \
+	} \
+	__attribute__((target(TARGET))) \
+	static void subtraction##NAME(double* result, double* a, double* b, int n) \
+	{ \
+		int i = 0; \
+		for (; i + WIDTH <= n; i += WIDTH) \
+		{ \
+			STORE(result + i, SUB(LOAD(a + i), LOAD(b + i))); \
+		} \
+		subtractionScalar(result + i, a + i, b + i, n - i); \
+	} \
+	__attribute__((target(TARGET))) \
+	static void scalarMultiplication##NAME(double* result, double* vector, int n, double scalar) \
+	{ \
+		VECTOR scalar_vector = SET1(scalar); \
+		int i = 0; \
+		for (; i + WIDTH <= n; i += WIDTH) \
+		{ \
+			STORE(result + i, MUL(scalar_vector, LOAD(vector + i))); \
+		} \
+		scalarMultiplicationScalar(result + i, vector + i, n - i, scalar); \
+	}
+
+//Horizontal sums of the vectors
+__attribute__((target("sse2")))
+static inline double reduceSSE2(__m128d v)
+{
+	return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+}
+
+__attribute__((target("avx2,fma")))
+static inline double reduceAVX2(__m256d v)
+{
+	return reduceSSE2(_mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1)));
+}
+
+__attribute__((target("avx512f")))
+static inline double reduceAVX512(__m512d v)
+{
+	return _mm512_reduce_add_pd(v);
+}
+
+//SSE2 doesn't have fused multiply-add
+#define FMADD_SSE2(a, b, c) _mm_add_pd(_mm_mul_pd(a, b), c)
+
+DEFINE_SIMD_KERNELS(SSE2, "sse2", __m128d, 2, _mm_loadu_pd, _mm_storeu_pd, _mm_set1_pd, _mm_setzero_pd,
+		_mm_add_pd, _mm_sub_pd, _mm_mul_pd, FMADD_SSE2, reduceSSE2)
+
+DEFINE_SIMD_KERNELS(AVX2, "avx2,fma", __m256d, 4, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_set1_pd, _mm256_setzero_pd,
+		_mm256_add_pd, _mm256_sub_pd, _mm256_mul_pd, _mm256_fmadd_pd, reduceAVX2)
+
+DEFINE_SIMD_KERNELS(AVX512, "avx512f", __m512d, 8, _mm512_loadu_pd, _mm512_storeu_pd, _mm512_set1_pd, _mm512_setzero_pd,
+		_mm512_add_pd, _mm512_sub_pd, _mm512_mul_pd, _mm512_fmadd_pd, reduceAVX512)
+
+/**
+ * SIMD compensated reductions
+ *
+ * TWO_SUM adds the item to the lanes of the sum and the rounding errors to the lanes of the compensation. The sum keeps
+ * four pairs of accumulators, and the moments keep two sets of the minimum, maximum and two pairs, which fit in the
+ * registers of all instruction sets. The lanes are merged into scalar accumulators, which process the remaining items.
+ */
+#define TWO_SUM(VECTOR, ADD, SUB, sum, compensation, item) \
+	{ \
+		VECTOR sum_new = ADD(sum, item); \
+		VECTOR item_virtual = SUB(sum_new, sum); \
+		compensation = ADD(compensation, ADD(SUB(sum, SUB(sum_new, item_virtual)), SUB(item, item_virtual))); \
+		sum = sum_new; \
+	}
+
+#define DEFINE_SIMD_REDUCTION_KERNELS(NAME, TARGET, VECTOR, WIDTH, LOAD, STORE, SET1, ZERO, ADD, SUB, MUL, MIN, MAX) \
+	/* Merges the lanes of a pair of accumulators into the scalar pair */ \
+	__attribute__((target(TARGET))) \
+	static inline void mergeLanes##NAME(VECTOR sum, VECTOR compensation, double* scalar_sum, double* scalar_compensation) \
+	{ \
+		double sums[WIDTH], compensations[WIDTH]; \
+		STORE(sums, sum); \
+		STORE(compensations, compensation); \
+		for (int lane = 0; lane < WIDTH; lane++) \
+		{ \
+			compensatedAdd(scalar_sum, scalar_compensation, sums[lane]); \
+			*scalar_compensation += compensations[lane]; \
+		} \
+	} \
+	__attribute__((target(TARGET))) \
+	static double sum##NAME(double* x, int n) \
+	{ \
+		VECTOR sum_0 = ZERO(), sum_1 = ZERO(), sum_2 = ZERO(), sum_3 = ZERO(); \
+		VECTOR compensation_0 = ZERO(), compensation_1 = ZERO(), compensation_2 = ZERO(), compensation_3 = ZERO(); \
+		int i = 0; \
+		for (; i + 4 * WIDTH <= n; i += 4 * WIDTH) \
+		{ \
+			VECTOR x_0 = LOAD(x + i); \
+			VECTOR x_1 = LOAD(x + i + WIDTH); \
+			VECTOR x_2 = LOAD(x + i + 2 * WIDTH); \
+			VECTOR x_3 = LOAD(x + i + 3 * WIDTH); \
+			TWO_SUM(VECTOR, ADD, SUB, sum_0, compensation_0, x_0) \
+			TWO_SUM(VECTOR, ADD, SUB, sum_1, compensation_1, x_1) \
+			TWO_SUM(VECTOR, ADD, SUB, sum_2, compensation_2, x_2) \
+			TWO_SUM(VECTOR, ADD, SUB, sum_3, compensation_3, x_3) \
+		} \
+		double sum = 0.0, compensation = 0.0; \
+		mergeLanes##NAME(sum_0, compensation_0, &sum, &compensation); \
+		mergeLanes##NAME(sum_1, compensation_1, &sum, &compensation); \
+		mergeLanes##NAME(sum_2, compensation_2, &sum, &compensation); \
+		mergeLanes##NAME(sum_3, compensation_3, &sum, &compensation); \
+		for (; i < n; i++) \
+		{ \
+			compensatedAdd(&sum, &compensation, x[i]); \
+		} \
+		return sum + compensation; \
+	} \
+	__attribute__((target(TARGET))) \
+	static void moments##NAME(double* x, int n, VectorMoments* moments) \
+	{ \
+		VECTOR min_0 = SET1(INFINITY), min_1 = SET1(INFINITY), max_0 = SET1(-INFINITY), max_1 = SET1(-INFINITY); \
+		VECTOR sum_0 = ZERO(), sum_1 = ZERO(), sum_compensation_0 = ZERO(), sum_compensation_1 = ZERO(); \
+		VECTOR squares_0 = ZERO(), squares_1 = ZERO(), squares_compensation_0 = ZERO(), squares_compensation_1 = ZERO(); \
+		int i = 0; \
+		for (; i + 2 * WIDTH <= n; i += 2 * WIDTH) \
+		{ \
+			/* The minimums and the maximums are the second operands, so the NaNs are skipped */ \
+			VECTOR x_0 = LOAD(x + i); \
+			VECTOR x_1 = LOAD(x + i + WIDTH); \
+			min_0 = MIN(x_0, min_0); \
+			min_1 = MIN(x_1, min_1); \
+			max_0 = MAX(x_0, max_0); \
+			max_1 = MAX(x_1, max_1); \
+			TWO_SUM(VECTOR, ADD, SUB, sum_0, sum_compensation_0, x_0) \
+			TWO_SUM(VECTOR, ADD, SUB, sum_1, sum_compensation_1, x_1) \
+			TWO_SUM(VECTOR, ADD, SUB, squares_0, squares_compensation_0, MUL(x_0, x_0)) \
+			TWO_SUM(VECTOR, ADD, SUB, squares_1, squares_compensation_1, MUL(x_1, x_1)) \
+		} \
+		double mins[WIDTH], maxs[WIDTH]; \
+		STORE(mins, MIN(min_0, min_1)); \
+		STORE(maxs, MAX(max_0, max_1)); \
+		double min = INFINITY, max = -INFINITY; \
+		for (int lane = 0; lane < WIDTH; lane++) \
+		{ \
+			min = (mins[lane] < min) ? mins[lane] : min; \
+			max = (maxs[lane] > max) ? maxs[lane] : max; \
+		} \
+		double sum = 0.0, sum_compensation = 0.0, squares = 0.0, squares_compensation = 0.0; \
+		mergeLanes##NAME(sum_0, sum_compensation_0, &sum, &sum_compensation); \
+		mergeLanes##NAME(sum_1, sum_compensation_1, &sum, &sum_compensation); \
+		mergeLanes##NAME(squares_0, squares_compensation_0, &squares, &squares_compensation); \
+		mergeLanes##NAME(squares_1, squares_compensation_1, &squares, &squares_compensation); \
+		accumulateMomentsScalar(x + i, n - i, &min, &max, &sum, &sum_compensation, &squares, &squares_compensation); \
+		*moments = (VectorMoments) {min, max, sum + sum_compensation, squares + squares_compensation}; \
+	}
+
+DEFINE_SIMD_REDUCTION_KERNELS(SSE2, "sse2", __m128d, 2, _mm_loadu_pd, _mm_storeu_pd, _mm_set1_pd, _mm_setzero_pd,
+		_mm_add_pd, _mm_sub_pd, _mm_mul_pd, _mm_min_pd, _mm_max_pd)
+
+DEFINE_SIMD_REDUCTION_KERNELS(AVX2, "avx2,fma", __m256d, 4, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_set1_pd, _mm256_setzero_pd,
+		_mm256_add_pd, _mm256_sub_pd, _mm256_mul_pd, _mm256_min_pd, _mm256_max_pd)
+
+DEFINE_SIMD_REDUCTION_KERNELS(AVX512, "avx512f", __m512d, 8, _mm512_loadu_pd, _mm512_storeu_pd, _mm512_set1_pd, _mm512_setzero_pd,
+		_mm512_add_pd, _mm512_sub_pd, _mm512_mul_pd, _mm512_min_pd, _mm512_max_pd)
+
+/**
+ * SIMD transcendental functions
+ *
+ * exp(x) : x = n * ln(2) + r with |r| <= ln(2) / 2, where ln(2) is split into two parts so that
+ * r is exact. exp(r) - 1 is approximated by its Taylor polynomial of degree 13, whose truncation
+ * error is below 2^-58 on the interval, and exp(x) = 2^n * (1 + q). 2^n is applied as the product
+ * of two powers of two, so n = 1024 doesn't overflow the exponent. The results below DBL_MIN are
+ * flushed to 0, since the arithmetic on the subnormal numbers is very slow on most processors.
+ *
+ * log(x) : x = 2^e * m with sqrt(2) / 2 <= m < sqrt(2), and log(m) is calculated as in the fdlibm
+ * from f = m - 1 and s = f / (2 + f) with a polynomial of degree 14 in s.
+ *
+ * sigmoid(x) = 1 / (1 + exp(-x)) and tanh(|x|) = expm1(2|x|) / (expm1(2|x|) + 2), where expm1 is
+ * calculated from the same reduction as the exp so that tanh is accurate around 0 as well.
+ *
+ * The methods below differ between the instruction sets only in the integer operations, the
+ * comparisons and the selections, which are implemented separately for each instruction set.
+ * The remaining items are processed by the same vector code in a padded buffer, so the result
+ * of an item doesn't depend on its position in the array.
+ */
+
+//Constants of the reductions
+#define MATH_LOG2_E 1.4426950408889634074
+#define MATH_LN2_HI 6.93147180369123816490e-01
+#define MATH_LN2_LO 1.90821492927058770002e-10
+#define MATH_SHIFTER 6755399441055744.0
+#define MATH_EXP_MAX 709.782712893383973096
+#define MATH_EXP_MIN -708.396418532264106224
+#define MATH_SQRT2 1.41421356237309504880
+
+//SSE2 integer operations, comparisons and selections
+__attribute__((target("sse2")))
+static inline __m128d andSSE2(__m128d a, __m128d b)
+{
+	return _mm_and_pd(a, b);
+}
+
+__attribute__((target("sse2")))
+static inline __m128d andNotSSE2(__m128d a, __m128d b)
+{
+	return _mm_andnot_pd(a, b);
+}
+
+__attribute__((target("sse2")))
+static inline __m128d orSSE2(__m128d a, __m128d b)
+{
+	return _mm_or_pd(a, b);
+}
+
+__attribute__((target("sse2")))
+static inline __m128d lessThanSSE2(__m128d a, __m128d b)
+{
+	return _mm_cmplt_pd(a, b);
+}
+
+__attribute__((target("sse2")))
+static inline __m128d greaterThanSSE2(__m128d a, __m128d b)
+{
+	return _mm_cmpgt_pd(a, b);
+}
+
+__attribute__((target("sse2")))
+static inline __m128d equalSSE2(__m128d a, __m128d b)
+{
+	return _mm_cmpeq_pd(a, b);
+}
+
+__attribute__((target("sse2")))
+static inline __m128d isNaNSSE2(__m128d a)
+{
+	return _mm_cmpunord_pd(a, a);
+}
+
+__attribute__((target("sse2")))
+static inline __m128d selectSSE2(__m128d mask, __m128d a, __m128d b)
+{
+	return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+}
+
+__attribute__((target("sse2")))
+static inline void powersOfTwoSSE2(__m128d shifted, __m128d* scale_1, __m128d* scale_2)
+{
+	//n is in the low bits of the shifted, and 2^n = 2^floor(n/2) * 2^(n-floor(n/2))
+	__m128i n = _mm_sub_epi64(_mm_castpd_si128(shifted), _mm_castpd_si128(_mm_set1_pd(MATH_SHIFTER)));
+	__m128i n_1 = _mm_sub_epi64(_mm_srli_epi64(_mm_add_epi64(n, _mm_set1_epi64x(2048)), 1), _mm_set1_epi64x(1024));
+	__m128i n_2 = _mm_sub_epi64(n, n_1);
+	*scale_1 = _mm_castsi128_pd(_mm_slli_epi64(_mm_add_epi64(n_1, _mm_set1_epi64x(1023)), 52));
+	*scale_2 = _mm_castsi128_pd(_mm_slli_epi64(_mm_add_epi64(n_2, _mm_set1_epi64x(1023)), 52));
+}
+
+__attribute__((target("sse2")))
+static inline __m128d decomposeSSE2(__m128d x, __m128d* mantissa)
+{
+	//x = 2^e * m with 1 <= m < 2 for the positive normal x, e is returned
+	__m128i bits = _mm_castpd_si128(x);
+	*mantissa = _mm_castsi128_pd(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi64x(0x000FFFFFFFFFFFFFLL)), _mm_set1_epi64x(0x3FF0000000000000LL)));
+	__m128d exponent = _mm_castsi128_pd(_mm_or_si128(_mm_srli_epi64(bits, 52), _mm_set1_epi64x(0x4330000000000000LL)));
+	return _mm_sub_pd(exponent, _mm_set1_pd(4503599627370496.0 + 1023.0));
+}
+
+//AVX2 integer operations, comparisons and selections
+__attribute__((target("avx2,fma")))
+static inline __m256d andAVX2(__m256d a, __m256d b)
+{
+	return _mm256_and_pd(a, b);
+}
+
+__attribute__((target("avx2,fma")))
+static inline __m256d andNotAVX2(__m256d a, __m256d b)
+{
+	return _mm256_andnot_pd(a, b);
+}
+
+__attribute__((target("avx2,fma")))
+static inline __m256d orAVX2(__m256d a, __m256d b)
+{
+	return _mm256_or_pd(a, b);
+}
+
+__attribute__((target("avx2,fma")))
+static inline __m256d lessThanAVX2(__m256d a, __m256d b)
+{
+	return _mm256_cmp_pd(a, b, _CMP_LT_OQ);
+}
+
+__attribute__((target("avx2,fma")))
+static inline __m256d greaterThanAVX2(__m256d a, __m256d b)
+{
+	return _mm256_cmp_pd(a, b, _CMP_GT_OQ);
+}
+
+__attribute__((target("avx2,fma")))
+static inline __m256d equalAVX2(__m256d a, __m256d b)
+{
+	return _mm256_cmp_pd(a, b, _CMP_EQ_OQ);
+}
+
+__attribute__((target("avx2,fma")))
+static inline __m256d isNaNAVX2(__m256d a)
+{
+	return _mm256_cmp_pd(a, a, _CMP_UNORD_Q);
+}
+
+__attribute__((target("avx2,fma")))
+static inline __m256d selectAVX2(__m256d mask, __m256d a, __m256d b)
+{
+	return _mm256_blendv_pd(b, a, mask);
+}
+
+__attribute__((target("avx2,fma")))
+static inline void powersOfTwoAVX2(__m256d shifted, __m256d* scale_1, __m256d* scale_2)
+{
+	__m256i n = _mm256_sub_epi64(_mm256_castpd_si256(shifted), _mm256_castpd_si256(_mm256_set1_pd(MATH_SHIFTER)));
+	__m256i n_1 = _mm256_sub_epi64(_mm256_srli_epi64(_mm256_add_epi64(n, _mm256_set1_epi64x(2048)), 1), _mm256_set1_epi64x(1024));
+	__m256i n_2 = _mm256_sub_epi64(n, n_1);
+	*scale_1 = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(n_1, _mm256_set1_epi64x(1023)), 52));
+	*scale_2 = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(n_2, _mm256_set1_epi64x(1023)), 52));
+}
+
+__attribute__((target("avx2,fma")))
+static inline __m256d decomposeAVX2(__m256d x, __m256d* mantissa)
+{
+	__m256i bits = _mm256_castpd_si256(x);
+	*mantissa = _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL)), _mm256_set1_epi64x(0x3FF0000000000000LL)));
+	__m256d exponent = _mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(bits, 52), _mm256_set1_epi64x(0x4330000000000000LL)));
+	return _mm256_sub_pd(exponent, _mm256_set1_pd(4503599627370496.0 + 1023.0));
+}
+
+//AVX-512 integer operations, comparisons and selections, the comparisons return bit masks
+__attribute__((target("avx512f")))
+static inline __m512d andAVX512(__m512d a, __m512d b)
+{
+	return _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(a), _mm512_castpd_si512(b)));
+}
+
+__attribute__((target("avx512f")))
+static inline __m512d andNotAVX512(__m512d a, __m512d b)
+{
+	return _mm512_castsi512_pd(_mm512_andnot_si512(_mm512_castpd_si512(a), _mm512_castpd_si512(b)));
+}
+
+__attribute__((target("avx512f")))
+static inline __m512d orAVX512(__m512d a, __m512d b)
+{
+	return _mm512_castsi512_pd(_mm512_or_si512(_mm512_castpd_si512(a), _mm512_castpd_si512(b)));
+}
+
+__attribute__((target("avx512f")))
+static inline __mmask8 lessThanAVX512(__m512d a, __m512d b)
+{
+	return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ);
+}
+
+__attribute__((target("avx512f")))
+static inline __mmask8 greaterThanAVX512(__m512d a, __m512d b)
+{
+	return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ);
+}
+
+__attribute__((target("avx512f")))
+static inline __mmask8 equalAVX512(__m512d a, __m512d b)
+{
+	return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ);
+}
+
+__attribute__((target("avx512f")))
+static inline __mmask8 isNaNAVX512(__m512d a)
+{
+	return _mm512_cmp_pd_mask(a, a, _CMP_UNORD_Q);
+}
+
+__attribute__((target("avx512f")))
+static inline __m512d selectAVX512(__mmask8 mask, __m512d a, __m512d b)
+{
+	return _mm512_mask_blend_pd(mask, b, a);
+}
+
+__attribute__((target("avx512f")))
+static inline void powersOfTwoAVX512(__m512d shifted, __m512d* scale_1, __m512d* scale_2)
+{
+	__m512i n = _mm512_sub_epi64(_mm512_castpd_si512(shifted), _mm512_castpd_si512(_mm512_set1_pd(MATH_SHIFTER)));
+	__m512i n_1 = _mm512_srai_epi64(n, 1);
+	__m512i n_2 = _mm512_sub_epi64(n, n_1);
+	*scale_1 = _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_add_epi64(n_1, _mm512_set1_epi64(1023)), 52));
+	*scale_2 = _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_add_epi64(n_2, _mm512_set1_epi64(1023)), 52));
+}
+
+__attribute__((target("avx512f")))
+static inline __m512d decomposeAVX512(__m512d x, __m512d* mantissa)
+{
+	__m512i bits = _mm512_castpd_si512(x);
+	*mantissa = _mm512_castsi512_pd(_mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi64(0x000FFFFFFFFFFFFFLL)), _mm512_set1_epi64(0x3FF0000000000000LL)));
+	__m512d exponent = _mm512_castsi512_pd(_mm512_or_si512(_mm512_srli_epi64(bits, 52), _mm512_set1_epi64(0x4330000000000000LL)));
+	return _mm512_sub_pd(exponent, _mm512_set1_pd(4503599627370496.0 + 1023.0));
+}
+
+//Method generating an array method from a vector method, the remaining items are processed in a padded buffer
+#define DEFINE_SIMD_MAP(NAME, FUNCTION, TARGET, WIDTH, LOAD, STORE) \
+	__attribute__((target(TARGET))) \
+	static void FUNCTION##NAME(double* result, double* x, int n) \
+	{ \
+		int i = 0; \
+		for (; i + WIDTH <= n; i += WIDTH) \
+		{ \
+			STORE(result + i, FUNCTION##Vector##NAME(LOAD(x + i))); \
+		} \
+		if (i < n) \
+		{ \
+			double buffer[WIDTH] = {0.0}; \
+			memcpy(buffer, x + i, (n - i) * sizeof(double)); \
+			STORE(buffer, FUNCTION##Vector##NAME(LOAD(buffer))); \
+			memcpy(result + i, buffer, (n - i) * sizeof(double)); \
+		} \
+	}
+
+#define DEFINE_SIMD_MATH_KERNELS(NAME, TARGET, VECTOR, WIDTH, LOAD, STORE, SET1, ADD, SUB, MUL, DIV, FMADD, MIN, MAX, REDUCE) \
+	/* Reduction of the exp : returns q = exp(r) - 1 and the scales whose product is 2^n */ \
+	__attribute__((target(TARGET))) \
+	static inline VECTOR expReduction##NAME(VECTOR x, VECTOR* scale_1, VECTOR* scale_2) \
+	{ \
+		/* The NaN is kept by passing the x as the second operand */ \
+		x = MIN(SET1(MATH_EXP_MAX + 0.01), MAX(SET1(MATH_EXP_MIN), x)); \
+		VECTOR shifted = FMADD(x, SET1(MATH_LOG2_E), SET1(MATH_SHIFTER)); \
+		VECTOR n = SUB(shifted, SET1(MATH_SHIFTER)); \
+		VECTOR r = FMADD(n, SET1(-MATH_LN2_HI), x); \
+		r = FMADD(n, SET1(-MATH_LN2_LO), r); \
+		VECTOR q = SET1(1.0 / 6227020800.0); \
+		q = FMADD(q, r, SET1(1.0 / 479001600.0)); \
+		q = FMADD(q, r, SET1(1.0 / 39916800.0)); \
+		q = FMADD(q, r, SET1(1.0 / 3628800.0)); \
+		q = FMADD(q, r, SET1(1.0 / 362880.0)); \
+		q = FMADD(q, r, SET1(1.0 / 40320.0)); \
+		q = FMADD(q, r, SET1(1.0 / 5040.0)); \
+		q = FMADD(q, r, SET1(1.0 / 720.0)); \
+		q = FMADD(q, r, SET1(1.0 / 120.0)); \
+		q = FMADD(q, r, SET1(1.0 / 24.0)); \
+		q = FMADD(q, r, SET1(1.0 / 6.0)); \
+		q = FMADD(q, r, SET1(0.5)); \
+		q = FMADD(q, r, SET1(1.0)); \
+		powersOfTwo##NAME(shifted, scale_1, scale_2); \
+		return MUL(q, r); \
+	} \
+	__attribute__((target(TARGET))) \
+	static inline VECTOR expVector##NAME(VECTOR x) \
+	{ \
+		VECTOR scale_1, scale_2; \
+		VECTOR q = expReduction##NAME(x, &scale_1, &scale_2); \
+		VECTOR y = MUL(FMADD(scale_1, q, scale_1), scale_2); \
+		y = select##NAME(greaterThan##NAME(x, SET1(MATH_EXP_MAX)), SET1(INFINITY), y); \
+		return select##NAME(lessThan##NAME(x, SET1(MATH_EXP_MIN)), SET1(0.0), y); \
+	} \
+	__attribute__((target(TARGET))) \
+	static inline VECTOR logVector##NAME(VECTOR x) \
+	{ \
+		/* Scale the subnormal x into the normal range */ \
+		VECTOR subnormal = select##NAME(lessThan##NAME(x, SET1(2.2250738585072014e-308)), SET1(52.0), SET1(0.0)); \
+		VECTOR m; \
+		VECTOR e = decompose##NAME(select##NAME(greaterThan##NAME(subnormal, SET1(0.0)), MUL(x, SET1(4503599627370496.0)), x), &m); \
+		e = SUB(e, subnormal); \
+		/* Move the m into [sqrt(2) / 2, sqrt(2)) */ \
+		VECTOR large = select##NAME(greaterThan##NAME(m, SET1(MATH_SQRT2)), SET1(1.0), SET1(0.0)); \
+		m = MUL(m, SUB(SET1(1.0), MUL(large, SET1(0.5)))); \
+		e = ADD(e, large); \
+		VECTOR f = SUB(m, SET1(1.0)); \
+		VECTOR s = DIV(f, ADD(SET1(2.0), f)); \
+		VECTOR z = MUL(s, s); \
+		VECTOR w = MUL(z, z); \
+		VECTOR t_1 = MUL(w, FMADD(w, FMADD(w, SET1(1.531383769920937332e-01), SET1(2.222219843214978396e-01)), SET1(3.999999999940941908e-01))); \
+		VECTOR t_2 = MUL(z, FMADD(w, FMADD(w, FMADD(w, SET1(1.479819860511658591e-01), SET1(1.818357216161805012e-01)), SET1(2.857142874366239149e-01)), SET1(6.666666666666735130e-01))); \
+		VECTOR R = ADD(t_1, t_2); \
+		VECTOR half_f_squared = MUL(MUL(SET1(0.5), f), f); \
+		/* log(x) = e * ln(2) + f - (half_f_squared - s * (half_f_squared + R)) */ \
+		VECTOR y = FMADD(s, ADD(half_f_squared, R), MUL(e, SET1(MATH_LN2_LO))); \
+		y = SUB(MUL(e, SET1(MATH_LN2_HI)), SUB(SUB(half_f_squared, y), f)); \
+		/* Special values */ \
+		y = select##NAME(equal##NAME(x, SET1(INFINITY)), SET1(INFINITY), y); \
+		y = select##NAME(lessThan##NAME(x, SET1(0.0)), SET1(NAN), y); \
+		y = select##NAME(equal##NAME(x, SET1(0.0)), SET1(-INFINITY), y); \
+		return select##NAME(isNaN##NAME(x), x, y); \
+	} \
+	__attribute__((target(TARGET))) \
+	static inline VECTOR sigmoidVector##NAME(VECTOR x) \
+	{ \
+		return DIV(SET1(1.0), ADD(SET1(1.0), expVector##NAME(SUB(SET1(0.0), x)))); \
+	} \
+	__attribute__((target(TARGET))) \
+	static inline VECTOR tanhVector##NAME(VECTOR x) \
+	{ \
+		/* tanh(|x|) rounds to 1 for |x| > 20, and the sign of the x is restored at the end */ \
+		VECTOR sign = and##NAME(x, SET1(-0.0)); \
+		VECTOR absolute = MIN(SET1(20.0), andNot##NAME(SET1(-0.0), x)); \
+		VECTOR scale_1, scale_2; \
+		VECTOR q = expReduction##NAME(ADD(absolute, absolute), &scale_1, &scale_2); \
+		VECTOR scale = MUL(scale_1, scale_2); \
+		VECTOR expm1 = FMADD(scale, q, SUB(scale, SET1(1.0))); \
+		return or##NAME(DIV(expm1, ADD(expm1, SET1(2.0))), sign); \
+	} \
+	DEFINE_SIMD_MAP(NAME, exp, TARGET, WIDTH, LOAD, STORE) \
+	DEFINE_SIMD_MAP(NAME, log, TARGET, WIDTH, LOAD, STORE) \
+	DEFINE_SIMD_MAP(NAME, sigmoid, TARGET, WIDTH, LOAD, STORE) \
+	DEFINE_SIMD_MAP(NAME, tanh, TARGET, WIDTH, LOAD, STORE) \
+	__attribute__((target(TARGET))) \
+	static void softmax##NAME(double* result, double* x, int n) \
+	{ \
+		double max_x = x[0]; \
+		for (int i = 1; i < n; i++) \
+		{ \
+			max_x = (x[i] > max_x) ? x[i] : max_x; \
+		} \
+		/* exp(x - max) into the result, the padding items are -inf so they don't change the sum */ \
+		VECTOR max_vector = SET1(max_x); \
+		VECTOR sum_vector = SET1(0.0); \
+		int i = 0; \
+		for (; i + WIDTH <= n; i += WIDTH) \
+		{ \
+			VECTOR e = expVector##NAME(SUB(LOAD(x + i), max_vector)); \
+			sum_vector = ADD(sum_vector, e); \
+			STORE(result + i, e); \
+		} \
+		if (i < n) \
+		{ \
+			double buffer[WIDTH]; \
+			for (int j = 0; j < WIDTH; j++) \
+			{ \
+				buffer[j] = (i + j < n) ? x[i + j] : -INFINITY; \
+			} \
+			VECTOR e = expVector##NAME(SUB(LOAD(buffer), max_vector)); \
+			sum_vector = ADD(sum_vector, e); \
+			STORE(buffer, e); \
+			memcpy(result + i, buffer, (n - i) * sizeof(double)); \
+		} \
+		/* Divide by the sum */ \
+		double sum = REDUCE(sum_vector); \
+		VECTOR sum_broadcast = SET1(sum); \
+		for (i = 0; i + WIDTH <= n; i += WIDTH) \
+		{ \
+			STORE(result + i, DIV(LOAD(result + i), sum_broadcast)); \
+		} \
+		for (; i < n; i++) \
+		{ \
+			result[i] /= sum; \
+		} \
+	} \
+	static const VectorKernels kernels_##NAME = {axpy##NAME, dot##NAME, addition##NAME, subtraction##NAME, scalarMultiplication##NAME, \
+			exp##NAME, log##NAME, sigmoid##NAME, tanh##NAME, softmax##NAME, sum##NAME, moments##NAME};
+
+DEFINE_SIMD_MATH_KERNELS(SSE2, "sse2", __m128d, 2, _mm_loadu_pd, _mm_storeu_pd, _mm_set1_pd,
+		_mm_add_pd, _mm_sub_pd, _mm_mul_pd, _mm_div_pd, FMADD_SSE2, _mm_min_pd, _mm_max_pd, reduceSSE2)
+
+DEFINE_SIMD_MATH_KERNELS(AVX2, "avx2,fma", __m256d, 4, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_set1_pd,
+		_mm256_add_pd, _mm256_sub_pd, _mm256_mul_pd, _mm256_div_pd, _mm256_fmadd_pd, _mm256_min_pd, _mm256_max_pd, reduceAVX2)
+
+DEFINE_SIMD_MATH_KERNELS(AVX512, "avx512f", __m512d, 8, _mm512_loadu_pd, _mm512_storeu_pd, _mm512_set1_pd,
+		_mm512_add_pd, _mm512_sub_pd, _mm512_mul_pd, _mm512_div_pd, _mm512_fmadd_pd, _mm512_min_pd, _mm512_max_pd, reduceAVX512)
+
+#endif //VECTOR_KERNELS_X86
+
+/**
+ * Selection of the kernels
+ */
+
+//Kernels in use and their instruction set
+static const VectorKernels* kernels = &kernels_scalar;
+static InstructionSet kernels_instruction_set = INSTRUCTION_SET_SCALAR;
+
+//Static method to find the widest instruction set supported by the processor
+static InstructionSet supportedInstructionSet(void)
+{
+#ifdef VECTOR_KERNELS_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+	{
+		return INSTRUCTION_SET_AVX512;
+	}
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+	{
+		return INSTRUCTION_SET_AVX2;
+	}
+	if (__builtin_cpu_supports("sse2"))
+	{
+		return INSTRUCTION_SET_SSE2;
+	}
+#endif
+	return INSTRUCTION_SET_SCALAR;
+}
+
+//Method to select the kernels of an instruction set
+void setInstructionSet(InstructionSet instruction_set)
+{
+	//Lower the instruction set to the supported one
+	InstructionSet supported = supportedInstructionSet();
+	if (instruction_set > supported)
+	{
+		instruction_set = supported;
+	}
+	//Select the table of the instruction set
+	kernels_instruction_set = instruction_set;
+	kernels = &kernels_scalar;
+#ifdef VECTOR_KERNELS_X86
+	if (instruction_set == INSTRUCTION_SET_AVX512)
+	{
+		kernels = &kernels_AVX512;
+	}
+	else if (instruction_set == INSTRUCTION_SET_AVX2)
+	{
+		kernels = &kernels_AVX2;
+	}
+	else if (instruction_set == INSTRUCTION_SET_SSE2)
+	{
+		kernels = &kernels_SSE2;
+	}
+#endif
+}
+
+//Static method to select the widest supported kernels when the library is loaded
+__attribute__((constructor))
+static void selectKernels(void)
+{
+	setInstructionSet(INSTRUCTION_SET_AVX512);
+}
+
+//Method to get the instruction set of the selected kernels
+InstructionSet getInstructionSet(void)
+{
+	return kernels_instruction_set;
+}
+
+/**
+ * Public methods forward to the selected kernels
+ */
+
+//Method for y = alpha * x + y
+void vectorAxpy(double alpha, double* x, double* y, int n)
+{
+	kernels->axpy(alpha, x, y, n);
+}
+
+//Method for x = alpha * x
+void vectorScal(double alpha, double* x, int n)
+{
+	kernels->scalarMultiplication(x, x, n, alpha);
+}
+
+//Method for the dot product of two vectors
+double vectorDot(double* x, double* y, int n)
+{
+	return kernels->dot(x, y, n);
+}
+
+//Method for the Euclidean norm of a vector
+double vectorNrm2(double* x, int n)
+{
+	return sqrt(kernels->dot(x, x, n));
+}
+
+//Method for the compensated sum of a vector
+double vectorSum(double* x, int n)
+{
+	return kernels->sum(x, n);
+}
+
+//Method for the moments of a vector in a single pass
+VectorMoments vectorMoments(double* x, int n)
+{
+	VectorMoments moments;
+	kernels->moments(x, n, &moments);
+	return moments;
+}
+
+//Method to merge the moments of two vectors
+VectorMoments mergeVectorMoments(VectorMoments a, VectorMoments b)
+{
+	VectorMoments merged;
+	merged.min = (b.min < a.min) ? b.min : a.min;
+	merged.max = (b.max > a.max) ? b.max : a.max;
+	merged.sum = a.sum + b.sum;
+	merged.sum_of_squares = a.sum_of_squares + b.sum_of_squares;
+	return merged;
+}
+
+//Method for result = a + b
+void vectorAdditionInto(double* result, double* a, double* b, int n)
+{
+	kernels->addition(result, a, b, n);
+}
+
+//Method for result = a - b
+void vectorSubtractionInto(double* result, double* a, double* b, int n)
+{
+	kernels->subtraction(result, a, b, n);
+}
+
+//Method for result = scalar * vector
+void vectorScalarMultiplicationInto(double* result, double* vector, int n, double scalar)
+{
+	kernels->scalarMultiplication(result, vector, n, scalar);
+}
+
+//Method for result = exp(x)
+void vectorExp(double* result, double* x, int n)
+{
+	kernels->exp(result, x, n);
+}
+
+//Method for result = log(x)
+void vectorLog(double* result, double* x, int n)
+{
+	kernels->log(result, x, n);
+}
+
+//Method for result = sigmoid(x)
+void vectorSigmoid(double* result, double* x, int n)
+{
+	kernels->sigmoid(result, x, n);
+}
+
+//Method for result = tanh(x)
+void vectorTanh(double* result, double* x, int n)
+{
+	kernels->tanh(result, x, n);
+}
+
+//Method for result = softmax(x)
+void vectorSoftmax(double* result, double* x, int n)
+{
+	kernels->softmax(result, x, n);
+}
@@ -0,0 +1,128 @@
+//Workspace class of LibBQsC by Berkay
+
+#include "../../include/core/workspace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../include/core/allocation.h"
+
+/**
+ * Sizes are rounded up to a multiple of MATRIX_ALIGNMENT, so every piece carved from the
+ * aligned buffer is aligned as well. An overflow allocation keeps the pointer to the next
+ * one in its first aligned block, and the memory returned begins after that block.
+ */
+
+//Static method to round a size up to a multiple of the alignment
+static size_t alignSize(size_t size)
+{
+	return ((size + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT) * MATRIX_ALIGNMENT;
+}
+
+//Static method to allocate an aligned block and handle any allocation failure
+static char* allocateBlock(size_t size)
+{
+	char* block = (char*) allocateAlignedMemory(MATRIX_ALIGNMENT, (size > 0) ? size : MATRIX_ALIGNMENT);
+	if (block == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	return block;
+}
+
+//Method to initialize a Workspace
+Workspace* initWorkspace(size_t capacity)
+{
+	//Initialize the Workspace and handle any allocation failure
+	Workspace* workspace = allocateMemory(sizeof(Workspace));
+	if (workspace == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	//Allocate the buffer
+	workspace->capacity = alignSize(capacity);
+	workspace->buffer = (workspace->capacity > 0) ? allocateBlock(workspace->capacity) : NULL;
+	workspace->offset = 0;
+	workspace->requested = 0;
+	workspace->overflow = NULL;
+	//Return the Workspace
+	return workspace;
+}
+
+//Method to carve memory from a Workspace
+void* workspaceAllocate(Workspace* workspace, size_t size)
+{
+	size = alignSize(size);
+	workspace->requested += size;
+	//Carve the memory from the buffer if it fits
+	if (workspace->offset + size <= workspace->capacity)
+	{
+		void* memory = workspace->buffer + workspace->offset;
+		workspace->offset += size;
+		return memory;
+	}
+	//Allocate it separately otherwise and add it to the overflow list
+	char* block = allocateBlock(MATRIX_ALIGNMENT + size);
+	*(void**) block = workspace->overflow;
+	workspace->overflow = block;
+	return block + MATRIX_ALIGNMENT;
+}
+
+//Method to carve a vector from a Workspace
+double* workspaceVector(Workspace* workspace, int n)
+{
+	return (double*) workspaceAllocate(workspace, (size_t) n * sizeof(double));
+}
+
+//Method to carve a Matrix from a Workspace
+Matrix* workspaceMatrix(Workspace* workspace, int rows, int columns)
+{
+	//Carve the struct and the buffer of the items
+	Matrix* M = (Matrix*) workspaceAllocate(workspace, sizeof(Matrix));
+	M->data = workspaceVector(workspace, rows * columns);
+	M->rows = rows;
+	M->columns = columns;
+	M->stride = columns;
+	//Return the Matrix
+	return M;
+}
+
+//Method to release all of the memory carved from a Workspace
+void resetWorkspace(Workspace* workspace)
+{
+	//Grow the buffer if some of the memory didn't fit in it
+	if (workspace->overflow != NULL)
+	{
+		while (workspace->overflow != NULL)
+		{
+			void* next = *(void**) workspace->overflow;
+			free(workspace->overflow);
+			workspace->overflow = next;
+		}
+		free(workspace->buffer);
+		workspace->capacity = workspace->requested;
+		workspace->buffer = allocateBlock(workspace->capacity);
+	}
+	//Release the memory carved from the buffer
+	workspace->offset = 0;
+	workspace->requested = 0;
+}
+
+//Method to dispose a Workspace
+void disposeWorkspace(Workspace* workspace)
+{
+	//Dispose the overflow allocations and the buffer
+	while (workspace->overflow != NULL)
+	{
+		void* next = *(void**) workspace->overflow;
+		free(workspace->overflow);
+		workspace->overflow = next;
+	}
+	free(workspace->buffer);
+	workspace->buffer = NULL;
+	//Dispose the Workspace itself
+	free(workspace);
+	workspace = NULL;
+}
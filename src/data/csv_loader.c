@@ -0,0 +1,794 @@
+//CSV loader class of LibBQsC by Berkay
+
+//madvise() and its advices aren't declared under a strict C standard without it
+#define _DEFAULT_SOURCE
+
+#include "../../include/data/csv_loader.h"
+
+#include <fcntl.h>
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../../include/core/allocation.h"
+#include "../../include/core/thread_pool.h"
+
+//Smallest chunk a thread parses in bytes, smaller files are parsed by fewer threads
+#define CSV_MINIMUM_CHUNK (1 << 20)
+
+//Longest field passed to strtod() in bytes
+#define CSV_MAXIMUM_FIELD 64
+
+//Targets of the columns of a file other than the indices of the X
+#define CSV_SKIP -1
+#define CSV_LABEL -2
+
+//Powers of ten that are exact in a double
+static const double csv_powers_of_ten[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/**
+ * State of a CSV file being loaded, shared by the threads
+ */
+typedef struct
+{
+	//Options and the number of columns of the file
+	CSVOptions options;
+	int columns;
+	//Target of each column of the file : an index of the X, CSV_LABEL or CSV_SKIP
+	int* targets;
+	//Boundaries of the chunks, the chunk i is between the boundaries i and i + 1
+	const char** boundaries;
+	//Number of rows in each chunk and the row at which each chunk begins
+	long* rows;
+	long* offsets;
+	//Loaded features and labels, Y is NULL if the labels aren't loaded
+	Matrix* X;
+	Matrix* Y;
+}
+CSVLoader;
+
+/**
+ * State of a libsvm file being loaded, shared by the threads
+ */
+typedef struct
+{
+	//Number of features requested, 0 for the largest index in the file, and the number of classes of the labels
+	int features;
+	int one_hot_classes;
+	//Boundaries of the chunks, the chunk i is between the boundaries i and i + 1
+	const char** boundaries;
+	//Number of rows and nonzero items in each chunk, and the row and the nonzero item at which each chunk begins
+	long* rows;
+	long* nonzeros;
+	long* offsets;
+	long* nonzero_offsets;
+	//Largest feature index in each chunk
+	int* maximum_indices;
+	//Loaded features and labels, Y is NULL if the labels aren't loaded
+	SparseMatrix* X;
+	Matrix* Y;
+}
+LibSVMLoader;
+
+//Method to get the default options of loading a CSV file
+CSVOptions defaultCSVOptions(void)
+{
+	CSVOptions options = {',', 1, NULL, 0, -1, 0, 0};
+	return options;
+}
+
+//Static method to exit with a message if a row of the file is invalid
+static void invalidRow(const char* message, long row_no)
+{
+	printf("Invalid file : %s on the row %ld", message, row_no + 1);
+	exit(EXIT_FAILURE);
+}
+
+//Static method to find the end of the line beginning at a position and the beginning of the next line
+static const char* lineEnd(const char* line, const char* end, const char** next)
+{
+	const char* line_break = memchr(line, '\n', end - line);
+	*next = (line_break != NULL) ? line_break + 1 : end;
+	const char* content_end = (line_break != NULL) ? line_break : end;
+	//Leave out the carriage return of a Windows line break
+	if (content_end > line && content_end[-1] == '\r')
+	{
+		content_end--;
+	}
+	return content_end;
+}
+
+//Static method to map a file read-only, it is read once from the beginning to the end by each thread
+static char* mapFile(const char* path, const char* format, size_t* size)
+{
+	//Open the file and get its size
+	int descriptor = open(path, O_RDONLY);
+	struct stat status;
+	if (descriptor < 0 || fstat(descriptor, &status) != 0)
+	{
+		printf("Failed to open the %s file", format);
+		exit(EXIT_FAILURE);
+	}
+	*size = (size_t) status.st_size;
+	if (*size == 0)
+	{
+		printf("Invalid %s file : the file is empty", format);
+		exit(EXIT_FAILURE);
+	}
+	//Map the file
+	char* mapping = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	close(descriptor);
+	if (mapping == MAP_FAILED)
+	{
+		printf("Failed to map the %s file", format);
+		exit(EXIT_FAILURE);
+	}
+	madvise(mapping, *size, MADV_SEQUENTIAL);
+	return mapping;
+}
+
+//Static method to split the lines between two positions into a chunk for each thread, each chunk ends after a line break
+static const char** splitChunks(const char* start, const char* end, int* threads)
+{
+	//Use fewer threads than requested for the small files, 0 threads are the number of processors
+	*threads = (*threads > 0) ? *threads : getNumberOfProcessors();
+	long chunks = (long) ((end - start) / CSV_MINIMUM_CHUNK) + 1;
+	*threads = (chunks < *threads) ? (int) chunks : *threads;
+	const char** boundaries = allocateMemory((*threads + 1) * sizeof(char*));
+	if (boundaries == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	boundaries[0] = start;
+	boundaries[*threads] = end;
+	for (int thread_no = 1; thread_no < *threads; thread_no++)
+	{
+		const char* boundary = start + (end - start) / *threads * thread_no;
+		boundary = (boundary < boundaries[thread_no - 1]) ? boundaries[thread_no - 1] : boundary;
+		if (boundary > start && boundary[-1] != '\n')
+		{
+			lineEnd(boundary, end, &boundary);
+		}
+		boundaries[thread_no] = boundary;
+	}
+	return boundaries;
+}
+
+//Static method to parse a number with strtod() when the fast path can't
+static const char* parseNumberSlow(const char* position, const char* end, char delimiter, double* value, long row_no)
+{
+	//Copy the field, the mapping isn't terminated by a zero
+	char field[CSV_MAXIMUM_FIELD];
+	int length = 0;
+	while (position + length < end && position[length] != delimiter && position[length] != ' ' && position[length] != '\t')
+	{
+		if (length == CSV_MAXIMUM_FIELD - 1)
+		{
+			invalidRow("too long field", row_no);
+		}
+		field[length] = position[length];
+		length++;
+	}
+	field[length] = '\0';
+	char* parsed;
+	*value = strtod(field, &parsed);
+	if (length == 0 || parsed != field + length)
+	{
+		invalidRow("not a number", row_no);
+	}
+	return position + length;
+}
+
+/**
+ * The fast path reads the significant digits into a 64-bit integer and the position of the decimal point
+ * into a power of ten. If the integer is at most 2^53 and the power is at most 22 in magnitude, both are
+ * exact doubles and a single multiplication or division gives the correctly rounded number.
+ *
+ * The integers of up to 19 digits, e.g. the ones written by "%.17g", are exact in the 64-bit significand
+ * of the x87 long double. The single operation in the long double is correctly rounded to 64 bits, and
+ * rounding that to a double gives the correctly rounded number unless the long double is exactly halfway
+ * between two doubles, i.e. its 11 bits beyond the double are 10000000000. Only that case and the numbers
+ * out of the both ranges are passed to strtod().
+ */
+
+#if LDBL_MANT_DIG == 64 && (defined(__x86_64__) || defined(__i386__))
+#define CSV_EXTENDED_PRECISION 1
+
+//Static method to convert the digits and the power of ten through a long double, 0 if strtod() is needed
+static int convertExtended(uint64_t mantissa, int exponent, double* value)
+{
+	long double number = (long double) mantissa;
+	number = (exponent < 0) ? number / csv_powers_of_ten[-exponent] : number * csv_powers_of_ten[exponent];
+	//The significand of the x87 long double is in its first 8 bytes
+	uint64_t significand;
+	memcpy(&significand, &number, sizeof(uint64_t));
+	if ((significand & 0x7FF) == 0x400)
+	{
+		return 0;
+	}
+	*value = (double) number;
+	return 1;
+}
+#endif
+
+//Static method to parse a number and return the position after it
+static const char* parseNumber(const char* position, const char* end, char delimiter, double* value, long row_no)
+{
+	const char* begin = position;
+	//Sign
+	int negative = 0;
+	if (position < end && (*position == '-' || *position == '+'))
+	{
+		negative = (*position == '-');
+		position++;
+	}
+	//Digits of the integer and the fractional parts
+	uint64_t mantissa = 0;
+	int significant_digits = 0;
+	int digits = 0;
+	int exponent = 0;
+	while (position < end && (unsigned) (*position - '0') < 10)
+	{
+		if (significant_digits < 19)
+		{
+			mantissa = mantissa * 10 + (*position - '0');
+			significant_digits += (mantissa != 0);
+		}
+		else
+		{
+			significant_digits++;
+		}
+		digits++;
+		position++;
+	}
+	if (position < end && *position == '.')
+	{
+		position++;
+		while (position < end && (unsigned) (*position - '0') < 10)
+		{
+			if (significant_digits < 19)
+			{
+				mantissa = mantissa * 10 + (*position - '0');
+				significant_digits += (mantissa != 0);
+				exponent--;
+			}
+			else
+			{
+				significant_digits++;
+			}
+			digits++;
+			position++;
+		}
+	}
+	//Exponent
+	if (digits > 0 && position < end && (*position == 'e' || *position == 'E'))
+	{
+		position++;
+		int negative_exponent = 0;
+		if (position < end && (*position == '-' || *position == '+'))
+		{
+			negative_exponent = (*position == '-');
+			position++;
+		}
+		if (position == end || (unsigned) (*position - '0') >= 10)
+		{
+			return parseNumberSlow(begin, end, delimiter, value, row_no);
+		}
+		int written_exponent = 0;
+		while (position < end && (unsigned) (*position - '0') < 10)
+		{
+			written_exponent = (written_exponent < 10000) ? written_exponent * 10 + (*position - '0') : written_exponent;
+			position++;
+		}
+		exponent += negative_exponent ? -written_exponent : written_exponent;
+	}
+	//Fall back to strtod() for the words, the long numbers and the large exponents
+	if (digits == 0 || significant_digits > 19 || exponent < -22 || exponent > 22)
+	{
+		return parseNumberSlow(begin, end, delimiter, value, row_no);
+	}
+	double number;
+	if (mantissa <= (1ULL << 53))
+	{
+		number = (double) mantissa;
+		number = (exponent < 0) ? number / csv_powers_of_ten[-exponent] : number * csv_powers_of_ten[exponent];
+	}
+#ifdef CSV_EXTENDED_PRECISION
+	else if (convertExtended(mantissa, exponent, &number) == 0)
+	{
+		return parseNumberSlow(begin, end, delimiter, value, row_no);
+	}
+#else
+	else
+	{
+		return parseNumberSlow(begin, end, delimiter, value, row_no);
+	}
+#endif
+	*value = negative ? -number : number;
+	return position;
+}
+
+//Static method to skip the spaces and tabs around a field
+static const char* skipSpaces(const char* position, const char* end)
+{
+	while (position < end && (*position == ' ' || *position == '\t'))
+	{
+		position++;
+	}
+	return position;
+}
+
+//Static method to count the fields of a line
+static int countFields(const char* line, const char* end, char delimiter)
+{
+	int fields = 1;
+	for (const char* position = line; position < end; position++)
+	{
+		fields += (*position == delimiter);
+	}
+	return fields;
+}
+
+//Static method to store a label into a row of the Y, one-hot encoded if there are classes to encode it into
+static void storeLabel(double* y, double value, int one_hot_classes, long row_no)
+{
+	if (one_hot_classes == 0)
+	{
+		y[0] = value;
+		return;
+	}
+	//One-hot encode the label
+	if (!(value >= 0.0 && value < one_hot_classes) || value != (int) value)
+	{
+		invalidRow("label out of the classes", row_no);
+	}
+	int label = (int) value;
+	memset(y, 0, one_hot_classes * sizeof(double));
+	y[label] = 1.0;
+}
+
+//Static method to parse a line into a row of the X and a row of the Y
+static void parseRow(CSVLoader* loader, const char* line, const char* end, long row_no)
+{
+	char delimiter = loader->options.delimiter;
+	double* x = MATRIX_ROW(loader->X, row_no);
+	double* y = (loader->Y != NULL) ? MATRIX_ROW(loader->Y, row_no) : NULL;
+	const char* position = line;
+	for (int column_no = 0; column_no < loader->columns; column_no++)
+	{
+		int target = loader->targets[column_no];
+		if (target == CSV_SKIP)
+		{
+			//Jump to the next delimiter without parsing the field
+			const char* next = memchr(position, delimiter, end - position);
+			position = (next != NULL) ? next : end;
+		}
+		else
+		{
+			//An empty field is NaN
+			double value = NAN;
+			position = skipSpaces(position, end);
+			if (position < end && *position != delimiter)
+			{
+				position = parseNumber(position, end, delimiter, &value, row_no);
+				position = skipSpaces(position, end);
+			}
+			if (target >= 0)
+			{
+				x[target] = value;
+			}
+			else
+			{
+				storeLabel(y, value, loader->options.one_hot_classes, row_no);
+			}
+		}
+		//Each field except the last one is followed by a delimiter, and the last one by the end of the line
+		if (column_no < loader->columns - 1)
+		{
+			if (position == end || *position != delimiter)
+			{
+				invalidRow((position == end) ? "too few fields" : "not a number", row_no);
+			}
+			position++;
+		}
+		else if (position != end)
+		{
+			invalidRow((*position == delimiter) ? "too many fields" : "not a number", row_no);
+		}
+	}
+}
+
+//Static method run by each thread to count the rows of its chunk
+static void countRowsCSV(void* argument, int thread_no)
+{
+	CSVLoader* loader = argument;
+	const char* end = loader->boundaries[thread_no + 1];
+	long rows = 0;
+	const char* next;
+	for (const char* line = loader->boundaries[thread_no]; line < end; line = next)
+	{
+		rows += (lineEnd(line, end, &next) > line);
+	}
+	loader->rows[thread_no] = rows;
+}
+
+//Static method run by each thread to parse the rows of its chunk
+static void parseRowsCSV(void* argument, int thread_no)
+{
+	CSVLoader* loader = argument;
+	const char* end = loader->boundaries[thread_no + 1];
+	long row_no = loader->offsets[thread_no];
+	const char* next;
+	for (const char* line = loader->boundaries[thread_no]; line < end; line = next)
+	{
+		const char* content_end = lineEnd(line, end, &next);
+		if (content_end > line)
+		{
+			parseRow(loader, line, content_end, row_no);
+			row_no++;
+		}
+	}
+}
+
+//Static method to map the targets of the columns from the options
+static void mapColumns(CSVLoader* loader, int* features, int load_labels)
+{
+	CSVOptions* options = &loader->options;
+	int columns = loader->columns;
+	int label_column = (options->label_column == -1) ? columns - 1 : options->label_column;
+	if (label_column < -2 || label_column >= columns || options->one_hot_classes < 0)
+	{
+		printf("Invalid label column");
+		exit(EXIT_FAILURE);
+	}
+	//Skip the columns that are neither features nor the label
+	for (int column_no = 0; column_no < columns; column_no++)
+	{
+		loader->targets[column_no] = CSV_SKIP;
+	}
+	if (label_column >= 0 && load_labels == 1)
+	{
+		loader->targets[label_column] = CSV_LABEL;
+	}
+	//Either the selected columns in their order or all columns except the label
+	if (options->feature_columns != NULL)
+	{
+		for (int feature_no = 0; feature_no < options->number_of_features; feature_no++)
+		{
+			int column_no = options->feature_columns[feature_no];
+			if (column_no < 0 || column_no >= columns || column_no == label_column || loader->targets[column_no] != CSV_SKIP)
+			{
+				printf("Invalid feature columns");
+				exit(EXIT_FAILURE);
+			}
+			loader->targets[column_no] = feature_no;
+		}
+		*features = options->number_of_features;
+	}
+	else
+	{
+		*features = 0;
+		for (int column_no = 0; column_no < columns; column_no++)
+		{
+			if (column_no != label_column)
+			{
+				loader->targets[column_no] = (*features)++;
+			}
+		}
+	}
+	if (*features == 0)
+	{
+		printf("Invalid feature columns");
+		exit(EXIT_FAILURE);
+	}
+}
+
+//Method to load a CSV file into a feature matrix and a label matrix
+void loadCSV(const char* path, CSVOptions* options, Matrix** X, Matrix** Y)
+{
+	//Map the file
+	size_t size;
+	char* mapping = mapFile(path, "CSV", &size);
+	//Skip the header and the empty lines before the first row, which gives the number of columns
+	CSVLoader loader;
+	loader.options = (options != NULL) ? *options : defaultCSVOptions();
+	const char* end = mapping + size;
+	const char* start = mapping;
+	const char* next;
+	if (loader.options.header == 1)
+	{
+		lineEnd(start, end, &next);
+		start = next;
+	}
+	const char* first_end = lineEnd(start, end, &next);
+	while (first_end == start && next < end)
+	{
+		start = next;
+		first_end = lineEnd(start, end, &next);
+	}
+	if (first_end == start)
+	{
+		printf("Invalid CSV file : the file has no rows");
+		exit(EXIT_FAILURE);
+	}
+	loader.columns = countFields(start, first_end, loader.options.delimiter);
+	//Map the columns to the X and the Y
+	int features;
+	int* targets = allocateMemory(loader.columns * sizeof(int));
+	if (targets == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	loader.targets = targets;
+	mapColumns(&loader, &features, Y != NULL);
+	//Split the rows into a chunk for each thread
+	int threads = loader.options.threads;
+	const char** boundaries = splitChunks(start, end, &threads);
+	long* rows = allocateMemory(threads * sizeof(long));
+	long* offsets = allocateMemory(threads * sizeof(long));
+	if (rows == NULL || offsets == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	loader.boundaries = boundaries;
+	loader.rows = rows;
+	loader.offsets = offsets;
+	//Count the rows of the chunks
+	ThreadPool* pool = (threads > 1) ? initThreadPool(threads) : NULL;
+	if (pool != NULL)
+	{
+		runThreadPool(pool, countRowsCSV, &loader);
+	}
+	else
+	{
+		countRowsCSV(&loader, 0);
+	}
+	long total_rows = 0;
+	for (int thread_no = 0; thread_no < threads; thread_no++)
+	{
+		offsets[thread_no] = total_rows;
+		total_rows += rows[thread_no];
+	}
+	if (total_rows > INT32_MAX)
+	{
+		printf("Invalid CSV file : too many rows");
+		exit(EXIT_FAILURE);
+	}
+	//Allocate the X and the Y once and parse the chunks straight into them
+	int load_labels = (Y != NULL && loader.options.label_column != -2);
+	loader.X = createMatrix((int) total_rows, features);
+	loader.Y = load_labels ? createMatrix((int) total_rows, (loader.options.one_hot_classes > 0) ? loader.options.one_hot_classes : 1) : NULL;
+	if (pool != NULL)
+	{
+		runThreadPool(pool, parseRowsCSV, &loader);
+		disposeThreadPool(pool);
+	}
+	else
+	{
+		parseRowsCSV(&loader, 0);
+	}
+	//Assign the loaded matrices and dispose the rest
+	*X = loader.X;
+	if (Y != NULL)
+	{
+		*Y = loader.Y;
+	}
+	munmap(mapping, size);
+	free(targets);
+	free(boundaries);
+	free(rows);
+	free(offsets);
+}
+
+//Static method to find the end of the content of a libsvm line, which leaves out a comment beginning with '#'
+static const char* contentEndLibSVM(const char* line, const char* end, const char** next)
+{
+	const char* content_end = lineEnd(line, end, next);
+	const char* comment = (content_end > line) ? memchr(line, '#', content_end - line) : NULL;
+	return (comment != NULL) ? comment : content_end;
+}
+
+//Static method to parse a libsvm line into a row of the X and a row of the Y, returns the index of the next nonzero item
+static long parseRowLibSVM(LibSVMLoader* loader, const char* line, const char* end, long row_no, long index, int* maximum_index)
+{
+	SparseMatrix* X = loader->X;
+	//The label is the first field
+	double label;
+	const char* position = parseNumber(skipSpaces(line, end), end, ' ', &label, row_no);
+	if (position < end && *position != ' ' && *position != '\t')
+	{
+		invalidRow("not a number", row_no);
+	}
+	if (loader->Y != NULL)
+	{
+		storeLabel(MATRIX_ROW(loader->Y, row_no), label, loader->one_hot_classes, row_no);
+	}
+	//The index:value pairs follow it with the 1-based indices in the ascending order
+	long previous = 0;
+	for (position = skipSpaces(position, end); position < end; position = skipSpaces(position, end))
+	{
+		long feature = 0;
+		const char* digits = position;
+		while (position < end && (unsigned) (*position - '0') < 10)
+		{
+			feature = (feature <= INT32_MAX) ? feature * 10 + (*position - '0') : feature;
+			position++;
+		}
+		if (position == digits || position == end || *position != ':')
+		{
+			invalidRow("not an index:value pair", row_no);
+		}
+		if (feature == 0 || feature > INT32_MAX)
+		{
+			invalidRow("feature index out of the range", row_no);
+		}
+		if (feature <= previous)
+		{
+			invalidRow("feature indices not in the ascending order", row_no);
+		}
+		if (loader->features > 0 && feature > loader->features)
+		{
+			invalidRow("feature index out of the features", row_no);
+		}
+		double value;
+		position = parseNumber(position + 1, end, ' ', &value, row_no);
+		if (position < end && *position != ' ' && *position != '\t')
+		{
+			invalidRow("not a number", row_no);
+		}
+		X->values[index] = value;
+		X->column_indices[index] = (int) (feature - 1);
+		index++;
+		previous = feature;
+	}
+	*maximum_index = (previous > *maximum_index) ? (int) previous : *maximum_index;
+	return index;
+}
+
+//Static method run by each thread to count the rows and the nonzero items of its chunk
+static void countRowsLibSVM(void* argument, int thread_no)
+{
+	LibSVMLoader* loader = argument;
+	const char* end = loader->boundaries[thread_no + 1];
+	long rows = 0;
+	long nonzeros = 0;
+	const char* next;
+	for (const char* line = loader->boundaries[thread_no]; line < end; line = next)
+	{
+		//Each index:value pair has a single colon, a line of the spaces or a comment isn't a row
+		const char* content_end = contentEndLibSVM(line, end, &next);
+		if (skipSpaces(line, content_end) < content_end)
+		{
+			rows++;
+			for (const char* position = line; position < content_end; position++)
+			{
+				nonzeros += (*position == ':');
+			}
+		}
+	}
+	loader->rows[thread_no] = rows;
+	loader->nonzeros[thread_no] = nonzeros;
+}
+
+//Static method run by each thread to parse the rows of its chunk
+static void parseRowsLibSVM(void* argument, int thread_no)
+{
+	LibSVMLoader* loader = argument;
+	const char* end = loader->boundaries[thread_no + 1];
+	long row_no = loader->offsets[thread_no];
+	long index = loader->nonzero_offsets[thread_no];
+	int maximum_index = 0;
+	const char* next;
+	for (const char* line = loader->boundaries[thread_no]; line < end; line = next)
+	{
+		const char* content_end = contentEndLibSVM(line, end, &next);
+		if (skipSpaces(line, content_end) < content_end)
+		{
+			loader->X->row_offsets[row_no] = index;
+			index = parseRowLibSVM(loader, line, content_end, row_no, index, &maximum_index);
+			row_no++;
+		}
+	}
+	loader->maximum_indices[thread_no] = maximum_index;
+}
+
+//Method to load a libsvm file into a sparse feature matrix and a label matrix
+void loadLibSVM(const char* path, int features, int one_hot_classes, SparseMatrix** X, Matrix** Y)
+{
+	//Check if the options are valid
+	if (features < 0 || one_hot_classes < 0)
+	{
+		printf("Invalid features or classes of the libsvm file");
+		exit(EXIT_FAILURE);
+	}
+	//Map the file and split it into a chunk for each thread
+	size_t size;
+	char* mapping = mapFile(path, "libsvm", &size);
+	int threads = 0;
+	const char** boundaries = splitChunks(mapping, mapping + size, &threads);
+	LibSVMLoader loader;
+	loader.features = features;
+	loader.one_hot_classes = one_hot_classes;
+	loader.boundaries = boundaries;
+	loader.rows = allocateMemory(threads * sizeof(long));
+	loader.nonzeros = allocateMemory(threads * sizeof(long));
+	loader.offsets = allocateMemory(threads * sizeof(long));
+	loader.nonzero_offsets = allocateMemory(threads * sizeof(long));
+	loader.maximum_indices = allocateMemory(threads * sizeof(int));
+	if (loader.rows == NULL || loader.nonzeros == NULL || loader.offsets == NULL || loader.nonzero_offsets == NULL || loader.maximum_indices == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	//Count the rows and the nonzero items of the chunks
+	ThreadPool* pool = (threads > 1) ? initThreadPool(threads) : NULL;
+	if (pool != NULL)
+	{
+		runThreadPool(pool, countRowsLibSVM, &loader);
+	}
+	else
+	{
+		countRowsLibSVM(&loader, 0);
+	}
+	long total_rows = 0;
+	long total_nonzeros = 0;
+	for (int thread_no = 0; thread_no < threads; thread_no++)
+	{
+		loader.offsets[thread_no] = total_rows;
+		loader.nonzero_offsets[thread_no] = total_nonzeros;
+		total_rows += loader.rows[thread_no];
+		total_nonzeros += loader.nonzeros[thread_no];
+	}
+	if (total_rows == 0)
+	{
+		printf("Invalid libsvm file : the file has no rows");
+		exit(EXIT_FAILURE);
+	}
+	if (total_rows > INT32_MAX)
+	{
+		printf("Invalid libsvm file : too many rows");
+		exit(EXIT_FAILURE);
+	}
+	//Allocate the X and the Y once and parse the chunks straight into them, the columns of the X are known after parsing
+	loader.X = createSparseMatrix((int) total_rows, features, total_nonzeros);
+	loader.Y = (Y != NULL) ? createMatrix((int) total_rows, (one_hot_classes > 0) ? one_hot_classes : 1) : NULL;
+	if (pool != NULL)
+	{
+		runThreadPool(pool, parseRowsLibSVM, &loader);
+		disposeThreadPool(pool);
+	}
+	else
+	{
+		parseRowsLibSVM(&loader, 0);
+	}
+	if (features == 0)
+	{
+		for (int thread_no = 0; thread_no < threads; thread_no++)
+		{
+			loader.X->columns = (loader.maximum_indices[thread_no] > loader.X->columns) ? loader.maximum_indices[thread_no] : loader.X->columns;
+		}
+	}
+	//Assign the loaded matrices and dispose the rest
+	*X = loader.X;
+	if (Y != NULL)
+	{
+		*Y = loader.Y;
+	}
+	munmap(mapping, size);
+	free(boundaries);
+	free(loader.rows);
+	free(loader.nonzeros);
+	free(loader.offsets);
+	free(loader.nonzero_offsets);
+	free(loader.maximum_indices);
+}
@@ -0,0 +1,394 @@
+//Dataset file class of LibBQsC by Berkay
+
+#include "../../include/data/dataset_file.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../../include/core/allocation.h"
+#include "../../include/core/model_file.h"
+
+//Magic number at the beginning of the files
+static const char dataset_file_magic[8] = "LIBBQSD";
+
+//Number of statistics arrays : minimums, ranges, means and standard deviations
+#define DATASET_STATISTICS 4
+
+//Static method to round a size up to the alignment of the file
+static uint64_t alignOffset(uint64_t offset)
+{
+	return (offset + DATASET_FILE_ALIGNMENT - 1) / DATASET_FILE_ALIGNMENT * DATASET_FILE_ALIGNMENT;
+}
+
+//Static method to get the size of an item in bytes
+static size_t elementSize(uint32_t element_type)
+{
+	return (element_type == DATASET_FLOAT32) ? sizeof(float) : sizeof(double);
+}
+
+//Static method to write bytes into a file, continue the checksum and handle any failure
+static void writeBytes(FILE* file, const void* data, size_t size, uint64_t* checksum)
+{
+	if (fwrite(data, 1, size, file) != size)
+	{
+		printf("Failed to write the dataset file");
+		exit(EXIT_FAILURE);
+	}
+	*checksum = updateModelFileChecksum(*checksum, data, size);
+}
+
+//Method to begin writing a dataset file
+DatasetWriter* openDatasetWriter(const char* path, int features, int labels, DatasetElementType element_type, int with_statistics)
+{
+	//Check the dimensions and the type
+	if (features < 1 || labels < 0 || (element_type != DATASET_FLOAT64 && element_type != DATASET_FLOAT32))
+	{
+		printf("Invalid dataset dimensions");
+		exit(EXIT_FAILURE);
+	}
+	//Initialize the DatasetWriter and handle any allocation failure
+	DatasetWriter* writer = allocateMemory(sizeof(DatasetWriter));
+	if (writer == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	//Initialize the header, the rows of floats are padded to an even number of items to keep them multiples of 8 bytes
+	DatasetFileHeader* header = &writer->header;
+	memset(header, 0, sizeof(DatasetFileHeader));
+	memcpy(header->magic, dataset_file_magic, sizeof(header->magic));
+	header->version = DATASET_FILE_VERSION;
+	header->endianness = MODEL_FILE_ENDIANNESS;
+	header->element_type = element_type;
+	header->has_statistics = (with_statistics == 1);
+	header->features = features;
+	header->labels = labels;
+	header->stride = (element_type == DATASET_FLOAT32) ? (uint64_t) (features + labels + 1) / 2 * 2 : (uint64_t) (features + labels);
+	header->rows_offset = alignOffset(sizeof(DatasetFileHeader));
+	//Initialize the buffer of a row with its padding
+	writer->row = allocateMemory(header->stride * elementSize(element_type));
+	if (writer->row == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	memset(writer->row, 0, header->stride * elementSize(element_type));
+	//Initialize the running statistics
+	writer->statistics = (header->has_statistics == 1) ? initColumnStatistics(features) : NULL;
+	writer->items = NULL;
+	if (header->has_statistics == 1 && element_type == DATASET_FLOAT32)
+	{
+		writer->items = allocateMemory(features * sizeof(double));
+		if (writer->items == NULL)
+		{
+			printf("Failed to allocate memory");
+			exit(EXIT_FAILURE);
+		}
+	}
+	//Open the file and write the placeholder header, its checksums are calculated when the file is closed
+	writer->file = fopen(path, "wb");
+	if (writer->file == NULL)
+	{
+		printf("Failed to open the dataset file");
+		exit(EXIT_FAILURE);
+	}
+	uint64_t ignored = MODEL_FILE_CHECKSUM_OFFSET;
+	writeBytes(writer->file, header, sizeof(DatasetFileHeader), &ignored);
+	writer->checksum = MODEL_FILE_CHECKSUM_OFFSET;
+	//Return the initialized DatasetWriter
+	return writer;
+}
+
+/**
+ * The statistics are calculated from the items as they are written, so the statistics of a file of floats
+ * are the ones of the floats that are read back from it.
+ */
+
+//Method to append rows to a dataset file being written
+void appendDatasetWriter(DatasetWriter* writer, Matrix* X, Matrix* Y)
+{
+	DatasetFileHeader* header = &writer->header;
+	//Check the dimensions
+	if (X->columns != (int) header->features || (header->labels > 0 && (Y == NULL || Y->columns != (int) header->labels || Y->rows != X->rows)))
+	{
+		printf("Dimensions of the rows do not match the dataset file");
+		exit(EXIT_FAILURE);
+	}
+	int features = header->features;
+	int labels = header->labels;
+	for (int i = 0; i < X->rows; i++)
+	{
+		double* x = MATRIX_ROW(X, i);
+		double* y = (labels > 0) ? MATRIX_ROW(Y, i) : NULL;
+		//Convert the features and the labels into the buffer of the row
+		if (header->element_type == DATASET_FLOAT64)
+		{
+			double* row = writer->row;
+			memcpy(row, x, features * sizeof(double));
+			if (labels > 0)
+			{
+				memcpy(row + features, y, labels * sizeof(double));
+			}
+		}
+		else
+		{
+			float* row = writer->row;
+			for (int j = 0; j < features; j++)
+			{
+				row[j] = (float) x[j];
+			}
+			for (int j = 0; j < labels; j++)
+			{
+				row[features + j] = (float) y[j];
+			}
+		}
+		writeBytes(writer->file, writer->row, header->stride * elementSize(header->element_type), &writer->checksum);
+		header->rows += 1;
+		//Update the statistics of the features of a file of floats with the rounded items
+		if (writer->items != NULL)
+		{
+			Matrix items = {writer->items, 1, features, features};
+			for (int j = 0; j < features; j++)
+			{
+				writer->items[j] = ((float*) writer->row)[j];
+			}
+			updateColumnStatistics(writer->statistics, &items);
+		}
+	}
+	//Update the statistics of the features of a file of doubles with all rows at once
+	if (writer->statistics != NULL && writer->items == NULL)
+	{
+		updateColumnStatistics(writer->statistics, X);
+	}
+}
+
+//Method to finish writing a dataset file
+void closeDatasetWriter(DatasetWriter* writer)
+{
+	DatasetFileHeader* header = &writer->header;
+	uint64_t offset = header->rows_offset + header->rows * header->stride * elementSize(header->element_type);
+	//Write the statistics after the rows, each array is padded with zeros
+	if (header->has_statistics == 1)
+	{
+		uint64_t array_size = alignOffset(header->features * sizeof(double));
+		double* arrays = allocateAlignedMemory(DATASET_FILE_ALIGNMENT, DATASET_STATISTICS * array_size);
+		if (arrays == NULL)
+		{
+			printf("Failed to allocate memory");
+			exit(EXIT_FAILURE);
+		}
+		memset(arrays, 0, DATASET_STATISTICS * array_size);
+		header->statistics_offset = alignOffset(offset);
+		writeBytes(writer->file, arrays, header->statistics_offset - offset, &writer->checksum);
+		double* min = arrays;
+		double* range = (double*) ((char*) arrays + array_size);
+		double* mean = (double*) ((char*) arrays + 2 * array_size);
+		double* standard_deviation = (double*) ((char*) arrays + 3 * array_size);
+		memcpy(min, writer->statistics->min, header->features * sizeof(double));
+		columnRanges(writer->statistics, range);
+		memcpy(mean, writer->statistics->mean, header->features * sizeof(double));
+		columnStandardDeviations(writer->statistics, standard_deviation);
+		writeBytes(writer->file, arrays, DATASET_STATISTICS * array_size, &writer->checksum);
+		offset = header->statistics_offset + DATASET_STATISTICS * array_size;
+		free(arrays);
+	}
+	//Write the header with its checksums over the placeholder
+	header->size = offset;
+	header->checksum = writer->checksum;
+	header->header_checksum = updateModelFileChecksum(MODEL_FILE_CHECKSUM_OFFSET, header, offsetof(DatasetFileHeader, header_checksum));
+	uint64_t ignored = MODEL_FILE_CHECKSUM_OFFSET;
+	if (fseek(writer->file, 0, SEEK_SET) != 0)
+	{
+		printf("Failed to write the dataset file");
+		exit(EXIT_FAILURE);
+	}
+	writeBytes(writer->file, header, sizeof(DatasetFileHeader), &ignored);
+	if (fclose(writer->file) != 0)
+	{
+		printf("Failed to write the dataset file");
+		exit(EXIT_FAILURE);
+	}
+	//Dispose the DatasetWriter
+	free(writer->row);
+	if (writer->statistics != NULL)
+	{
+		disposeColumnStatistics(writer->statistics);
+	}
+	free(writer->items);
+	free(writer);
+	writer = NULL;
+}
+
+//Method to write a dataset into a dataset file at once
+void writeDatasetFile(const char* path, Matrix* X, Matrix* Y, DatasetElementType element_type, int with_statistics)
+{
+	DatasetWriter* writer = openDatasetWriter(path, X->columns, (Y != NULL) ? Y->columns : 0, element_type, with_statistics);
+	appendDatasetWriter(writer, X, Y);
+	closeDatasetWriter(writer);
+}
+
+//Static method to exit with a message if a condition of a valid file doesn't hold
+static void checkDatasetFile(int condition, const char* message)
+{
+	if (!condition)
+	{
+		printf("Invalid dataset file : %s", message);
+		exit(EXIT_FAILURE);
+	}
+}
+
+//Method to map a dataset file into the memory
+DatasetFile* mapDatasetFile(const char* path, int verify_checksum)
+{
+	//Open the file and get its size
+	int descriptor = open(path, O_RDONLY);
+	struct stat status;
+	if (descriptor < 0 || fstat(descriptor, &status) != 0)
+	{
+		printf("Failed to open the dataset file");
+		exit(EXIT_FAILURE);
+	}
+	size_t size = (size_t) status.st_size;
+	checkDatasetFile(size >= sizeof(DatasetFileHeader), "the file is too small");
+	//Map the file read-only and shared, the mapping stays valid after the file is closed
+	void* mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, descriptor, 0);
+	close(descriptor);
+	if (mapping == MAP_FAILED)
+	{
+		printf("Failed to map the dataset file");
+		exit(EXIT_FAILURE);
+	}
+	//Validate the header, so the rows and the statistics can be used without bounds checks
+	DatasetFileHeader* header = mapping;
+	checkDatasetFile(memcmp(header->magic, dataset_file_magic, sizeof(header->magic)) == 0, "wrong magic number");
+	checkDatasetFile(header->endianness != 0x04030201u, "the file has the other byte order");
+	checkDatasetFile(header->endianness == MODEL_FILE_ENDIANNESS, "wrong endianness flag");
+	checkDatasetFile(header->header_checksum == updateModelFileChecksum(MODEL_FILE_CHECKSUM_OFFSET, header, offsetof(DatasetFileHeader, header_checksum)), "wrong header checksum");
+	checkDatasetFile(header->version == DATASET_FILE_VERSION, "unsupported version");
+	checkDatasetFile(header->element_type == DATASET_FLOAT64 || header->element_type == DATASET_FLOAT32, "wrong element type");
+	checkDatasetFile(header->size == size, "wrong file size");
+	checkDatasetFile(header->features > 0 && header->stride >= (uint64_t) header->features + header->labels && header->stride <= size, "wrong row dimensions");
+	checkDatasetFile(header->rows_offset % DATASET_FILE_ALIGNMENT == 0 && header->rows_offset >= sizeof(DatasetFileHeader) && header->rows_offset <= size, "misaligned rows");
+	uint64_t row_size = header->stride * elementSize(header->element_type);
+	checkDatasetFile(header->rows <= (size - header->rows_offset) / row_size && header->rows <= INT32_MAX, "rows out of the file");
+	if (header->has_statistics == 1)
+	{
+		uint64_t statistics_size = DATASET_STATISTICS * alignOffset(header->features * sizeof(double));
+		checkDatasetFile(header->statistics_offset % DATASET_FILE_ALIGNMENT == 0, "misaligned statistics");
+		checkDatasetFile(header->statistics_offset >= header->rows_offset + header->rows * row_size, "overlapping statistics");
+		checkDatasetFile(header->statistics_offset <= size && statistics_size <= size - header->statistics_offset, "statistics out of the file");
+	}
+	//Verify the checksum of the rest of the file if requested
+	if (verify_checksum == 1)
+	{
+		checkDatasetFile(updateModelFileChecksum(MODEL_FILE_CHECKSUM_OFFSET, (char*) mapping + sizeof(DatasetFileHeader), size - sizeof(DatasetFileHeader)) == header->checksum, "wrong checksum");
+	}
+	//Initialize the DatasetFile and handle any allocation failure
+	DatasetFile* file = allocateMemory(sizeof(DatasetFile));
+	if (file == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	file->mapping = mapping;
+	file->size = size;
+	file->header = header;
+	//Return the mapped DatasetFile
+	return file;
+}
+
+//Static method to get a view of the items of a file of doubles beginning at a column of the rows
+static Matrix viewDatasetFile(DatasetFile* file, int first_column, int columns)
+{
+	if (file->header->element_type != DATASET_FLOAT64)
+	{
+		printf("The dataset file does not have doubles");
+		exit(EXIT_FAILURE);
+	}
+	double* rows = (double*) ((char*) file->mapping + file->header->rows_offset);
+	Matrix M = {rows + first_column, (int) file->header->rows, columns, (int) file->header->stride};
+	return M;
+}
+
+//Method to get the features of a mapped dataset file of doubles as a Matrix
+Matrix datasetFileX(DatasetFile* file)
+{
+	return viewDatasetFile(file, 0, file->header->features);
+}
+
+//Method to get the labels of a mapped dataset file of doubles as a Matrix
+Matrix datasetFileY(DatasetFile* file)
+{
+	return viewDatasetFile(file, file->header->features, file->header->labels);
+}
+
+//Method to copy consecutive rows of a mapped dataset file into matrices as doubles
+void datasetFileRows(DatasetFile* file, long first_row, Matrix* X, Matrix* Y)
+{
+	DatasetFileHeader* header = file->header;
+	//Check the rows and the dimensions
+	if (first_row < 0 || first_row + X->rows > (long) header->rows || X->columns != (int) header->features
+			|| (Y != NULL && (Y->rows != X->rows || Y->columns != (int) header->labels)))
+	{
+		printf("Rows out of the dataset file");
+		exit(EXIT_FAILURE);
+	}
+	int features = header->features;
+	int labels = header->labels;
+	char* rows = (char*) file->mapping + header->rows_offset;
+	for (int i = 0; i < X->rows; i++)
+	{
+		if (header->element_type == DATASET_FLOAT64)
+		{
+			double* row = (double*) rows + (first_row + i) * header->stride;
+			memcpy(MATRIX_ROW(X, i), row, features * sizeof(double));
+			if (Y != NULL)
+			{
+				memcpy(MATRIX_ROW(Y, i), row + features, labels * sizeof(double));
+			}
+		}
+		else
+		{
+			float* row = (float*) rows + (first_row + i) * header->stride;
+			double* x = MATRIX_ROW(X, i);
+			for (int j = 0; j < features; j++)
+			{
+				x[j] = row[j];
+			}
+			if (Y != NULL)
+			{
+				double* y = MATRIX_ROW(Y, i);
+				for (int j = 0; j < labels; j++)
+				{
+					y[j] = row[features + j];
+				}
+			}
+		}
+	}
+}
+
+//Method to get the statistics of the features of a mapped dataset file
+DatasetStatistics datasetFileStatistics(DatasetFile* file)
+{
+	if (file->header->has_statistics != 1)
+	{
+		printf("The dataset file does not have statistics");
+		exit(EXIT_FAILURE);
+	}
+	char* arrays = (char*) file->mapping + file->header->statistics_offset;
+	uint64_t array_size = alignOffset(file->header->features * sizeof(double));
+	DatasetStatistics statistics = {(double*) arrays, (double*) (arrays + array_size), (double*) (arrays + 2 * array_size), (double*) (arrays + 3 * array_size)};
+	return statistics;
+}
+
+//Method to unmap a dataset file
+void unmapDatasetFile(DatasetFile* file)
+{
+	munmap(file->mapping, file->size);
+	free(file);
+	file = NULL;
+}
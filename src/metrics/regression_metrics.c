@@ -4,16 +4,46 @@
 
 #include <math.h>
 
+#include "../../include/core/vector_kernels.h"
+
+/**
+ * The log losses calculate the logarithms by the vector kernels. The items are processed in chunks
+ * of LOG_CHUNK whose logarithms are kept on the stack, and the products with the y_true are summed
+ * by the vectorDot().
+ */
+#define LOG_CHUNK 256
+
+//Static method for sum(y * log(clip(p))) where clip(p) limits the p to [epsilon, 1 - epsilon]
+static double sumLogProducts(double* y, double* p, int n, double epsilon)
+{
+	double log_p[LOG_CHUNK];
+	double sum = 0.0;
+	for (int start = 0; start < n; start += LOG_CHUNK)
+	{
+		int size = (n - start < LOG_CHUNK) ? n - start : LOG_CHUNK;
+		//Clip the p
+		for (int i = 0; i < size; i++)
+		{
+			log_p[i] = fmax(epsilon, fmin(1.0 - epsilon, p[start + i]));
+		}
+		vectorLog(log_p, log_p, size);
+		sum += vectorDot(y + start, log_p, size);
+	}
+	return sum;
+}
+
 //Method to calculate a mean squared error
 double meanSquaredError(double *y_true, double *y_pred, int n)
 {
 	//Initialize the sum
 	double sum = 0;
-	//Calculate the sum
-	for (int i = 0; i < n; i++)
+	//Calculate the sum of the squares of y_pred - y_true, the differences of a chunk are kept on the stack
+	double differences[LOG_CHUNK];
+	for (int start = 0; start < n; start += LOG_CHUNK)
 	{
-		//The square of y_pred - y_true
-		sum += pow((y_pred[i] - y_true[i]), 2);
+		int size = (n - start < LOG_CHUNK) ? n - start : LOG_CHUNK;
+		vectorSubtractionInto(differences, y_pred + start, y_true + start, size);
+		sum += vectorDot(differences, differences, size);
 	}
 	//Return the MSE
 	return sum / n;
@@ -37,12 +67,24 @@ double meanAbsoluteError(double *y_true, double *y_pred, int n)
 //Method to calculate a log loss
 double logLoss(double *y_true, double *y_pred, int n)
 {
+	//Chunks of log(p), log(1 - p) and 1 - y
+	double log_p[LOG_CHUNK];
+	double log_q[LOG_CHUNK];
+	double y_q[LOG_CHUNK];
 	//Initialize the sum
 	double sum = 0;
-	//Calculate the sum
-	for (int i = 0; i < n; i++)
+	//Calculate the sum : y * log(p) + (1 - y) * log(1 - p)
+	for (int start = 0; start < n; start += LOG_CHUNK)
 	{
-		sum += y_true[i] * log(y_pred[i]) + (1.0 - y_true[i]) * log(1.0 - y_pred[i]);
+		int size = (n - start < LOG_CHUNK) ? n - start : LOG_CHUNK;
+		for (int i = 0; i < size; i++)
+		{
+			log_q[i] = 1.0 - y_pred[start + i];
+			y_q[i] = 1.0 - y_true[start + i];
+		}
+		vectorLog(log_p, y_pred + start, size);
+		vectorLog(log_q, log_q, size);
+		sum += vectorDot(y_true + start, log_p, size) + vectorDot(y_q, log_q, size);
 	}
 	//Return the log loss
 	return -1.0 * sum / n;
@@ -55,17 +97,35 @@ double logLossMatrix(double** y_true, double** y_pred, int samples, int classes)
 	double epsilon = 1e-15;
 	//Initialize the sum
 	double sum = 0.0;
-	//Calculate the sum
+	//Calculate the sum with the clipped p
 	for (int i = 0; i < samples; i++)
 	{
-		for (int j = 0; j < classes; j++)
-		{
-			//Clip the actual p
-			double current_p = fmax(epsilon, fmin(1.0 - epsilon, y_pred[i][j]));
-			sum -= y_true[i][j] * log(current_p);
-		}
+		sum -= sumLogProducts(y_true[i], y_pred[i], classes, epsilon);
 	}
 	//Return the log loss
 	return sum / samples;
 }
 
+
+//Method to calculate a log loss for contiguous matrices
+double logLossMatrixStruct(Matrix* Y_true, Matrix* Y_pred)
+{
+	//Small value to avoid numerical instability (log(0))
+	double epsilon = 1e-15;
+	//Initialize the sum
+	double sum = 0.0;
+	//Calculate the sum with the clipped p, the rows are contiguous if the matrices are not views
+	if (Y_true->stride == Y_true->columns && Y_pred->stride == Y_pred->columns)
+	{
+		sum -= sumLogProducts(Y_true->data, Y_pred->data, Y_true->rows * Y_true->columns, epsilon);
+	}
+	else
+	{
+		for (int i = 0; i < Y_true->rows; i++)
+		{
+			sum -= sumLogProducts(MATRIX_ROW(Y_true, i), MATRIX_ROW(Y_pred, i), Y_true->columns, epsilon);
+		}
+	}
+	//Return the log loss
+	return sum / Y_true->rows;
+}
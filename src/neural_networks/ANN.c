@@ -3,10 +3,17 @@
 #include "../../include/neural_networks/ANN.h"
 
 #include <limits.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "../../include/core/allocation.h"
+#include "../../include/core/gemm.h"
 #include "../../include/core/linear_algebra.h"
+#include "../../include/core/model_file.h"
+#include "../../include/core/thread_pool.h"
+#include "../../include/core/workspace.h"
 #include "../../include/metrics/regression_metrics.h"
 #include "../../include/optimization/adam_optimizer.h"
 
@@ -14,22 +21,30 @@
 ANN* initANN(double** X, double** Y, int samples, int features, int classes)
 {
 	//Initialize the ANN and handle any allocation failure
-	ANN* ann = malloc(sizeof(ANN));
+	ANN* ann = allocateMemory(sizeof(ANN));
 	if (ann == NULL)
 	{
 		printf("Failed to allocate memory");
 		exit(EXIT_FAILURE);
 	}
-	//Import the X and Y
-	ann->X = X;
-	ann->Y = Y;
+	//Copy the X and Y into contiguous matrices, an ANN trained on a dataset file doesn't have them
+	ann->X = (X != NULL) ? matrixFromArray(X, samples, features) : NULL;
+	ann->Y = (X != NULL) ? matrixFromArray(Y, samples, classes) : NULL;
 	//Input data dimensions
-	ann->samples = samples;
+	ann->samples = (X != NULL) ? samples : 0;
 	ann->features = features;
 	ann->classes = classes;
 	//Layers of the ANN
 	ann->layers = NULL;
 	ann->number_of_layers = 0;
+	//The ANN is trained by a single thread unless setThreadsANN() is called
+	ann->threads = 1;
+	//Workspace of the temporaries
+	ann->workspace = initWorkspace(0);
+	//The inputs aren't scaled unless setScalerANN() is called
+	ann->scaler = NULL;
+	ann->W_folded = NULL;
+	ann->B_folded = NULL;
 	//Return the initialized ANN
 	return ann;
 }
@@ -43,7 +58,7 @@ ANN* initANN(double** X, double** Y, int samples, int features, int classes)
 void addLayerANN(ANN* ann, int neurons, LayerType layer_type, Activation activation)
 {
 	//Initialize the new ann->layers with the size of ann->number_of_layers + 1 and handle any allocation failure
-	ANNLayer** new_layer_array = malloc((ann->number_of_layers+1) * sizeof(ANNLayer*));
+	ANNLayer** new_layer_array = allocateMemory((ann->number_of_layers+1) * sizeof(ANNLayer*));
 	if (new_layer_array == NULL)
 	{
 		printf("Failed to allocate memory");
@@ -57,9 +72,9 @@ void addLayerANN(ANN* ann, int neurons, LayerType layer_type, Activation activat
 	//Dispose the old array
 	free(ann->layers);
 	ann->layers = new_layer_array;
-	//Decide the number of neurons in the previous layer and initialize the new layer
+	//Decide the number of neurons in the previous layer and initialize the new layer, its matrices are sized by the training
 	int neurons_previous = (ann->number_of_layers == 0) ? ann->features : ann->layers[ann->number_of_layers-1]->neurons;
-	ANNLayer* new_layer = initANNLayer(ann->samples, neurons_previous, neurons, layer_type, activation);
+	ANNLayer* new_layer = initANNLayer(0, neurons_previous, neurons, layer_type, activation);
 	//Add the new layer to the ANN and increase the ann->number_of_layers by one
 	ann->layers[ann->number_of_layers] = new_layer;
 	ann->number_of_layers += 1;
@@ -67,53 +82,38 @@ void addLayerANN(ANN* ann, int neurons, LayerType layer_type, Activation activat
 
 /**
  * This method performs the Z = XW + B and A = activation_function(Z) operations for the layer with the specified
- * index element-wise. It is "update" because it doesn't calculates and returns something but rather updates the
- * matrices of the ANNLayers of the ANN.
+ * index. layerForward() calculates XW into the Z, and adds the B and applies the activation function to each tile
+ * of the Z right after it is calculated, so the Z isn't read again in a separate pass. It is "update" because it
+ * doesn't calculate and return anything but rather updates the matrices of the ANNLayers of the ANN.
+ *
+ * The propagation methods work on the passed layers and X, so that each thread can propagate its part of the rows
+ * through its own layers. The matrices of the layers have as many rows as the X.
  */
 
 //Method to update the outputs of a layer
-static void updateLayerOutputs(ANN* ann, int layer_no)
+static void updateLayerOutputs(ANN* ann, ANNLayer** layers, Matrix* X, int layer_no)
 {
-	//Iterate over the rows of the X/A[l-1] (also the rows of the Z[l] and A[l]) to perform the XW
-	for (int row_no = 0; row_no < ann->samples; row_no++)
-	{
-		//Iterate over the columns of the Wi (also the columns of the Z[l] and A[l]) to perform the XW
-		for (int column_no = 0; column_no < ann->layers[layer_no]->neurons; column_no++)
-		{
-			//Iterate to calculate the result of the matrix multiplication
-			double result_XW = 0.0;
-			for (int item_no = 0; item_no < ann->layers[layer_no]->neurons_previous; item_no++)
-			{
-				//Use X if this is the first layer
-				if (layer_no == 0)
-				{
-					result_XW += ann->X[row_no][item_no] * ann->layers[layer_no]->W[item_no][column_no];
-				}
-				//Use A[l-1] otherwise
-				else
-				{
-					result_XW += ann->layers[layer_no-1]->A[row_no][item_no] * ann->layers[layer_no]->W[item_no][column_no];
-				}
-			}
-			//Z[l][i][j] = XW[l][i][j] + B[l][i][j]
-			ann->layers[layer_no]->Z[row_no][column_no] = result_XW + ann->layers[layer_no]->B[row_no][column_no];
-			//A[l][i][j] = activation_function(Z[l][i][j])
-			ann->layers[layer_no]->A[row_no][column_no] = activationFunction(ann->layers[layer_no]->Z[row_no][column_no], ann->layers[layer_no]->activation);
-		}
-	}
+	//Use X if this is the first layer and A[l-1] otherwise
+	ANNLayer* layer = layers[layer_no];
+	Matrix* input = (layer_no == 0) ? X : layers[layer_no-1]->A;
+	//The first layer applies the W and B with the Scaler folded into them to the unscaled X
+	Matrix* W = (layer_no == 0 && ann->scaler != NULL) ? ann->W_folded : layer->W;
+	double* B = (layer_no == 0 && ann->scaler != NULL) ? ann->B_folded : layer->B;
+	//Z[l] = XW[l] + B[l] and A[l] = activation_function(Z[l]) in a single pass over the tiles
+	layerForward(input, W, B, layer->activation, layer->Z, layer->A);
 	//Z and A matrices of the current layer are now updated so the next layer (l+1) can be calculated using the A of the current layer
 }
 
 //Method to perform the complete forward propagation
-static void forwardPropagationANN(ANN* ann)
+static void forwardPropagationANN(ANN* ann, ANNLayer** layers, Matrix* X)
 {
 	//Iterate over the layers
 	for (int layer_no = 0; layer_no < ann->number_of_layers; layer_no++)
 	{
 		//Update the layers using the method
-		updateLayerOutputs(ann, layer_no);
+		updateLayerOutputs(ann, layers, X, layer_no);
 	}
-	//ann->layers[ann->number_of_layers-1]->A = is the output layer of the ANN
+	//layers[ann->number_of_layers-1]->A = is the output layer of the ANN
 }
 
 /**
@@ -121,186 +121,458 @@ static void forwardPropagationANN(ANN* ann)
  *
  * dZ[L] = A[L] - Y						and 	dZ[l] = (dZ[l+1] x W[l+1]^T) * activation_function_derivative(Z[l])
  * dW[l] = 1/m * (A[l-1]^T x dZ[l]) 	and 	dW[l=1] = 1/m * (X^T x dZ[l])
- * dB[l] = mean(dZ[l])
+ * dB[l] = mean(dZ[l]) over the samples, i.e. the column means of the dZ[l]
+ *
+ * m is the number of samples in the current step, and the scale 1/m is passed rather than being calculated from
+ * the rows of the X : when the rows are split between the threads, the gradients of the parts are scaled by the
+ * same 1/m so that their sum is the gradient of the step.
  */
 
 //Method to update the dZ of a layer
-static double* update_dZ(ANN* ann, int layer_no)
+static void update_dZ(ANN* ann, ANNLayer** layers, Matrix* Y, int layer_no)
 {
-	//Generate the vector to be the rows of the dB
-	double* db = initZeroVector(ann->layers[layer_no]->neurons);
+	ANNLayer* layer = layers[layer_no];
+	//Calculate dZ[l+1] x W[l+1]^T into the dZ for the hidden layers
+	if (layer_no < ann->number_of_layers-1)
+	{
+		matrixGEMM(0, 1, 1.0, layers[layer_no+1]->dZ, layers[layer_no+1]->W, 0.0, layer->dZ);
+	}
 	//Iterate over the rows of the dZ (samples, neurons) to update it
-	for (int row_no = 0; row_no < ann->samples; row_no++)
+	for (int row_no = 0; row_no < Y->rows; row_no++)
 	{
-		//Iterate over the columns of the dZ (samples, neurons) to update it
-		for (int column_no = 0; column_no < ann->layers[layer_no]->neurons; column_no++)
+		double* dZ_row = MATRIX_ROW(layer->dZ, row_no);
+		double* A_row = MATRIX_ROW(layer->A, row_no);
+		//Calculate the dZ for the output layer : dZ[L] = A[L] - Y
+		if (layer_no == ann->number_of_layers-1)
 		{
-			//Calculate the dZ for the output layer : dZ[L] = A[L] - Y
-			if (layer_no == ann->number_of_layers-1)
-			{
-				ann->layers[layer_no]->dZ[row_no][column_no] = ann->layers[layer_no]->A[row_no][column_no] - ann->Y[row_no][column_no];
-			}
-			//Calculate the dZ for the hidden layers : dZ[l] = (dZ[l+1] x W[l+1]^T) * activation_function_derivative(Z[l])
-			else
-			{
-				//Calculate the current item of dZ[l+1] x W[l+1]^T (which dZlp1xWlp1T stands for) by performing the matrix multiplication
-				double dZlp1xWlp1T = 0.0;
-				for (int item_no = 0; item_no < ann->layers[layer_no+1]->neurons; item_no++)
-				{
-					dZlp1xWlp1T += ann->layers[layer_no+1]->dZ[row_no][item_no] * ann->layers[layer_no+1]->W[column_no][item_no];
-				}
-				//Update the current item of dZ by doing dZlp1xWlp1T * activation_function_derivative(Z[l][i][j])
-				ann->layers[layer_no]->dZ[row_no][column_no] = dZlp1xWlp1T * activationFunctionDerivative(ann->layers[layer_no]->Z[row_no][column_no], ann->layers[layer_no]->activation);
-			}
-			//A column of db is the mean of the column of dZ and dB will be generated by tiling the db
-			db[column_no] += ann->layers[layer_no]->dZ[row_no][column_no];
+			vectorSubtractionInto(dZ_row, A_row, MATRIX_ROW(Y, row_no), layer->neurons);
+		}
+		//Calculate the dZ for the hidden layers : dZ[l] = (dZ[l+1] x W[l+1]^T) * activation_function_derivative(Z[l])
+		else
+		{
+			//The derivative is calculated from the A[l] cached by the forward propagation
+			multiplyActivationDerivative(dZ_row, A_row, layer->neurons, layer->activation);
 		}
 	}
-	//Divide the db by samples to calculate the means then return the it to generate the dB
-	for (int db_i = 0; db_i < ann->layers[layer_no]->neurons; db_i++)
-	{
-		db[db_i] /= ann->samples;
-	}
-	return db;
 	//dZ matrix of the current layer is now updated so the next layer (l-1) can be calculated using the dZ of the current layer
 }
 
 //Method to update the dW of a layer
-static void update_dW(ANN* ann, int layer_no)
+static void update_dW(ANNLayer** layers, Matrix* X, double scale, int layer_no)
 {
-	//Iterate over the rows of the dW (neurons_previous, neurons) to update it
-	for (int row_no = 0; row_no < ann->layers[layer_no]->neurons_previous; row_no++)
-	{
-		//Iterate over the columns of the dW (neurons_previous, neurons) to update it
-		for (int column_no = 0; column_no < ann->layers[layer_no]->neurons; column_no++)
-		{
-			//Calculate the dW for the hidden layers in between : 1/m * (A[l-1]^T x dZ[l])
-			if (layer_no > 0)
-			{
-				//Calculate the current item of (A[l-1]^T x dZ[l]) (which Alm1TxdZl stands for)
-				double Alm1TxdZl = 0.0;
-				for (int item_no = 0; item_no < ann->samples; item_no++)
-				{
-					Alm1TxdZl += ann->layers[layer_no-1]->A[item_no][row_no] * ann->layers[layer_no]->dZ[item_no][column_no];
-				}
-				//Update the current item of dw
-				ann->layers[layer_no]->dW[row_no][column_no] = (1.0/ann->samples) * Alm1TxdZl;
-			}
-			//Calculate the dW for the first hidden layer (l=1) : 1/m * (X^T x dZ[l])
-			else if (layer_no == 0)
-			{
-				//Calculate the current item of (X^T x dZ[l]) (which XTxdZl stands for)
-				double XTxdZl = 0.0;
-				for (int item_no = 0; item_no < ann->samples; item_no++)
-				{
-					XTxdZl += ann->X[item_no][row_no] * ann->layers[layer_no]->dZ[item_no][column_no];
-				}
-				//Update the current item of dw
-				ann->layers[layer_no]->dW[row_no][column_no] = (1.0/ann->samples) * XTxdZl;
-			}
-		}
-	}
+	/**
+	 * dW for the first hidden layer (l=1) : 1/m * (X^T x dZ[l])
+	 * dW for the hidden layers in between : 1/m * (A[l-1]^T x dZ[l])
+	 */
+	ANNLayer* layer = layers[layer_no];
+	Matrix* input = (layer_no == 0) ? X : layers[layer_no-1]->A;
+	//dW[l] = 1/m * (A[l-1]^T x dZ[l])
+	matrixGEMM(1, 0, scale, input, layer->dZ, 0.0, layer->dW);
 	//dW matrix of the current layer is now updated
 }
 
 //Method to update the dB of a layer
-static void update_dB(ANN* ann, double* db, int layer_no)
+static void update_dB(ANNLayer** layers, double scale, int layer_no)
 {
-	//Iterate over the rows of the dB (samples, neurons) to update it
-	for (int row_no = 0; row_no < ann->samples; row_no++)
+	ANNLayer* layer = layers[layer_no];
+	//dB[l] = 1/m * sum of the rows of the dZ[l]
+	memset(layer->dB, 0, layer->neurons * sizeof(double));
+	for (int row_no = 0; row_no < layer->dZ->rows; row_no++)
 	{
-		//Iterate over the columns of the dB (samples, neurons) to update it
-		for (int column_no = 0; column_no < ann->layers[layer_no]->neurons; column_no++)
-		{
-			//Update the current item of dB
-			ann->layers[layer_no]->dB[row_no][column_no] = db[column_no];
-		}
+		vectorAxpy(scale, MATRIX_ROW(layer->dZ, row_no), layer->dB, layer->neurons);
 	}
 }
 
 //Method to perform the complete backward propagation
-static void backwardPropagationANN(ANN* ann)
+static void backwardPropagationANN(ANN* ann, ANNLayer** layers, Matrix* X, Matrix* Y, double scale)
 {
 	//Iterate over the layers starting from the output layer
 	for (int layer_no = ann->number_of_layers-1; layer_no > -1; layer_no--)
 	{
 		//Update the dZ of the current layer
-		double* db = update_dZ(ann, layer_no);
+		update_dZ(ann, layers, Y, layer_no);
 		//Update the dW of the current layer
-		update_dW(ann, layer_no);
-		//Update the dB of the current layer and dispose the db
-		update_dB(ann, db, layer_no);
-		free(db);
-		db = NULL;
+		update_dW(layers, X, scale, layer_no);
+		//Update the dB of the current layer
+		update_dB(layers, scale, layer_no);
 	}
 	//Gradients of each layer are now updated
 }
 
-//Method to train the ANN
-void trainANN(ANN* ann, int max_iterations, double threshold)
+/**
+ * A training step splits the rows of its X and Y into as many contiguous parts as there are threads. Each thread
+ * propagates its part through its own layers : the thread 0 uses the layers of the ANN and the other threads use
+ * layers sharing the W and B of the ANN. The gradients of the parts are then summed into the gradients of the
+ * layers of the ANN by a tree reduction : at each level the part t adds the part t + distance to itself, and the
+ * distance doubles until the part 0 holds the sum. The parts and the order of the additions only depend on the
+ * number of threads, so the training is reproducible for a fixed number of threads.
+ *
+ * The matrices of the layers are initialized with 0 rows by addLayerANN(), and the trainings resize them to the
+ * number of rows a thread processes at once. So, the memory of the activations is proportional to the batch size
+ * rather than to the data. The last batch of an epoch may be smaller than the others, in which case only the first
+ * rows of the matrices are used.
+ */
+
+/**
+ * ANNShard struct
+ *
+ * Part of the rows of a step processed by a thread
+ */
+typedef struct
+{
+	//Layers of the thread
+	ANNLayer** layers;
+	//Rows of the X and Y of the step processed by the thread
+	Matrix X;
+	Matrix Y;
+	//Sum of the losses of the rows
+	double loss;
+}
+ANNShard;
+
+/**
+ * ANNTrainer struct
+ *
+ * State of a training shared by its steps
+ */
+typedef struct
+{
+	ANN* ann;
+	//Parts of the current step, one per thread
+	ANNShard* shards;
+	int number_of_shards;
+	int active_shards;
+	//Scale of the gradients of the current step : 1/m
+	double scale;
+	//Threads of the training, NULL if there is one thread
+	ThreadPool* pool;
+	//Optimizers of the W and B of the layers
+	ADAM** adamW;
+	ADAM** adamB;
+}
+ANNTrainer;
+
+//Method to resize the matrices of the layers of the ANN to hold the passed number of rows
+static void resizeLayersANN(ANN* ann, int rows)
+{
+	for (int layer_no = 0; layer_no < ann->number_of_layers; layer_no++)
+	{
+		if (ann->layers[layer_no]->samples != rows)
+		{
+			resizeANNLayer(ann->layers[layer_no], rows);
+		}
+	}
+}
+
+//Method to use the first rows of the matrices of the layers
+static void setLayerRowsANN(ANN* ann, ANNLayer** layers, int rows)
+{
+	for (int layer_no = 0; layer_no < ann->number_of_layers; layer_no++)
+	{
+		layers[layer_no]->Z->rows = rows;
+		layers[layer_no]->A->rows = rows;
+		layers[layer_no]->dZ->rows = rows;
+	}
+}
+
+//Method to check if the ANN is initialized with its X and Y
+static void checkDataANN(ANN* ann)
+{
+	if (ann->X == NULL)
+	{
+		printf("The ANN does not have an X and Y");
+		exit(EXIT_FAILURE);
+	}
+}
+
+//Method to check if the ANN is initialized appropriately having an output layer
+static void checkOutputLayerANN(ANN* ann)
+{
+	if (ann->number_of_layers == 0 || ann->layers[ann->number_of_layers-1]->layer_type != OUTPUT_LAYER)
+	{
+		printf("The ANN does not have an output layer");
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+ * With a Scaler, the first layer computes X_scaled x W + B as X x W_folded + B_folded, and its dW is calculated
+ * from the unscaled X by the backward propagation. So, the W_folded and B_folded are updated from the W and B
+ * before each step and prediction, and the dW is converted into the gradient of the W before the update.
+ */
+
+//Method to fold the Scaler into the W and B of the first layer
+static void foldScalerANN(ANN* ann)
+{
+	if (ann->scaler == NULL)
+	{
+		return;
+	}
+	ANNLayer* layer = ann->layers[0];
+	//Allocate the folded W and B once
+	if (ann->W_folded == NULL)
+	{
+		ann->W_folded = createMatrix(layer->neurons_previous, layer->neurons);
+		ann->B_folded = allocateMemory(layer->neurons * sizeof(double));
+		if (ann->B_folded == NULL)
+		{
+			printf("Failed to allocate memory");
+			exit(EXIT_FAILURE);
+		}
+	}
+	foldScaler(ann->scaler, layer->W, layer->B, ann->W_folded, ann->B_folded);
+}
+
+/**
+ * The matrices of the layers are contiguous, so the ADAMs update the buffers of the W matrices and the B vectors
+ * in place and the buffers of the dW matrices and the dB vectors are passed as the gradients without being flattened.
+ */
+
+//Method to initialize an ANNTrainer for the steps of at most the passed number of rows
+static ANNTrainer* initTrainerANN(ANN* ann, int rows)
 {
 	//Check if the ANN is initialized appropriately having an output layer
-	if (ann->layers[ann->number_of_layers-1]->layer_type == OUTPUT_LAYER)
+	checkOutputLayerANN(ann);
+	//Initialize the ANNTrainer and its arrays and handle any allocation failure
+	int threads = (ann->threads < rows) ? ann->threads : rows;
+	ANNTrainer* trainer = allocateMemory(sizeof(ANNTrainer));
+	ANNShard* shards = allocateMemory(threads * sizeof(ANNShard));
+	ADAM** adamW = allocateMemory(ann->number_of_layers * sizeof(ADAM*));
+	ADAM** adamB = allocateMemory(ann->number_of_layers * sizeof(ADAM*));
+	if (trainer == NULL || shards == NULL || adamW == NULL || adamB == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	trainer->ann = ann;
+	trainer->shards = shards;
+	trainer->number_of_shards = threads;
+	trainer->active_shards = 0;
+	trainer->scale = 0.0;
+	trainer->pool = (threads > 1) ? initThreadPool(threads) : NULL;
+	trainer->adamW = adamW;
+	trainer->adamB = adamB;
+	//The layers of the ANN are the layers of the thread 0, the other threads have layers sharing their W and B
+	int shard_rows = (rows + threads - 1) / threads;
+	resizeLayersANN(ann, shard_rows);
+	shards[0].layers = ann->layers;
+	for (int shard_no = 1; shard_no < threads; shard_no++)
 	{
-		//Initialize the arrays of ADAMs
-		ADAM* adamW[ann->number_of_layers];
-		ADAM* adamB[ann->number_of_layers];
+		shards[shard_no].layers = allocateMemory(ann->number_of_layers * sizeof(ANNLayer*));
+		if (shards[shard_no].layers == NULL)
+		{
+			printf("Failed to allocate memory");
+			exit(EXIT_FAILURE);
+		}
 		for (int layer_no = 0; layer_no < ann->number_of_layers; layer_no++)
 		{
-			//Initialize an ADAM for the current W
-			double* current_flattened_W = flatten(ann->layers[layer_no]->W, ann->layers[layer_no]->neurons_previous, ann->layers[layer_no]->neurons, 0);
-			adamW[layer_no] = initADAM(current_flattened_W, ann->layers[layer_no]->neurons_previous * ann->layers[layer_no]->neurons);
-			//Initialize an ADAM for the current B
-			double* current_flattened_B = flatten(ann->layers[layer_no]->B, ann->samples, ann->layers[layer_no]->neurons, 0);
-			adamB[layer_no] = initADAM(current_flattened_B, ann->samples * ann->layers[layer_no]->neurons);
+			shards[shard_no].layers[layer_no] = initSharedANNLayer(ann->layers[layer_no], shard_rows);
+		}
+	}
+	//Initialize the ADAMs of the layers
+	for (int layer_no = 0; layer_no < ann->number_of_layers; layer_no++)
+	{
+		//Initialize an ADAM for the current W
+		adamW[layer_no] = initADAM(ann->layers[layer_no]->W->data, ann->layers[layer_no]->neurons_previous * ann->layers[layer_no]->neurons);
+		//Initialize an ADAM for the current B
+		adamB[layer_no] = initADAM(ann->layers[layer_no]->B, ann->layers[layer_no]->neurons);
+	}
+	//Return the ANNTrainer
+	return trainer;
+}
+
+//Method run by each thread to propagate its part of the rows of a step
+static void runShardANN(void* argument, int thread_no)
+{
+	ANNTrainer* trainer = (ANNTrainer*) argument;
+	ANNShard* shard = &trainer->shards[thread_no];
+	//The threads beyond the active ones don't have any rows
+	if (thread_no >= trainer->active_shards)
+	{
+		return;
+	}
+	//Perform the propagations and calculate the loss of the rows
+	forwardPropagationANN(trainer->ann, shard->layers, &shard->X);
+	backwardPropagationANN(trainer->ann, shard->layers, &shard->X, &shard->Y, trainer->scale);
+	ANNLayer* output_layer = shard->layers[trainer->ann->number_of_layers-1];
+	if (shard->Y.stride == shard->Y.columns)
+	{
+		shard->loss = shard->X.rows * logLoss(shard->Y.data, output_layer->A->data, shard->X.rows * trainer->ann->classes);
+	}
+	else
+	{
+		//The Y is a view into the rows of a dataset file, so its loss is summed row by row
+		shard->loss = 0.0;
+		for (int row_no = 0; row_no < shard->X.rows; row_no++)
+		{
+			shard->loss += logLoss(MATRIX_ROW(&shard->Y, row_no), MATRIX_ROW(output_layer->A, row_no), trainer->ann->classes);
 		}
-		//Initialize the previous loss as INT_MAX
-		double loss_previous = INT_MAX;
-		//Begin the iteration
-		for (int t = 0; t < max_iterations; t++)
+	}
+}
+
+//Method run by each thread to reduce its part of the items of the gradients
+static void runReductionANN(void* argument, int thread_no)
+{
+	ANNTrainer* trainer = (ANNTrainer*) argument;
+	ANNShard* shards = trainer->shards;
+	for (int layer_no = 0; layer_no < trainer->ann->number_of_layers; layer_no++)
+	{
+		//Items of the dW and dB reduced by this thread
+		int neurons = trainer->ann->layers[layer_no]->neurons;
+		long dW_items = (long) trainer->ann->layers[layer_no]->neurons_previous * neurons;
+		long dW_begin = dW_items * thread_no / trainer->number_of_shards;
+		long dW_end = dW_items * (thread_no + 1) / trainer->number_of_shards;
+		long dB_begin = (long) neurons * thread_no / trainer->number_of_shards;
+		long dB_end = (long) neurons * (thread_no + 1) / trainer->number_of_shards;
+		//Tree reduction into the part 0
+		for (int distance = 1; distance < trainer->active_shards; distance *= 2)
 		{
-			//Perform the propagations and update the matrices
-			forwardPropagationANN(ann);
-			backwardPropagationANN(ann);
-			//Update the optimizers and the matrices
-			for (int layer_no = 0; layer_no < ann->number_of_layers; layer_no++)
+			for (int shard_no = 0; shard_no + distance < trainer->active_shards; shard_no += 2 * distance)
 			{
-				//UPDATE THE W MATRIX
-				//Flatten the gradient into dw
-				double* dw = flatten(ann->layers[layer_no]->dW, ann->layers[layer_no]->neurons_previous, ann->layers[layer_no]->neurons, 0);
-				//Update the optimizer
-				double* updated_w = updateADAM(adamW[layer_no], dw, (ann->layers[layer_no]->neurons_previous * ann->layers[layer_no]->neurons));
-				//Dispose the flattened gradient
-				free(dw);
-				//Update the W matrix of the current layer out of the w vector returned from the optimizer
-				int index_w = 0;
-				for (int row_no = 0; row_no < ann->layers[layer_no]->neurons_previous; row_no++)
-				{
-					for (int column_no = 0; column_no < ann->layers[layer_no]->neurons; column_no++)
-					{
-						ann->layers[layer_no]->W[row_no][column_no] = updated_w[index_w];
-						index_w += 1;
-					}
-				}
-				//UPDATE THE B MATRIX
-				//Flatten the gradient into db
-				double* db = flatten(ann->layers[layer_no]->dB, ann->samples, ann->layers[layer_no]->neurons, 0);
-				//Update the optimizer
-				double* updated_b = updateADAM(adamB[layer_no], db, (ann->samples * ann->layers[layer_no]->neurons));
-				//Dispose the flattened gradient
-				free(db);
-				//Update the B matrix of the current layer out of the b vector returned from the optimizer
-				int index_b = 0;
-				for (int row_no = 0; row_no < ann->samples; row_no++)
-				{
-					for (int column_no = 0; column_no < ann->layers[layer_no]->neurons; column_no++)
-					{
-						ann->layers[layer_no]->B[row_no][column_no] = updated_b[index_b];
-						index_b += 1;
-					}
-				}
+				ANNLayer* layer = shards[shard_no].layers[layer_no];
+				ANNLayer* other_layer = shards[shard_no + distance].layers[layer_no];
+				vectorAdditionInto(layer->dW->data + dW_begin, layer->dW->data + dW_begin, other_layer->dW->data + dW_begin, dW_end - dW_begin);
+				vectorAdditionInto(layer->dB + dB_begin, layer->dB + dB_begin, other_layer->dB + dB_begin, dB_end - dB_begin);
 			}
+		}
+	}
+}
+
+//Method to perform a training step on the passed X and Y, returns the loss of the step
+static double stepANN(ANNTrainer* trainer, Matrix* X, Matrix* Y)
+{
+	ANN* ann = trainer->ann;
+	int rows = X->rows;
+	//Split the rows into the parts of the threads
+	trainer->active_shards = (trainer->number_of_shards < rows) ? trainer->number_of_shards : rows;
+	trainer->scale = 1.0/rows;
+	for (int shard_no = 0; shard_no < trainer->active_shards; shard_no++)
+	{
+		ANNShard* shard = &trainer->shards[shard_no];
+		int begin = (int) ((long) rows * shard_no / trainer->active_shards);
+		int end = (int) ((long) rows * (shard_no + 1) / trainer->active_shards);
+		shard->X = (Matrix) {MATRIX_ROW(X, begin), end - begin, X->columns, X->stride};
+		shard->Y = (Matrix) {MATRIX_ROW(Y, begin), end - begin, Y->columns, Y->stride};
+		setLayerRowsANN(ann, shard->layers, end - begin);
+	}
+	//Fold the Scaler into the first layer, propagate the parts and reduce their gradients into the layers of the ANN
+	foldScalerANN(ann);
+	if (trainer->pool != NULL)
+	{
+		runThreadPool(trainer->pool, runShardANN, trainer);
+		runThreadPool(trainer->pool, runReductionANN, trainer);
+	}
+	else
+	{
+		runShardANN(trainer, 0);
+	}
+	//Convert the dW of the first layer calculated from the unscaled X into the gradient of its W
+	if (ann->scaler != NULL)
+	{
+		unfoldScalerGradients(ann->scaler, ann->layers[0]->dW, ann->layers[0]->dB);
+	}
+	//Update the W matrices and the B vectors
+	for (int layer_no = 0; layer_no < ann->number_of_layers; layer_no++)
+	{
+		//Update the W matrix
+		updateADAM(trainer->adamW[layer_no], ann->layers[layer_no]->dW->data, (ann->layers[layer_no]->neurons_previous * ann->layers[layer_no]->neurons));
+		//Update the B vector
+		updateADAM(trainer->adamB[layer_no], ann->layers[layer_no]->dB, ann->layers[layer_no]->neurons);
+	}
+	//Return the loss of the step, the losses of the parts are summed in order
+	double loss = 0.0;
+	for (int shard_no = 0; shard_no < trainer->active_shards; shard_no++)
+	{
+		loss += trainer->shards[shard_no].loss;
+	}
+	return loss / rows;
+}
+
+//Method to dispose an ANNTrainer
+static void disposeTrainerANN(ANNTrainer* trainer)
+{
+	ANN* ann = trainer->ann;
+	//Restore the rows of the matrices of the layers of the ANN
+	setLayerRowsANN(ann, ann->layers, ann->layers[0]->samples);
+	//Dispose the layers of the other threads and the threads
+	for (int shard_no = 1; shard_no < trainer->number_of_shards; shard_no++)
+	{
+		for (int layer_no = 0; layer_no < ann->number_of_layers; layer_no++)
+		{
+			disposeSharedANNLayer(trainer->shards[shard_no].layers[layer_no]);
+		}
+		free(trainer->shards[shard_no].layers);
+	}
+	if (trainer->pool != NULL)
+	{
+		disposeThreadPool(trainer->pool);
+	}
+	//Dispose the optimizers
+	for (int layer_no = 0; layer_no < ann->number_of_layers; layer_no++)
+	{
+		//Dispose for the current W, the weights are the buffer of the W itself
+		disposeADAM(trainer->adamW[layer_no], 0);
+		//Dispose for the current B, the weights are the B itself
+		disposeADAM(trainer->adamB[layer_no], 0);
+	}
+	free(trainer->adamW);
+	free(trainer->adamB);
+	//Dispose the ANNTrainer itself
+	free(trainer->shards);
+	free(trainer);
+	trainer = NULL;
+}
+
+//Method to set the number of threads used to train the ANN
+void setThreadsANN(ANN* ann, int threads)
+{
+	if (threads < 1)
+	{
+		printf("Invalid number of threads");
+		exit(EXIT_FAILURE);
+	}
+	ann->threads = threads;
+}
+
+//Method to set the Scaler of the inputs of the ANN
+void setScalerANN(ANN* ann, Scaler* scaler)
+{
+	if (scaler != NULL && scaler->features != ann->features)
+	{
+		printf("Features of the scaler do not match the ANN");
+		exit(EXIT_FAILURE);
+	}
+	ann->scaler = scaler;
+}
+
+//Method to get the W and B of the first layer applied to the unscaled inputs
+void inputLayerParametersANN(ANN* ann, Matrix** W, double** B)
+{
+	if (ann->number_of_layers == 0)
+	{
+		printf("The ANN does not have any layers");
+		exit(EXIT_FAILURE);
+	}
+	foldScalerANN(ann);
+	*W = (ann->scaler != NULL) ? ann->W_folded : ann->layers[0]->W;
+	*B = (ann->scaler != NULL) ? ann->B_folded : ann->layers[0]->B;
+}
 
+//Method to train the ANN
+void trainANN(ANN* ann, int max_iterations, double threshold)
+{
+	//The whole data is processed at once
+	checkDataANN(ann);
+	ANNTrainer* trainer = initTrainerANN(ann, ann->samples);
+	//Initialize the previous loss as INT_MAX
+	double loss_previous = INT_MAX;
+	//Begin the iteration
+	for (int t = 0; t < max_iterations; t++)
+	{
+		//Release the temporaries of the previous iteration
+		resetWorkspace(ann->workspace);
+		//Perform the propagations and update the matrices
+		double current_loss = stepANN(trainer, ann->X, ann->Y);
 
 
 
@@ -308,23 +580,20 @@ void trainANN(ANN* ann, int max_iterations, double threshold)
 
 
 
-			//Loss calculation will be here
-			if (t%1 == 0)
+
+		//Loss calculation will be here
+		if (t%1 == 0)
+		{
+			//Break if necessary
+			if (((loss_previous - current_loss) < threshold) && (t > 1000))
 			{
-				//Calculate the current loss
-				double* y_true = flatten(ann->Y, ann->samples, ann->classes, 0);
-				double* y_pred = flatten(ann->layers[ann->number_of_layers-1]->A, ann->samples, ann->classes, 0);
-				double current_loss = logLoss(y_true, y_pred, ann->samples * ann->classes);
-				//Break if necessary
-				if (((loss_previous - current_loss) < threshold) && (t > 1000))
-				{
-					printf("BREAK\n");
-					break;
-				}
-				//Update the previous loss
-				loss_previous = current_loss;
+				printf("BREAK\n");
+				break;
 			}
-			printf("Iteration : %d, Loss : %lf\n", t, loss_previous);
+			//Update the previous loss
+			loss_previous = current_loss;
+		}
+		printf("Iteration : %d, Loss : %lf\n", t, loss_previous);
 
 
 
@@ -333,64 +602,238 @@ void trainANN(ANN* ann, int max_iterations, double threshold)
 
 
 
+	}
+	//Dispose the trainer and the optimizers after the optimization
+	disposeTrainerANN(trainer);
+}
+
+/**
+ * The mini-batch training shuffles the order of the samples at the beginning of every epoch
+ * and iterates over the order batch_size samples at a time. The rows of the X and Y of the
+ * current batch are gathered into matrices carved from the workspace, so the X and Y of the
+ * ANN stay in their contiguous matrices and a step doesn't allocate. The loss of an epoch is
+ * the mean of the losses of its batches weighted by their sizes.
+ */
+
+//Method to train the ANN using mini-batches
+void trainANNMiniBatch(ANN* ann, int epochs, int batch_size, double threshold)
+{
+	//Check the batch size, a batch can't be larger than the data
+	checkDataANN(ann);
+	if (batch_size < 1)
+	{
+		printf("Invalid batch size");
+		exit(EXIT_FAILURE);
+	}
+	batch_size = (batch_size < ann->samples) ? batch_size : ann->samples;
+	//A batch is processed at once
+	ANNTrainer* trainer = initTrainerANN(ann, batch_size);
+	//Initialize the order of the samples and handle any allocation failure
+	int* order = allocateMemory(ann->samples * sizeof(int));
+	if (order == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	for (int i = 0; i < ann->samples; i++)
+	{
+		order[i] = i;
+	}
+	//Initialize the previous loss as INT_MAX
+	double loss_previous = INT_MAX;
+	//Begin the epochs
+	for (int epoch = 0; epoch < epochs; epoch++)
+	{
+		//Shuffle the order using the Fisher-Yates shuffle
+		for (int i = ann->samples - 1; i > 0; i--)
+		{
+			int j = rand() % (i + 1);
+			int temporary = order[i];
+			order[i] = order[j];
+			order[j] = temporary;
 		}
-		//Dispose the optimizers after the optimization
-		for (int layer_no = 0; layer_no < ann->number_of_layers; layer_no++)
+		//Iterate over the batches
+		double current_loss = 0.0;
+		for (int begin = 0; begin < ann->samples; begin += batch_size)
+		{
+			int rows = (ann->samples - begin < batch_size) ? ann->samples - begin : batch_size;
+			//Release the temporaries of the previous step and gather the X and Y of the batch
+			resetWorkspace(ann->workspace);
+			Matrix* X_batch = workspaceMatrix(ann->workspace, rows, ann->features);
+			Matrix* Y_batch = workspaceMatrix(ann->workspace, rows, ann->classes);
+			for (int row_no = 0; row_no < rows; row_no++)
+			{
+				memcpy(MATRIX_ROW(X_batch, row_no), MATRIX_ROW(ann->X, order[begin + row_no]), ann->features * sizeof(double));
+				memcpy(MATRIX_ROW(Y_batch, row_no), MATRIX_ROW(ann->Y, order[begin + row_no]), ann->classes * sizeof(double));
+			}
+			//Perform the propagations, update the matrices and add the loss of the batch
+			current_loss += rows * stepANN(trainer, X_batch, Y_batch);
+		}
+		current_loss /= ann->samples;
+		printf("Epoch : %d, Loss : %lf\n", epoch, current_loss);
+		//Break if the loss has converged
+		if (fabs(loss_previous - current_loss) < threshold)
 		{
-			//Dispose for the current W
-			disposeADAM(adamW[layer_no], 1);
-			//Dispose for the current W
-			disposeADAM(adamB[layer_no], 1);
+			printf("BREAK\n");
+			break;
 		}
+		loss_previous = current_loss;
 	}
-	//Throw exception otherwise
-	else
+	//Dispose the order, the trainer and the optimizers after the optimization
+	free(order);
+	disposeTrainerANN(trainer);
+}
+
+/**
+ * The batches of a dataset file are its consecutive rows, and the order of the batches rather than the
+ * order of the rows is shuffled at the beginning of every epoch. So, each step reads a contiguous range
+ * of the file, and a file larger than the memory is read in sequential pieces rather than page by page.
+ * The batches of a file of doubles are used as views into the mapping, and the batches of a file of
+ * floats are converted into the workspace.
+ */
+
+//Method to train the ANN on a mapped dataset file using mini-batches
+void trainANNDataset(ANN* ann, DatasetFile* dataset, int epochs, int batch_size, double threshold)
+{
+	//Check the dimensions of the dataset and the batch size
+	long samples = (long) dataset->header->rows;
+	if ((int) dataset->header->features != ann->features || (int) dataset->header->labels != ann->classes || samples == 0)
 	{
-		printf("The ANN does not have an output layer");
+		printf("Dimensions of the dataset file do not match the ANN");
+		exit(EXIT_FAILURE);
+	}
+	if (batch_size < 1)
+	{
+		printf("Invalid batch size");
+		exit(EXIT_FAILURE);
+	}
+	batch_size = (batch_size < samples) ? batch_size : (int) samples;
+	//A batch is processed at once
+	ANNTrainer* trainer = initTrainerANN(ann, batch_size);
+	//Initialize the order of the batches and handle any allocation failure
+	int batches = (int) ((samples + batch_size - 1) / batch_size);
+	int* order = allocateMemory(batches * sizeof(int));
+	if (order == NULL)
+	{
+		printf("Failed to allocate memory");
 		exit(EXIT_FAILURE);
 	}
+	for (int i = 0; i < batches; i++)
+	{
+		order[i] = i;
+	}
+	//Views of the whole X and Y if the file has doubles
+	int views = (dataset->header->element_type == DATASET_FLOAT64);
+	Matrix X_file = views ? datasetFileX(dataset) : (Matrix) {NULL, 0, 0, 0};
+	Matrix Y_file = views ? datasetFileY(dataset) : (Matrix) {NULL, 0, 0, 0};
+	//Initialize the previous loss as INT_MAX
+	double loss_previous = INT_MAX;
+	//Begin the epochs
+	for (int epoch = 0; epoch < epochs; epoch++)
+	{
+		//Shuffle the order using the Fisher-Yates shuffle
+		for (int i = batches - 1; i > 0; i--)
+		{
+			int j = rand() % (i + 1);
+			int temporary = order[i];
+			order[i] = order[j];
+			order[j] = temporary;
+		}
+		//Iterate over the batches
+		double current_loss = 0.0;
+		for (int batch_no = 0; batch_no < batches; batch_no++)
+		{
+			long begin = (long) order[batch_no] * batch_size;
+			int rows = (samples - begin < batch_size) ? (int) (samples - begin) : batch_size;
+			//Release the temporaries of the previous step and get the X and Y of the batch
+			resetWorkspace(ann->workspace);
+			Matrix X_view = {MATRIX_ROW(&X_file, begin), rows, X_file.columns, X_file.stride};
+			Matrix Y_view = {MATRIX_ROW(&Y_file, begin), rows, Y_file.columns, Y_file.stride};
+			Matrix* X_batch = &X_view;
+			Matrix* Y_batch = &Y_view;
+			if (views == 0)
+			{
+				X_batch = workspaceMatrix(ann->workspace, rows, ann->features);
+				Y_batch = workspaceMatrix(ann->workspace, rows, ann->classes);
+				datasetFileRows(dataset, begin, X_batch, Y_batch);
+			}
+			//Perform the propagations, update the matrices and add the loss of the batch
+			current_loss += rows * stepANN(trainer, X_batch, Y_batch);
+		}
+		current_loss /= samples;
+		printf("Epoch : %d, Loss : %lf\n", epoch, current_loss);
+		//Break if the loss has converged
+		if (fabs(loss_previous - current_loss) < threshold)
+		{
+			printf("BREAK\n");
+			break;
+		}
+		loss_previous = current_loss;
+	}
+	//Dispose the order, the trainer and the optimizers after the optimization
+	free(order);
+	disposeTrainerANN(trainer);
 }
 
 //Method to make a prediction
 double** predictANN(ANN* ann, double** X, int samples, int features)
 {
-	//Declare the A, which will become the result, as X, which is the input layer
-	double** A = X;
+	/**
+	 * The outputs of the layers are carved from the workspace, so only the returned double**
+	 * is allocated once the workspace has grown to hold them.
+	 */
+	resetWorkspace(ann->workspace);
+	//Copy the X, which is the input layer, into a contiguous matrix and declare the A as it
+	Matrix* A = workspaceMatrix(ann->workspace, samples, features);
+	matrixCopyFromArray(A, X);
+	//Fold the Scaler into the first layer
+	foldScalerANN(ann);
 	//Iterate over the layers
 	for (int layer_no = 0; layer_no < ann->number_of_layers; layer_no++)
 	{
-		//If the previous A is not the input layer X, dispose it
-		if (layer_no != 0)
-		{
-			matrixDispose(A, samples);
-		}
+		ANNLayer* layer = ann->layers[layer_no];
+		Matrix* W = (layer_no == 0 && ann->scaler != NULL) ? ann->W_folded : layer->W;
+		double* B = (layer_no == 0 && ann->scaler != NULL) ? ann->B_folded : layer->B;
 		/*
 		 * Calculate the A of the current layer (A_l) then update the A
 		 */
-		//Initialize the A of the current layer to be returned
-		double** A_l = initMatrix(samples, ann->layers[layer_no]->neurons);
-		//Iterate over the rows of the output of the previous layer
-		for (int row_no = 0; row_no < samples; row_no++)
-		{
-			//Iterate ove the columns of the W of the current layer
-			for (int column_no = 0; column_no < ann->layers[layer_no]->neurons; column_no++)
-			{
-				//Initialize the current item of the XW as 0
-				double XW = 0.0;
-				//Iterate over the rows of the W of the current layer to perform the matrix multiplication
-				for (int item_no = 0; item_no < ann->layers[layer_no]->neurons_previous; item_no++)
-				{
-					XW += A[row_no][item_no] * ann->layers[layer_no]->W[item_no][column_no];
-				}
-				//Calculate the current item of the A_l
-				A_l[row_no][column_no] = activationFunction((XW + ann->layers[layer_no]->B[0][column_no]), ann->layers[layer_no]->activation);
-			}
-		}
+		//Carve the A of the current layer and calculate it in place, the Z isn't required for the prediction
+		Matrix* A_l = workspaceMatrix(ann->workspace, samples, layer->neurons);
+		layerForward(A, W, B, layer->activation, A_l, A_l);
 		//Update the A
 		A = A_l;
 	}
-	//Return the A
-	return A;
+	//Return the A as a double**
+	return matrixToArray(A);
+}
+
+//Method to save the parameters of an ANN into a model file
+void saveANN(ANN* ann, const char* path)
+{
+	//Check if the ANN is initialized appropriately having an output layer
+	checkOutputLayerANN(ann);
+	//Collect the W, B and activations of the layers and handle any allocation failure
+	Matrix** W = allocateMemory(ann->number_of_layers * sizeof(Matrix*));
+	double** B = allocateMemory(ann->number_of_layers * sizeof(double*));
+	int* activations = allocateMemory(ann->number_of_layers * sizeof(int));
+	if (W == NULL || B == NULL || activations == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	for (int layer_no = 0; layer_no < ann->number_of_layers; layer_no++)
+	{
+		W[layer_no] = ann->layers[layer_no]->W;
+		B[layer_no] = ann->layers[layer_no]->B;
+		activations[layer_no] = ann->layers[layer_no]->activation;
+	}
+	//The first layer is written with the Scaler folded into it, so the model takes the unscaled inputs
+	inputLayerParametersANN(ann, &W[0], &B[0]);
+	//Write the model file
+	writeModelFile(path, MODEL_FILE_ANN, ann->number_of_layers, W, B, activations);
+	free(W);
+	free(B);
+	free(activations);
 }
 
 //Method to dispose an ANN
@@ -401,6 +844,14 @@ void disposeANN(ANN* ann)
 	{
 		disposeANNLayer(ann->layers[layer_no]);
 	}
+	free(ann->layers);
+	//Dispose the copies of the X and Y
+	disposeMatrix(ann->X);
+	disposeMatrix(ann->Y);
+	//Dispose the workspace and the folded first layer, the Scaler belongs to the user
+	disposeWorkspace(ann->workspace);
+	disposeMatrix(ann->W_folded);
+	free(ann->B_folded);
 	//Dispose the ANN
 	free(ann);
 	ann = NULL;
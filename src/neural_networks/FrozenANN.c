@@ -0,0 +1,210 @@
+//FrozenANN class of LibBQsC by Berkay
+
+#include "../../include/neural_networks/FrozenANN.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../include/core/allocation.h"
+
+//Number of doubles in MATRIX_ALIGNMENT bytes, the rows of the packed W are padded to it
+#define FROZEN_ANN_PADDING ((int) (MATRIX_ALIGNMENT / sizeof(double)))
+
+//Static method to round a number of doubles up to the padding
+static int paddedSize(int n)
+{
+	return (n + FROZEN_ANN_PADDING - 1) / FROZEN_ANN_PADDING * FROZEN_ANN_PADDING;
+}
+
+//Method to compile a trained ANN into a FrozenANN
+FrozenANN* compileANN(ANN* ann)
+{
+	//Check if the ANN has an output layer
+	if (ann->number_of_layers == 0 || ann->layers[ann->number_of_layers-1]->layer_type != OUTPUT_LAYER)
+	{
+		printf("The ANN does not have an output layer");
+		exit(EXIT_FAILURE);
+	}
+	//Initialize the FrozenANN and its arrays and handle any allocation failure
+	int layers = ann->number_of_layers;
+	FrozenANN* frozen = allocateMemory(sizeof(FrozenANN));
+	Matrix* W = allocateMemory(layers * sizeof(Matrix));
+	double** B = allocateMemory(layers * sizeof(double*));
+	GEMMEpilogue* epilogues = allocateMemory(layers * sizeof(GEMMEpilogue));
+	if (frozen == NULL || W == NULL || B == NULL || epilogues == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	//Calculate the size of the parameters : W with padded rows followed by the padded B for each layer
+	long size = 0;
+	for (int layer_no = 0; layer_no < layers; layer_no++)
+	{
+		ANNLayer* layer = ann->layers[layer_no];
+		size += (long) (layer->neurons_previous + 1) * paddedSize(layer->neurons);
+	}
+	double* parameters = allocateAlignedMemory(MATRIX_ALIGNMENT, size * sizeof(double));
+	if (parameters == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	memset(parameters, 0, size * sizeof(double));
+	//Pack the parameters of the layers
+	double* position = parameters;
+	frozen->max_hidden_neurons = 0;
+	for (int layer_no = 0; layer_no < layers; layer_no++)
+	{
+		ANNLayer* layer = ann->layers[layer_no];
+		int stride = paddedSize(layer->neurons);
+		//Copy the W row by row
+		W[layer_no].data = position;
+		W[layer_no].rows = layer->neurons_previous;
+		W[layer_no].columns = layer->neurons;
+		W[layer_no].stride = stride;
+		//The first layer is copied with the Scaler of the ANN folded into it
+		Matrix* layer_W = layer->W;
+		double* layer_B = layer->B;
+		if (layer_no == 0)
+		{
+			inputLayerParametersANN(ann, &layer_W, &layer_B);
+		}
+		for (int row_no = 0; row_no < layer->neurons_previous; row_no++)
+		{
+			memcpy(MATRIX_ROW(&W[layer_no], row_no), MATRIX_ROW(layer_W, row_no), layer->neurons * sizeof(double));
+		}
+		position += (long) layer->neurons_previous * stride;
+		//Copy the B
+		B[layer_no] = position;
+		memcpy(B[layer_no], layer_B, layer->neurons * sizeof(double));
+		position += stride;
+		//Select the epilogue of the activation
+		epilogues[layer_no] = selectLayerEpilogue(layer->activation);
+		//Keep the largest hidden layer to size the scratch
+		if (layer_no < layers-1 && layer->neurons > frozen->max_hidden_neurons)
+		{
+			frozen->max_hidden_neurons = layer->neurons;
+		}
+	}
+	//Import the dimensions and the arrays
+	frozen->features = ann->layers[0]->neurons_previous;
+	frozen->classes = ann->layers[layers-1]->neurons;
+	frozen->number_of_layers = layers;
+	frozen->parameters = parameters;
+	frozen->W = W;
+	frozen->B = B;
+	frozen->epilogues = epilogues;
+	frozen->file = NULL;
+	//Return the compiled FrozenANN
+	return frozen;
+}
+
+//Method to load a FrozenANN from a model file written by saveANN()
+FrozenANN* loadFrozenANN(const char* path, int verify_checksum)
+{
+	//Map the file
+	ModelFile* file = mapModelFile(path, MODEL_FILE_ANN, verify_checksum);
+	int layers = file->header->number_of_layers;
+	//Initialize the FrozenANN and its arrays and handle any allocation failure
+	FrozenANN* frozen = allocateMemory(sizeof(FrozenANN));
+	Matrix* W = allocateMemory(layers * sizeof(Matrix));
+	double** B = allocateMemory(layers * sizeof(double*));
+	GEMMEpilogue* epilogues = allocateMemory(layers * sizeof(GEMMEpilogue));
+	if (frozen == NULL || W == NULL || B == NULL || epilogues == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	//Point the W and B of the layers into the mapping
+	frozen->max_hidden_neurons = 0;
+	for (int layer_no = 0; layer_no < layers; layer_no++)
+	{
+		W[layer_no] = modelFileW(file, layer_no);
+		B[layer_no] = modelFileB(file, layer_no);
+		//Check if the layers are consecutive and their activations are valid
+		if ((layer_no > 0 && W[layer_no].rows != W[layer_no-1].columns) || file->layers[layer_no].activation > TANH)
+		{
+			printf("Invalid model file : wrong layers");
+			exit(EXIT_FAILURE);
+		}
+		epilogues[layer_no] = selectLayerEpilogue((Activation) file->layers[layer_no].activation);
+		if (layer_no < layers-1 && W[layer_no].columns > frozen->max_hidden_neurons)
+		{
+			frozen->max_hidden_neurons = W[layer_no].columns;
+		}
+	}
+	//Import the dimensions and the arrays
+	frozen->features = W[0].rows;
+	frozen->classes = W[layers-1].columns;
+	frozen->number_of_layers = layers;
+	frozen->parameters = NULL;
+	frozen->W = W;
+	frozen->B = B;
+	frozen->epilogues = epilogues;
+	frozen->file = file;
+	//Return the loaded FrozenANN
+	return frozen;
+}
+
+//Method to get the size of the Workspace required to predict the passed number of samples
+size_t scratchSizeFrozenANN(FrozenANN* frozen, int samples)
+{
+	//Two buffers for the outputs of the hidden layers, each rounded up to the alignment of the Workspace
+	if (frozen->number_of_layers == 1)
+	{
+		return 0;
+	}
+	size_t buffer = (size_t) samples * frozen->max_hidden_neurons * sizeof(double);
+	buffer = (buffer + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT * MATRIX_ALIGNMENT;
+	return 2 * buffer;
+}
+
+/**
+ * The outputs of the hidden layers are written into two buffers in turns : each layer reads the output
+ * of the previous layer from one of them and writes its output into the other one. The output layer writes
+ * into the buffer of the caller, and each layer is calculated in place by the GEMM and its epilogue.
+ */
+
+//Method to make a prediction
+void predictFrozenANN(FrozenANN* frozen, double* X, int samples, double* output, Workspace* scratch)
+{
+	//Carve the buffers of the hidden layers
+	resetWorkspace(scratch);
+	double* buffers[2] = {NULL, NULL};
+	if (frozen->number_of_layers > 1)
+	{
+		buffers[0] = workspaceVector(scratch, samples * frozen->max_hidden_neurons);
+		buffers[1] = workspaceVector(scratch, samples * frozen->max_hidden_neurons);
+	}
+	//Declare the X as the input of the first layer
+	Matrix input = {X, samples, frozen->features, frozen->features};
+	for (int layer_no = 0; layer_no < frozen->number_of_layers; layer_no++)
+	{
+		//Write into the buffer of the caller if this is the output layer
+		int neurons = frozen->W[layer_no].columns;
+		double* data = (layer_no == frozen->number_of_layers-1) ? output : buffers[layer_no % 2];
+		Matrix result = {data, samples, neurons, neurons};
+		//A = activation_function(input x W + B)
+		LayerEpilogue argument = {frozen->B[layer_no], &result};
+		matrixGEMMEpilogue(0, 0, 1.0, &input, &frozen->W[layer_no], 0.0, &result, frozen->epilogues[layer_no], &argument);
+		//The output of this layer is the input of the next one
+		input = result;
+	}
+}
+
+//Method to dispose a FrozenANN
+void disposeFrozenANN(FrozenANN* frozen)
+{
+	//The parameters are either in the mapping of the model file or in the buffer of the FrozenANN
+	if (frozen->file != NULL)
+	{
+		unmapModelFile(frozen->file);
+	}
+	free(frozen->parameters);
+	free(frozen->W);
+	free(frozen->B);
+	free(frozen->epilogues);
+	free(frozen);
+	frozen = NULL;
+}
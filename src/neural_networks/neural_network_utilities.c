@@ -5,9 +5,10 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
 
+#include "../../include/core/allocation.h"
 #include "../../include/core/linear_algebra.h"
+#include "../../include/core/vector_kernels.h"
 
 //Method to apply the activation function
 double activationFunction(double z, Activation activation)
@@ -33,6 +34,36 @@ double activationFunction(double z, Activation activation)
 	return a;
 }
 
+//Method to multiply a vector by the derivative of the activation function, calculated from the output of the activation
+void multiplyActivationDerivative(double* dA, double* A, int n, Activation activation)
+{
+	//The loops are separated for each activation so that they can be vectorized
+	if (activation == RELU)
+	{
+		//RELU'(z) = 1 if A > 0 and 0 otherwise
+		for (int i = 0; i < n; i++)
+		{
+			dA[i] = (A[i] > 0.0) ? dA[i] : 0.0;
+		}
+	}
+	else if (activation == SIGMOID)
+	{
+		//sigmoid'(z) = A * (1 - A)
+		for (int i = 0; i < n; i++)
+		{
+			dA[i] *= A[i] * (1.0 - A[i]);
+		}
+	}
+	else if (activation == TANH)
+	{
+		//tanh'(z) = 1 - A^2
+		for (int i = 0; i < n; i++)
+		{
+			dA[i] *= 1.0 - A[i] * A[i];
+		}
+	}
+}
+
 //Method to apply the derivative of the activation function
 double activationFunctionDerivative(double z, Activation activation)
 {
@@ -59,59 +90,73 @@ double activationFunctionDerivative(double z, Activation activation)
 	return dS;
 }
 
-/*
- * initB method initialized the proper B matrix for an ANNLayer. B matrix should be
- * consist of same random rows.
+/**
+ * Epilogues of the layers, one for each activation. Each of them adds the bias to a piece
+ * of a row of the Z and writes the activation of the piece into the A.
  */
 
-//Static method to initialize the B matrix of an ANNLayer
-static double** initB(int samples, int neurons)
+//Epilogue for RELU
+static void layerEpilogueRELU(Matrix* Z, int row, int column, int n, void* argument)
 {
-	//Initialize the double** B matrix and handle any allocation failure
-	double** B = (double**) malloc (samples * sizeof(double*));
-	if (B == NULL)
+	LayerEpilogue* epilogue = argument;
+	double* Z_row = &MATRIX_AT(Z, row, column);
+	double* A_row = &MATRIX_AT(epilogue->A, row, column);
+	double* B = epilogue->B + column;
+	for (int j = 0; j < n; j++)
 	{
-		printf("Failed to allocate memory");
-		exit(EXIT_FAILURE);
+		double z = Z_row[j] + B[j];
+		Z_row[j] = z;
+		A_row[j] = (z > 0.0) ? z : 0.0;
+	}
+}
+
+//Epilogue for sigmoid
+static void layerEpilogueSIGMOID(Matrix* Z, int row, int column, int n, void* argument)
+{
+	LayerEpilogue* epilogue = argument;
+	double* Z_row = &MATRIX_AT(Z, row, column);
+	double* A_row = &MATRIX_AT(epilogue->A, row, column);
+	vectorAdditionInto(Z_row, Z_row, epilogue->B + column, n);
+	vectorSigmoid(A_row, Z_row, n);
+}
+
+//Epilogue for tanh
+static void layerEpilogueTANH(Matrix* Z, int row, int column, int n, void* argument)
+{
+	LayerEpilogue* epilogue = argument;
+	double* Z_row = &MATRIX_AT(Z, row, column);
+	double* A_row = &MATRIX_AT(epilogue->A, row, column);
+	vectorAdditionInto(Z_row, Z_row, epilogue->B + column, n);
+	vectorTanh(A_row, Z_row, n);
+}
+
+//Method to select the GEMM epilogue of an activation
+GEMMEpilogue selectLayerEpilogue(Activation activation)
+{
+	if (activation == SIGMOID)
+	{
+		return layerEpilogueSIGMOID;
 	}
-	//Seed the random number generator
-	srand(time(NULL));
-	//Define the rows of the B matrix
-	for (int i = 0; i < samples; i++)
+	else if (activation == TANH)
 	{
-		B[i] = (double*) malloc (neurons * sizeof(double));
-		//Handle the allocation failure for the current row of the array
-		if (B[i] == NULL)
-		{
-			printf("Failed to allocate memory");
-			exit(EXIT_FAILURE);
-		}
-		//Define the items of the current row
-		for (int j = 0; j < neurons; j++)
-		{
-			//If the current row is the first row
-			if (i == 0)
-			{
-				//Define the random number
-				B[i][j] = (double)rand() / RAND_MAX;
-			}
-			//Otherwise
-			else
-			{
-				//Copy the numbers from the first row
-				B[i][j] = B[0][j];
-			}
-		}
+		return layerEpilogueTANH;
 	}
-	//Return the B matrix
-	return B;
+	return layerEpilogueRELU;
+}
+
+//Method for the forward pass of a layer : Z = X x W + B and A = activation_function(Z)
+void layerForward(Matrix* X, Matrix* W, double* B, Activation activation, Matrix* Z, Matrix* A)
+{
+	//Z = XW, then the epilogue of the activation adds the B and writes the activation into the A tile by tile
+	LayerEpilogue argument = {B, A};
+	matrixGEMMEpilogue(0, 0, 1.0, X, W, 0.0, Z, selectLayerEpilogue(activation), &argument);
 }
 
 //Method to initialze an ANNLayer
 ANNLayer* initANNLayer(int samples, int neurons_previous, int neurons, LayerType layer_type, Activation activation)
 {
 	//Initialize the ANN and handle any allocation failure
-	ANNLayer* ann_layer = malloc(sizeof(ANNLayer));
+	ANNLayer* ann_layer = allocateMemory(sizeof(ANNLayer));
 	if (ann_layer == NULL)
 	{
 		printf("Failed to allocate memory");
@@ -122,19 +167,19 @@ ANNLayer* initANNLayer(int samples, int neurons_previous, int neurons, LayerType
 	ann_layer->neurons_previous = neurons_previous;
 	ann_layer->neurons = neurons;
 	//W
-	ann_layer->W = initRandomMatrix(neurons_previous, neurons);
+	ann_layer->W = createRandomMatrix(neurons_previous, neurons);
 	//B
-	ann_layer->B = initB(samples, neurons);
+	ann_layer->B = initRandomVector(neurons);
 	//Z
-	ann_layer->Z = initZeroMatrix(samples, neurons);
+	ann_layer->Z = createZeroMatrix(samples, neurons);
 	//A
-	ann_layer->A = initZeroMatrix(samples, neurons);
+	ann_layer->A = createZeroMatrix(samples, neurons);
 	//dZ
-	ann_layer->dZ = initZeroMatrix(samples, neurons);
+	ann_layer->dZ = createZeroMatrix(samples, neurons);
 	//dW
-	ann_layer->dW = initZeroMatrix(neurons_previous, neurons);
+	ann_layer->dW = createZeroMatrix(neurons_previous, neurons);
 	//dB
-	ann_layer->dB = initZeroMatrix(samples, neurons);
+	ann_layer->dB = initZeroVector(neurons);
 	//Import the layer type and the activation
 	ann_layer->layer_type = layer_type;
 	ann_layer->activation = activation;
@@ -142,19 +187,76 @@ ANNLayer* initANNLayer(int samples, int neurons_previous, int neurons, LayerType
 	return ann_layer;
 }
 
+//Method to resize the matrices of an ANNLayer whose number of rows depends on the samples
+void resizeANNLayer(ANNLayer* ann_layer, int samples)
+{
+	//Dispose the old matrices
+	disposeMatrix(ann_layer->Z);
+	disposeMatrix(ann_layer->A);
+	disposeMatrix(ann_layer->dZ);
+	//Initialize the new matrices
+	ann_layer->samples = samples;
+	ann_layer->Z = createZeroMatrix(samples, ann_layer->neurons);
+	ann_layer->A = createZeroMatrix(samples, ann_layer->neurons);
+	ann_layer->dZ = createZeroMatrix(samples, ann_layer->neurons);
+}
+
+//Method to initialize an ANNLayer sharing the W and B of another ANNLayer
+ANNLayer* initSharedANNLayer(ANNLayer* ann_layer, int samples)
+{
+	//Initialize the ANNLayer and handle any allocation failure
+	ANNLayer* shared_layer = allocateMemory(sizeof(ANNLayer));
+	if (shared_layer == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	//Import the dimensions
+	shared_layer->samples = samples;
+	shared_layer->neurons_previous = ann_layer->neurons_previous;
+	shared_layer->neurons = ann_layer->neurons;
+	//Share the W and B
+	shared_layer->W = ann_layer->W;
+	shared_layer->B = ann_layer->B;
+	//Initialize the other matrices and vectors
+	shared_layer->Z = createZeroMatrix(samples, ann_layer->neurons);
+	shared_layer->A = createZeroMatrix(samples, ann_layer->neurons);
+	shared_layer->dZ = createZeroMatrix(samples, ann_layer->neurons);
+	shared_layer->dW = createZeroMatrix(ann_layer->neurons_previous, ann_layer->neurons);
+	shared_layer->dB = initZeroVector(ann_layer->neurons);
+	//Import the layer type and the activation
+	shared_layer->layer_type = ann_layer->layer_type;
+	shared_layer->activation = ann_layer->activation;
+	//Return the initialized ANNLayer
+	return shared_layer;
+}
+
+//Method to dispose an ANNLayer sharing the W and B of another ANNLayer
+void disposeSharedANNLayer(ANNLayer* shared_layer)
+{
+	//Dispose the matrices and the vectors of the layer except the shared ones
+	disposeMatrix(shared_layer->Z);
+	disposeMatrix(shared_layer->A);
+	disposeMatrix(shared_layer->dZ);
+	disposeMatrix(shared_layer->dW);
+	free(shared_layer->dB);
+	//Dispose the ANNLayer itself
+	free(shared_layer);
+	shared_layer = NULL;
+}
+
 //Method to dispose an ANNLayer
 void disposeANNLayer(ANNLayer* ann_layer)
 {
-	//Dispose the matrices of the layer
-	matrixDispose(ann_layer->W, ann_layer->neurons_previous);
-	matrixDispose(ann_layer->B, ann_layer->samples);
-	matrixDispose(ann_layer->Z, ann_layer->samples);
-	matrixDispose(ann_layer->A, ann_layer->samples);
-	matrixDispose(ann_layer->dZ, ann_layer->samples);
-	matrixDispose(ann_layer->dW, ann_layer->neurons_previous);
-	matrixDispose(ann_layer->dB, ann_layer->samples);
+	//Dispose the matrices and the vectors of the layer
+	disposeMatrix(ann_layer->W);
+	free(ann_layer->B);
+	disposeMatrix(ann_layer->Z);
+	disposeMatrix(ann_layer->A);
+	disposeMatrix(ann_layer->dZ);
+	disposeMatrix(ann_layer->dW);
+	free(ann_layer->dB);
 	//Dispose the ANNLayer itself
 	free(ann_layer);
 	ann_layer = NULL;
 }
-
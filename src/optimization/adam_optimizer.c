@@ -6,6 +6,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "../../include/core/allocation.h"
 #include "../../include/core/linear_algebra.h"
 #include "../../include/optimization/optimization_config.h"
 
@@ -13,7 +14,7 @@
 ADAM* initADAM(double* w, int n)
 {
 	//Initialize the ADAM optimizer and handle any allocation failure
-	ADAM* adam = malloc(sizeof(ADAM));
+	ADAM* adam = allocateMemory(sizeof(ADAM));
 	if (adam == NULL)
 	{
 		printf("Failed to allocate memory");
@@ -37,7 +38,9 @@ ADAM* initADAM(double* w, int n)
 
 /**
  * Note : 	updateADAM() method works element-wise instead of using the vectorized
- * 			operations maximise the efficiency.
+ * 			operations maximise the efficiency. The bias corrections only depend on
+ * 			the t, so they are calculated once per update instead of per item, and
+ * 			the loop doesn't call pow() so the compiler can vectorize it.
  */
 
 //Method to update the weights
@@ -46,17 +49,23 @@ double* updateADAM(ADAM* adam, double* gradient, int n)
 	//Check if the passed gradient is valid
 	if (adam->n == n)
 	{
+		//Calculate the bias corrections of the moment estimates
+		double m_correction = 1.0 / (1.0 - pow(adam->beta_1, adam->t));
+		double v_correction = 1.0 / (1.0 - pow(adam->beta_2, adam->t));
 		//Iterate over the w, v and m which are all same size
+		double* w = adam->w;
+		double* m = adam->m;
+		double* v = adam->v;
 		for (int index = 0; index < adam->n; index++)
 		{
 			//Update the moment estimates
-			adam->m[index] = adam->beta_1 * adam->m[index] + (1.0 - adam->beta_1) * gradient[index];
-			adam->v[index] = adam->beta_2 * adam->v[index] + (1.0 - adam->beta_2) * pow(gradient[index], 2);
+			m[index] = adam->beta_1 * m[index] + (1.0 - adam->beta_1) * gradient[index];
+			v[index] = adam->beta_2 * v[index] + (1.0 - adam->beta_2) * gradient[index] * gradient[index];
 			//Calculate the bias-corrected moment estimates
-			double m_hat = adam->m[index] / (1.0 - pow(adam->beta_1, adam->t));
-			double v_hat = adam->v[index] / (1.0 - pow(adam->beta_2, adam->t));
+			double m_hat = m[index] * m_correction;
+			double v_hat = v[index] * v_correction;
 			//ADAM update rule
-			adam->w[index] = adam->w[index] - adam->learning_rate * m_hat / (pow(v_hat, 0.5) + adam->epsilon);
+			w[index] = w[index] - adam->learning_rate * m_hat / (sqrt(v_hat) + adam->epsilon);
 		}
 		//Increase the t
 		adam->t += 1;
@@ -5,13 +5,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "../../include/core/allocation.h"
+#include "../../include/core/vector_kernels.h"
 #include "../../include/optimization/optimization_config.h"
 
 //Constructor method of the gradient descent class
 GradientDescent* initGradientDescent(double* w, int n)
 {
 	//Initialize the GradientDescent and handle any allocation failure
-	GradientDescent* gradientDescent = malloc(sizeof(GradientDescent));
+	GradientDescent* gradientDescent = allocateMemory(sizeof(GradientDescent));
 	if (gradientDescent == NULL)
 	{
 		printf("Failed to allocate memory");
@@ -27,8 +29,8 @@ GradientDescent* initGradientDescent(double* w, int n)
 }
 
 /**
- * Note : 	updateGradientDescent() method works element-wise instead of using the vectorized
- * 			operations maximise the efficiency.
+ * Note : 	updateGradientDescent() method updates the w in place using vectorAxpy(), which
+ * 			doesn't allocate and uses the widest SIMD instructions available.
  */
 
 //Method to update the weights
@@ -37,12 +39,8 @@ double* updateGradientDescent(GradientDescent* gradientDescent, double* gradient
 	//Check if the passed gradient is valid
 	if (gradientDescent->n == n)
 	{
-		//Iterate over the w
-		for (int index = 0; index < gradientDescent->n; index++)
-		{
-			//Gradient descent update rule
-			gradientDescent->w[index] = gradientDescent->w[index] - gradientDescent->learning_rate * gradient[index];
-		}
+		//Gradient descent update rule : w = w - learning_rate * gradient
+		vectorAxpy(-gradientDescent->learning_rate, gradient, gradientDescent->w, gradientDescent->n);
 		//Return the updated w
 		return gradientDescent->w;
 	}
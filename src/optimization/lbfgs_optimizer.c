@@ -0,0 +1,148 @@
+//L-BFGS optimizer class of LibBQsC by Berkay
+
+#include "../../include/optimization/lbfgs_optimizer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../include/core/allocation.h"
+#include "../../include/core/vector_kernels.h"
+#include "../../include/optimization/optimization_config.h"
+
+//Constructor method of the L-BFGS optimizer class
+LBFGS* initLBFGS(double* w, int n)
+{
+	//Initialize the LBFGS and handle any allocation failure
+	LBFGS* lbfgs = allocateMemory(sizeof(LBFGS));
+	if (lbfgs == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	//Import the w and its size n
+	lbfgs->w = w;
+	lbfgs->n = n;
+	//Check the number of the updates to be kept
+	if (lbfgs_memory < 1)
+	{
+		printf("Invalid memory of the L-BFGS");
+		exit(EXIT_FAILURE);
+	}
+	//No update is kept yet
+	lbfgs->memory = lbfgs_memory;
+	lbfgs->count = 0;
+	lbfgs->newest = -1;
+	//The vectors share a single buffer : s, y, w_previous, gradient_previous, rho and alpha
+	size_t items = (size_t) (2 * lbfgs->memory + 2) * n + 2 * lbfgs->memory;
+	double* buffer = allocateMemory(items * sizeof(double));
+	if (buffer == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	lbfgs->s = buffer;
+	lbfgs->y = lbfgs->s + (size_t) lbfgs->memory * n;
+	lbfgs->w_previous = lbfgs->y + (size_t) lbfgs->memory * n;
+	lbfgs->gradient_previous = lbfgs->w_previous + n;
+	lbfgs->rho = lbfgs->gradient_previous + n;
+	lbfgs->alpha = lbfgs->rho + lbfgs->memory;
+	//Return the initialized LBFGS
+	return lbfgs;
+}
+
+/**
+ * Two-loop recursion :
+ *
+ * q = g
+ * for the updates from the newest to the oldest : alpha_i = rho_i s_i^T q, q = q - alpha_i y_i
+ * r = gamma q, where gamma = s^T y / y^T y of the newest update scales the initial inverse Hessian
+ * for the updates from the oldest to the newest : beta = rho_i y_i^T r, r = r + (alpha_i - beta) s_i
+ * direction = -r
+ */
+
+//Method to calculate the direction of the next step
+void directionLBFGS(LBFGS* lbfgs, double* gradient, double* direction, int n)
+{
+	//Check if the passed gradient is valid
+	if (lbfgs->n != n)
+	{
+		printf("Invalid gradient for w");
+		exit(EXIT_FAILURE);
+	}
+	//Remember the w and the gradient for the update of the step
+	memcpy(lbfgs->w_previous, lbfgs->w, n * sizeof(double));
+	memcpy(lbfgs->gradient_previous, gradient, n * sizeof(double));
+	//The q is calculated in the direction
+	memcpy(direction, gradient, n * sizeof(double));
+	for (int i = 0; i < lbfgs->count; i++)
+	{
+		int index = (lbfgs->newest - i + lbfgs->memory) % lbfgs->memory;
+		double* s = lbfgs->s + (size_t) index * n;
+		double* y = lbfgs->y + (size_t) index * n;
+		lbfgs->alpha[index] = lbfgs->rho[index] * vectorDot(s, direction, n);
+		vectorAxpy(-lbfgs->alpha[index], y, direction, n);
+	}
+	//Scale the q by the gamma of the newest update
+	if (lbfgs->count > 0)
+	{
+		double* y = lbfgs->y + (size_t) lbfgs->newest * n;
+		vectorScal(1.0 / (lbfgs->rho[lbfgs->newest] * vectorDot(y, y, n)), direction, n);
+	}
+	for (int i = lbfgs->count - 1; i >= 0; i--)
+	{
+		int index = (lbfgs->newest - i + lbfgs->memory) % lbfgs->memory;
+		double* s = lbfgs->s + (size_t) index * n;
+		double* y = lbfgs->y + (size_t) index * n;
+		double beta = lbfgs->rho[index] * vectorDot(y, direction, n);
+		vectorAxpy(lbfgs->alpha[index] - beta, s, direction, n);
+	}
+	vectorScal(-1.0, direction, n);
+}
+
+//Method to keep the update of a step taken by the caller
+void updateLBFGS(LBFGS* lbfgs, double* gradient, int n)
+{
+	//Check if the passed gradient is valid
+	if (lbfgs->n != n)
+	{
+		printf("Invalid gradient for w");
+		exit(EXIT_FAILURE);
+	}
+	//Calculate the update into the slot after the newest one, which overwrites the oldest one if the ring is full
+	int index = (lbfgs->newest + 1) % lbfgs->memory;
+	double* s = lbfgs->s + (size_t) index * n;
+	double* y = lbfgs->y + (size_t) index * n;
+	vectorSubtractionInto(s, lbfgs->w, lbfgs->w_previous, n);
+	vectorSubtractionInto(y, gradient, lbfgs->gradient_previous, n);
+	//Keep the update only if it satisfies the curvature condition
+	double ys = vectorDot(y, s, n);
+	if (ys > 1e-10 * vectorDot(y, y, n))
+	{
+		lbfgs->rho[index] = 1.0 / ys;
+		lbfgs->newest = index;
+		lbfgs->count += (lbfgs->count < lbfgs->memory);
+	}
+	//The oldest update was overwritten otherwise if the ring was full
+	else if (lbfgs->count == lbfgs->memory)
+	{
+		lbfgs->count--;
+	}
+}
+
+//Method to dispose an LBFGS
+void disposeLBFGS(LBFGS* lbfgs, int dispose_w)
+{
+	//Dispose the buffer of the vectors
+	free(lbfgs->s);
+	lbfgs->s = NULL;
+	//Dispose the w as well if required
+	if (dispose_w == 1)
+	{
+		free(lbfgs->w);
+		lbfgs->w = NULL;
+	}
+	//Dispose the LBFGS itself
+	free(lbfgs);
+	lbfgs = NULL;
+}
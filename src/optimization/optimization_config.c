@@ -10,3 +10,13 @@ double adam_learning_rate = 0.001;
 double adam_beta_1 = 0.9;
 double adam_beta_2 = 0.999;
 double adam_epsilon = 1e-8;
+
+//Newton optimizer parameters
+double newton_ridge = 1e-6;
+
+//L-BFGS optimizer parameters
+int lbfgs_memory = 10;
+
+//Backtracking line search parameters of the second-order optimizers
+double line_search_sufficient_decrease = 1e-4;
+int line_search_max_steps = 30;
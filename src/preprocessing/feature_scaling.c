@@ -3,7 +3,10 @@
 #include "../../include/preprocessing/feature_scaling.h"
 
 #include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
 
+#include "../../include/core/allocation.h"
 #include "../../include/core/linear_algebra.h"
 
 //Method for min-max scaling
@@ -18,8 +21,7 @@ double** minMaxScale(double** X_input, double* min, double* range, int samples,
 		for (int j = 0; j < features; j++)
 		{
 			//Min and range are vectors of the minimums and ranges of the columns (min[n] is the minimum of the nth column)
-			X_scaled[i][j] -= min[j];
-			X_scaled[i][j] /= range[j];
+			X_scaled[i][j] = (X_input[i][j] - min[j]) / range[j];
 		}
 	}
 	//Return the scaled X
@@ -38,8 +40,7 @@ double** inverseMinMaxScale(double** X_scaled, double* min, double* range, int s
 		for (int j = 0; j < features; j++)
 		{
 			//Min and range are vectors of the minimums and ranges of the columns (min[n] is the minimum of the nth column)
-			X[i][j] *= range[j];
-			X[i][j] += min[j];
+			X[i][j] = range[j] * X_scaled[i][j] + min[j];
 		}
 	}
 	//Return the scaled X
@@ -58,8 +59,7 @@ double** standardize(double** X_input, double* mean, double* standard_deviation,
 		for (int j = 0; j < features; j++)
 		{
 			//Mean and standard_deviation are vectors of the means and standard deviations of the columns (mean[n] is the mean of the nth column)
-			X_scaled[i][j] -= mean[j];
-			X_scaled[i][j] /= standard_deviation[j];
+			X_scaled[i][j] = (X_input[i][j] - mean[j]) / standard_deviation[j];
 
 			//Temp
 			if (isinf(X_scaled[i][j]))
@@ -85,10 +85,367 @@ double** inverseStandardize(double** X_scaled, double* mean, double* standard_de
 		for (int j = 0; j < features; j++)
 		{
 			//Mean and standard_deviation are vectors of the means and standard deviations of the columns (mean[n] is the mean of the nth column)
-			X[i][j] *= standard_deviation[j];
-			X[i][j] += mean[j];
+			X[i][j] = standard_deviation[j] * X_scaled[i][j] + mean[j];
 		}
 	}
 	//Return the scaled X
 	return X;
 }
+
+/**
+ * Methods for contiguous matrices
+ *
+ * Each row is read from the passed Matrix and written into the same row of the new
+ * Matrix in a single pass.
+ */
+
+//Method for min-max scaling of a Matrix
+Matrix* minMaxScaleMatrix(Matrix* X_input, double* min, double* range)
+{
+	//Initialize the scaled X matrix
+	Matrix* X_scaled = createMatrix(X_input->rows, X_input->columns);
+	//Iterate over the rows of the matrix
+	for (int i = 0; i < X_input->rows; i++)
+	{
+		double* x = MATRIX_ROW(X_input, i);
+		double* x_scaled = MATRIX_ROW(X_scaled, i);
+		//Do (x - min_x)/(range_x)
+		for (int j = 0; j < X_input->columns; j++)
+		{
+			x_scaled[j] = (x[j] - min[j]) / range[j];
+		}
+	}
+	//Return the scaled X
+	return X_scaled;
+}
+
+//Method to revert min-max scaling of a Matrix
+Matrix* inverseMinMaxScaleMatrix(Matrix* X_scaled, double* min, double* range)
+{
+	//Initialize the X matrix
+	Matrix* X = createMatrix(X_scaled->rows, X_scaled->columns);
+	//Iterate over the rows of the matrix
+	for (int i = 0; i < X_scaled->rows; i++)
+	{
+		double* x_scaled = MATRIX_ROW(X_scaled, i);
+		double* x = MATRIX_ROW(X, i);
+		//Do ((x_max - x_min) * x_scaled) + x_min
+		for (int j = 0; j < X_scaled->columns; j++)
+		{
+			x[j] = range[j] * x_scaled[j] + min[j];
+		}
+	}
+	//Return the X
+	return X;
+}
+
+//Method for standardization of a Matrix
+Matrix* standardizeMatrix(Matrix* X_input, double* mean, double* standard_deviation)
+{
+	//Initialize the scaled X matrix
+	Matrix* X_scaled = createMatrix(X_input->rows, X_input->columns);
+	//Iterate over the rows of the matrix
+	for (int i = 0; i < X_input->rows; i++)
+	{
+		double* x = MATRIX_ROW(X_input, i);
+		double* x_scaled = MATRIX_ROW(X_scaled, i);
+		//Do (x - mean_x)/(standard_deviation_x)
+		for (int j = 0; j < X_input->columns; j++)
+		{
+			x_scaled[j] = (x[j] - mean[j]) / standard_deviation[j];
+			//Constant columns have zero standard deviation
+			if (isinf(x_scaled[j]))
+			{
+				x_scaled[j] = 0.0;
+			}
+		}
+	}
+	//Return the scaled X
+	return X_scaled;
+}
+
+//Method to revert standardization of a Matrix
+Matrix* inverseStandardizeMatrix(Matrix* X_scaled, double* mean, double* standard_deviation)
+{
+	//Initialize the X matrix
+	Matrix* X = createMatrix(X_scaled->rows, X_scaled->columns);
+	//Iterate over the rows of the matrix
+	for (int i = 0; i < X_scaled->rows; i++)
+	{
+		double* x_scaled = MATRIX_ROW(X_scaled, i);
+		double* x = MATRIX_ROW(X, i);
+		//Do (x_standard_deviation * x_scaled) + x_mean
+		for (int j = 0; j < X_scaled->columns; j++)
+		{
+			x[j] = standard_deviation[j] * x_scaled[j] + mean[j];
+		}
+	}
+	//Return the X
+	return X;
+}
+
+/**
+ * Methods of the Scaler
+ */
+
+//Method to initialize a Scaler that doesn't change the features
+Scaler* initScaler(ScalerType type, int features)
+{
+	//Initialize the Scaler and its arrays and handle any allocation failure
+	Scaler* scaler = allocateMemory(sizeof(Scaler));
+	double* arrays = allocateMemory(3 * (size_t) features * sizeof(double));
+	if (scaler == NULL || arrays == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	//The arrays share a single buffer
+	scaler->type = type;
+	scaler->features = features;
+	scaler->offset = arrays;
+	scaler->scale = arrays + features;
+	scaler->inverse_scale = arrays + 2 * features;
+	for (int j = 0; j < features; j++)
+	{
+		scaler->offset[j] = 0.0;
+		scaler->scale[j] = 1.0;
+		scaler->inverse_scale[j] = 1.0;
+	}
+	//Return the initialized Scaler
+	return scaler;
+}
+
+//Static method to set the inverses of the scales, the features whose scale is 0 are only shifted
+static void updateInverseScales(Scaler* scaler)
+{
+	for (int j = 0; j < scaler->features; j++)
+	{
+		if (scaler->scale[j] == 0.0 || !isfinite(scaler->scale[j]))
+		{
+			scaler->scale[j] = 1.0;
+		}
+		scaler->inverse_scale[j] = 1.0 / scaler->scale[j];
+	}
+}
+
+//Method to fit a Scaler to the features of a Matrix
+void fitScaler(Scaler* scaler, Matrix* X)
+{
+	//Check the dimensions
+	if (X->columns != scaler->features || X->rows < 1)
+	{
+		printf("Invalid matrix to fit the scaler");
+		exit(EXIT_FAILURE);
+	}
+	//The min-max and standard scalers only need the statistics of the columns
+	if (scaler->type != ROBUST_SCALER)
+	{
+		ColumnStatistics* statistics = columnStatistics(X, 1);
+		fitScalerStatistics(scaler, statistics);
+		disposeColumnStatistics(statistics);
+		return;
+	}
+	//The robust scaler selects the median and the quartiles of each column from a scratch copy of it
+	double* column = allocateMemory((size_t) X->rows * sizeof(double));
+	if (column == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	for (int j = 0; j < X->columns; j++)
+	{
+		for (int i = 0; i < X->rows; i++)
+		{
+			column[i] = MATRIX_AT(X, i, j);
+		}
+		scaler->offset[j] = selectQuantile(column, X->rows, 0.5);
+		scaler->scale[j] = selectQuantile(column, X->rows, 0.75) - selectQuantile(column, X->rows, 0.25);
+	}
+	free(column);
+	updateInverseScales(scaler);
+}
+
+//Method to fit a min-max or standard Scaler to the statistics of the features
+void fitScalerStatistics(Scaler* scaler, ColumnStatistics* statistics)
+{
+	//Check the type and the dimensions, the quantiles of a robust scaler aren't in the statistics
+	if (scaler->type == ROBUST_SCALER || statistics->columns != scaler->features || statistics->count < 1)
+	{
+		printf("Invalid statistics to fit the scaler");
+		exit(EXIT_FAILURE);
+	}
+	if (scaler->type == MIN_MAX_SCALER)
+	{
+		for (int j = 0; j < scaler->features; j++)
+		{
+			scaler->offset[j] = statistics->min[j];
+		}
+		columnRanges(statistics, scaler->scale);
+	}
+	else
+	{
+		for (int j = 0; j < scaler->features; j++)
+		{
+			scaler->offset[j] = statistics->mean[j];
+		}
+		columnStandardDeviations(statistics, scaler->scale);
+	}
+	updateInverseScales(scaler);
+}
+
+//Method to fit a robust Scaler to the quantile sketches of the features
+void fitScalerQuantiles(Scaler* scaler, QuantileSketch** sketches)
+{
+	//Check the type, the medians and the quartiles of the other scalers aren't used
+	if (scaler->type != ROBUST_SCALER)
+	{
+		printf("Invalid sketches to fit the scaler");
+		exit(EXIT_FAILURE);
+	}
+	for (int j = 0; j < scaler->features; j++)
+	{
+		scaler->offset[j] = sketchQuantile(sketches[j], 0.5);
+		scaler->scale[j] = sketchQuantile(sketches[j], 0.75) - sketchQuantile(sketches[j], 0.25);
+	}
+	updateInverseScales(scaler);
+}
+
+//Method to scale the features of a Matrix in place
+void transformScaler(Scaler* scaler, Matrix* X)
+{
+	transformScalerInto(scaler, X, X);
+}
+
+//Method to scale the features of a Matrix into another Matrix
+void transformScalerInto(Scaler* scaler, Matrix* X, Matrix* X_scaled)
+{
+	//Check the dimensions
+	if (X->columns != scaler->features || X_scaled->columns != scaler->features || X_scaled->rows != X->rows)
+	{
+		printf("Invalid matrix dimensions to scale");
+		exit(EXIT_FAILURE);
+	}
+	double* offset = scaler->offset;
+	double* inverse_scale = scaler->inverse_scale;
+	//Do (x - offset) * (1 / scale) row by row
+	for (int i = 0; i < X->rows; i++)
+	{
+		double* x = MATRIX_ROW(X, i);
+		double* x_scaled = MATRIX_ROW(X_scaled, i);
+		for (int j = 0; j < scaler->features; j++)
+		{
+			x_scaled[j] = (x[j] - offset[j]) * inverse_scale[j];
+		}
+	}
+}
+
+//Method to revert the scaling of the features of a Matrix in place
+void inverseTransformScaler(Scaler* scaler, Matrix* X_scaled)
+{
+	//Check the dimensions
+	if (X_scaled->columns != scaler->features)
+	{
+		printf("Invalid matrix dimensions to scale");
+		exit(EXIT_FAILURE);
+	}
+	double* offset = scaler->offset;
+	double* scale = scaler->scale;
+	//Do x_scaled * scale + offset row by row
+	for (int i = 0; i < X_scaled->rows; i++)
+	{
+		double* x = MATRIX_ROW(X_scaled, i);
+		for (int j = 0; j < scaler->features; j++)
+		{
+			x[j] = x[j] * scale[j] + offset[j];
+		}
+	}
+}
+
+//Method to fold a Scaler into the parameters of a linear layer
+void foldScaler(Scaler* scaler, Matrix* W, double* B, Matrix* W_folded, double* B_folded)
+{
+	//Check the dimensions
+	if (W->rows != scaler->features || W_folded->rows != W->rows || W_folded->columns != W->columns)
+	{
+		printf("Invalid matrix dimensions to fold the scaler");
+		exit(EXIT_FAILURE);
+	}
+	int neurons = W->columns;
+	for (int k = 0; k < neurons; k++)
+	{
+		B_folded[k] = B[k];
+	}
+	//Divide each row of the W by the scale of its feature and subtract its shifted row from the B
+	for (int j = 0; j < scaler->features; j++)
+	{
+		double* w = MATRIX_ROW(W, j);
+		double* w_folded = MATRIX_ROW(W_folded, j);
+		double inverse_scale = scaler->inverse_scale[j];
+		double offset = scaler->offset[j];
+		for (int k = 0; k < neurons; k++)
+		{
+			w_folded[k] = w[k] * inverse_scale;
+			B_folded[k] -= offset * w_folded[k];
+		}
+	}
+}
+
+//Method to convert the gradients of a folded layer into the gradients of its W
+void unfoldScalerGradients(Scaler* scaler, Matrix* dW, double* dB)
+{
+	//Check the dimensions
+	if (dW->rows != scaler->features)
+	{
+		printf("Invalid matrix dimensions to unfold the scaler");
+		exit(EXIT_FAILURE);
+	}
+	//Do (dw - offset * dB) * (1 / scale) for each row of the dW
+	for (int j = 0; j < scaler->features; j++)
+	{
+		double* dw = MATRIX_ROW(dW, j);
+		double inverse_scale = scaler->inverse_scale[j];
+		double offset = scaler->offset[j];
+		for (int k = 0; k < dW->columns; k++)
+		{
+			dw[k] = (dw[k] - offset * dB[k]) * inverse_scale;
+		}
+	}
+}
+
+//Method to unfold a Scaler from the parameters of a linear layer
+void unfoldScaler(Scaler* scaler, Matrix* W_folded, double* B_folded, Matrix* W, double* B)
+{
+	//Check the dimensions
+	if (W_folded->rows != scaler->features || W->rows != W_folded->rows || W->columns != W_folded->columns)
+	{
+		printf("Invalid matrix dimensions to unfold the scaler");
+		exit(EXIT_FAILURE);
+	}
+	int neurons = W->columns;
+	for (int k = 0; k < neurons; k++)
+	{
+		B[k] = B_folded[k];
+	}
+	//Add the shifted row of the W_folded to the B before multiplying it by the scale of its feature
+	for (int j = 0; j < scaler->features; j++)
+	{
+		double* w_folded = MATRIX_ROW(W_folded, j);
+		double* w = MATRIX_ROW(W, j);
+		double inverse_scale = scaler->inverse_scale[j];
+		double offset = scaler->offset[j];
+		for (int k = 0; k < neurons; k++)
+		{
+			B[k] += offset * w_folded[k];
+			w[k] = w_folded[k] / inverse_scale;
+		}
+	}
+}
+
+//Method to dispose a Scaler
+void disposeScaler(Scaler* scaler)
+{
+	//The arrays share the buffer of the offsets
+	free(scaler->offset);
+	free(scaler);
+	scaler = NULL;
+}
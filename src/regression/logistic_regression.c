@@ -6,237 +6,742 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "../../include/core/allocation.h"
+#include "../../include/core/gemm.h"
 #include "../../include/core/linear_algebra.h"
-#include "../../include/metrics/regression_metrics.h"
+#include "../../include/core/sparse_matrix.h"
+#include "../../include/core/workspace.h"
 #include "../../include/optimization/adam_optimizer.h"
 #include "../../include/optimization/gradient_descent.h"
+#include "../../include/optimization/lbfgs_optimizer.h"
 #include "../../include/statistics/statistics.h"
 
 //Define the constant variables
 int debugTrainingLogisticRegression = 0;
 
-//Method to initialize a LogisticRegression struct
-LogisticRegression* initLogisticRegression(double** X, double** Y, int samples, int features, int classes)
+//Number of the rows of the X weighted at once to calculate the Hessian
+#define HESSIAN_ROWS 1024
+
+//Static method to initialize a LogisticRegression struct without its X, the Y is NULL for an online model
+static LogisticRegression* allocateLogisticRegression(double** Y, int samples, int features, int classes)
 {
 	//Initialize the logistic regression and handle any allocation failure
-	LogisticRegression* regr = malloc(sizeof(LogisticRegression));
+	LogisticRegression* regr = allocateMemory(sizeof(LogisticRegression));
 	if (regr == NULL)
 	{
 		printf("Failed to allocate memory");
 		exit(EXIT_FAILURE);
 	}
-	//Import the X and Y matrices
-	regr->X = X;
-	regr->Y = Y;
+	//Copy the Y matrix into a contiguous matrix
+	regr->X = NULL;
+	regr->X_sparse = NULL;
+	regr->Y = (Y != NULL) ? matrixFromArray(Y, samples, classes) : NULL;
 	//Import the dimensions of the matrices
 	regr->samples = samples;
 	regr->features = features;
 	regr->classes = classes;
 	//Initialize the W and dW matrices
-	regr->W = initRandomMatrix(features, classes);
-	regr->dW = initMatrix(features, classes);
+	regr->W = createRandomMatrix(features, classes);
+	regr->dW = createMatrix(features, classes);
 	//Initialize the b and db matrices
 	regr->b = initRandomVector(classes);
 	regr->db = initVector(classes);
-	//The P will be NULL initially
-	regr->P = NULL;
+	//Initialize the P, it is overwritten by each training iteration
+	regr->P = (Y != NULL) ? createMatrix(samples, classes) : NULL;
+	regr->workspace = initWorkspace(0);
+	//The online optimizers are initialized by the first chunk
+	regr->online_optimizer = GRADIENT_DESCENT;
+	regr->optimizer_w = NULL;
+	regr->optimizer_b = NULL;
+	//The features aren't scaled unless setScalerLogisticRegression() is called
+	regr->scaler = NULL;
 	//Initialize the log loss as INT_MAX
 	regr->log_loss = INT_MAX;
+	//The parameters are owned by the model
+	regr->file = NULL;
+	//Return the initialized logistic regression
+	return regr;
+}
+
+//Method to initialize a LogisticRegression struct
+LogisticRegression* initLogisticRegression(double** X, double** Y, int samples, int features, int classes)
+{
+	//Initialize the logistic regression and copy the X matrix into a contiguous matrix
+	LogisticRegression* regr = allocateLogisticRegression(Y, samples, features, classes);
+	regr->X = matrixFromArray(X, samples, features);
 	//Return the initialized logistic regression
 	return regr;
 }
 
+//Method to initialize a LogisticRegression struct with a sparse X
+LogisticRegression* initLogisticRegressionSparse(SparseMatrix* X, double** Y, int classes)
+{
+	//Initialize the logistic regression and copy the arrays of the X
+	LogisticRegression* regr = allocateLogisticRegression(Y, X->rows, X->columns, classes);
+	regr->X_sparse = cloneSparseMatrix(X);
+	//Return the initialized logistic regression
+	return regr;
+}
+
+//Method to initialize a LogisticRegression struct to be trained online
+LogisticRegression* initLogisticRegressionOnline(int features, int classes)
+{
+	//The model doesn't keep any rows
+	return allocateLogisticRegression(NULL, 0, features, classes);
+}
+
 /**
  * Sigmoid and softmax functions :
  *
  * sigmoid(z) = 1 / (1 + exp(-z))
  *
  * softmax(zi) = exp(zi) / sum(exp(z))
+ *
+ * Both are applied to a row of the Z in place by the vector kernels (vectorSigmoid() and vectorSoftmax()),
+ * so the row becomes the corresponding row of the P.
+ */
+
+/**
+ * In calculating the P in this method, XW is calculated into the P by matrixGEMMEpilogue(), and the b and the
+ * sigmoid/softmax are applied by its epilogue to each piece of a row of the P as soon as the piece is final, while
+ * it is still in the cache. The softmax of a row needs all of its items, so the epilogue counts the final items of
+ * each row and applies the softmax to the row when the last piece of it is final.
+ *
+ * A sparse X is multiplied by sparseMatrixGEMMEpilogue() instead, which passes each row to the same epilogues
+ * as a single piece, so the cost is proportional to the nonzero items of the X rather than its size.
+ *
+ * The number of samples may be different when using this method to make a prediction
+ * other than to train the model, so the P is passed by the caller : the training passes
+ * the P of the model and the prediction initializes the returned one. The W and b are
+ * passed as well, they are the ones with the Scaler folded into them if the model has a
+ * Scaler. The counters of the rows are carved from the workspace.
  */
 
-//Method to apply sigmoid to a vector
-static double* sigmoid(double* z, int n)
+/**
+ * Arguments of the epilogues of the P
+ */
+typedef struct
 {
-	//Initialize the resulting vector p
-	double* p = initVector(n);
-	//Apply the sigmoid for all items of the z into the p
-	for (int index = 0; index < n; index++)
+	//b to be added to the rows
+	double* b;
+	//Number of final items of each row, only used by the softmax
+	int* final_items;
+}
+PEpilogue;
+
+//Epilogue for sigmoid : P = sigmoid(XW + b)
+static void epilogueSigmoid(Matrix* P, int row, int column, int n, void* argument)
+{
+	PEpilogue* epilogue = argument;
+	double* z = &MATRIX_AT(P, row, column);
+	vectorAdditionInto(z, z, epilogue->b + column, n);
+	vectorSigmoid(z, z, n);
+}
+
+//Epilogue for softmax : P = softmax(XW + b) once all pieces of the row are final
+static void epilogueSoftmax(Matrix* P, int row, int column, int n, void* argument)
+{
+	PEpilogue* epilogue = argument;
+	double* z = &MATRIX_AT(P, row, column);
+	vectorAdditionInto(z, z, epilogue->b + column, n);
+	epilogue->final_items[row] += n;
+	if (epilogue->final_items[row] == P->columns)
 	{
-		p[index] = 1.0 / (1.0 + exp(-1.0 * z[index]));
+		vectorSoftmax(MATRIX_ROW(P, row), MATRIX_ROW(P, row), P->columns);
 	}
-	//Return the p
-	return p;
 }
 
-//Method to apply softmax to a vector
-static double* softmax(double* z, int n)
+//Method to generate the P : output of the logistic regression for the passed X matrix, either the X or the X_sparse is NULL
+static void generateP(LogisticRegression* regr, Matrix* X, SparseMatrix* X_sparse, Matrix* W, double* b, Matrix* P)
 {
-	//Find the maximum number in the z to use for numerical stability
-	double max_z = max(z, n);
-	//max_z will be subtracted from every exp(zi)
-	double sum_exp = 0.0;
-	//Iterate to calculate the sum of exponentials
-	for (int index = 0; index < n; index++)
+	int rows = (X != NULL) ? X->rows : X_sparse->rows;
+	int columns = (X != NULL) ? X->columns : X_sparse->columns;
+	//If the passed X matrix is valid
+	if (columns == regr->features)
 	{
-		sum_exp += exp(z[index] - max_z);
+		/**
+		 * Calculate the P :
+		 *
+		 * Z = XW + b
+		 * P = sigmoid/softmax(Z)
+		 */
+		PEpilogue epilogue = {b, NULL};
+		//Apply sigmoid if there is one class, or apply softmax otherwise
+		GEMMEpilogue method = epilogueSigmoid;
+		if (regr->classes > 1)
+		{
+			epilogue.final_items = workspaceAllocate(regr->workspace, rows * sizeof(int));
+			memset(epilogue.final_items, 0, rows * sizeof(int));
+			method = epilogueSoftmax;
+		}
+		if (X != NULL)
+		{
+			matrixGEMMEpilogue(0, 0, 1.0, X, W, 0.0, P, method, &epilogue);
+		}
+		else
+		{
+			sparseMatrixGEMMEpilogue(1.0, X_sparse, W, 0.0, P, method, &epilogue);
+		}
 	}
-	//Initialize the resulting vector p
-	double* p = initVector(n);
-	//Do exp(xi)/sum exp(x) to calculate the p
-	for (int index = 0; index < n; index++)
+	//Throw exception otherwise
+	else
 	{
-		p[index] = exp(z[index] - max_z) / sum_exp;
+		printf("Invalid X matrix.");
+		exit(EXIT_FAILURE);
 	}
-	//Return the p
-	return p;
 }
 
 /**
- * In calculating the P in this method, the ith row of the Z is disposed as ith
- * row of the P is generated out of the ith row of the Z.
+ * With a Scaler, X_scaled x W + b is calculated as X x W_folded + b_folded, and the gradients are calculated
+ * from the unscaled X and converted into the gradients of the W and b by unfoldScalerGradients().
+ */
+
+//Method to get the W and b applied to the unscaled X, the folded ones are carved from the workspace
+static void foldedParameters(LogisticRegression* regr, Matrix** W, double** b)
+{
+	*W = regr->W;
+	*b = regr->b;
+	if (regr->scaler != NULL)
+	{
+		*W = workspaceMatrix(regr->workspace, regr->features, regr->classes);
+		*b = workspaceVector(regr->workspace, regr->classes);
+		foldScaler(regr->scaler, regr->W, regr->b, *W, *b);
+	}
+}
+
+/**
+ * The method to update the gradients uses the regr->P (the latest p) to update the
+ * dW and db, so before calling it, update_P needs to be called first. Similarly,
+ * the method update_W_b needs dW and db to be updated.
+ */
+
+//Method to update the P : XW + b
+static void update_P(LogisticRegression* regr)
+{
+	//Generate the P of the model with the folded W and b
+	Matrix* W;
+	double* b;
+	foldedParameters(regr, &W, &b);
+	generateP(regr, regr->X, regr->X_sparse, W, b, regr->P);
+}
+
+/**
+ * The gradients and the log loss are calculated in a single pass over the rows of the X, P and Y :
+ *
+ * r = p - y
+ * dW += x^T r
+ * db += r
+ * loss -= y log(p)
  *
- * It would be impractical to store the P in the passed logistic regression struct like
- * the gradients are due to the dimensions of the P. A P matrix has dimensions of
- * (samples, classes) and the number of samples may be different when using this method to
- * make a prediction other than to train the model. Thus, this method returns a new P
- * matrix instead of updating an existing P matrix.
+ * So, each row of the X is read once while the dW is kept in the cache, instead of reading the X
+ * column by column and calculating the P - Y again for each feature, the db and the loss. Only the
+ * labels that aren't 0 contribute to the loss, and the features that are 0 are skipped. A row of a
+ * sparse X only adds its nonzero items, so the pass costs the nonzero items of the X. The loss of
+ * a single class is the binary log loss, so it is the loss whose gradients are calculated, which the
+ * line search of the second-order optimizers relies on.
  */
 
-//Method to generate the P : output of the logistic regression for the passed X matrix
-static double** generateP(LogisticRegression* regr, double** X, int samples, int features)
+//Method to update the dW : 1/m X^T (P - Y) and the db : mean(P - Y) of the rows of an X, returns the log loss, either the X or the X_sparse is NULL
+static double update_gradients(LogisticRegression* regr, Matrix* X, SparseMatrix* X_sparse, Matrix* P, Matrix* Y)
 {
-	//If the passed X matrix is valid
-	if (features == regr->features)
+	//Small value to avoid numerical instability (log(0)), same as the one of the log loss metrics
+	double epsilon = 1e-15;
+	double loss = 0.0;
+	Matrix* dW = regr->dW;
+	double* db = regr->db;
+	double* r = workspaceVector(regr->workspace, regr->classes);
+	memset(dW->data, 0, dW->rows * dW->stride * sizeof(double));
+	memset(db, 0, regr->classes * sizeof(double));
+	//Iterate over the rows
+	for (int row_no = 0; row_no < P->rows; row_no++)
 	{
-		/**
-		 * Calculate the P :
-		 *
-		 * Z = XW + b
-		 * P = sigmoid/softmax(Z)
-		 */
-		//Initialize the Z : XW
-		double** Z = initMatrix(samples, regr->classes);
-		//Initialize the P and handle the allocation failure for the array (It will be double** but its rows won't be initialized yet)
-		double** P = (double**) malloc (samples * sizeof(double*));
-		if (P == NULL)
+		double* p = MATRIX_ROW(P, row_no);
+		double* y = MATRIX_ROW(Y, row_no);
+		//Calculate the residual of the row, and add it to the db and its log loss to the loss
+		vectorSubtractionInto(r, p, y, regr->classes);
+		vectorAdditionInto(db, db, r, regr->classes);
+		if (regr->classes == 1)
 		{
-			printf("Failed to allocate memory");
-			exit(EXIT_FAILURE);
+			//The loss of a single class has the term of its complement as well : -(y log(p) + (1 - y) log(1 - p))
+			double p_clipped = fmax(epsilon, fmin(1.0 - epsilon, p[0]));
+			if (y[0] != 0.0)
+			{
+				loss -= y[0] * log(p_clipped);
+			}
+			if (y[0] != 1.0)
+			{
+				loss -= (1.0 - y[0]) * log(1.0 - p_clipped);
+			}
 		}
-		//Iterate over the rows of the Z
-		for (int row_no = 0; row_no < samples; row_no++)
+		else
 		{
-			//Iterate over the columns of the Z
-			for (int column_no = 0; column_no < regr->classes; column_no++)
+			for (int class_no = 0; class_no < regr->classes; class_no++)
 			{
-				double current_item = 0.0;
-				//Iterate over the columns/rows of the X/W to perform the matrix multiplication
-				for (int item_no = 0; item_no < features; item_no++)
+				if (y[class_no] != 0.0)
 				{
-					current_item += X[row_no][item_no] * regr->W[item_no][column_no];
+					loss -= y[class_no] * log(fmax(epsilon, fmin(1.0 - epsilon, p[class_no])));
 				}
-				//Set the current item of the Z
-				Z[row_no][column_no] = current_item + regr->b[column_no];
 			}
-			//After the current row is done, apply sigmoid into the current row of P if there is one class
-			if (regr->classes == 1)
+		}
+		//Add the rank-1 update of the row, the dW of a single class is a contiguous column
+		if (X_sparse != NULL)
+		{
+			for (long index = X_sparse->row_offsets[row_no]; index < X_sparse->row_offsets[row_no + 1]; index++)
 			{
-				P[row_no] = sigmoid(Z[row_no], regr->classes);
+				vectorAxpy(X_sparse->values[index], r, MATRIX_ROW(dW, X_sparse->column_indices[index]), regr->classes);
 			}
-			//Or apply softmax otherwise
-			else
+		}
+		else if (regr->classes == 1)
+		{
+			vectorAxpy(r[0], MATRIX_ROW(X, row_no), dW->data, regr->features);
+		}
+		else
+		{
+			double* x = MATRIX_ROW(X, row_no);
+			for (int feature_no = 0; feature_no < regr->features; feature_no++)
 			{
-				P[row_no] = softmax(Z[row_no], regr->classes);
+				if (x[feature_no] != 0.0)
+				{
+					vectorAxpy(x[feature_no], r, MATRIX_ROW(dW, feature_no), regr->classes);
+				}
 			}
-			//The current row of the Z can be freed now since it won't be used again
-			free(Z[row_no]);
-			Z[row_no] = NULL;
 		}
-		//There are not any rows remaining in the Z
-		free(Z);
-		Z = NULL;
-		//Return the P
-		return P;
 	}
-	//Throw exception otherwise
-	else
+	//Take the means
+	vectorScal(1.0 / P->rows, dW->data, dW->rows * dW->stride);
+	vectorScal(1.0 / P->rows, db, regr->classes);
+	return loss / P->rows;
+}
+
+//Method to set the Scaler of the features of a logistic regression
+void setScalerLogisticRegression(LogisticRegression* regr, Scaler* scaler)
+{
+	if (scaler != NULL && scaler->features != regr->features)
 	{
-		printf("Invalid X matrix.");
+		printf("Features of the scaler do not match the logistic regression");
 		exit(EXIT_FAILURE);
 	}
+	regr->scaler = scaler;
 }
 
 /**
- * The methods to update the dW and db use the regr->P (the latest p) to update the
- * dW and db, so before calling them, update_P needs to be called first. Similarly,
- * the method update_W_b needs dW and db to be updated.
+ * The second-order optimizers work on the parameters theta = [W; b], the W flattened row by row followed
+ * by the b. So, the b is the W of a feature which is always 1, and the item of the j-th feature and
+ * the k-th class is theta[j * classes + k], where the features-th feature is the one of the b.
  */
 
-//Method to update the P : XW + b
-static void update_P(LogisticRegression* regr)
+//Method to copy a W and b into the parameters theta
+static void packParameters(Matrix* W, double* b, double* theta)
+{
+	for (int row_no = 0; row_no < W->rows; row_no++)
+	{
+		memcpy(theta + row_no * W->columns, MATRIX_ROW(W, row_no), W->columns * sizeof(double));
+	}
+	memcpy(theta + W->rows * W->columns, b, W->columns * sizeof(double));
+}
+
+//Method to copy the parameters theta into a W and b
+static void unpackParameters(double* theta, Matrix* W, double* b)
+{
+	for (int row_no = 0; row_no < W->rows; row_no++)
+	{
+		memcpy(MATRIX_ROW(W, row_no), theta + row_no * W->columns, W->columns * sizeof(double));
+	}
+	memcpy(b, theta + W->rows * W->columns, W->columns * sizeof(double));
+}
+
+//Method to calculate the P, the gradients and the log loss at the W and b, the gradients are packed into the gradient
+static double evaluateParameters(LogisticRegression* regr, double* gradient, double* folded_gradient)
+{
+	//Release the temporaries of the previous evaluation
+	resetWorkspace(regr->workspace);
+	update_P(regr);
+	double loss = update_gradients(regr, regr->X, regr->X_sparse, regr->P, regr->Y);
+	//The Newton optimizer needs the gradients of the folded parameters as well, which are calculated with the unscaled X
+	if (folded_gradient != NULL)
+	{
+		packParameters(regr->dW, regr->db, folded_gradient);
+	}
+	if (regr->scaler != NULL)
+	{
+		unfoldScalerGradients(regr->scaler, regr->dW, regr->db);
+	}
+	packParameters(regr->dW, regr->db, gradient);
+	return loss;
+}
+
+/**
+ * Backtracking line search : the step begins at 1 and is halved until the loss decreases enough,
+ *
+ * loss(theta + step d) <= loss(theta) + c step g^T d
+ *
+ * where c is the line_search_sufficient_decrease. The steepest descent direction is used if the
+ * direction doesn't descend. Afterwards, the P, the gradients and the loss are the ones of the
+ * accepted theta, or the ones of the initial theta if no step decreased the loss enough.
+ */
+
+//Method to move the parameters along the direction with a line search, returns 0 if no step decreased the loss enough
+static int searchStep(LogisticRegression* regr, double* theta, double* theta_initial, double* direction, double* gradient, double* folded_gradient, double* loss)
+{
+	int n = (regr->features + 1) * regr->classes;
+	double loss_initial = *loss;
+	double slope = vectorDot(gradient, direction, n);
+	if (!(slope < 0.0))
+	{
+		vectorScalarMultiplicationInto(direction, gradient, n, -1.0);
+		slope = -vectorDot(gradient, gradient, n);
+		//The theta is a stationary point if the gradient is 0
+		if (!(slope < 0.0))
+		{
+			return 0;
+		}
+	}
+	memcpy(theta_initial, theta, n * sizeof(double));
+	double step = 1.0;
+	for (int step_no = 0; step_no < line_search_max_steps; step_no++)
+	{
+		//theta = theta_initial + step d
+		memcpy(theta, theta_initial, n * sizeof(double));
+		vectorAxpy(step, direction, theta, n);
+		unpackParameters(theta, regr->W, regr->b);
+		*loss = evaluateParameters(regr, gradient, folded_gradient);
+		if (*loss <= loss_initial + line_search_sufficient_decrease * step * slope)
+		{
+			return 1;
+		}
+		step *= 0.5;
+	}
+	//Restore the initial theta otherwise
+	memcpy(theta, theta_initial, n * sizeof(double));
+	unpackParameters(theta, regr->W, regr->b);
+	*loss = evaluateParameters(regr, gradient, folded_gradient);
+	return 0;
+}
+
+/**
+ * Newton's method for the logistic regression is IRLS. The Hessian of the log loss of the folded theta is,
+ * both for the sigmoid of a single class and for the softmax,
+ *
+ * H[j * classes + k][i * classes + l] = 1/m sum(x_j x_i p_k (delta_kl - p_l))
+ *
+ * where the x of the features-th feature is 1. For each pair of classes, the rows of the X are
+ * multiplied by their weights p_k (delta_kl - p_l) / m HESSIAN_ROWS at a time, X^T X_weighted is
+ * accumulated by the GEMM into the block of the pair, and the block is scattered into the H along
+ * with the sums of the weighted rows, which are the items of the b. The H is symmetric, so the
+ * pairs with l < k aren't calculated. The block of a sparse X is accumulated row by row from the
+ * products of the nonzero items of each row, which costs the sum of their squares.
+ *
+ * The Newton direction is invariant to the scaling of the features, so it is calculated for the
+ * folded theta with the unscaled X and converted into the direction of the theta by unfoldScaler().
+ *
+ * The softmax H is singular since adding the same number to the items of a feature of all classes
+ * doesn't change the P. The gradient has no component along these directions, so the mean of the
+ * diagonal of each feature is added to the items of the feature of all pairs of classes, which
+ * gives the H a curvature along them without changing the direction.
+ *
+ * Far from the optimum, e.g. when the P is saturated, the H is almost 0 and the Newton step is far
+ * too long. So, a ridge relative to the mean of the diagonal is added to the H while no step along
+ * the direction decreases the loss enough or the Cholesky decomposition fails, which turns the
+ * direction towards the steepest descent, and it is lowered after each successful step.
+ */
+
+/**
+ * Buffers of the Newton optimizer
+ */
+typedef struct
 {
-	//Generate the P
-	double** P = generateP(regr, regr->X, regr->samples, regr->features);
-	//Dispose any existing P
-	if (regr->P != NULL)
+	//Hessian of the theta and its diagonal, which is kept to restore the H after a failed decomposition
+	Matrix* H;
+	double* diagonal;
+	//Ridge relative to the mean of the diagonal, 0 unless the Newton steps failed
+	double damping;
+	//Weighted rows of the X, the X^T X_weighted of a pair of classes and the sums of the weighted rows
+	Matrix* X_weighted;
+	Matrix* block;
+	double* sums;
+}
+Newton;
+
+//Method to accumulate the X^T X_weighted of a pair of classes and the sums of the weighted rows of a sparse X, returns the sum of the weights
+static double sparseHessianBlock(LogisticRegression* regr, int k, int l, Matrix* block, double* sums)
+{
+	SparseMatrix* X = regr->X_sparse;
+	double weight_sum = 0.0;
+	matrixFillZero(block);
+	for (int row_no = 0; row_no < regr->samples; row_no++)
+	{
+		double* p = MATRIX_ROW(regr->P, row_no);
+		double weight = p[k] * ((k == l) - p[l]) / regr->samples;
+		for (long a = X->row_offsets[row_no]; a < X->row_offsets[row_no + 1]; a++)
+		{
+			double x_weighted = weight * X->values[a];
+			double* block_row = MATRIX_ROW(block, X->column_indices[a]);
+			sums[X->column_indices[a]] += x_weighted;
+			for (long c = X->row_offsets[row_no]; c < X->row_offsets[row_no + 1]; c++)
+			{
+				block_row[X->column_indices[c]] += x_weighted * X->values[c];
+			}
+		}
+		weight_sum += weight;
+	}
+	return weight_sum;
+}
+
+//Method to update the H : Hessian of the log loss of the folded theta at the P
+static void update_H(LogisticRegression* regr, Newton* newton)
+{
+	int features = regr->features;
+	int classes = regr->classes;
+	Matrix* H = newton->H;
+	Matrix* block = newton->block;
+	double* sums = newton->sums;
+	//Iterate over the pairs of classes
+	for (int k = 0; k < classes; k++)
+	{
+		for (int l = k; l < classes; l++)
+		{
+			double weight_sum = 0.0;
+			memset(sums, 0, features * sizeof(double));
+			//Accumulate the X^T X_weighted and the sums of the weighted rows
+			if (regr->X_sparse != NULL)
+			{
+				weight_sum = sparseHessianBlock(regr, k, l, block, sums);
+			}
+			else
+			{
+				for (int begin = 0; begin < regr->samples; begin += HESSIAN_ROWS)
+				{
+					int rows = (regr->samples - begin < HESSIAN_ROWS) ? regr->samples - begin : HESSIAN_ROWS;
+					Matrix X = {MATRIX_ROW(regr->X, begin), rows, features, regr->X->stride};
+					Matrix X_weighted = {newton->X_weighted->data, rows, features, newton->X_weighted->stride};
+					for (int row_no = 0; row_no < rows; row_no++)
+					{
+						double* p = MATRIX_ROW(regr->P, begin + row_no);
+						double weight = p[k] * ((k == l) - p[l]) / regr->samples;
+						double* x_weighted = MATRIX_ROW(&X_weighted, row_no);
+						vectorScalarMultiplicationInto(x_weighted, MATRIX_ROW(&X, row_no), features, weight);
+						vectorAdditionInto(sums, sums, x_weighted, features);
+						weight_sum += weight;
+					}
+					matrixGEMM(1, 0, 1.0, &X, &X_weighted, (begin == 0) ? 0.0 : 1.0, block);
+				}
+			}
+			//Scatter the block and the sums into the H and its transpose
+			for (int j = 0; j < features; j++)
+			{
+				for (int i = 0; i < features; i++)
+				{
+					MATRIX_AT(H, j * classes + k, i * classes + l) = MATRIX_AT(block, j, i);
+					MATRIX_AT(H, i * classes + l, j * classes + k) = MATRIX_AT(block, j, i);
+				}
+				MATRIX_AT(H, j * classes + k, features * classes + l) = sums[j];
+				MATRIX_AT(H, features * classes + l, j * classes + k) = sums[j];
+				MATRIX_AT(H, j * classes + l, features * classes + k) = sums[j];
+				MATRIX_AT(H, features * classes + k, j * classes + l) = sums[j];
+			}
+			MATRIX_AT(H, features * classes + k, features * classes + l) = weight_sum;
+			MATRIX_AT(H, features * classes + l, features * classes + k) = weight_sum;
+		}
+	}
+	//Add the curvature along the directions which don't change the softmax
+	if (classes > 1)
 	{
-		matrixDispose(regr->P, regr->samples);
+		for (int j = 0; j <= features; j++)
+		{
+			double curvature = 0.0;
+			for (int k = 0; k < classes; k++)
+			{
+				curvature += MATRIX_AT(H, j * classes + k, j * classes + k) / classes;
+			}
+			for (int k = 0; k < classes; k++)
+			{
+				for (int l = 0; l < classes; l++)
+				{
+					MATRIX_AT(H, j * classes + k, j * classes + l) += curvature;
+				}
+			}
+		}
+	}
+	//Keep the diagonal
+	for (int i = 0; i < H->rows; i++)
+	{
+		newton->diagonal[i] = MATRIX_AT(H, i, i);
 	}
-	//Update the P
-	regr->P = P;
 }
 
-//Method to update the dW : 1/m X^T (P - Y)
-static void update_dW(LogisticRegression* regr)
+//Method to calculate the Newton direction : -(H + ridge I)^-1 g of the folded theta, converted into the direction of the theta
+static void newtonDirection(LogisticRegression* regr, Newton* newton, double* folded_gradient, double* direction)
 {
-	//Iterate over the rows of the dW
-	for (int row_no = 0; row_no < regr->features; row_no++)
+	int n = (regr->features + 1) * regr->classes;
+	Matrix* H = newton->H;
+	//Calculate the ridge relative to the mean of the diagonal
+	double trace = 0.0;
+	for (int i = 0; i < n; i++)
 	{
-		//Iterate over the columns of the dW
-		for (int column_no = 0; column_no < regr->classes; column_no++)
+		trace += newton->diagonal[i];
+	}
+	double mean = (trace > 0.0) ? trace / n : 1.0;
+	double ridge = newton->damping * mean;
+	//Decompose the H, raising the ridge if it isn't numerically positive definite
+	int decomposed = 0;
+	for (int attempt_no = 0; attempt_no < 8 && decomposed == 0; attempt_no++)
+	{
+		if (attempt_no > 0)
+		{
+			ridge = fmax(100.0 * ridge, newton_ridge * mean);
+		}
+		//Restore the lower triangle from the upper one, which isn't modified by the decomposition
+		for (int i = 0; i < n; i++)
 		{
-			double current_item = 0.0;
-			//Iterate over the columns/rows of the X^T/(P-Y) to perform the matrix multiplication
-			for (int item_no = 0; item_no < regr->samples; item_no++)
+			for (int j = 0; j < i; j++)
 			{
-				current_item += regr->X[item_no][row_no] * (regr->P[item_no][column_no] - regr->Y[item_no][column_no]);
+				MATRIX_AT(H, i, j) = MATRIX_AT(H, j, i);
 			}
-			//Set the current item of the gradient
-			regr->dW[row_no][column_no] = (1.0/regr->samples) * current_item;
+			MATRIX_AT(H, i, i) = newton->diagonal[i] + ridge;
 		}
+		decomposed = matrixCholeskyDecomposition(H);
+	}
+	//Solve the direction, or use the steepest descent if the H couldn't be decomposed
+	vectorScalarMultiplicationInto(direction, folded_gradient, n, -1.0);
+	if (decomposed == 1)
+	{
+		Matrix step = {direction, n, 1, 1};
+		matrixCholeskySolve(H, &step);
+	}
+	//Convert the direction of the folded theta into the direction of the theta
+	if (regr->scaler != NULL)
+	{
+		Matrix W_direction = {direction, regr->features, regr->classes, regr->classes};
+		double* b_direction = direction + regr->features * regr->classes;
+		unfoldScaler(regr->scaler, &W_direction, b_direction, &W_direction, b_direction);
 	}
 }
 
-//Method to update the db : mean(P - Y)
-static void update_db(LogisticRegression* regr)
+//Method to train a logistic regression with a second-order optimizer
+static void trainSecondOrder(LogisticRegression* regr, Optimizer optimizer, int max_iterations, double threshold)
 {
-	//Iterate over the items of the db
-	for (int db_index = 0; db_index < regr->classes; db_index++)
+	int n = (regr->features + 1) * regr->classes;
+	//The theta, the theta before the step, the gradient, the direction and the gradient of the folded theta share a buffer
+	double* buffer = initVector(5 * n);
+	double* theta = buffer;
+	double* theta_initial = buffer + n;
+	double* gradient = buffer + 2 * n;
+	double* direction = buffer + 3 * n;
+	double* folded_gradient = NULL;
+	packParameters(regr->W, regr->b, theta);
+	//Initialize the L-BFGS out of the theta, or the buffers of the Newton optimizer
+	LBFGS* lbfgs = NULL;
+	Newton newton = {NULL, NULL, 0.0, NULL, NULL, NULL};
+	if (optimizer == LBFGS_OPTIMIZER)
 	{
-		double current_sum = 0.0;
-		//Iterate to calculate the sum of the current column of the (P - Y)
-		for (int item_no = 0; item_no < regr->samples; item_no++)
+		lbfgs = initLBFGS(theta, n);
+	}
+	else
+	{
+		folded_gradient = buffer + 4 * n;
+		newton.H = createMatrix(n, n);
+		newton.diagonal = initVector(n);
+		newton.X_weighted = (regr->X_sparse == NULL) ? createMatrix((regr->samples < HESSIAN_ROWS) ? regr->samples : HESSIAN_ROWS, regr->features) : NULL;
+		newton.block = createMatrix(regr->features, regr->features);
+		newton.sums = initVector(regr->features);
+	}
+	double loss = evaluateParameters(regr, gradient, folded_gradient);
+	for (int t = 0; t < max_iterations; t++)
+	{
+		//Check converge and update the log loss of the logistic regression struct after that
+		if (fabs(regr->log_loss - loss) < threshold)
 		{
-			current_sum += (regr->P[item_no][db_index] - regr->Y[item_no][db_index]);
+			break;
+		}
+		regr->log_loss = loss;
+		//Print the current t and loss if the debugTraining is 1
+		if (debugTrainingLogisticRegression == 1)
+		{
+			printf("t : %d , loss : %f\n", t, loss);
+		}
+		//Calculate the direction and move the theta along it
+		int decreased = 0;
+		if (optimizer == NEWTON_OPTIMIZER)
+		{
+			//Raise the damping until a step decreases the loss enough, and lower it afterwards
+			update_H(regr, &newton);
+			for (int attempt_no = 0; attempt_no < 6 && decreased == 0; attempt_no++)
+			{
+				newtonDirection(regr, &newton, folded_gradient, direction);
+				decreased = searchStep(regr, theta, theta_initial, direction, gradient, folded_gradient, &loss);
+				newton.damping = (decreased == 1) ? 0.01 * newton.damping : fmax(100.0 * newton.damping, newton_ridge);
+				newton.damping = (newton.damping < newton_ridge) ? 0.0 : newton.damping;
+			}
+		}
+		else
+		{
+			directionLBFGS(lbfgs, gradient, direction, n);
+			decreased = searchStep(regr, theta, theta_initial, direction, gradient, folded_gradient, &loss);
+		}
+		//Try the steepest descent direction otherwise, the theta is optimal if no step along it decreases the loss either
+		if (decreased == 0)
+		{
+			vectorScalarMultiplicationInto(direction, gradient, n, -1.0);
+			if (searchStep(regr, theta, theta_initial, direction, gradient, folded_gradient, &loss) == 0)
+			{
+				break;
+			}
+		}
+		if (optimizer == LBFGS_OPTIMIZER)
+		{
+			updateLBFGS(lbfgs, gradient, n);
 		}
-		//Set the current item of the db
-		regr->db[db_index] = (1.0/regr->samples) * current_sum;
 	}
+	//The log loss is the one of the final W and b
+	regr->log_loss = loss;
+	//Dispose the optimizer, the theta is disposed with the buffer
+	if (optimizer == LBFGS_OPTIMIZER)
+	{
+		disposeLBFGS(lbfgs, 0);
+	}
+	else
+	{
+		disposeMatrix(newton.H);
+		free(newton.diagonal);
+		disposeMatrix(newton.X_weighted);
+		disposeMatrix(newton.block);
+		free(newton.sums);
+	}
+	free(buffer);
 }
 
 //Method to train a logistic regression
 void trainLogisticRegression(LogisticRegression* regr, Optimizer optimizer, int max_iterations, double threshold)
 {
-	//Flatten the W into a new vector that is to be of the optimizer
-	double* w = flatten(regr->W, regr->features, regr->classes, 0);
+	//The parameters of a loaded model are read-only and it doesn't have the training data
+	if (regr->file != NULL)
+	{
+		printf("A loaded logistic regression can only be trained by chunks");
+		exit(EXIT_FAILURE);
+	}
+	//An online model doesn't keep its rows
+	if (regr->X == NULL && regr->X_sparse == NULL)
+	{
+		printf("An online logistic regression can only be trained by chunks");
+		exit(EXIT_FAILURE);
+	}
+	//The second-order optimizers search their steps instead of taking the fixed steps of the others
+	if (optimizer == NEWTON_OPTIMIZER || optimizer == LBFGS_OPTIMIZER)
+	{
+		trainSecondOrder(regr, optimizer, max_iterations, threshold);
+		return;
+	}
+	//The W is contiguous, so its buffer is the w of the optimizer and it is updated in place
+	double* w = regr->W->data;
 	/**
-	 * Initialize the optimizers. Initialize the one for the W out of the flattened W
+	 * Initialize the optimizers. Initialize the one for the W out of the buffer of the W
 	 * w, and initialize the one for b passing the b of the logistic regression itself.
 	 */
 	//Declare the optimizers
-	void* optimizer_w;
-	void* optimizer_b;
+	void* optimizer_w = NULL;
+	void* optimizer_b = NULL;
 	//Instantiate the optimizers if gradient descent will be used
 	if (optimizer == GRADIENT_DESCENT)
 	{
@@ -255,18 +760,22 @@ void trainLogisticRegression(LogisticRegression* regr, Optimizer optimizer, int
 	 */
 	for (int t = 0; t < max_iterations; t++)
 	{
+		//Release the temporaries of the previous iteration
+		resetWorkspace(regr->workspace);
 		/**
 		 * Update the P and the gradients calling these methods so the
 		 * weights and the biasas can be updated using the gradients
 		 */
 		update_P(regr);
-		update_dW(regr);
-		update_db(regr);
+		double loss_current = update_gradients(regr, regr->X, regr->X_sparse, regr->P, regr->Y);
+		if (regr->scaler != NULL)
+		{
+			unfoldScalerGradients(regr->scaler, regr->dW, regr->db);
+		}
 		/**
-		 * Calculate the current log loss and check the converge
+		 * Check the converge with the current log loss calculated with the gradients
 		 * Print the current t and loss if the debug mode is enabled
 		 */
-		double loss_current = logLossMatrix(regr->Y, regr->P, regr->samples, regr->classes);
 		//Check converge and update the log loss of the logistic regression struct after that
 		if (fabs(regr->log_loss - loss_current) < threshold)
 		{
@@ -280,66 +789,306 @@ void trainLogisticRegression(LogisticRegression* regr, Optimizer optimizer, int
 		}
 		/**
 		 * Update the weights and the biases. Calling the update method of the optimizer
-		 * is sufficient for the biases since it is already a vector, but the returned w
-		 * needs to be copied into the W of the logistic regression. Also, the gradient of
-		 * the W needs to be flattened to be able to be passed to the update methods.
+		 * is sufficient for both since the w is the buffer of the W and the buffer of the
+		 * dW is its flattened gradient already.
 		 */
-		//Flatten the dW to update the W and declare the updated_w
-		double* dw = flatten(regr->dW, regr->features, regr->classes, 0);
-		double* updated_w;
 		//Call the update methods for gradient descent
 		if (optimizer == GRADIENT_DESCENT)
 		{
-			updated_w = updateGradientDescent(optimizer_w, dw, regr->features * regr->classes);
+			updateGradientDescent(optimizer_w, regr->dW->data, regr->features * regr->classes);
 			updateGradientDescent(optimizer_b, regr->db, regr->classes);
 		}
 		//Call the update methods for ADAM optimizer
 		else if (optimizer == ADAM_OPTIMIZER)
 		{
-			updated_w = updateADAM(optimizer_w, dw, regr->features * regr->classes);
+			updateADAM(optimizer_w, regr->dW->data, regr->features * regr->classes);
 			updateADAM(optimizer_b, regr->db, regr->classes);
 		}
-		//Copy the updated w into the W of the logistic regression to update it
-		int updated_w_index = 0;
-		for (int row_no = 0; row_no < regr->features; row_no++)
-		{
-			for (int column_no = 0; column_no < regr->classes; column_no++)
-			{
-				regr->W[row_no][column_no] = updated_w[updated_w_index];
-				updated_w_index += 1;
-			}
-		}
-		//Dispose the dw
-		free(dw);
-		dw = NULL;
 	}
 	/**
 	 * The second parameter of the disposeADAM() is whether the w of the ADAM will be disposed.
-	 * The w of the first ADAM should be disposed since it is a new vector that is the flattened of
-	 * the original W, but the w of the second ADAM shouldn't be disposed since it is the b of the
+	 * Neither of the ws should be disposed since they are the buffer of the W and the b of the
 	 * logistic regression itself.
 	 */
 	//Dispose the optimizers after the optimization if gradient descent will be used
 	if (optimizer == GRADIENT_DESCENT)
 	{
-		disposeGradientDescent(optimizer_w, 1);
+		disposeGradientDescent(optimizer_w, 0);
 		disposeGradientDescent(optimizer_b, 0);
 	}
 	//Dispose the optimizers after the optimization if ADAM optimizer will be used
 	else if (optimizer == ADAM_OPTIMIZER)
 	{
-		disposeADAM(optimizer_w, 1);
+		disposeADAM(optimizer_w, 0);
 		disposeADAM(optimizer_b, 0);
 	}
 }
 
+/**
+ * The online training takes a step of the optimizer for each chunk of rows passed to it, with the gradients
+ * of the mean log loss of the chunk. So, a step costs the rows of its chunk and doesn't depend on the number
+ * of rows seen before, and the model keeps nothing of the chunks. The P of a chunk is carved from the
+ * workspace, which grows to the largest chunk once. The optimizers are kept in the model between the
+ * chunks, so the moments of ADAM and its bias correction continue from the previous chunk.
+ *
+ * A loaded model has its W and b in the read-only mapping of its file, so they are copied out of the
+ * mapping and the file is unmapped before its first chunk, which lets a saved model be trained further
+ * on the new rows.
+ */
+
+//Method to dispose the online optimizers of a logistic regression
+static void disposeOnlineOptimizers(LogisticRegression* regr)
+{
+	//The ws of the optimizers are the W and the b of the logistic regression, so they aren't disposed
+	if (regr->optimizer_w == NULL)
+	{
+		return;
+	}
+	if (regr->online_optimizer == GRADIENT_DESCENT)
+	{
+		disposeGradientDescent(regr->optimizer_w, 0);
+		disposeGradientDescent(regr->optimizer_b, 0);
+	}
+	else
+	{
+		disposeADAM(regr->optimizer_w, 0);
+		disposeADAM(regr->optimizer_b, 0);
+	}
+	regr->optimizer_w = NULL;
+	regr->optimizer_b = NULL;
+}
+
+//Method to copy the W and b of a loaded logistic regression out of the mapping of its file
+static void detachModelFile(LogisticRegression* regr)
+{
+	Matrix* W = cloneMatrix(regr->W);
+	double* b = initVector(regr->classes);
+	memcpy(b, regr->b, regr->classes * sizeof(double));
+	free(regr->W);
+	unmapModelFile(regr->file);
+	regr->file = NULL;
+	regr->W = W;
+	regr->b = b;
+	regr->dW = createMatrix(regr->features, regr->classes);
+	regr->db = initVector(regr->classes);
+}
+
+//Method to take a step of an optimizer with the gradients of a chunk of rows, either the X or the X_sparse is NULL
+static double partialFit(LogisticRegression* regr, Optimizer optimizer, Matrix* X, SparseMatrix* X_sparse, Matrix* Y)
+{
+	//Check the optimizer and the dimensions of the chunk
+	if (optimizer != GRADIENT_DESCENT && optimizer != ADAM_OPTIMIZER)
+	{
+		printf("Invalid optimizer for the online training");
+		exit(EXIT_FAILURE);
+	}
+	int rows = (X != NULL) ? X->rows : X_sparse->rows;
+	if (Y->rows != rows || Y->columns != regr->classes || rows == 0)
+	{
+		printf("Invalid Y matrix.");
+		exit(EXIT_FAILURE);
+	}
+	//Copy the W and b of a loaded model out of its file
+	if (regr->file != NULL)
+	{
+		detachModelFile(regr);
+	}
+	//Initialize the optimizers at the first chunk or when the optimizer is changed
+	if (regr->optimizer_w == NULL || regr->online_optimizer != optimizer)
+	{
+		disposeOnlineOptimizers(regr);
+		regr->online_optimizer = optimizer;
+		if (optimizer == GRADIENT_DESCENT)
+		{
+			regr->optimizer_w = initGradientDescent(regr->W->data, regr->features * regr->classes);
+			regr->optimizer_b = initGradientDescent(regr->b, regr->classes);
+		}
+		else
+		{
+			regr->optimizer_w = initADAM(regr->W->data, regr->features * regr->classes);
+			regr->optimizer_b = initADAM(regr->b, regr->classes);
+		}
+	}
+	//Calculate the P of the chunk into the workspace and the gradients of its rows
+	resetWorkspace(regr->workspace);
+	Matrix* W;
+	double* b;
+	foldedParameters(regr, &W, &b);
+	Matrix* P = workspaceMatrix(regr->workspace, rows, regr->classes);
+	generateP(regr, X, X_sparse, W, b, P);
+	double loss = update_gradients(regr, X, X_sparse, P, Y);
+	if (regr->scaler != NULL)
+	{
+		unfoldScalerGradients(regr->scaler, regr->dW, regr->db);
+	}
+	//Take the step
+	if (optimizer == GRADIENT_DESCENT)
+	{
+		updateGradientDescent(regr->optimizer_w, regr->dW->data, regr->features * regr->classes);
+		updateGradientDescent(regr->optimizer_b, regr->db, regr->classes);
+	}
+	else
+	{
+		updateADAM(regr->optimizer_w, regr->dW->data, regr->features * regr->classes);
+		updateADAM(regr->optimizer_b, regr->db, regr->classes);
+	}
+	//Return the loss of the chunk before the step
+	return loss;
+}
+
+//Method to train a logistic regression on a chunk of rows
+double partialFitLogisticRegression(LogisticRegression* regr, Optimizer optimizer, Matrix* X, Matrix* Y)
+{
+	return partialFit(regr, optimizer, X, NULL, Y);
+}
+
+//Method to train a logistic regression on a chunk of sparse rows
+double partialFitLogisticRegressionSparse(LogisticRegression* regr, Optimizer optimizer, SparseMatrix* X, Matrix* Y)
+{
+	return partialFit(regr, optimizer, NULL, X, Y);
+}
+
+//Method to train a logistic regression on the chunks of rows read from a reader
+double trainLogisticRegressionStream(LogisticRegression* regr, Optimizer optimizer, int chunk_rows, LogisticRegressionReader reader, void* argument)
+{
+	//Check the size of the chunks
+	if (chunk_rows < 1)
+	{
+		printf("Invalid chunk size");
+		exit(EXIT_FAILURE);
+	}
+	//The buffers of the chunks are the only memory that depends on the rows
+	Matrix* X = createMatrix(chunk_rows, regr->features);
+	Matrix* Y = createMatrix(chunk_rows, regr->classes);
+	double loss = 0.0;
+	long total_rows = 0;
+	//Read the chunks until the reader returns 0 rows and take a step with each of them
+	for (int t = 0;; t++)
+	{
+		int rows = reader(X, Y, argument);
+		if (rows <= 0)
+		{
+			break;
+		}
+		if (rows > chunk_rows)
+		{
+			printf("Invalid number of rows read");
+			exit(EXIT_FAILURE);
+		}
+		//Views of the rows read
+		Matrix X_chunk = {X->data, rows, X->columns, X->stride};
+		Matrix Y_chunk = {Y->data, rows, Y->columns, Y->stride};
+		double loss_chunk = partialFit(regr, optimizer, &X_chunk, NULL, &Y_chunk);
+		loss += loss_chunk * rows;
+		total_rows += rows;
+		//Print the current t and loss if the debugTraining is 1
+		if (debugTrainingLogisticRegression == 1)
+		{
+			printf("t : %d , loss : %f\n", t, loss_chunk);
+		}
+	}
+	//The log loss of the model is the mean of the losses of the rows before the steps taken with them
+	disposeMatrix(X);
+	disposeMatrix(Y);
+	if (total_rows > 0)
+	{
+		regr->log_loss = loss / total_rows;
+	}
+	return regr->log_loss;
+}
+
 //Method to make a prediction
 double** predictLogisticRegression(LogisticRegression* regr, double** X, int samples, int features)
 {
-	//Get the P calculated using the passed X
-	double** P = generateP(regr, X, samples, features);
-	//Return the P
-	return P;
+	//Check the dimensions before copying the X
+	if (features != regr->features)
+	{
+		printf("Invalid X matrix.");
+		exit(EXIT_FAILURE);
+	}
+	//Get the P calculated using the contiguous copy of the passed X, the folded W and b are carved from the workspace
+	resetWorkspace(regr->workspace);
+	Matrix* W;
+	double* b;
+	foldedParameters(regr, &W, &b);
+	Matrix* X_matrix = matrixFromArray(X, samples, features);
+	Matrix* P = createMatrix(samples, regr->classes);
+	generateP(regr, X_matrix, NULL, W, b, P);
+	disposeMatrix(X_matrix);
+	//Return the P as a double**
+	double** result = matrixToArray(P);
+	disposeMatrix(P);
+	return result;
+}
+
+//Method to make a prediction for a sparse X
+double** predictLogisticRegressionSparse(LogisticRegression* regr, SparseMatrix* X)
+{
+	//Get the P calculated using the passed X as it is, the folded W and b are carved from the workspace
+	resetWorkspace(regr->workspace);
+	Matrix* W;
+	double* b;
+	foldedParameters(regr, &W, &b);
+	Matrix* P = createMatrix(X->rows, regr->classes);
+	generateP(regr, NULL, X, W, b, P);
+	//Return the P as a double**
+	double** result = matrixToArray(P);
+	disposeMatrix(P);
+	return result;
+}
+
+//Method to save the parameters of a logistic regression into a model file
+void saveLogisticRegression(LogisticRegression* regr, const char* path)
+{
+	//The model is written as a single layer without an activation, with the Scaler folded into it
+	resetWorkspace(regr->workspace);
+	Matrix* W[1];
+	double* B[1];
+	foldedParameters(regr, &W[0], &B[0]);
+	writeModelFile(path, MODEL_FILE_LOGISTIC_REGRESSION, 1, W, B, NULL);
+}
+
+//Method to load a logistic regression from a model file written by saveLogisticRegression()
+LogisticRegression* loadLogisticRegression(const char* path, int verify_checksum)
+{
+	//Map the file
+	ModelFile* file = mapModelFile(path, MODEL_FILE_LOGISTIC_REGRESSION, verify_checksum);
+	if (file->header->number_of_layers != 1)
+	{
+		printf("Invalid model file : wrong layers");
+		exit(EXIT_FAILURE);
+	}
+	//Initialize the logistic regression and the Matrix viewing its W, and handle any allocation failure
+	LogisticRegression* regr = allocateMemory(sizeof(LogisticRegression));
+	Matrix* W = allocateMemory(sizeof(Matrix));
+	if (regr == NULL || W == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	*W = modelFileW(file, 0);
+	//The loaded model doesn't have the training data and the gradients
+	regr->X = NULL;
+	regr->X_sparse = NULL;
+	regr->Y = NULL;
+	regr->samples = 0;
+	regr->features = W->rows;
+	regr->classes = W->columns;
+	//Point the W and b into the mapping
+	regr->W = W;
+	regr->dW = NULL;
+	regr->b = modelFileB(file, 0);
+	regr->db = NULL;
+	regr->P = NULL;
+	regr->workspace = initWorkspace(0);
+	regr->online_optimizer = GRADIENT_DESCENT;
+	regr->optimizer_w = NULL;
+	regr->optimizer_b = NULL;
+	regr->scaler = NULL;
+	regr->log_loss = INT_MAX;
+	regr->file = file;
+	//Return the loaded logistic regression
+	return regr;
 }
 
 //Method to print a logistic regression
@@ -360,7 +1109,7 @@ void printLogisticRegression(LogisticRegression* regr, int decimal_places)
 	printf("- Number of Classes : %d\n", regr->classes);
 	//Print the weight matrix W
 	printf("- Weight Matrix (W) : \n");
-	printMatrix(regr->W, regr->features, regr->classes, decimal_places);
+	printMatrixStruct(regr->W, decimal_places);
 	//Print the bias vector b
 	printf("- Bias Vector (b) : \n");
 	printVector(regr->b, regr->classes, decimal_places);
@@ -371,19 +1120,39 @@ void printLogisticRegression(LogisticRegression* regr, int decimal_places)
 //Method to dispose a LogisticRegression struct
 void disposeLogisticRegression(LogisticRegression* regr)
 {
-	//Dispose the W and the dW of the logistic regression
-	matrixDispose(regr->W, regr->features);
+	//Dispose the online optimizers, which point into the W and b
+	disposeOnlineOptimizers(regr);
+	//Dispose the copies of the X and Y
+	disposeMatrix(regr->X);
+	regr->X = NULL;
+	disposeSparseMatrix(regr->X_sparse);
+	regr->X_sparse = NULL;
+	disposeMatrix(regr->Y);
+	regr->Y = NULL;
+	//Unmap the model file if the W and b are in its mapping, dispose them otherwise
+	if (regr->file != NULL)
+	{
+		free(regr->W);
+		unmapModelFile(regr->file);
+		regr->file = NULL;
+	}
+	else
+	{
+		disposeMatrix(regr->W);
+		free(regr->b);
+	}
 	regr->W = NULL;
-	matrixDispose(regr->dW, regr->features);
-	regr->dW = NULL;
-	//Dispose the b and the db of the logistic regression
-	free(regr->b);
 	regr->b = NULL;
+	//Dispose the dW and the db of the logistic regression
+	disposeMatrix(regr->dW);
+	regr->dW = NULL;
 	free(regr->db);
 	regr->db = NULL;
-	//Dispose the P of the logistic regression
-	matrixDispose(regr->P, regr->samples);
+	//Dispose the P and the workspace of the logistic regression
+	disposeMatrix(regr->P);
 	regr->P = NULL;
+	disposeWorkspace(regr->workspace);
+	regr->workspace = NULL;
 	//Dispose the logistic regression itself
 	free(regr);
 	regr = NULL;
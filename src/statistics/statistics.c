@@ -3,18 +3,91 @@
 #include "../../include/statistics/statistics.h"
 
 #include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
-//Method to calculate the sum of an array
-double sum(double* array, int n)
+#include "../../include/core/allocation.h"
+#include "../../include/core/thread_pool.h"
+#include "../../include/core/vector_kernels.h"
+
+/**
+ * The reductions of the arrays are calculated by the compensated vector kernels, so their errors don't grow with the
+ * size of the arrays. The arrays of at least STATISTICS_PARALLEL_ITEMS items are split into a contiguous part for each
+ * processor, and the results of the parts are merged in order, so the result only depends on the number of processors.
+ */
+
+//Number of items from which the reductions of an array are split between the processors
+#define STATISTICS_PARALLEL_ITEMS (1 << 22)
+
+//Number of the deviations from the mean kept on the stack by the standard deviation
+#define STATISTICS_CHUNK 256
+
+/**
+ * Arguments of the threads reducing the parts of an array
+ */
+typedef struct
 {
-	double sum = 0.0;
-	//Calculate the sum
-	for (int i = 0; i < n; i++)
+	double* array;
+	int n;
+	int number_of_parts;
+	VectorMoments* parts;
+	//1 if only the sums of the parts are calculated
+	int sum_only;
+}
+ArrayReductionTask;
+
+//Static method run by each thread to reduce its part of the array
+static void runArrayReduction(void* argument, int thread_no)
+{
+	ArrayReductionTask* task = argument;
+	int begin = (int) ((long) task->n * thread_no / task->number_of_parts);
+	int end = (int) ((long) task->n * (thread_no + 1) / task->number_of_parts);
+	if (task->sum_only == 1)
+	{
+		task->parts[thread_no].sum = vectorSum(task->array + begin, end - begin);
+	}
+	else
 	{
-		sum += array[i];
+		task->parts[thread_no] = vectorMoments(task->array + begin, end - begin);
 	}
-	//Return the sum
-	return sum;
+}
+
+//Static method to reduce an array, only the sum of the returned moments is calculated if sum_only is 1
+static VectorMoments reduceArray(double* array, int n, int sum_only)
+{
+	//The small arrays are reduced by the calling thread
+	int threads = getNumberOfProcessors();
+	if (n < STATISTICS_PARALLEL_ITEMS || threads < 2)
+	{
+		return (sum_only == 1) ? (VectorMoments) {0.0, 0.0, vectorSum(array, n), 0.0} : vectorMoments(array, n);
+	}
+	//Reduce the parts and handle any allocation failure
+	VectorMoments* parts = allocateMemory(threads * sizeof(VectorMoments));
+	if (parts == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	ArrayReductionTask task = {array, n, threads, parts, sum_only};
+	ThreadPool* pool = initThreadPool(threads);
+	runThreadPool(pool, runArrayReduction, &task);
+	disposeThreadPool(pool);
+	//Merge the parts in order
+	VectorMoments result = parts[0];
+	for (int part_no = 1; part_no < threads; part_no++)
+	{
+		result = mergeVectorMoments(result, parts[part_no]);
+	}
+	free(parts);
+	//Return the moments
+	return result;
+}
+
+//Method to calculate the sum of an array
+double sum(double* array, int n)
+{
+	return reduceArray(array, n, 1).sum;
 }
 
 //Method to calculate the mean of an array
@@ -24,89 +97,693 @@ double mean(double* array, int n)
 	return sum(array, n)/n;
 }
 
-//Method to get the median of an array
-double median(double* array, int n)
+//Method to calculate the minimum, maximum, sum and sum of squares of an array in a single pass
+VectorMoments moments(double* array, int n)
+{
+	return reduceArray(array, n, 0);
+}
+
+/**
+ * The quantiles are selected by an introselect : the array is partitioned around the median of its first, middle
+ * and last items as in a quicksort, and only the part that has the requested item is partitioned further, which
+ * takes O(n) on average. The items equal to the pivot are split between both parts by the Hoare partition, so the
+ * arrays with many equal items are partitioned evenly as well. If the parts don't shrink fast enough, which the
+ * median of three pivots can't prevent on some inputs, the rest of the part is sorted, so the worst case is
+ * O(n log n) rather than O(n^2).
+ */
+
+//Static method to compare two doubles for qsort
+static int compareItems(const void* a, const void* b)
+{
+	double x = *(const double*) a;
+	double y = *(const double*) b;
+	return (x > y) - (x < y);
+}
+
+//Static method to swap two items of an array
+static void swapItems(double* array, int i, int j)
+{
+	double temporary = array[i];
+	array[i] = array[j];
+	array[j] = temporary;
+}
+
+//Static method to move the kth smallest item of an array to its index, the smaller items before and the larger ones after it
+static void selectItem(double* array, int n, int k)
 {
-	double median = 0.0;
-	//Even sized array
-	if (n%2 == 0)
+	int left = 0;
+	int right = n - 1;
+	//Allow about twice the partitions of the balanced ones before sorting the rest
+	int depth = 2;
+	for (int length = n; length > 1; length /= 2)
 	{
-		median = (array[n/2] + array[(n/2)-1]) / 2.0;
+		depth += 2;
 	}
-	//Odd sized array
-	else
+	while (right > left)
 	{
-		median = array[n/2];
+		if (depth-- == 0)
+		{
+			qsort(array + left, right - left + 1, sizeof(double), compareItems);
+			return;
+		}
+		//Sort the first, middle and last items and use the middle one as the pivot
+		int middle = left + (right - left) / 2;
+		if (array[middle] < array[left])
+		{
+			swapItems(array, middle, left);
+		}
+		if (array[right] < array[left])
+		{
+			swapItems(array, right, left);
+		}
+		if (array[right] < array[middle])
+		{
+			swapItems(array, right, middle);
+		}
+		double pivot = array[middle];
+		//Hoare partition : the items up to the j are at most the pivot and the items from the i are at least the pivot
+		int i = left;
+		int j = right;
+		while (i <= j)
+		{
+			while (array[i] < pivot)
+			{
+				i++;
+			}
+			while (array[j] > pivot)
+			{
+				j--;
+			}
+			if (i <= j)
+			{
+				swapItems(array, i, j);
+				i++;
+				j--;
+			}
+		}
+		//Continue with the part that has the kth item, the items between the parts are equal to the pivot
+		if (k <= j)
+		{
+			right = j;
+		}
+		else if (k >= i)
+		{
+			left = i;
+		}
+		else
+		{
+			return;
+		}
 	}
-	//Return the median
-	return median;
 }
 
-//Method to get the minimum value in an array
-double min(double* array, int n)
+//Method to get a quantile of an array reordering the array instead of copying it
+double selectQuantile(double* array, int n, double fraction)
 {
-	double min = array[0];
-	//Find the minimum
-	for (int i = 1; i < n; i++)
+	//Check the arguments
+	if (n < 1 || !(fraction >= 0.0 && fraction <= 1.0))
 	{
-		if (array[i] < min)
+		printf("Invalid quantile");
+		exit(EXIT_FAILURE);
+	}
+	//Select the item at the floor of the position
+	double position = fraction * (n - 1);
+	int k = (int) position;
+	selectItem(array, n, k);
+	double quantile = array[k];
+	//Interpolate towards the next item, which is the smallest of the larger items
+	if (position > k)
+	{
+		double next = array[k + 1];
+		for (int i = k + 2; i < n; i++)
 		{
-			min = array[i];
+			next = (array[i] < next) ? array[i] : next;
 		}
+		quantile += (position - k) * (next - quantile);
 	}
-	//Return the minimum
-	return min;
+	//Return the quantile
+	return quantile;
+}
+
+//Method to get a quantile of an array
+double quantile(double* array, int n, double fraction)
+{
+	//Copy the array into a scratch array and handle any allocation failure
+	double* copy = allocateMemory((n > 0 ? n : 1) * sizeof(double));
+	if (copy == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	memcpy(copy, array, (n > 0 ? n : 0) * sizeof(double));
+	//Select the quantile from the copy
+	double quantile = selectQuantile(copy, n, fraction);
+	free(copy);
+	//Return the quantile
+	return quantile;
+}
+
+//Method to get the median of an array
+double median(double* array, int n)
+{
+	//The median is the quantile 0.5, the mean of the two middle items of an even sized array
+	return quantile(array, n, 0.5);
+}
+
+//Method to get the minimum value in an array
+double min(double* array, int n)
+{
+	return moments(array, n).min;
 }
 
 //Method to get the maximum value in an array
 double max(double* array, int n)
 {
-	double max = array[0];
-	//Find the maximum
-	for (int i = 1; i < n; i++)
+	return moments(array, n).max;
+}
+
+//Method to calculate the range of an array
+double range(double* array, int n)
+{
+	//The minimum and the maximum are found in the same pass
+	VectorMoments array_moments = moments(array, n);
+	return array_moments.max - array_moments.min;
+}
+
+//Method to calculate the standard deviation of an array
+double standardDeviation(double* array, int n)
+{
+	double mean_array = mean(array, n);
+	//Calculate the sum of squared deviations, the deviations of a chunk are squared and summed by the dot product kernel
+	double sum_deviation_square = 0.0;
+	double deviations[STATISTICS_CHUNK];
+	for (int start = 0; start < n; start += STATISTICS_CHUNK)
 	{
-		if (array[i] > max)
+		int size = (n - start < STATISTICS_CHUNK) ? n - start : STATISTICS_CHUNK;
+		for (int i = 0; i < size; i++)
 		{
-			max = array[i];
+			deviations[i] = array[start + i] - mean_array;
 		}
+		sum_deviation_square += vectorDot(deviations, deviations, size);
 	}
-	//Return the maximum
-	return max;
+	//Divide it by (n-1) : sample
+	sum_deviation_square /= (n-1);
+	//Return the square root of it
+	return sqrt(sum_deviation_square);
 }
 
-//Method to calculate the range of an array
-double range(double* array, int n)
+//Method to initialize the ColumnStatistics of no rows
+ColumnStatistics* initColumnStatistics(int columns)
+{
+	//Initialize the ColumnStatistics and its arrays and handle any allocation failure
+	ColumnStatistics* statistics = allocateMemory(sizeof(ColumnStatistics));
+	double* arrays = allocateMemory(4 * (size_t) columns * sizeof(double));
+	if (statistics == NULL || arrays == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	//The arrays share a single buffer
+	statistics->columns = columns;
+	statistics->min = arrays;
+	statistics->max = arrays + columns;
+	statistics->mean = arrays + 2 * columns;
+	statistics->squared_deviations = arrays + 3 * columns;
+	resetColumnStatistics(statistics);
+	//Return the initialized ColumnStatistics
+	return statistics;
+}
+
+//Method to reset the ColumnStatistics to no rows
+void resetColumnStatistics(ColumnStatistics* statistics)
+{
+	statistics->count = 0;
+	for (int j = 0; j < statistics->columns; j++)
+	{
+		statistics->min[j] = INFINITY;
+		statistics->max[j] = -INFINITY;
+		statistics->mean[j] = 0.0;
+		statistics->squared_deviations[j] = 0.0;
+	}
+}
+
+/**
+ * Each row updates all columns : the mean of a column is moved towards the item by its deviation divided
+ * by the count, and the sum of squared deviations is increased by the product of the deviations from the
+ * old and the new means. The columns are independent, so the inner loop is vectorized by the compiler.
+ */
+
+//Method to add the rows of a Matrix to the ColumnStatistics
+void updateColumnStatistics(ColumnStatistics* statistics, Matrix* X)
+{
+	int columns = statistics->columns;
+	double* minimums = statistics->min;
+	double* maximums = statistics->max;
+	double* means = statistics->mean;
+	double* squared_deviations = statistics->squared_deviations;
+	for (int i = 0; i < X->rows; i++)
+	{
+		double* x = MATRIX_ROW(X, i);
+		statistics->count += 1;
+		double inverse_count = 1.0 / statistics->count;
+		for (int j = 0; j < columns; j++)
+		{
+			double deviation = x[j] - means[j];
+			means[j] += deviation * inverse_count;
+			squared_deviations[j] += deviation * (x[j] - means[j]);
+			minimums[j] = (x[j] < minimums[j]) ? x[j] : minimums[j];
+			maximums[j] = (x[j] > maximums[j]) ? x[j] : maximums[j];
+		}
+	}
+}
+
+/**
+ * The statistics of two parts with the counts n_a and n_b are merged as in Chan et al. :
+ *
+ * mean = mean_a + (mean_b - mean_a) * n_b / n
+ * squared_deviations = squared_deviations_a + squared_deviations_b + (mean_b - mean_a)^2 * n_a * n_b / n
+ */
+
+//Method to merge the ColumnStatistics of other rows into the ColumnStatistics
+void mergeColumnStatistics(ColumnStatistics* statistics, ColumnStatistics* other)
+{
+	if (other->count == 0)
+	{
+		return;
+	}
+	double count = (double) (statistics->count + other->count);
+	double weight = other->count / count;
+	double product = (double) statistics->count * other->count / count;
+	for (int j = 0; j < statistics->columns; j++)
+	{
+		double difference = other->mean[j] - statistics->mean[j];
+		statistics->mean[j] += difference * weight;
+		statistics->squared_deviations[j] += other->squared_deviations[j] + difference * difference * product;
+		statistics->min[j] = fmin(statistics->min[j], other->min[j]);
+		statistics->max[j] = fmax(statistics->max[j], other->max[j]);
+	}
+	statistics->count += other->count;
+}
+
+/**
+ * Arguments of the threads calculating the statistics of the parts of a Matrix
+ */
+typedef struct
+{
+	Matrix* X;
+	ColumnStatistics** parts;
+	int number_of_parts;
+}
+ColumnStatisticsTask;
+
+//Static method run by each thread to calculate the statistics of its part of the rows
+static void runColumnStatistics(void* argument, int thread_no)
+{
+	ColumnStatisticsTask* task = argument;
+	Matrix* X = task->X;
+	int begin = (int) ((long) X->rows * thread_no / task->number_of_parts);
+	int end = (int) ((long) X->rows * (thread_no + 1) / task->number_of_parts);
+	Matrix part = {MATRIX_ROW(X, begin), end - begin, X->columns, X->stride};
+	updateColumnStatistics(task->parts[thread_no], &part);
+}
+
+//Method to calculate the statistics of the columns of a Matrix
+ColumnStatistics* columnStatistics(Matrix* X, int threads)
+{
+	//Check the number of threads, a thread has at least a row
+	if (threads < 1)
+	{
+		printf("Invalid number of threads");
+		exit(EXIT_FAILURE);
+	}
+	threads = (threads < X->rows) ? threads : (X->rows > 0 ? X->rows : 1);
+	//Initialize the statistics of the parts and handle any allocation failure
+	ColumnStatistics** parts = allocateMemory(threads * sizeof(ColumnStatistics*));
+	if (parts == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	for (int part_no = 0; part_no < threads; part_no++)
+	{
+		parts[part_no] = initColumnStatistics(X->columns);
+	}
+	//Calculate the statistics of the parts
+	ColumnStatisticsTask task = {X, parts, threads};
+	if (threads > 1)
+	{
+		ThreadPool* pool = initThreadPool(threads);
+		runThreadPool(pool, runColumnStatistics, &task);
+		disposeThreadPool(pool);
+	}
+	else
+	{
+		runColumnStatistics(&task, 0);
+	}
+	//Merge the parts in order into the first one
+	ColumnStatistics* statistics = parts[0];
+	for (int part_no = 1; part_no < threads; part_no++)
+	{
+		mergeColumnStatistics(statistics, parts[part_no]);
+		disposeColumnStatistics(parts[part_no]);
+	}
+	free(parts);
+	//Return the statistics
+	return statistics;
+}
+
+//Method to get the ranges of the columns
+void columnRanges(ColumnStatistics* statistics, double* range)
+{
+	for (int j = 0; j < statistics->columns; j++)
+	{
+		range[j] = statistics->max[j] - statistics->min[j];
+	}
+}
+
+//Method to get the standard deviations of the columns
+void columnStandardDeviations(ColumnStatistics* statistics, double* standard_deviation)
+{
+	for (int j = 0; j < statistics->columns; j++)
+	{
+		standard_deviation[j] = (statistics->count > 1) ? sqrt(statistics->squared_deviations[j] / (statistics->count - 1)) : 0.0;
+	}
+}
+
+//Method to dispose a ColumnStatistics
+void disposeColumnStatistics(ColumnStatistics* statistics)
+{
+	//The arrays share the buffer of the minimums
+	free(statistics->min);
+	free(statistics);
+	statistics = NULL;
+}
+
+/**
+ * The capacity of the compactor h of a sketch of H compactors is k * (2/3)^(H - 1 - h), and at least 2. The sketch
+ * is compacted when the number of its items reaches the sum of the capacities : the lowest compactor that is full is
+ * compacted into the next one, and so on until the sketch has room. A compactor is added on top when the top one is
+ * full, which shrinks the capacities of the ones below it.
+ */
+
+//Static method to get the capacity of a compactor of a QuantileSketch
+static int compactorCapacity(QuantileSketch* sketch, int level)
 {
-	double min = array[0];
-	double max = array[0];
-	//Find the minimum and the maximum
-	for (int i = 1; i < n; i++)
+	int capacity = (int) ceil(sketch->k * pow(2.0 / 3.0, sketch->levels - 1 - level));
+	return (capacity > 2) ? capacity : 2;
+}
+
+//Static method to make room for the passed number of items in a compactor of a QuantileSketch
+static void reserveCompactor(QuantileSketch* sketch, int level, int items)
+{
+	if (sketch->allocated[level] >= items)
+	{
+		return;
+	}
+	//Double the buffer to keep the number of allocations logarithmic
+	int allocated = (2 * sketch->allocated[level] > items) ? 2 * sketch->allocated[level] : items;
+	double* compactor = allocateMemory(allocated * sizeof(double));
+	if (compactor == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	if (sketch->sizes[level] > 0)
+	{
+		memcpy(compactor, sketch->compactors[level], sketch->sizes[level] * sizeof(double));
+	}
+	free(sketch->compactors[level]);
+	sketch->compactors[level] = compactor;
+	sketch->allocated[level] = allocated;
+}
+
+//Static method to add a compactor on top of a QuantileSketch
+static void growQuantileSketch(QuantileSketch* sketch)
+{
+	//Initialize the arrays with room for the new compactor and handle any allocation failure
+	int levels = sketch->levels + 1;
+	double** compactors = allocateMemory(levels * sizeof(double*));
+	int* sizes = allocateMemory(levels * sizeof(int));
+	int* allocated = allocateMemory(levels * sizeof(int));
+	if (compactors == NULL || sizes == NULL || allocated == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	for (int level = 0; level < sketch->levels; level++)
+	{
+		compactors[level] = sketch->compactors[level];
+		sizes[level] = sketch->sizes[level];
+		allocated[level] = sketch->allocated[level];
+	}
+	compactors[levels - 1] = NULL;
+	sizes[levels - 1] = 0;
+	allocated[levels - 1] = 0;
+	free(sketch->compactors);
+	free(sketch->sizes);
+	free(sketch->allocated);
+	sketch->compactors = compactors;
+	sketch->sizes = sizes;
+	sketch->allocated = allocated;
+	sketch->levels = levels;
+	//Update the number of items at which the sketch is compacted
+	sketch->max_size = 0;
+	for (int level = 0; level < levels; level++)
 	{
-		if (array[i] < min)
+		sketch->max_size += compactorCapacity(sketch, level);
+	}
+}
+
+//Method to initialize a QuantileSketch of no items
+QuantileSketch* initQuantileSketch(int k)
+{
+	//Check the capacity
+	if (k < 2)
+	{
+		printf("Invalid capacity of the quantile sketch");
+		exit(EXIT_FAILURE);
+	}
+	//Initialize the QuantileSketch and handle any allocation failure
+	QuantileSketch* sketch = allocateMemory(sizeof(QuantileSketch));
+	if (sketch == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	sketch->k = k;
+	sketch->levels = 0;
+	sketch->compactors = NULL;
+	sketch->sizes = NULL;
+	sketch->allocated = NULL;
+	sketch->size = 0;
+	sketch->max_size = 0;
+	sketch->count = 0;
+	sketch->min = INFINITY;
+	sketch->max = -INFINITY;
+	//Any odd seed works for the xorshift generator
+	sketch->random = 0x9E3779B97F4A7C15ULL;
+	//Begin with a compactor
+	growQuantileSketch(sketch);
+	//Return the initialized QuantileSketch
+	return sketch;
+}
+
+//Static method to compact the lowest full compactors of a QuantileSketch until it has room
+static void compressQuantileSketch(QuantileSketch* sketch)
+{
+	for (int level = 0; level < sketch->levels; level++)
+	{
+		int size = sketch->sizes[level];
+		if (size < compactorCapacity(sketch, level))
 		{
-			min = array[i];
+			continue;
 		}
-		else if (array[i] > max)
+		if (level + 1 == sketch->levels)
 		{
-			max = array[i];
+			growQuantileSketch(sketch);
+		}
+		//Sort the compactor and choose the first or the second item of each pair with the xorshift generator
+		double* compactor = sketch->compactors[level];
+		qsort(compactor, size, sizeof(double), compareItems);
+		sketch->random ^= sketch->random << 13;
+		sketch->random ^= sketch->random >> 7;
+		sketch->random ^= sketch->random << 17;
+		int offset = (int) (sketch->random >> 63);
+		//Move the chosen items into the next compactor, an odd item out stays in the compactor
+		int pairs = size / 2;
+		reserveCompactor(sketch, level + 1, sketch->sizes[level + 1] + pairs);
+		double* next = sketch->compactors[level + 1] + sketch->sizes[level + 1];
+		for (int pair_no = 0; pair_no < pairs; pair_no++)
+		{
+			next[pair_no] = compactor[2 * pair_no + offset];
+		}
+		sketch->sizes[level + 1] += pairs;
+		compactor[0] = compactor[size - 1];
+		sketch->sizes[level] = size % 2;
+		sketch->size -= size - pairs - size % 2;
+		//Stop once the sketch has room
+		if (sketch->size < sketch->max_size)
+		{
+			break;
 		}
 	}
-	//Return the range
-	return max - min;
 }
 
-//Method to calculate the standard deviation of an array
-double standardDeviation(double* array, int n)
+//Method to add items to a QuantileSketch
+void updateQuantileSketch(QuantileSketch* sketch, double* array, int n)
 {
-	double mean_array = mean(array, n);
-	//Calculate the sum of squared deviations
-	double sum_deviation_square = 0.0;
 	for (int i = 0; i < n; i++)
 	{
-		sum_deviation_square += pow(mean_array - array[i], 2);
+		double item = array[i];
+		if (isnan(item))
+		{
+			continue;
+		}
+		//Keep the exact minimum and maximum and add the item to the first compactor
+		sketch->count += 1;
+		sketch->min = (item < sketch->min) ? item : sketch->min;
+		sketch->max = (item > sketch->max) ? item : sketch->max;
+		reserveCompactor(sketch, 0, sketch->sizes[0] + 1);
+		sketch->compactors[0][sketch->sizes[0]] = item;
+		sketch->sizes[0] += 1;
+		sketch->size += 1;
+		if (sketch->size >= sketch->max_size)
+		{
+			compressQuantileSketch(sketch);
+		}
 	}
-	//Divide it by (n-1) : sample
-	sum_deviation_square /= (n-1);
-	//Return the square root of it
-	return pow(sum_deviation_square, 0.5);
+}
+
+//Method to add the columns of a Matrix to a QuantileSketch for each column
+void updateQuantileSketches(QuantileSketch** sketches, Matrix* X)
+{
+	for (int i = 0; i < X->rows; i++)
+	{
+		double* x = MATRIX_ROW(X, i);
+		for (int j = 0; j < X->columns; j++)
+		{
+			updateQuantileSketch(sketches[j], &x[j], 1);
+		}
+	}
+}
+
+//Method to merge a QuantileSketch of other items into a QuantileSketch
+void mergeQuantileSketch(QuantileSketch* sketch, QuantileSketch* other)
+{
+	//Add compactors until the sketch has as many as the other one
+	while (sketch->levels < other->levels)
+	{
+		growQuantileSketch(sketch);
+	}
+	//Concatenate the compactors level by level
+	for (int level = 0; level < other->levels; level++)
+	{
+		int size = other->sizes[level];
+		if (size == 0)
+		{
+			continue;
+		}
+		reserveCompactor(sketch, level, sketch->sizes[level] + size);
+		memcpy(sketch->compactors[level] + sketch->sizes[level], other->compactors[level], size * sizeof(double));
+		sketch->sizes[level] += size;
+		sketch->size += size;
+	}
+	sketch->count += other->count;
+	sketch->min = (other->min < sketch->min) ? other->min : sketch->min;
+	sketch->max = (other->max > sketch->max) ? other->max : sketch->max;
+	//Compact the full compactors
+	while (sketch->size >= sketch->max_size)
+	{
+		compressQuantileSketch(sketch);
+	}
+}
+
+/**
+ * An item of the compactor h stands for 2^h items, so the items of all compactors are sorted along with their
+ * weights, and the estimated quantile is the first item whose cumulative weight reaches the fraction of the total
+ * weight.
+ */
+
+//Struct of an item of a QuantileSketch and its weight
+typedef struct
+{
+	double item;
+	long weight;
+}
+WeightedItem;
+
+//Static method to compare two WeightedItems for qsort
+static int compareWeightedItems(const void* a, const void* b)
+{
+	return compareItems(&((const WeightedItem*) a)->item, &((const WeightedItem*) b)->item);
+}
+
+//Method to estimate a quantile of the items of a QuantileSketch
+double sketchQuantile(QuantileSketch* sketch, double fraction)
+{
+	//Check the arguments
+	if (sketch->count < 1 || !(fraction >= 0.0 && fraction <= 1.0))
+	{
+		printf("Invalid quantile");
+		exit(EXIT_FAILURE);
+	}
+	//The minimum and the maximum are exact
+	if (fraction == 0.0)
+	{
+		return sketch->min;
+	}
+	if (fraction == 1.0)
+	{
+		return sketch->max;
+	}
+	//Collect the items with their weights and handle any allocation failure
+	WeightedItem* items = allocateMemory(sketch->size * sizeof(WeightedItem));
+	if (items == NULL)
+	{
+		printf("Failed to allocate memory");
+		exit(EXIT_FAILURE);
+	}
+	int size = 0;
+	long total_weight = 0;
+	for (int level = 0; level < sketch->levels; level++)
+	{
+		for (int item_no = 0; item_no < sketch->sizes[level]; item_no++)
+		{
+			items[size].item = sketch->compactors[level][item_no];
+			items[size].weight = 1L << level;
+			total_weight += items[size].weight;
+			size++;
+		}
+	}
+	qsort(items, size, sizeof(WeightedItem), compareWeightedItems);
+	//Find the first item whose cumulative weight reaches the fraction of the total weight
+	double rank = fraction * total_weight;
+	long cumulative_weight = 0;
+	double quantile = items[size - 1].item;
+	for (int item_no = 0; item_no < size; item_no++)
+	{
+		cumulative_weight += items[item_no].weight;
+		if (cumulative_weight >= rank)
+		{
+			quantile = items[item_no].item;
+			break;
+		}
+	}
+	free(items);
+	//Return the estimated quantile
+	return quantile;
+}
+
+//Method to dispose a QuantileSketch
+void disposeQuantileSketch(QuantileSketch* sketch)
+{
+	for (int level = 0; level < sketch->levels; level++)
+	{
+		free(sketch->compactors[level]);
+	}
+	free(sketch->compactors);
+	free(sketch->sizes);
+	free(sketch->allocated);
+	free(sketch);
+	sketch = NULL;
 }
@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/core/allocation.h"
+#include "../include/core/gemm.h"
+#include "../include/neural_networks/ANN.h"
+#include "../include/neural_networks/FrozenANN.h"
+#include "../include/regression/logistic_regression.h"
+
+#include "../tests/sample_data.h"
+
+/*
+ * Test of the steady-state allocations of the training loops. A model is trained for
+ * FEW_ITERATIONS and for MANY_ITERATIONS, and the allocations counted during the two
+ * trainings must be the same, i.e. the additional iterations must not allocate. The
+ * workspaces of the models grow at the end of their first iterations, so both of the
+ * trainings have more than one iteration. The predictions of a FrozenANN are counted the
+ * same way, with FEW_ITERATIONS and MANY_ITERATIONS predictions.
+ *
+ * The library should be compiled with the allocation counter enabled, e.g.
+ * gcc -DLIBBQSC_DEBUG_ALLOCATIONS tests/AllocationTest.c $(find src -name '*.c') -lm
+ */
+
+//Numbers of iterations of the two trainings
+#define FEW_ITERATIONS 2
+#define MANY_ITERATIONS 102
+
+//Method to count the allocations of the initialization, training and disposal of an ANN, batch_size 0 is full-batch
+static long countANNAllocations(double** X, double** Y, int iterations, int batch_size, int threads)
+{
+	//Dispose the packing buffers of matrixGEMM() so both trainings allocate them
+	disposeGEMMBuffers();
+	resetAllocationCount();
+	ANN* ann = initANN(X, Y, samples, features, classes);
+	addLayerANN(ann, 12, HIDDEN_LAYER, SIGMOID);
+	addLayerANN(ann, 6, HIDDEN_LAYER, SIGMOID);
+	addLayerANN(ann, 1, OUTPUT_LAYER, SIGMOID);
+	setThreadsANN(ann, threads);
+	if (batch_size == 0)
+	{
+		trainANN(ann, iterations, 1e-8);
+	}
+	else
+	{
+		trainANNMiniBatch(ann, iterations, batch_size, 0.0);
+	}
+	disposeANN(ann);
+	return getAllocationCount();
+}
+
+//Method to count the allocations of the initialization, training and disposal of a LogisticRegression
+static long countLogisticRegressionAllocations(double** X, double** Y, int iterations)
+{
+	//Dispose the packing buffers of matrixGEMM() so both trainings allocate them
+	disposeGEMMBuffers();
+	resetAllocationCount();
+	LogisticRegression* regr = initLogisticRegression(X, Y, samples, features, classes);
+	trainLogisticRegression(regr, ADAM_OPTIMIZER, iterations, 0.0);
+	disposeLogisticRegression(regr);
+	return getAllocationCount();
+}
+
+//Method to count the allocations of the initialization, online training by chunks of 64 rows and disposal of a LogisticRegression
+static long countOnlineLogisticRegressionAllocations(double** X, double** Y, int iterations)
+{
+	//Dispose the packing buffers of matrixGEMM() so both trainings allocate them
+	disposeGEMMBuffers();
+	resetAllocationCount();
+	Matrix* X_matrix = matrixFromArray(X, samples, features);
+	Matrix* Y_matrix = matrixFromArray(Y, samples, classes);
+	LogisticRegression* regr = initLogisticRegressionOnline(features, classes);
+	for (int iteration = 0; iteration < iterations; iteration++)
+	{
+		int begin = iteration * 64 % samples;
+		int rows = (samples - begin < 64) ? samples - begin : 64;
+		Matrix X_chunk = {MATRIX_ROW(X_matrix, begin), rows, features, X_matrix->stride};
+		Matrix Y_chunk = {MATRIX_ROW(Y_matrix, begin), rows, classes, Y_matrix->stride};
+		partialFitLogisticRegression(regr, ADAM_OPTIMIZER, &X_chunk, &Y_chunk);
+	}
+	disposeLogisticRegression(regr);
+	disposeMatrix(X_matrix);
+	disposeMatrix(Y_matrix);
+	return getAllocationCount();
+}
+
+//Method to count the allocations of the predictions of a FrozenANN once its Workspace is sized
+static long countFrozenANNAllocations(double** X, double** Y, int predictions)
+{
+	ANN* ann = initANN(X, Y, samples, features, classes);
+	addLayerANN(ann, 12, HIDDEN_LAYER, TANH);
+	addLayerANN(ann, 6, HIDDEN_LAYER, RELU);
+	addLayerANN(ann, 1, OUTPUT_LAYER, SIGMOID);
+	FrozenANN* frozen = compileANN(ann);
+	Workspace* scratch = initWorkspace(scratchSizeFrozenANN(frozen, samples));
+	double* input = malloc(samples * features * sizeof(double));
+	double* output = malloc(samples * classes * sizeof(double));
+	for (int i = 0; i < samples; i++)
+	{
+		for (int j = 0; j < features; j++)
+		{
+			input[i * features + j] = X[i][j];
+		}
+	}
+	//Count the allocations of the predictions only, including the packing buffers of matrixGEMM()
+	disposeGEMMBuffers();
+	resetAllocationCount();
+	for (int prediction = 0; prediction < predictions; prediction++)
+	{
+		predictFrozenANN(frozen, input, samples, output, scratch);
+		predictFrozenANN(frozen, input + prediction % samples * features, 1, output, scratch);
+	}
+	long count = getAllocationCount();
+	free(input);
+	free(output);
+	disposeWorkspace(scratch);
+	disposeFrozenANN(frozen);
+	disposeANN(ann);
+	return count;
+}
+
+//Method to check that the two trainings allocated the same number of times
+static int checkAllocations(const char* model, long few, long many)
+{
+	printf("%s : %ld allocations for %d iterations, %ld allocations for %d iterations\n", model, few, FEW_ITERATIONS, many, MANY_ITERATIONS);
+	if (few != many)
+	{
+		printf("%s training iterations are not allocation-free\n", model);
+		return 0;
+	}
+	return 1;
+}
+
+int main()
+{
+	//Import the X and Y data
+	double** X = getX();
+	double** Y = getY();
+	//Count the allocations of the trainings and fail if the additional iterations allocated
+	int passed = checkAllocations("ANN", countANNAllocations(X, Y, FEW_ITERATIONS, 0, 1), countANNAllocations(X, Y, MANY_ITERATIONS, 0, 1));
+	passed &= checkAllocations("ANN (mini-batch)", countANNAllocations(X, Y, FEW_ITERATIONS, 64, 1), countANNAllocations(X, Y, MANY_ITERATIONS, 64, 1));
+	passed &= checkAllocations("ANN (4 threads)", countANNAllocations(X, Y, FEW_ITERATIONS, 64, 4), countANNAllocations(X, Y, MANY_ITERATIONS, 64, 4));
+	passed &= checkAllocations("LogisticRegression", countLogisticRegressionAllocations(X, Y, FEW_ITERATIONS), countLogisticRegressionAllocations(X, Y, MANY_ITERATIONS));
+	passed &= checkAllocations("LogisticRegression (online)", countOnlineLogisticRegressionAllocations(X, Y, FEW_ITERATIONS), countOnlineLogisticRegressionAllocations(X, Y, MANY_ITERATIONS));
+	passed &= checkAllocations("FrozenANN", countFrozenANNAllocations(X, Y, FEW_ITERATIONS), countFrozenANNAllocations(X, Y, MANY_ITERATIONS));
+	//Exit success if both of the models passed
+	return (passed == 1) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/data/csv_loader.h"
+
+#include "../tests/sample_data.h"
+
+/*
+ * Test of the CSV loader. The sample data is written into a CSV file with an id column, a
+ * header and Windows line breaks, and it is repeated so that the file is split between
+ * several threads. The loaded X and Y must be the same as the sample data, with the labels
+ * either as they are or one-hot encoded.
+ *
+ * e.g. gcc tests/CSVLoaderTest.c $(find src -name '*.c') -lm -pthread
+ */
+
+//Path of the CSV file written by the test and the number of times the sample data is repeated in it
+#define CSV_PATH "CSVLoaderTest.csv"
+#define REPEATS 100
+
+//Method to check the loaded matrices against the sample data
+static int checkLoaded(const char* test, Matrix* X, Matrix* Y, double** X_sample, double** Y_sample, int one_hot)
+{
+	int mismatches = 0;
+	for (int i = 0; i < X->rows; i++)
+	{
+		int sample_no = i % samples;
+		for (int j = 0; j < features; j++)
+		{
+			mismatches += (MATRIX_AT(X, i, j) != X_sample[sample_no][j]);
+		}
+		if (one_hot == 1)
+		{
+			int label = (int) Y_sample[sample_no][0];
+			mismatches += (MATRIX_AT(Y, i, label) != 1.0 || MATRIX_AT(Y, i, 1 - label) != 0.0);
+		}
+		else
+		{
+			mismatches += (MATRIX_AT(Y, i, 0) != Y_sample[sample_no][0]);
+		}
+	}
+	int passed = (X->rows == samples * REPEATS && X->columns == features && mismatches == 0);
+	printf("%s : %d rows loaded with %d mismatches\n", test, X->rows, mismatches);
+	return passed;
+}
+
+int main()
+{
+	//Write the sample data into a CSV file
+	double** X_sample = getX();
+	double** Y_sample = getY();
+	FILE* file = fopen(CSV_PATH, "w");
+	fprintf(file, "id,x0,x1,label\r\n");
+	for (int repeat_no = 0; repeat_no < REPEATS; repeat_no++)
+	{
+		for (int i = 0; i < samples; i++)
+		{
+			fprintf(file, "%d,%.17g,%.17g,%g\r\n", repeat_no * samples + i, X_sample[i][0], X_sample[i][1], Y_sample[i][0]);
+		}
+	}
+	fclose(file);
+	//Load the features without the id column and the labels as they are, with one and several threads
+	CSVOptions options = defaultCSVOptions();
+	int feature_columns[features] = {1, 2};
+	options.feature_columns = feature_columns;
+	options.number_of_features = features;
+	int passed = 1;
+	for (int threads = 1; threads <= 4; threads *= 4)
+	{
+		Matrix* X;
+		Matrix* Y;
+		options.threads = threads;
+		loadCSV(CSV_PATH, &options, &X, &Y);
+		passed &= checkLoaded((threads == 1) ? "Single thread" : "Several threads", X, Y, X_sample, Y_sample, 0);
+		disposeMatrix(X);
+		disposeMatrix(Y);
+	}
+	//Load the labels one-hot encoded into two classes
+	Matrix* X;
+	Matrix* Y;
+	options.one_hot_classes = 2;
+	loadCSV(CSV_PATH, &options, &X, &Y);
+	passed &= checkLoaded("One-hot labels", X, Y, X_sample, Y_sample, 1);
+	disposeMatrix(X);
+	disposeMatrix(Y);
+	//Remove the file
+	remove(CSV_PATH);
+	matrixDispose(X_sample, samples);
+	matrixDispose(Y_sample, samples);
+	//Exit success if all loads gave the sample data
+	return (passed == 1) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
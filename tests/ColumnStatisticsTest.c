@@ -0,0 +1,65 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/statistics/statistics.h"
+
+/*
+ * Test of the column statistics. The statistics of the columns of a random matrix, calculated
+ * by one and several threads, must match the ones calculated column by column by the methods
+ * of the statistics class. A column with a large mean must keep the precision of its standard
+ * deviation.
+ *
+ * e.g. gcc tests/ColumnStatisticsTest.c $(find src -name '*.c') -lm -pthread
+ */
+
+//Dimensions of the random matrix
+#define ROWS 10007
+#define COLUMNS 13
+
+//Method to calculate the largest relative difference between the statistics and the ones of the statistics class
+static double largestDifference(ColumnStatistics* statistics, Matrix* X)
+{
+	double* column = malloc(X->rows * sizeof(double));
+	double standard_deviation[COLUMNS];
+	columnStandardDeviations(statistics, standard_deviation);
+	double difference = (statistics->count == X->rows) ? 0.0 : INFINITY;
+	for (int j = 0; j < X->columns; j++)
+	{
+		for (int i = 0; i < X->rows; i++)
+		{
+			column[i] = MATRIX_AT(X, i, j);
+		}
+		double scale = fmax(fabs(mean(column, X->rows)), 1.0);
+		difference = fmax(difference, fabs(statistics->mean[j] - mean(column, X->rows)) / scale);
+		difference = fmax(difference, fabs(standard_deviation[j] / standardDeviation(column, X->rows) - 1.0));
+		difference = fmax(difference, fabs(statistics->min[j] - min(column, X->rows)));
+		difference = fmax(difference, fabs(statistics->max[j] - max(column, X->rows)));
+	}
+	free(column);
+	return difference;
+}
+
+int main()
+{
+	//Random matrix whose last column has a mean of 1e9 and a standard deviation of about 0.3
+	Matrix* X = createRandomMatrix(ROWS, COLUMNS);
+	for (int i = 0; i < ROWS; i++)
+	{
+		MATRIX_AT(X, i, COLUMNS - 1) += 1e9;
+	}
+	//Compare the statistics calculated by different numbers of threads
+	int passed = 1;
+	for (int threads = 1; threads <= 4; threads++)
+	{
+		ColumnStatistics* statistics = columnStatistics(X, threads);
+		double difference = largestDifference(statistics, X);
+		printf("%d threads : largest relative difference is %g\n", threads, difference);
+		//The items of the last column are only exact to about 1e-7, and the sum of squares would lose all of its digits
+		passed &= (difference < 1e-6);
+		disposeColumnStatistics(statistics);
+	}
+	disposeMatrix(X);
+	//Exit success if all statistics matched
+	return (passed == 1) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
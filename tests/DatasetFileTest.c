@@ -0,0 +1,107 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/data/dataset_file.h"
+#include "../include/neural_networks/ANN.h"
+#include "../include/statistics/statistics.h"
+
+#include "../tests/sample_data.h"
+
+/*
+ * Test of the dataset files. The sample data is written into a file of doubles and a file
+ * of floats. The mapped rows must be the same as the sample data, the stored statistics must
+ * match the ones calculated by the statistics class, and an ANN must be trainable on the file.
+ *
+ * e.g. gcc tests/DatasetFileTest.c $(find src -name '*.c') -lm -pthread
+ */
+
+//Paths of the dataset files written by the test
+#define FLOAT64_PATH "DatasetFileTest_64.bin"
+#define FLOAT32_PATH "DatasetFileTest_32.bin"
+
+//Method to calculate the largest relative difference between the stored statistics and the calculated ones
+static double statisticsDifference(DatasetStatistics* statistics, double** X)
+{
+	double difference = 0.0;
+	double column[samples];
+	for (int j = 0; j < features; j++)
+	{
+		for (int i = 0; i < samples; i++)
+		{
+			column[i] = X[i][j];
+		}
+		difference = fmax(difference, fabs(statistics->min[j] - min(column, samples)));
+		difference = fmax(difference, fabs(statistics->range[j] - range(column, samples)));
+		difference = fmax(difference, fabs(statistics->mean[j] - mean(column, samples)));
+		difference = fmax(difference, fabs(statistics->standard_deviation[j] / standardDeviation(column, samples) - 1.0));
+	}
+	return difference;
+}
+
+int main()
+{
+	//Import the X and Y data and write them into the dataset files
+	double** X_sample = getX();
+	double** Y_sample = getY();
+	Matrix* X = matrixFromArray(X_sample, samples, features);
+	Matrix* Y = matrixFromArray(Y_sample, samples, classes);
+	writeDatasetFile(FLOAT64_PATH, X, Y, DATASET_FLOAT64, 1);
+	writeDatasetFile(FLOAT32_PATH, X, Y, DATASET_FLOAT32, 0);
+	//The views into the file of doubles must be the same as the sample data
+	DatasetFile* file = mapDatasetFile(FLOAT64_PATH, 1);
+	Matrix X_view = datasetFileX(file);
+	Matrix Y_view = datasetFileY(file);
+	int mismatches = (X_view.rows != samples || Y_view.columns != classes);
+	for (int i = 0; i < samples && mismatches == 0; i++)
+	{
+		for (int j = 0; j < features; j++)
+		{
+			mismatches += (MATRIX_AT(&X_view, i, j) != X_sample[i][j]);
+		}
+		mismatches += (MATRIX_AT(&Y_view, i, 0) != Y_sample[i][0]);
+	}
+	printf("Doubles : %d mismatches\n", mismatches);
+	int passed = (mismatches == 0);
+	//The stored statistics must match the statistics class
+	DatasetStatistics statistics = datasetFileStatistics(file);
+	double difference = statisticsDifference(&statistics, X_sample);
+	printf("Statistics : largest difference is %g\n", difference);
+	passed &= (difference < 1e-12);
+	//The rows of the file of floats must be the sample data rounded to floats
+	DatasetFile* file32 = mapDatasetFile(FLOAT32_PATH, 1);
+	Matrix* X_rows = createMatrix(samples - 100, features);
+	Matrix* Y_rows = createMatrix(samples - 100, classes);
+	datasetFileRows(file32, 100, X_rows, Y_rows);
+	mismatches = 0;
+	for (int i = 0; i < X_rows->rows; i++)
+	{
+		for (int j = 0; j < features; j++)
+		{
+			mismatches += (MATRIX_AT(X_rows, i, j) != (double) (float) X_sample[i + 100][j]);
+		}
+		mismatches += (MATRIX_AT(Y_rows, i, 0) != Y_sample[i + 100][0]);
+	}
+	printf("Floats : %d mismatches\n", mismatches);
+	passed &= (mismatches == 0);
+	//Train an ANN on both files without its own X and Y
+	ANN* ann = initANN(NULL, NULL, 0, features, classes);
+	addLayerANN(ann, 6, HIDDEN_LAYER, RELU);
+	addLayerANN(ann, 1, OUTPUT_LAYER, SIGMOID);
+	trainANNDataset(ann, file, 5, 64, 0.0);
+	trainANNDataset(ann, file32, 5, 64, 0.0);
+	disposeANN(ann);
+	//Dispose the data and remove the files
+	disposeMatrix(X_rows);
+	disposeMatrix(Y_rows);
+	unmapDatasetFile(file);
+	unmapDatasetFile(file32);
+	remove(FLOAT64_PATH);
+	remove(FLOAT32_PATH);
+	disposeMatrix(X);
+	disposeMatrix(Y);
+	matrixDispose(X_sample, samples);
+	matrixDispose(Y_sample, samples);
+	//Exit success if the files gave back the sample data and its statistics
+	return (passed == 1) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,96 @@
+//clock_gettime() isn't declared by the C standard
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../include/core/gemm.h"
+#include "../include/core/linear_algebra.h"
+#include "../include/core/matrix.h"
+
+/*
+ * Benchmark of matrixGEMM() against the naive i-j-k loop that matrixMultiplication()
+ * used before, for square matrices of the sizes below. The naive loop runs over the
+ * double** arrays as it did in matrixMultiplication().
+ *
+ * The micro-kernel of matrixGEMM() is chosen at run time : the AVX2 one if the instruction
+ * set of the vector kernels is AVX2 or wider, and the portable one otherwise. The AVX2 one is
+ * compiled for AVX2 whatever the flags are, so -march isn't required, but the benchmark should
+ * be compiled with the optimizations enabled, e.g.
+ * gcc -O3 tests/GEMMBenchmark.c $(find src -name '*.c') -lm -pthread
+ */
+
+//Sizes of the square matrices to be multiplied
+static const int benchmark_sizes[] = {64, 256, 1024, 4096};
+
+//Method to get the current time in seconds
+static double currentSeconds()
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+//Method for the naive i-j-k matrix multiplication
+static void naiveMultiplication(double** A, double** B, double** C, int n)
+{
+	for (int a_row_no = 0; a_row_no < n; a_row_no++)
+	{
+		for (int b_column_no = 0; b_column_no < n; b_column_no++)
+		{
+			double new_item = 0;
+			for (int index = 0; index < n; index++)
+			{
+				new_item += A[a_row_no][index] * B[index][b_column_no];
+			}
+			C[a_row_no][b_column_no] = new_item;
+		}
+	}
+}
+
+int main()
+{
+	printf("%8s %16s %16s\n", "size", "naive GFLOP/s", "GEMM GFLOP/s");
+	//Iterate over the sizes
+	for (int size_no = 0; size_no < (int)(sizeof(benchmark_sizes) / sizeof(benchmark_sizes[0])); size_no++)
+	{
+		int n = benchmark_sizes[size_no];
+		double flops = 2.0 * n * n * n;
+		//Initialize the matrices
+		Matrix* A = createRandomMatrix(n, n);
+		Matrix* B = createRandomMatrix(n, n);
+		Matrix* C = createMatrix(n, n);
+		double** A_array = matrixToArray(A);
+		double** B_array = matrixToArray(B);
+		double** C_array = matrixToArray(C);
+		//Repeat the smaller multiplications to measure a meaningful duration
+		int repeats = (n <= 256) ? 20 : 1;
+		//Time the naive loop
+		double begin = currentSeconds();
+		for (int repeat = 0; repeat < repeats; repeat++)
+		{
+			naiveMultiplication(A_array, B_array, C_array, n);
+		}
+		double naive_seconds = (currentSeconds() - begin) / repeats;
+		//Time the GEMM
+		begin = currentSeconds();
+		for (int repeat = 0; repeat < repeats; repeat++)
+		{
+			matrixGEMM(0, 0, 1.0, A, B, 0.0, C);
+		}
+		double gemm_seconds = (currentSeconds() - begin) / repeats;
+		//Print the results
+		printf("%8d %16.3f %16.3f\n", n, flops / naive_seconds * 1e-9, flops / gemm_seconds * 1e-9);
+		//Dispose the matrices
+		matrixDispose(A_array, n);
+		matrixDispose(B_array, n);
+		matrixDispose(C_array, n);
+		disposeMatrix(A);
+		disposeMatrix(B);
+		disposeMatrix(C);
+	}
+	//Exit success
+	return EXIT_SUCCESS;
+}
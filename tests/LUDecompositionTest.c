@@ -0,0 +1,112 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/core/linear_algebra.h"
+
+/*
+ * Test of the LU decomposition methods. The determinant, the solutions of Ax = b into a
+ * separate vector and in place, and the inverse calculated by luInverseInto() must match
+ * the exact values of a non-symmetric matrix and of a matrix whose first pivot is zero, so
+ * its rows must be swapped. The decomposition of a singular matrix must be flagged.
+ *
+ * e.g. gcc tests/LUDecompositionTest.c $(find src -name '*.c') -lm -pthread
+ */
+
+//Size of the test matrices
+#define N 4
+
+//Non-symmetric matrix, its determinant and its inverse
+static const double non_symmetric[N][N] = {{2, 1, 0, 3}, {1, 3, 2, 0}, {0, 1, 4, 1}, {2, 0, 1, 5}};
+static const double non_symmetric_determinant = 8.0;
+static const double non_symmetric_inverse[N][N] = {
+	{47.0 / 8, -11.0 / 4, 19.0 / 8, -4.0},
+	{-23.0 / 8, 7.0 / 4, -11.0 / 8, 2.0},
+	{11.0 / 8, -3.0 / 4, 7.0 / 8, -1.0},
+	{-21.0 / 8, 5.0 / 4, -9.0 / 8, 2.0}};
+
+//Matrix whose first pivot is zero, its determinant and its inverse
+static const double pivoting[N][N] = {{0, 2, 1, 0}, {1, 1, 0, 2}, {3, 0, 1, 1}, {0, 1, 2, 1}};
+static const double pivoting_determinant = -20.0;
+static const double pivoting_inverse[N][N] = {
+	{3.0 / 20, -1.0 / 20, 7.0 / 20, -1.0 / 4},
+	{11.0 / 20, 3.0 / 20, -1.0 / 20, -1.0 / 4},
+	{-1.0 / 10, -3.0 / 10, 1.0 / 10, 1.0 / 2},
+	{-7.0 / 20, 9.0 / 20, -3.0 / 20, 1.0 / 4}};
+
+//Singular matrix, its second row is twice the first one
+static const double singular[N][N] = {{1, 2, 0, 1}, {2, 4, 0, 2}, {1, 0, 1, 1}, {2, 1, 3, 1}};
+
+//Method to copy a constant table into a new matrix
+static double** tableToMatrix(const double table[N][N])
+{
+	double** A = initMatrix(N, N);
+	for (int i = 0; i < N; i++)
+	{
+		for (int j = 0; j < N; j++)
+		{
+			A[i][j] = table[i][j];
+		}
+	}
+	return A;
+}
+
+//Method to check the determinant, the solutions and the inverse calculated by the LU decomposition of a matrix
+static int checkDecomposition(const char* test, const double table[N][N], double determinant, const double inverse[N][N])
+{
+	double** A = tableToMatrix(table);
+	LUDecomposition* lu = initLUDecomposition(A, N, N);
+	//The b is calculated from a known x
+	double x_true[N] = {1.0, -2.0, 3.0, -4.0};
+	double b[N];
+	double x[N];
+	for (int i = 0; i < N; i++)
+	{
+		b[i] = 0.0;
+		for (int j = 0; j < N; j++)
+		{
+			b[i] += table[i][j] * x_true[j];
+		}
+	}
+	luSolveInto(lu, b, x);
+	luSolveInto(lu, b, b);
+	double solution_difference = 0.0;
+	for (int i = 0; i < N; i++)
+	{
+		solution_difference = fmax(solution_difference, fmax(fabs(x[i] - x_true[i]), fabs(b[i] - x_true[i])));
+	}
+	//The inverse is written into an existing matrix
+	double** A_inverse = initMatrix(N, N);
+	luInverseInto(lu, A_inverse);
+	double inverse_difference = 0.0;
+	for (int i = 0; i < N; i++)
+	{
+		for (int j = 0; j < N; j++)
+		{
+			inverse_difference = fmax(inverse_difference, fabs(A_inverse[i][j] - inverse[i][j]));
+		}
+	}
+	double determinant_difference = fabs(luDeterminant(lu) - determinant);
+	printf("%s : differences of the determinant, the solutions and the inverse are %g, %g and %g\n", test, determinant_difference, solution_difference, inverse_difference);
+	int passed = (lu->singular == 0 && determinant_difference < 1e-12 && solution_difference < 1e-12 && inverse_difference < 1e-12);
+	//Dispose the matrices and the decomposition
+	disposeLUDecomposition(lu);
+	matrixDispose(A, N);
+	matrixDispose(A_inverse, N);
+	return passed;
+}
+
+int main()
+{
+	int passed = checkDecomposition("Non-symmetric matrix", non_symmetric, non_symmetric_determinant, non_symmetric_inverse);
+	passed &= checkDecomposition("Matrix requiring pivoting", pivoting, pivoting_determinant, pivoting_inverse);
+	//The decomposition of the singular matrix must be flagged
+	double** A = tableToMatrix(singular);
+	LUDecomposition* lu = initLUDecomposition(A, N, N);
+	printf("Singular matrix : the decomposition is %s\n", (lu->singular == 1) ? "flagged as singular" : "not flagged as singular");
+	passed &= (lu->singular == 1);
+	disposeLUDecomposition(lu);
+	matrixDispose(A, N);
+	//Exit success if the decompositions gave the exact values
+	return (passed == 1) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
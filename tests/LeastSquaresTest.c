@@ -0,0 +1,137 @@
+//fork() and waitpid() aren't declared by the C standard
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../include/core/linear_algebra.h"
+#include "../include/core/matrix.h"
+
+/*
+ * Test of the least squares methods. Both solvers must recover the B of a consistent XB = Y,
+ * and the left inverse of a tall ill-conditioned matrix, whose Gram matrix isn't numerically
+ * positive definite, must be calculated by the QR decomposition without an (m, m) matrix.
+ * A rank deficient matrix must make the solvers exit instead of returning huge items.
+ *
+ * e.g. gcc tests/LeastSquaresTest.c $(find src -name '*.c') -lm -pthread
+ */
+
+//Dimensions of the consistent system and the rows of the tall ill-conditioned matrix
+#define SYSTEM_ROWS 200
+#define SYSTEM_COLUMNS 5
+#define SYSTEM_TARGETS 2
+#define TALL_ROWS 20000
+
+//Rows of the rank deficient matrix, whose second column is twice the first one
+#define DEFICIENT_ROWS 4
+
+//Method to check that a solver recovers the B of a consistent system
+static int checkSolver(const char* test, Matrix* X, Matrix* Y, Matrix* B_true, LeastSquaresSolver solver)
+{
+	Matrix* B = matrixLeastSquares(X, Y, solver);
+	double difference = 0.0;
+	for (int i = 0; i < B->rows; i++)
+	{
+		for (int j = 0; j < B->columns; j++)
+		{
+			difference = fmax(difference, fabs(MATRIX_AT(B, i, j) - MATRIX_AT(B_true, i, j)));
+		}
+	}
+	printf("%s : largest difference from the B is %g\n", test, difference);
+	disposeMatrix(B);
+	return (difference < 1e-10);
+}
+
+//Method to check that a solver exits with a failure on a rank deficient matrix, it is run in a child process
+static int checkRankDeficiency(const char* test, int left_inverse, LeastSquaresSolver solver)
+{
+	fflush(stdout);
+	pid_t child = fork();
+	if (child == 0)
+	{
+		//Silence the message of the library, the child exits in any case
+		freopen("/dev/null", "w", stdout);
+		double** A = initMatrix(DEFICIENT_ROWS, 2);
+		for (int i = 0; i < DEFICIENT_ROWS; i++)
+		{
+			A[i][0] = i + 1.0;
+			A[i][1] = 2.0 * (i + 1.0);
+		}
+		if (left_inverse == 1)
+		{
+			matrixLeftInverse(A, DEFICIENT_ROWS, 2);
+		}
+		else
+		{
+			Matrix* X = matrixFromArray(A, DEFICIENT_ROWS, 2);
+			Matrix* Y = createRandomMatrix(DEFICIENT_ROWS, 1);
+			matrixLeastSquares(X, Y, solver);
+		}
+		exit(EXIT_SUCCESS);
+	}
+	int status = 0;
+	int passed = (child > 0 && waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_FAILURE);
+	printf("%s : rank deficient matrix %s\n", test, (passed == 1) ? "is rejected" : "is not rejected");
+	return passed;
+}
+
+int main()
+{
+	//Consistent system with a random X and B
+	srand(1);
+	Matrix* X = createRandomMatrix(SYSTEM_ROWS, SYSTEM_COLUMNS);
+	Matrix* B_true = createRandomMatrix(SYSTEM_COLUMNS, SYSTEM_TARGETS);
+	Matrix* Y = createZeroMatrix(SYSTEM_ROWS, SYSTEM_TARGETS);
+	for (int i = 0; i < SYSTEM_ROWS; i++)
+	{
+		for (int j = 0; j < SYSTEM_TARGETS; j++)
+		{
+			for (int k = 0; k < SYSTEM_COLUMNS; k++)
+			{
+				MATRIX_AT(Y, i, j) += MATRIX_AT(X, i, k) * MATRIX_AT(B_true, k, j);
+			}
+		}
+	}
+	int passed = checkSolver("Cholesky solver", X, Y, B_true, CHOLESKY_SOLVER);
+	passed &= checkSolver("QR solver", X, Y, B_true, QR_SOLVER);
+	//Tall matrix whose last column is almost the second one, so its Gram matrix is singular in doubles
+	double** A = initMatrix(TALL_ROWS, 3);
+	for (int i = 0; i < TALL_ROWS; i++)
+	{
+		A[i][0] = 1.0;
+		A[i][1] = (double) i / TALL_ROWS;
+		A[i][2] = A[i][1] + 1e-9 * ((double) rand() / RAND_MAX - 0.5);
+	}
+	double** A_left_inverse = matrixLeftInverse(A, TALL_ROWS, 3);
+	//The left inverse times the A must be the identity up to the condition number of the A
+	double difference = 0.0;
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			double item = 0.0;
+			for (int k = 0; k < TALL_ROWS; k++)
+			{
+				item += A_left_inverse[i][k] * A[k][j];
+			}
+			difference = fmax(difference, fabs(item - (i == j)));
+		}
+	}
+	printf("Ill-conditioned left inverse : largest difference from the identity is %g\n", difference);
+	passed &= (difference < 1e-4);
+	//Rank deficient matrices must be rejected by both solvers and the left inverse
+	passed &= checkRankDeficiency("Cholesky solver", 0, CHOLESKY_SOLVER);
+	passed &= checkRankDeficiency("QR solver", 0, QR_SOLVER);
+	passed &= checkRankDeficiency("Left inverse", 1, QR_SOLVER);
+	//Dispose the matrices
+	disposeMatrix(X);
+	disposeMatrix(B_true);
+	disposeMatrix(Y);
+	matrixDispose(A, TALL_ROWS);
+	matrixDispose(A_left_inverse, 3);
+	//Exit success if the solutions were recovered
+	return (passed == 1) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
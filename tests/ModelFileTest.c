@@ -0,0 +1,162 @@
+//fork() and waitpid() aren't declared by the C standard
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../include/core/linear_algebra.h"
+#include "../include/core/model_file.h"
+#include "../include/neural_networks/FrozenANN.h"
+#include "../include/regression/logistic_regression.h"
+
+#include "../tests/sample_data.h"
+
+/*
+ * Test of the model files. An ANN and a LogisticRegression are trained briefly, saved and
+ * loaded back, and the predictions of the loaded models must be the same as the ones of
+ * the original models. Copies of a file with a flipped byte in a blob, with a truncated end
+ * and with a layer table out of the file must make the loader exit, the first one when its
+ * checksum is verified and the others even when it isn't.
+ *
+ * e.g. gcc tests/ModelFileTest.c $(find src -name '*.c') -lm -pthread
+ */
+
+//Paths of the model files written by the test
+#define ANN_PATH "ModelFileTest_ANN.bin"
+#define LOGISTIC_REGRESSION_PATH "ModelFileTest_LogisticRegression.bin"
+#define CORRUPT_PATH "ModelFileTest_Corrupt.bin"
+
+//Method to calculate the largest difference between two predictions
+static double maxDifference(double** A, double* B, int rows, int columns)
+{
+	double difference = 0.0;
+	for (int i = 0; i < rows; i++)
+	{
+		for (int j = 0; j < columns; j++)
+		{
+			difference = fmax(difference, fabs(A[i][j] - B[i * columns + j]));
+		}
+	}
+	return difference;
+}
+
+//Method to check the predictions of a loaded model
+static int checkPredictions(const char* model, double difference)
+{
+	printf("%s : largest difference of the loaded model is %g\n", model, difference);
+	return difference == 0.0;
+}
+
+//Method to read a whole file into a buffer
+static char* readFile(const char* path, size_t* size)
+{
+	FILE* file = fopen(path, "rb");
+	fseek(file, 0, SEEK_END);
+	*size = (size_t) ftell(file);
+	fseek(file, 0, SEEK_SET);
+	char* buffer = malloc(*size);
+	*size = fread(buffer, 1, *size, file);
+	fclose(file);
+	return buffer;
+}
+
+//Method to check the exit status of loading a copy of a logistic regression file, it is loaded in a child process
+static int checkLoading(const char* test, const char* buffer, size_t size, int verify_checksum, int expected_status)
+{
+	FILE* file = fopen(CORRUPT_PATH, "wb");
+	fwrite(buffer, 1, size, file);
+	fclose(file);
+	fflush(stdout);
+	pid_t child = fork();
+	if (child == 0)
+	{
+		//Silence the message of the library, the child exits in any case
+		freopen("/dev/null", "w", stdout);
+		disposeLogisticRegression(loadLogisticRegression(CORRUPT_PATH, verify_checksum));
+		exit(EXIT_SUCCESS);
+	}
+	int status = 0;
+	int passed = (child > 0 && waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == expected_status);
+	printf("%s : the file is %s\n", test, (WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS) ? "loaded" : "rejected");
+	remove(CORRUPT_PATH);
+	return passed;
+}
+
+int main()
+{
+	//Import the X and Y data and copy the X into a contiguous buffer
+	double** X = getX();
+	double** Y = getY();
+	double* input = malloc(samples * features * sizeof(double));
+	double* output = malloc(samples * classes * sizeof(double));
+	for (int i = 0; i < samples; i++)
+	{
+		for (int j = 0; j < features; j++)
+		{
+			input[i * features + j] = X[i][j];
+		}
+	}
+	//Save an ANN and compare its predictions with the ones of the loaded FrozenANN
+	ANN* ann = initANN(X, Y, samples, features, classes);
+	addLayerANN(ann, 12, HIDDEN_LAYER, TANH);
+	addLayerANN(ann, 6, HIDDEN_LAYER, RELU);
+	addLayerANN(ann, 1, OUTPUT_LAYER, SIGMOID);
+	trainANN(ann, 10, 0.0);
+	saveANN(ann, ANN_PATH);
+	FrozenANN* frozen = loadFrozenANN(ANN_PATH, 1);
+	Workspace* scratch = initWorkspace(scratchSizeFrozenANN(frozen, samples));
+	predictFrozenANN(frozen, input, samples, output, scratch);
+	double** P = predictANN(ann, X, samples, features);
+	int passed = checkPredictions("ANN", maxDifference(P, output, samples, classes));
+	matrixDispose(P, samples);
+	disposeWorkspace(scratch);
+	disposeFrozenANN(frozen);
+	disposeANN(ann);
+	//Save a LogisticRegression and compare its predictions with the ones of the loaded one
+	LogisticRegression* regr = initLogisticRegression(X, Y, samples, features, classes);
+	trainLogisticRegression(regr, ADAM_OPTIMIZER, 10, 0.0);
+	saveLogisticRegression(regr, LOGISTIC_REGRESSION_PATH);
+	LogisticRegression* loaded = loadLogisticRegression(LOGISTIC_REGRESSION_PATH, 1);
+	P = predictLogisticRegression(loaded, X, samples, features);
+	double** P_original = predictLogisticRegression(regr, X, samples, features);
+	for (int i = 0; i < samples; i++)
+	{
+		for (int j = 0; j < classes; j++)
+		{
+			output[i * classes + j] = P_original[i][j];
+		}
+	}
+	passed &= checkPredictions("LogisticRegression", maxDifference(P, output, samples, classes));
+	//An intact copy must be loaded, so the rejections below are caused by the damages
+	size_t size;
+	char* buffer = readFile(LOGISTIC_REGRESSION_PATH, &size);
+	ModelFileLayer* layers = (ModelFileLayer*) (buffer + sizeof(ModelFileHeader));
+	passed &= checkLoading("Intact file", buffer, size, 1, EXIT_SUCCESS);
+	//A flipped byte of the W is found by the checksum of the whole file
+	buffer[layers[0].W_offset] ^= 0x10;
+	passed &= checkLoading("Flipped blob byte", buffer, size, 1, EXIT_FAILURE);
+	buffer[layers[0].W_offset] ^= 0x10;
+	//A truncated file and a layer table pointing out of the file are found without the checksum
+	passed &= checkLoading("Truncated file", buffer, size - MODEL_FILE_ALIGNMENT, 0, EXIT_FAILURE);
+	layers[0].rows = INT32_MAX;
+	passed &= checkLoading("Layer table out of the file", buffer, size, 0, EXIT_FAILURE);
+	free(buffer);
+	matrixDispose(P, samples);
+	matrixDispose(P_original, samples);
+	disposeLogisticRegression(loaded);
+	disposeLogisticRegression(regr);
+	//Remove the files
+	remove(ANN_PATH);
+	remove(LOGISTIC_REGRESSION_PATH);
+	free(input);
+	free(output);
+	matrixDispose(X, samples);
+	matrixDispose(Y, samples);
+	//Exit success if both of the loaded models made the same predictions
+	return (passed == 1) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,149 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/core/linear_algebra.h"
+#include "../include/core/sparse_matrix.h"
+#include "../include/regression/logistic_regression.h"
+
+#include "../tests/sample_data.h"
+
+/*
+ * Test of the online training of the logistic regression. Chunks of the whole data passed to
+ * partialFitLogisticRegression() must take the same steps as trainLogisticRegression(), sparse
+ * chunks must take the same steps as dense ones, and a saved model loaded from its file must
+ * continue the training as the model in the memory. A model trained by small chunks read from a
+ * stream must reach about the loss of the full-batch training.
+ *
+ * e.g. gcc tests/OnlineTrainingTest.c $(find src -name '*.c') -lm -pthread
+ */
+
+//Path of the model file written by the test
+#define MODEL_PATH "OnlineTrainingTest.bqsm"
+
+//Rows in a chunk of the stream and the number of times the stream passes over the data
+#define CHUNK_ROWS 25
+#define EPOCHS 200
+
+/**
+ * State of the stream of the sample data
+ */
+typedef struct
+{
+	Matrix* X;
+	Matrix* Y;
+	//Rows read so far over all epochs
+	long rows_read;
+}
+SampleStream;
+
+//Reader of the sample data, which passes over it EPOCHS times
+static int readSamples(Matrix* X, Matrix* Y, void* argument)
+{
+	SampleStream* stream = argument;
+	int rows = 0;
+	while (rows < X->rows && stream->rows_read < (long) EPOCHS * samples)
+	{
+		int row_no = (int) (stream->rows_read % samples);
+		memcpy(MATRIX_ROW(X, rows), MATRIX_ROW(stream->X, row_no), features * sizeof(double));
+		memcpy(MATRIX_ROW(Y, rows), MATRIX_ROW(stream->Y, row_no), classes * sizeof(double));
+		stream->rows_read++;
+		rows++;
+	}
+	return rows;
+}
+
+//Method to set the W and b of a logistic regression to zeros
+static void zeroParameters(LogisticRegression* regr)
+{
+	matrixFillZero(regr->W);
+	memset(regr->b, 0, regr->W->columns * sizeof(double));
+}
+
+//Method to calculate the largest difference between the parameters of two logistic regressions
+static double parameterDifference(LogisticRegression* a, LogisticRegression* b)
+{
+	double difference = 0.0;
+	for (int j = 0; j < a->W->rows; j++)
+	{
+		for (int k = 0; k < a->W->columns; k++)
+		{
+			difference = fmax(difference, fabs(MATRIX_AT(a->W, j, k) - MATRIX_AT(b->W, j, k)));
+		}
+	}
+	for (int k = 0; k < a->W->columns; k++)
+	{
+		difference = fmax(difference, fabs(a->b[k] - b->b[k]));
+	}
+	return difference;
+}
+
+int main()
+{
+	//Import the X and Y data
+	double** X = getX();
+	double** Y = getY();
+	Matrix* X_matrix = matrixFromArray(X, samples, features);
+	Matrix* Y_matrix = matrixFromArray(Y, samples, classes);
+	SparseMatrix* X_sparse = sparseMatrixFromMatrix(X_matrix);
+	//Chunks of the whole data must take the same steps as the full-batch training
+	LogisticRegression* batch = initLogisticRegression(X, Y, samples, features, classes);
+	LogisticRegression* online = initLogisticRegressionOnline(features, classes);
+	LogisticRegression* sparse = initLogisticRegressionOnline(features, classes);
+	zeroParameters(batch);
+	zeroParameters(online);
+	zeroParameters(sparse);
+	trainLogisticRegression(batch, ADAM_OPTIMIZER, 200, 0.0);
+	for (int t = 0; t < 200; t++)
+	{
+		partialFitLogisticRegression(online, ADAM_OPTIMIZER, X_matrix, Y_matrix);
+		partialFitLogisticRegressionSparse(sparse, ADAM_OPTIMIZER, X_sparse, Y_matrix);
+	}
+	double difference = parameterDifference(batch, online);
+	double difference_sparse = parameterDifference(online, sparse);
+	printf("Partial fit : largest differences from the full-batch and the dense steps are %g and %g\n", difference, difference_sparse);
+	int passed = (difference < 1e-12 && difference_sparse < 1e-12);
+	//A loaded model must continue the training as the model in the memory
+	saveLogisticRegression(online, MODEL_PATH);
+	LogisticRegression* loaded = loadLogisticRegression(MODEL_PATH, 1);
+	remove(MODEL_PATH);
+	for (int t = 0; t < 10; t++)
+	{
+		partialFitLogisticRegression(online, GRADIENT_DESCENT, X_matrix, Y_matrix);
+		partialFitLogisticRegression(loaded, GRADIENT_DESCENT, X_matrix, Y_matrix);
+	}
+	difference = parameterDifference(online, loaded);
+	printf("Loaded model : largest difference of the parameters is %g\n", difference);
+	passed &= (difference < 1e-12 && loaded->file == NULL);
+	//A model trained by small chunks of a stream must reach about the loss of the full-batch training
+	LogisticRegression* full = initLogisticRegression(X, Y, samples, features, classes);
+	LogisticRegression* streamed = initLogisticRegressionOnline(features, classes);
+	zeroParameters(full);
+	zeroParameters(streamed);
+	trainLogisticRegression(full, ADAM_OPTIMIZER, 2000, 1e-12);
+	SampleStream stream = {X_matrix, Y_matrix, 0};
+	double progressive_loss = trainLogisticRegressionStream(streamed, ADAM_OPTIMIZER, CHUNK_ROWS, readSamples, &stream);
+	//The loss of the streamed model on the whole data is calculated by the full-batch model with its parameters
+	LogisticRegression* evaluated = initLogisticRegression(X, Y, samples, features, classes);
+	memcpy(evaluated->W->data, streamed->W->data, features * classes * sizeof(double));
+	memcpy(evaluated->b, streamed->b, classes * sizeof(double));
+	trainLogisticRegression(evaluated, GRADIENT_DESCENT, 1, 0.0);
+	printf("Stream : %ld rows read, progressive loss %.6f, loss %.6f, full-batch loss %.6f\n", stream.rows_read, progressive_loss, evaluated->log_loss, full->log_loss);
+	passed &= (stream.rows_read == (long) EPOCHS * samples && evaluated->log_loss < full->log_loss + 0.01);
+	//Dispose the data
+	disposeLogisticRegression(batch);
+	disposeLogisticRegression(online);
+	disposeLogisticRegression(sparse);
+	disposeLogisticRegression(loaded);
+	disposeLogisticRegression(full);
+	disposeLogisticRegression(streamed);
+	disposeLogisticRegression(evaluated);
+	disposeSparseMatrix(X_sparse);
+	disposeMatrix(X_matrix);
+	disposeMatrix(Y_matrix);
+	matrixDispose(X, samples);
+	matrixDispose(Y, samples);
+	//Exit success if the online training matched the full-batch training
+	return (passed == 1) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
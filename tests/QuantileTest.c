@@ -0,0 +1,130 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/statistics/statistics.h"
+
+/*
+ * Test of the quantiles. The quantiles selected from arrays of several shapes must be the
+ * same as the ones interpolated from the sorted arrays, and the ranks of the quantiles
+ * estimated by a QuantileSketch merged from the sketches of several parts must be close to
+ * the requested ones.
+ *
+ * e.g. gcc tests/QuantileTest.c $(find src -name '*.c') -lm -pthread
+ */
+
+//Number of items of the arrays, and the number of items and parts of the sketch
+#define ITEMS 10001
+#define SKETCH_ITEMS 1000000
+#define PARTS 4
+
+//Method to compare two doubles for qsort
+static int compare(const void* a, const void* b)
+{
+	double x = *(const double*) a;
+	double y = *(const double*) b;
+	return (x > y) - (x < y);
+}
+
+//Method to check the quantiles of an array against the ones of its sorted copy
+static int checkQuantiles(const char* shape, double* array, int n)
+{
+	double* sorted = malloc(n * sizeof(double));
+	double* copy = malloc(n * sizeof(double));
+	memcpy(sorted, array, n * sizeof(double));
+	qsort(sorted, n, sizeof(double), compare);
+	double fractions[7] = {0.0, 0.01, 0.25, 0.5, 0.75, 0.99, 1.0};
+	int mismatches = 0;
+	for (int fraction_no = 0; fraction_no < 7; fraction_no++)
+	{
+		double position = fractions[fraction_no] * (n - 1);
+		int k = (int) position;
+		double expected = (k + 1 < n) ? sorted[k] + (position - k) * (sorted[k + 1] - sorted[k]) : sorted[k];
+		memcpy(copy, array, n * sizeof(double));
+		mismatches += (selectQuantile(copy, n, fractions[fraction_no]) != expected);
+		mismatches += (quantile(array, n, fractions[fraction_no]) != expected);
+	}
+	printf("%s : %d mismatches\n", shape, mismatches);
+	free(sorted);
+	free(copy);
+	return mismatches == 0;
+}
+
+int main()
+{
+	//Arrays of several shapes, including the ones that are hard for the quickselect
+	double* array = malloc(ITEMS * sizeof(double));
+	int passed = 1;
+	srand(1);
+	for (int i = 0; i < ITEMS; i++)
+	{
+		array[i] = (double) rand() / RAND_MAX;
+	}
+	passed &= checkQuantiles("Random", array, ITEMS);
+	for (int i = 0; i < ITEMS; i++)
+	{
+		array[i] = rand() % 3;
+	}
+	passed &= checkQuantiles("Few values", array, ITEMS);
+	for (int i = 0; i < ITEMS; i++)
+	{
+		array[i] = i;
+	}
+	passed &= checkQuantiles("Sorted", array, ITEMS);
+	for (int i = 0; i < ITEMS; i++)
+	{
+		array[i] = ITEMS - i;
+	}
+	passed &= checkQuantiles("Reversed", array, ITEMS);
+	for (int i = 0; i < ITEMS; i++)
+	{
+		array[i] = (i < ITEMS / 2) ? i : ITEMS - i;
+	}
+	passed &= checkQuantiles("Organ pipe", array, ITEMS);
+	for (int i = 0; i < ITEMS; i++)
+	{
+		array[i] = 1.0;
+	}
+	passed &= checkQuantiles("Constant", array, ITEMS);
+	//The median of an unsorted array of an even size is the mean of its two middle items
+	double unsorted[6] = {5.0, 1.0, 4.0, 2.0, 6.0, 3.0};
+	printf("Median : %g\n", median(unsorted, 6));
+	passed &= (median(unsorted, 6) == 3.5 && unsorted[0] == 5.0);
+	free(array);
+	//Sketch the parts of the items separately and merge them
+	double* items = malloc(SKETCH_ITEMS * sizeof(double));
+	for (int i = 0; i < SKETCH_ITEMS; i++)
+	{
+		items[i] = exp(4.0 * rand() / RAND_MAX);
+	}
+	QuantileSketch* sketch = initQuantileSketch(200);
+	for (int part_no = 0; part_no < PARTS; part_no++)
+	{
+		QuantileSketch* part = initQuantileSketch(200);
+		updateQuantileSketch(part, items + part_no * (SKETCH_ITEMS / PARTS), SKETCH_ITEMS / PARTS);
+		mergeQuantileSketch(sketch, part);
+		disposeQuantileSketch(part);
+	}
+	//The ranks of the estimated quantiles must be close to the requested ones
+	qsort(items, SKETCH_ITEMS, sizeof(double), compare);
+	double fractions[5] = {0.01, 0.25, 0.5, 0.75, 0.99};
+	double error = 0.0;
+	for (int fraction_no = 0; fraction_no < 5; fraction_no++)
+	{
+		double estimate = sketchQuantile(sketch, fractions[fraction_no]);
+		long rank = 0;
+		while (rank < SKETCH_ITEMS && items[rank] < estimate)
+		{
+			rank++;
+		}
+		error = fmax(error, fabs((double) rank / SKETCH_ITEMS - fractions[fraction_no]));
+	}
+	printf("Sketch : %d items kept, largest rank error is %g\n", sketch->size, error);
+	passed &= (error < 0.02 && sketch->count == SKETCH_ITEMS);
+	passed &= (sketchQuantile(sketch, 0.0) == items[0] && sketchQuantile(sketch, 1.0) == items[SKETCH_ITEMS - 1]);
+	disposeQuantileSketch(sketch);
+	free(items);
+	//Exit success if the quantiles were selected exactly and estimated closely
+	return (passed == 1) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
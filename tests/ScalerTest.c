@@ -0,0 +1,140 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/core/linear_algebra.h"
+#include "../include/neural_networks/FrozenANN.h"
+#include "../include/preprocessing/feature_scaling.h"
+#include "../include/regression/logistic_regression.h"
+
+#include "../tests/sample_data.h"
+
+/*
+ * Test of the Scaler. The features of the sample data are shifted and stretched far from
+ * their scale, and each type of Scaler must revert its own scaling. Models with a Scaler set
+ * on them are trained on the unscaled features, and they must learn the same parameters as
+ * the models trained on a scaled copy of the features.
+ *
+ * e.g. gcc tests/ScalerTest.c $(find src -name '*.c') -lm -pthread
+ */
+
+//Method to calculate the largest difference between two double**
+static double arrayDifference(double** A, double** B, int rows, int columns)
+{
+	double difference = 0.0;
+	for (int i = 0; i < rows; i++)
+	{
+		for (int j = 0; j < columns; j++)
+		{
+			difference = fmax(difference, fabs(A[i][j] - B[i][j]));
+		}
+	}
+	return difference;
+}
+
+//Method to check a difference against a tolerance
+static int checkDifference(const char* test, double difference, double tolerance)
+{
+	printf("%s : largest difference is %g\n", test, difference);
+	return difference < tolerance;
+}
+
+int main()
+{
+	//Import the X and Y data and move the features far from their scale
+	double** X = getX();
+	double** Y = getY();
+	for (int i = 0; i < samples; i++)
+	{
+		X[i][0] = 1000.0 + 250.0 * X[i][0];
+		X[i][1] = -5.0 + 0.01 * X[i][1];
+	}
+	Matrix* X_matrix = matrixFromArray(X, samples, features);
+	Matrix* X_scaled = createMatrix(samples, features);
+	int passed = 1;
+	//Each type of Scaler must revert its scaling
+	const char* names[3] = {"Min-max round trip", "Standard round trip", "Robust round trip"};
+	ScalerType types[3] = {MIN_MAX_SCALER, STANDARD_SCALER, ROBUST_SCALER};
+	for (int type_no = 0; type_no < 3; type_no++)
+	{
+		Scaler* scaler = initScaler(types[type_no], features);
+		fitScaler(scaler, X_matrix);
+		transformScalerInto(scaler, X_matrix, X_scaled);
+		inverseTransformScaler(scaler, X_scaled);
+		double difference = 0.0;
+		for (int i = 0; i < samples; i++)
+		{
+			for (int j = 0; j < features; j++)
+			{
+				difference = fmax(difference, fabs(MATRIX_AT(X_scaled, i, j) - X[i][j]) / fabs(X[i][j]));
+			}
+		}
+		passed &= checkDifference(names[type_no], difference, 1e-14);
+		disposeScaler(scaler);
+	}
+	//The standardized features must match the ones of the methods of the arrays
+	Scaler* scaler = initScaler(STANDARD_SCALER, features);
+	fitScaler(scaler, X_matrix);
+	transformScalerInto(scaler, X_matrix, X_scaled);
+	double** X_standardized = standardize(X, scaler->offset, scaler->scale, samples, features);
+	double** X_scaled_array = matrixToArray(X_scaled);
+	passed &= checkDifference("Standardization", arrayDifference(X_standardized, X_scaled_array, samples, features), 1e-12);
+	matrixDispose(X_standardized, samples);
+	//A LogisticRegression with the Scaler must learn the same parameters as one trained on the scaled features
+	srand(1);
+	LogisticRegression* regr = initLogisticRegression(X, Y, samples, features, classes);
+	setScalerLogisticRegression(regr, scaler);
+	trainLogisticRegression(regr, ADAM_OPTIMIZER, 200, 0.0);
+	srand(1);
+	LogisticRegression* regr_scaled = initLogisticRegression(X_scaled_array, Y, samples, features, classes);
+	trainLogisticRegression(regr_scaled, ADAM_OPTIMIZER, 200, 0.0);
+	double** P = predictLogisticRegression(regr, X, samples, features);
+	double** P_scaled = predictLogisticRegression(regr_scaled, X_scaled_array, samples, features);
+	passed &= checkDifference("LogisticRegression", arrayDifference(P, P_scaled, samples, classes), 1e-9);
+	matrixDispose(P, samples);
+	matrixDispose(P_scaled, samples);
+	disposeLogisticRegression(regr);
+	disposeLogisticRegression(regr_scaled);
+	//An ANN with the Scaler must learn the same parameters as one trained on the scaled features
+	srand(1);
+	ANN* ann = initANN(X, Y, samples, features, classes);
+	addLayerANN(ann, 6, HIDDEN_LAYER, RELU);
+	addLayerANN(ann, 1, OUTPUT_LAYER, SIGMOID);
+	setScalerANN(ann, scaler);
+	trainANNMiniBatch(ann, 10, 50, 0.0);
+	srand(1);
+	ANN* ann_scaled = initANN(X_scaled_array, Y, samples, features, classes);
+	addLayerANN(ann_scaled, 6, HIDDEN_LAYER, RELU);
+	addLayerANN(ann_scaled, 1, OUTPUT_LAYER, SIGMOID);
+	trainANNMiniBatch(ann_scaled, 10, 50, 0.0);
+	P = predictANN(ann, X, samples, features);
+	P_scaled = predictANN(ann_scaled, X_scaled_array, samples, features);
+	passed &= checkDifference("ANN", arrayDifference(P, P_scaled, samples, classes), 1e-9);
+	matrixDispose(P_scaled, samples);
+	//The compiled ANN has the Scaler folded into it and takes the unscaled features
+	FrozenANN* frozen = compileANN(ann);
+	Workspace* scratch = initWorkspace(scratchSizeFrozenANN(frozen, samples));
+	double* output = malloc(samples * classes * sizeof(double));
+	predictFrozenANN(frozen, X_matrix->data, samples, output, scratch);
+	double difference = 0.0;
+	for (int i = 0; i < samples; i++)
+	{
+		difference = fmax(difference, fabs(output[i] - P[i][0]));
+	}
+	passed &= checkDifference("FrozenANN", difference, 1e-12);
+	free(output);
+	disposeWorkspace(scratch);
+	disposeFrozenANN(frozen);
+	matrixDispose(P, samples);
+	disposeANN(ann);
+	disposeANN(ann_scaled);
+	//Dispose the data
+	disposeScaler(scaler);
+	matrixDispose(X_scaled_array, samples);
+	disposeMatrix(X_scaled);
+	disposeMatrix(X_matrix);
+	matrixDispose(X, samples);
+	matrixDispose(Y, samples);
+	//Exit success if the scalings were reverted and the models with the Scaler learned the same parameters
+	return (passed == 1) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,93 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/preprocessing/feature_scaling.h"
+#include "../include/regression/logistic_regression.h"
+
+#include "../tests/sample_data.h"
+
+/*
+ * Test of the second-order optimizers. Logistic regressions trained on the sample data and on
+ * three noisy classes derived from it with NEWTON_OPTIMIZER and LBFGS_OPTIMIZER for a few tens
+ * of iterations must reach the loss ADAM_OPTIMIZER reaches in thousands of iterations, and they
+ * must make the same predictions. The Newton direction doesn't depend on the scaling of the
+ * features, so a model with a Scaler must make the same predictions as well.
+ *
+ * e.g. gcc tests/SecondOrderOptimizerTest.c $(find src -name '*.c') -lm -pthread
+ */
+
+//Method to train a logistic regression with an optimizer, the Scaler may be NULL
+static LogisticRegression* train(double** X, double** Y, int number_of_classes, Optimizer optimizer, int max_iterations, Scaler* scaler)
+{
+	LogisticRegression* regr = initLogisticRegression(X, Y, samples, features, number_of_classes);
+	setScalerLogisticRegression(regr, scaler);
+	trainLogisticRegression(regr, optimizer, max_iterations, 1e-12);
+	return regr;
+}
+
+//Method to calculate the largest difference between the predictions of two logistic regressions
+static double predictionDifference(LogisticRegression* a, LogisticRegression* b, double** X, int number_of_classes)
+{
+	double** P_a = predictLogisticRegression(a, X, samples, features);
+	double** P_b = predictLogisticRegression(b, X, samples, features);
+	double difference = 0.0;
+	for (int i = 0; i < samples; i++)
+	{
+		for (int k = 0; k < number_of_classes; k++)
+		{
+			difference = fmax(difference, fabs(P_a[i][k] - P_b[i][k]));
+		}
+	}
+	matrixDispose(P_a, samples);
+	matrixDispose(P_b, samples);
+	return difference;
+}
+
+//Method to check the optimizers on a Y
+static int checkOptimizers(const char* test, double** X, double** Y, int number_of_classes, Scaler* scaler)
+{
+	LogisticRegression* adam = train(X, Y, number_of_classes, ADAM_OPTIMIZER, 20000, NULL);
+	LogisticRegression* newton = train(X, Y, number_of_classes, NEWTON_OPTIMIZER, 30, NULL);
+	LogisticRegression* lbfgs = train(X, Y, number_of_classes, LBFGS_OPTIMIZER, 60, NULL);
+	LogisticRegression* newton_scaled = train(X, Y, number_of_classes, NEWTON_OPTIMIZER, 30, scaler);
+	printf("%s : losses of ADAM, Newton and L-BFGS are %.10f, %.10f and %.10f\n", test, adam->log_loss, newton->log_loss, lbfgs->log_loss);
+	int passed = (newton->log_loss <= adam->log_loss + 1e-8 && lbfgs->log_loss <= adam->log_loss + 1e-8);
+	double difference = predictionDifference(newton, lbfgs, X, number_of_classes);
+	double difference_scaled = predictionDifference(newton, newton_scaled, X, number_of_classes);
+	printf("%s : largest differences of the predictions of L-BFGS and the scaled Newton are %g and %g\n", test, difference, difference_scaled);
+	passed &= (difference < 1e-5 && difference_scaled < 1e-8);
+	disposeLogisticRegression(adam);
+	disposeLogisticRegression(newton);
+	disposeLogisticRegression(lbfgs);
+	disposeLogisticRegression(newton_scaled);
+	return passed;
+}
+
+int main()
+{
+	//Import the X and Y data and fit a Scaler to the X
+	double** X = getX();
+	double** Y = getY();
+	Matrix* X_matrix = matrixFromArray(X, samples, features);
+	Scaler* scaler = initScaler(STANDARD_SCALER, features);
+	fitScaler(scaler, X_matrix);
+	int passed = checkOptimizers("Two classes", X, Y, classes, scaler);
+	//Derive three classes from the quadrants of the X, a third of them chosen randomly so that they aren't separable
+	double** Y_3 = initZeroMatrix(samples, 3);
+	srand(1);
+	for (int i = 0; i < samples; i++)
+	{
+		int class_no = (X[i][0] > 0.0) + (X[i][1] > 0.5);
+		Y_3[i][(rand() % 3 == 0) ? rand() % 3 : class_no] = 1.0;
+	}
+	passed &= checkOptimizers("Three classes", X, Y_3, 3, scaler);
+	//Dispose the data
+	disposeScaler(scaler);
+	disposeMatrix(X_matrix);
+	matrixDispose(X, samples);
+	matrixDispose(Y, samples);
+	matrixDispose(Y_3, samples);
+	//Exit success if the second-order optimizers reached the loss of ADAM and agreed
+	return (passed == 1) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,182 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/core/gemm.h"
+#include "../include/core/linear_algebra.h"
+#include "../include/core/sparse_matrix.h"
+#include "../include/data/csv_loader.h"
+#include "../include/regression/logistic_regression.h"
+
+/*
+ * Test of the sparse matrices. A random sparse data set of three classes is written into a
+ * libsvm file with comments and empty lines, and the loaded X must be the same as the data
+ * set. The sparse multiplications must give the results of matrixGEMM() on the dense X, and
+ * the logistic regressions trained on the sparse and the dense X from the same W and b must
+ * reach the same parameters and make the same predictions.
+ *
+ * e.g. gcc tests/SparseMatrixTest.c $(find src -name '*.c') -lm -pthread
+ */
+
+//Path of the libsvm file written by the test
+#define LIBSVM_PATH "SparseMatrixTest.svm"
+
+//Dimensions of the data set and the number of the nonzero features of each row
+#define ROWS 20000
+#define FEATURES 300
+#define CLASSES 3
+#define NONZEROS_PER_ROW 6
+
+//Method to calculate the largest difference between two matrices
+static double largestDifference(Matrix* A, Matrix* B)
+{
+	double difference = 0.0;
+	for (int i = 0; i < A->rows; i++)
+	{
+		for (int j = 0; j < A->columns; j++)
+		{
+			difference = fmax(difference, fabs(MATRIX_AT(A, i, j) - MATRIX_AT(B, i, j)));
+		}
+	}
+	return difference;
+}
+
+//Method to train a logistic regression from fixed W and b, either the X or the X_sparse is NULL
+static LogisticRegression* train(double** X, SparseMatrix* X_sparse, double** Y, Optimizer optimizer, int max_iterations)
+{
+	LogisticRegression* regr = (X_sparse != NULL) ? initLogisticRegressionSparse(X_sparse, Y, CLASSES) : initLogisticRegression(X, Y, ROWS, FEATURES, CLASSES);
+	matrixFillZero(regr->W);
+	for (int class_no = 0; class_no < CLASSES; class_no++)
+	{
+		regr->b[class_no] = 0.0;
+	}
+	trainLogisticRegression(regr, optimizer, max_iterations, 0.0);
+	return regr;
+}
+
+//Method to check the logistic regressions trained on the sparse and the dense X with an optimizer
+static int checkTraining(const char* test, Matrix* X_dense, SparseMatrix* X, Optimizer optimizer, int max_iterations, double** Y)
+{
+	double** X_array = matrixToArray(X_dense);
+	LogisticRegression* dense = train(X_array, NULL, Y, optimizer, max_iterations);
+	LogisticRegression* sparse = train(NULL, X, Y, optimizer, max_iterations);
+	double** P_dense = predictLogisticRegression(dense, X_array, ROWS, FEATURES);
+	double** P_sparse = predictLogisticRegressionSparse(sparse, X);
+	double difference = largestDifference(dense->W, sparse->W);
+	for (int i = 0; i < ROWS; i++)
+	{
+		for (int k = 0; k < CLASSES; k++)
+		{
+			difference = fmax(difference, fabs(P_dense[i][k] - P_sparse[i][k]));
+		}
+	}
+	printf("%s : losses are %.10f and %.10f, largest difference of the W and the P is %g\n", test, dense->log_loss, sparse->log_loss, difference);
+	int passed = (difference < 1e-8 && fabs(dense->log_loss - sparse->log_loss) < 1e-10);
+	matrixDispose(X_array, ROWS);
+	matrixDispose(P_dense, ROWS);
+	matrixDispose(P_sparse, ROWS);
+	disposeLogisticRegression(dense);
+	disposeLogisticRegression(sparse);
+	return passed;
+}
+
+int main()
+{
+	//Generate the sparse rows and their classes from random weights, and write them into a libsvm file
+	srand(1);
+	Matrix* X_dense = createZeroMatrix(ROWS, FEATURES);
+	Matrix* W = createMatrix(FEATURES, CLASSES);
+	for (int j = 0; j < FEATURES; j++)
+	{
+		for (int k = 0; k < CLASSES; k++)
+		{
+			MATRIX_AT(W, j, k) = 4.0 * rand() / RAND_MAX - 2.0;
+		}
+	}
+	double** Y = initZeroMatrix(ROWS, CLASSES);
+	FILE* file = fopen(LIBSVM_PATH, "w");
+	fprintf(file, "# label index:value ...\n\n");
+	for (int i = 0; i < ROWS; i++)
+	{
+		double* x = MATRIX_ROW(X_dense, i);
+		for (int nonzero_no = 0; nonzero_no < NONZEROS_PER_ROW; nonzero_no++)
+		{
+			x[rand() % FEATURES] = (double) rand() / RAND_MAX;
+		}
+		//The class with the largest score, a tenth of them chosen randomly so that they aren't separable
+		int class_no = 0;
+		double best = -INFINITY;
+		for (int k = 0; k < CLASSES; k++)
+		{
+			double score = 0.0;
+			for (int j = 0; j < FEATURES; j++)
+			{
+				score += x[j] * MATRIX_AT(W, j, k);
+			}
+			class_no = (score > best) ? k : class_no;
+			best = fmax(score, best);
+		}
+		class_no = (rand() % 10 == 0) ? rand() % CLASSES : class_no;
+		Y[i][class_no] = 1.0;
+		fprintf(file, "%d", class_no);
+		for (int j = 0; j < FEATURES; j++)
+		{
+			if (x[j] != 0.0)
+			{
+				fprintf(file, " %d:%.17g", j + 1, x[j]);
+			}
+		}
+		fprintf(file, (i % 1000 == 0) ? " # comment\r\n" : "\n");
+	}
+	fclose(file);
+	//Load the file with the number of features of the largest index and one-hot encoded labels
+	SparseMatrix* X;
+	Matrix* Y_loaded;
+	loadLibSVM(LIBSVM_PATH, 0, CLASSES, &X, &Y_loaded);
+	Matrix* X_loaded = sparseMatrixToMatrix(X);
+	Matrix* Y_matrix = matrixFromArray(Y, ROWS, CLASSES);
+	int passed = (X->rows == ROWS && X->columns <= FEATURES && X_loaded->columns == X->columns);
+	if (passed == 1)
+	{
+		Matrix X_view = {X_dense->data, ROWS, X->columns, X_dense->stride};
+		double difference = fmax(largestDifference(&X_view, X_loaded), largestDifference(Y_matrix, Y_loaded));
+		printf("Loader : %d rows and %ld nonzero items loaded, largest difference is %g\n", X->rows, SPARSE_NONZEROS(X), difference);
+		passed &= (difference == 0.0);
+	}
+	//Load the file again with all features, and compare the multiplications with the ones of the dense X
+	disposeSparseMatrix(X);
+	loadLibSVM(LIBSVM_PATH, FEATURES, CLASSES, &X, NULL);
+	Matrix* C_dense = createMatrix(ROWS, CLASSES);
+	Matrix* C_sparse = createMatrix(ROWS, CLASSES);
+	matrixGEMM(0, 0, 0.5, X_dense, W, 0.0, C_dense);
+	sparseMatrixGEMM(0.5, X, W, 0.0, C_sparse);
+	double difference = largestDifference(C_dense, C_sparse);
+	Matrix* G_dense = createMatrix(FEATURES, CLASSES);
+	Matrix* G_sparse = createMatrix(FEATURES, CLASSES);
+	matrixFillZero(G_dense);
+	matrixFillZero(G_sparse);
+	matrixGEMM(1, 0, 2.0, X_dense, C_dense, 1.0, G_dense);
+	sparseMatrixTransposeGEMM(2.0, X, C_dense, 1.0, G_sparse);
+	difference = fmax(difference, largestDifference(G_dense, G_sparse));
+	printf("Multiplications : largest difference is %g\n", difference);
+	passed &= (difference < 1e-10);
+	//Train the logistic regressions on the sparse and the dense X
+	passed &= checkTraining("ADAM", X_dense, X, ADAM_OPTIMIZER, 100, Y);
+	passed &= checkTraining("L-BFGS", X_dense, X, LBFGS_OPTIMIZER, 20, Y);
+	passed &= checkTraining("Newton", X_dense, X, NEWTON_OPTIMIZER, 5, Y);
+	//Dispose the data and the file
+	remove(LIBSVM_PATH);
+	disposeSparseMatrix(X);
+	disposeMatrix(X_dense);
+	disposeMatrix(X_loaded);
+	disposeMatrix(Y_loaded);
+	disposeMatrix(Y_matrix);
+	disposeMatrix(W);
+	disposeMatrix(C_dense);
+	disposeMatrix(C_sparse);
+	disposeMatrix(G_dense);
+	disposeMatrix(G_sparse);
+	matrixDispose(Y, ROWS);
+	//Exit success if the sparse matrices matched the dense ones
+	return (passed == 1) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
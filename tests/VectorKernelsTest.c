@@ -0,0 +1,173 @@
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/core/vector_kernels.h"
+
+/*
+ * Test of the errors of the transcendental vector kernels. Each method is evaluated on
+ * SAMPLES evenly spaced points of an interval with each of the instruction sets, and the
+ * maximum error is measured in ulp against the long double functions of the C library.
+ * The errors must be below the bounds documented in vector_kernels.h. The compensated
+ * sums must be correctly rounded for the items of many magnitudes, and exact for the
+ * items cancelling each other.
+ *
+ * e.g. gcc tests/VectorKernelsTest.c src/core/vector_kernels.c -lm
+ */
+
+//Number of points of each interval
+#define SAMPLES 200001
+
+//Method to calculate the error of a result in ulp of the reference
+static double errorULP(double result, long double reference)
+{
+	double rounded = (double) reference;
+	if (isnan(rounded) || isinf(rounded))
+	{
+		return (isnan(result) == isnan(rounded) && (isnan(rounded) || result == rounded)) ? 0.0 : INFINITY;
+	}
+	double ulp = nextafter(fabs(rounded), INFINITY) - fabs(rounded);
+	return (double) (fabsl((long double) result - reference) / ulp);
+}
+
+//Reference implementations
+static long double referenceExp(long double x)
+{
+	return expl(x);
+}
+
+static long double referenceLog(long double x)
+{
+	return logl(x);
+}
+
+static long double referenceSigmoid(long double x)
+{
+	return 1.0L / (1.0L + expl(-x));
+}
+
+static long double referenceTanh(long double x)
+{
+	return tanhl(x);
+}
+
+//Method to check the maximum error of a vector method on an interval
+static int checkErrors(const char* name, void (*method)(double*, double*, int), long double (*reference)(long double), double low, double high, double bound, double* x, double* y)
+{
+	for (int i = 0; i < SAMPLES; i++)
+	{
+		x[i] = low + (high - low) * i / (SAMPLES - 1);
+	}
+	method(y, x, SAMPLES);
+	double max_error = 0.0;
+	for (int i = 0; i < SAMPLES; i++)
+	{
+		double error = errorULP(y[i], reference(x[i]));
+		max_error = (error > max_error) ? error : max_error;
+	}
+	printf("\t%s on [%g, %g] : %.3f ulp\n", name, low, high, max_error);
+	if (max_error > bound)
+	{
+		printf("\t%s exceeds %.1f ulp\n", name, bound);
+		return 0;
+	}
+	return 1;
+}
+
+//Method to check the softmax of a row whose items are close to each other, so x[i] - max(x) is exact
+static int checkSoftmax(double* x, double* y, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		x[i] = 1.0 + (double) (i % 7) / 8.0;
+	}
+	vectorSoftmax(y, x, n);
+	long double sum = 0.0L;
+	for (int i = 0; i < n; i++)
+	{
+		sum += expl((long double) x[i] - 1.75L);
+	}
+	double max_error = 0.0;
+	for (int i = 0; i < n; i++)
+	{
+		double error = errorULP(y[i], expl((long double) x[i] - 1.75L) / sum);
+		max_error = (error > max_error) ? error : max_error;
+	}
+	printf("\tsoftmax of %d items : %.3f ulp\n", n, max_error);
+	return max_error <= 3.0;
+}
+
+//Method to check the compensated sums and the moments of the items of many magnitudes and of cancelling items
+static int checkReductions(double* x, int n)
+{
+	//Positive items from 1e-9 to 1e9, whose long double sum is accurate
+	long double reference_sum = 0.0L;
+	long double reference_squares = 0.0L;
+	double reference_min = INFINITY;
+	double reference_max = -INFINITY;
+	for (int i = 0; i < n; i++)
+	{
+		x[i] = exp(-20.7 + 41.4 * (double) ((i * 7919L) % n) / n);
+		reference_sum += x[i];
+		reference_squares += (long double) x[i] * x[i];
+		reference_min = fmin(reference_min, x[i]);
+		reference_max = fmax(reference_max, x[i]);
+	}
+	double sum_error = errorULP(vectorSum(x, n), reference_sum);
+	VectorMoments moments = vectorMoments(x, n);
+	double moments_error = fmax(errorULP(moments.sum, reference_sum), errorULP(moments.sum_of_squares, reference_squares));
+	int passed = (sum_error <= 1.0 && moments_error <= 1.0 && moments.min == reference_min && moments.max == reference_max);
+	//Items cancelling each other, whose naive sum loses the ones : 1e16 + 1 - 1e16 + ...
+	int triples = n / 3;
+	for (int i = 0; i < triples; i++)
+	{
+		x[3 * i] = 1e16;
+		x[3 * i + 1] = 1.0;
+		x[3 * i + 2] = -1e16;
+	}
+	double cancelled = vectorSum(x, 3 * triples);
+	passed &= (cancelled == triples && vectorMoments(x, 3 * triples).sum == triples);
+	//The NaNs are skipped by the minimum and the maximum
+	x[n / 2] = NAN;
+	moments = vectorMoments(x, 3 * triples);
+	passed &= (moments.min == -1e16 && moments.max == 1e16 && isnan(moments.sum));
+	printf("	sum of %d items : %.3f ulp, moments : %.3f ulp, cancelling sum : %.17g\n", n, sum_error, moments_error, cancelled);
+	return passed;
+}
+
+int main()
+{
+	double* x = malloc(SAMPLES * sizeof(double));
+	double* y = malloc(SAMPLES * sizeof(double));
+	const char* names[] = {"scalar", "SSE2", "AVX2", "AVX-512"};
+	int passed = 1;
+	//Check the instruction sets supported by the processor
+	for (InstructionSet instruction_set = INSTRUCTION_SET_SCALAR; instruction_set <= INSTRUCTION_SET_AVX512; instruction_set++)
+	{
+		setInstructionSet(instruction_set);
+		if (getInstructionSet() != instruction_set)
+		{
+			continue;
+		}
+		printf("%s :\n", names[instruction_set]);
+		passed &= checkErrors("exp", vectorExp, referenceExp, -708.0, 709.7, 1.5, x, y);
+		passed &= checkErrors("exp", vectorExp, referenceExp, -1.0, 1.0, 1.5, x, y);
+		passed &= checkErrors("log", vectorLog, referenceLog, DBL_MIN, 1e300, 1.0, x, y);
+		passed &= checkErrors("log", vectorLog, referenceLog, 0.5, 2.0, 1.0, x, y);
+		passed &= checkErrors("sigmoid", vectorSigmoid, referenceSigmoid, -709.0, 40.0, 2.5, x, y);
+		passed &= checkErrors("sigmoid", vectorSigmoid, referenceSigmoid, -5.0, 5.0, 2.5, x, y);
+		passed &= checkErrors("tanh", vectorTanh, referenceTanh, -25.0, 25.0, 3.5, x, y);
+		passed &= checkErrors("tanh", vectorTanh, referenceTanh, -1e-3, 1e-3, 3.5, x, y);
+		for (int n = 1; n <= 19; n += 3)
+		{
+			passed &= checkSoftmax(x, y, n);
+		}
+		passed &= checkReductions(x, SAMPLES);
+		passed &= checkReductions(x, 37);
+	}
+	free(x);
+	free(y);
+	//Exit success if all of the errors are within the bounds
+	return (passed == 1) ? EXIT_SUCCESS : EXIT_FAILURE;
+}